@@ -247,6 +247,30 @@ ssc_data_t ssc_data_get_table( ssc_data_t p_data, const char *name )
 	return (*f)( p_data, name );
 }
 
+ssc_number_t *ssc_data_alloc_array( int length )
+{
+	static ssc_number_t *(*f)(int) = NULL;
+	CHECK_DLL_LOADED();
+	if (!f && 0 == (f = (ssc_number_t*(*)(int))PROCADDR())) FAIL_ON_LOCATE();
+	return (*f)( length );
+}
+
+void ssc_data_set_array_owned( ssc_data_t p_data, const char *name, ssc_number_t *pvalues, int length )
+{
+	static void (*f)(ssc_data_t, const char*, ssc_number_t*, int) = NULL;
+	CHECK_DLL_LOADED();
+	if (!f && 0 == (f = (void(*)(ssc_data_t, const char*, ssc_number_t*, int))PROCADDR())) FAIL_ON_LOCATE();
+	(*f)( p_data, name, pvalues, length );
+}
+
+const ssc_number_t *ssc_data_get_array_view( ssc_data_t p_data, const char *name, int *length )
+{
+	static const ssc_number_t *(*f)(ssc_data_t, const char*, int*) = NULL;
+	CHECK_DLL_LOADED();
+	if (!f && 0 == (f = (const ssc_number_t*(*)(ssc_data_t, const char*, int*))PROCADDR())) FAIL_ON_LOCATE();
+	return (*f)( p_data, name, length );
+}
+
 #define DYNAMICCALL_CONSTCHARSTAR__SSCDATAT() \
 	static const char *(*f)(ssc_data_t) = NULL; \
 	CHECK_DLL_LOADED(); \
@@ -443,6 +467,14 @@ const char *ssc_module_log( ssc_module_t p_mod, int index, int *item_type, float
 	return (*f)( p_mod, index, item_type, time );
 }
 
+int ssc_module_exec_batch( const char *name, ssc_data_t *p_data, int count, int nthreads, ssc_bool_t *results, ssc_module_t *p_mods )
+{
+	static int (*f)(const char*, ssc_data_t*, int, int, ssc_bool_t*, ssc_module_t*) = NULL;
+	CHECK_DLL_LOADED();
+	if (!f && 0 == (f = (int(*)(const char*, ssc_data_t*, int, int, ssc_bool_t*, ssc_module_t*))PROCADDR())) FAIL_ON_LOCATE();
+	return (*f)( name, p_data, count, nthreads, results, p_mods );
+}
+
 void __ssc_segfault()
 {
 	static void (*f)() = NULL;
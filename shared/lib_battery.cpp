@@ -144,6 +144,38 @@ void capacity_t::copy(capacity_t * capacity)
 	_prev_charge = capacity->_prev_charge;
 	_charge = capacity->_charge;
 }
+void capacity_t::save_state(battery_state::capacity_state &state)
+{
+	state.q0 = _q0;
+	state.qmax = _qmax;
+	state.qmax_thermal = _qmax_thermal;
+	state.qmax0 = _qmax0;
+	state.I = _I;
+	state.I_loss = _I_loss;
+	state.SOC = _SOC;
+	state.DOD = _DOD;
+	state.DOD_prev = _DOD_prev;
+	state.dt_hour = _dt_hour;
+	state.chargeChange = _chargeChange;
+	state.prev_charge = _prev_charge;
+	state.charge = _charge;
+}
+void capacity_t::restore_state(const battery_state::capacity_state &state)
+{
+	_q0 = state.q0;
+	_qmax = state.qmax;
+	_qmax_thermal = state.qmax_thermal;
+	_qmax0 = state.qmax0;
+	_I = state.I;
+	_I_loss = state.I_loss;
+	_SOC = state.SOC;
+	_DOD = state.DOD;
+	_DOD_prev = state.DOD_prev;
+	_dt_hour = state.dt_hour;
+	_chargeChange = state.chargeChange;
+	_prev_charge = state.prev_charge;
+	_charge = state.charge;
+}
 void capacity_t::check_charge_change()
 {
 	_charge = NO_CHARGE;
@@ -269,6 +301,22 @@ void capacity_kibam_t::copy(capacity_t * capacity)
 	_q20 = tmp->_q20;
 	_I20 = tmp->_I20;
 }
+void capacity_kibam_t::save_state(battery_state::capacity_state &state)
+{
+	capacity_t::save_state(state);
+	state.q1 = _q1;
+	state.q2 = _q2;
+	state.q1_0 = _q1_0;
+	state.q2_0 = _q2_0;
+}
+void capacity_kibam_t::restore_state(const battery_state::capacity_state &state)
+{
+	capacity_t::restore_state(state);
+	_q1 = state.q1;
+	_q2 = state.q2;
+	_q1_0 = state.q1_0;
+	_q2_0 = state.q2_0;
+}
 
 void capacity_kibam_t::replace_battery()
 {
@@ -522,6 +570,8 @@ void voltage_t::copy(voltage_t * voltage)
 	// doesn't change;
 	//_batt_voltage_matrix = voltage->_batt_voltage_matrix;
 }
+void voltage_t::save_state(battery_state::voltage_state &state){ state.cell_voltage = _cell_voltage; }
+void voltage_t::restore_state(const battery_state::voltage_state &state){ _cell_voltage = state.cell_voltage; }
 double voltage_t::battery_voltage(){ return _num_cells_series*_cell_voltage; }
 double voltage_t::battery_voltage_nominal(){ return _num_cells_series * _cell_voltage_nominal; }
 double voltage_t::cell_voltage(){ return _cell_voltage; }
@@ -721,6 +771,16 @@ void voltage_vanadium_redox_t::copy(voltage_t * voltage)
 	_F = tmp->_F;
 	_C0 = tmp->_C0;
 }
+void voltage_vanadium_redox_t::save_state(battery_state::voltage_state &state)
+{
+	voltage_t::save_state(state);
+	state.I = _I;
+}
+void voltage_vanadium_redox_t::restore_state(const battery_state::voltage_state &state)
+{
+	voltage_t::restore_state(state);
+	_I = state.I;
+}
 void voltage_vanadium_redox_t::updateVoltage(capacity_t * capacity, thermal_t * thermal, double )
 {
 
@@ -801,6 +861,22 @@ void lifetime_t::copy(lifetime_t * lifetime)
 	_replacement_scheduled = lifetime->_replacement_scheduled;
 	_q = lifetime->_q;
 }
+void lifetime_t::save_state(battery_state::lifetime_state &state)
+{
+	_lifetime_cycle->save_state(state);
+	_lifetime_calendar->save_state(state);
+	state.replacements = _replacements;
+	state.replacement_scheduled = _replacement_scheduled;
+	state.q = _q;
+}
+void lifetime_t::restore_state(const battery_state::lifetime_state &state)
+{
+	_lifetime_cycle->restore_state(state);
+	_lifetime_calendar->restore_state(state);
+	_replacements = state.replacements;
+	_replacement_scheduled = state.replacement_scheduled;
+	_q = state.q;
+}
 double lifetime_t::capacity_percent(){ return _q; }
 void lifetime_t::runLifetimeModels(size_t idx, capacity_t * capacity, double T_battery)
 {
@@ -857,6 +933,8 @@ lifetime_cycle_t::lifetime_cycle_t(const util::matrix_t<double> &batt_lifetime_m
 		_cycles_vect.push_back(batt_lifetime_matrix.at(i,1));
 		_capacities_vect.push_back(batt_lifetime_matrix.at(i, 2));
 	}
+	init_brackets();
+
 	// initialize other member variables
 	_nCycles = 0;
 	_Dlt = 0;
@@ -891,6 +969,30 @@ void lifetime_cycle_t::copy(lifetime_cycle_t * lifetime_cycle)
 	_Range = lifetime_cycle->_Range;
 	_average_range = lifetime_cycle->_average_range;
 }
+void lifetime_cycle_t::save_state(battery_state::lifetime_state &state)
+{
+	state.cycle_nCycles = _nCycles;
+	state.cycle_q = _q;
+	state.cycle_Dlt = _Dlt;
+	state.cycle_jlt = _jlt;
+	state.cycle_Xlt = _Xlt;
+	state.cycle_Ylt = _Ylt;
+	state.cycle_Peaks.assign(_Peaks.begin(), _Peaks.end());
+	state.cycle_Range = _Range;
+	state.cycle_average_range = _average_range;
+}
+void lifetime_cycle_t::restore_state(const battery_state::lifetime_state &state)
+{
+	_nCycles = state.cycle_nCycles;
+	_q = state.cycle_q;
+	_Dlt = state.cycle_Dlt;
+	_jlt = state.cycle_jlt;
+	_Xlt = state.cycle_Xlt;
+	_Ylt = state.cycle_Ylt;
+	_Peaks.assign(state.cycle_Peaks.begin(), state.cycle_Peaks.end());
+	_Range = state.cycle_Range;
+	_average_range = state.cycle_average_range;
+}
 double lifetime_cycle_t::computeCycleDamageAtDOD(double DOD)
 {
 	if (DOD == 0)
@@ -980,18 +1082,16 @@ int lifetime_cycle_t::rainflow_compareRanges()
 		_nCycles++;
 
 		// the capacity percent cannot increase
-		if (bilinear(_average_range, _nCycles) <= _q)
-			_q = bilinear(_average_range, _nCycles);
+		double q = bilinear(_average_range, _nCycles);
+		if (q <= _q)
+			_q = q;
 
 		if (_q < 0)
 			_q = 0.;
 		
 		// discard peak & valley of Y
-		double save = _Peaks[_jlt]; 
-		_Peaks.pop_back(); 
-		_Peaks.pop_back();
-		_Peaks.pop_back();
-		_Peaks.push_back(save);
+		_Peaks[_jlt - 2] = _Peaks[_jlt];
+		_Peaks.resize(_jlt - 1);
 		_jlt -= 2;
 		// stay in while loop
 		retCode = LT_RERANGE;
@@ -1015,142 +1115,146 @@ int lifetime_cycle_t::cycles_elapsed(){ return _nCycles; }
 double lifetime_cycle_t::cycle_range(){ return _Range; }
 
 
-double lifetime_cycle_t::bilinear(double DOD, int cycle_number)
+void lifetime_cycle_t::init_brackets()
 {
 	/*
-	Work could be done to make this simpler
-	Current idea is to interpolate first along the C = f(n) curves for each DOD to get C_DOD_, C_DOD_+ 
-	Then interpolate C_, C+ to get C at the DOD of interest
+	The interpolation tables used by bilinear() only depend on which DOD levels of the lifetime matrix
+	bracket the DOD, so they are built once for each interval between levels instead of at every call
 	*/
+	_DOD_levels = _DOD_vect;
+	std::sort(_DOD_levels.begin(), _DOD_levels.end());
+	_DOD_levels.erase(std::unique(_DOD_levels.begin(), _DOD_levels.end()), _DOD_levels.end());
+
+	_brackets.clear();
+	size_t n = _DOD_levels.size();
+	if (n < 2)
+		return;
+
+	// representative DOD for each interval (_DOD_levels[k-1], _DOD_levels[k]], and above the highest level
+	for (size_t k = 0; k < n; k++)
+		_brackets.push_back(make_bracket(_DOD_levels[k]));
+	_brackets.push_back(make_bracket(_DOD_levels[n - 1] + 1.));
+}
 
-	std::vector<double> D_unique_vect;
+lifetime_cycle_t::dod_bracket lifetime_cycle_t::make_bracket(double DOD)
+{
 	std::vector<double> C_n_low_vect;
-	std::vector<double> D_high_vect;
 	std::vector<double> C_n_high_vect;
 	std::vector<int> low_indices;
 	std::vector<int> high_indices;
 	double D = 0.;
-	size_t n = 0;
-	double C = 100;
-
-	// get unique values of D
-	D_unique_vect.push_back(_DOD_vect[0]);
-	for (int i = 0; i < (int)_DOD_vect.size(); i++){
-		bool contained = false;
-		for (int j = 0; j < (int)D_unique_vect.size(); j++){
-			if (_DOD_vect[i] == D_unique_vect[j]){
-				contained = true;
-				break;
-			}
-		}
-		if (!contained){
-			D_unique_vect.push_back(_DOD_vect[i]);
-		}
-	}
-	n = D_unique_vect.size();
 
-	if (n > 1)
+	// get where DOD is bracketed [D_lo, DOD, D_hi]
+	double D_lo = 0;
+	double D_hi = 100;
+
+	for (int i = 0; i < (int)_DOD_vect.size(); i++)
 	{
-		// get where DOD is bracketed [D_lo, DOD, D_hi]
-		double D_lo = 0;
-		double D_hi = 100;
+		D = _DOD_vect[i];
+		if (D < DOD && D > D_lo)
+			D_lo = D;
+		else if (D >= DOD && D < D_hi)
+			D_hi = D;
+	}
 
-		for (int i = 0; i < (int)_DOD_vect.size(); i++)
-		{
-			D = _DOD_vect[i];
-			if (D < DOD && D > D_lo)
-				D_lo = D;
-			else if (D >= DOD && D < D_hi)
-				D_hi = D;
-		}
+	// Seperate table into bins
+	double D_min = 100.;
+	double D_max = 0.;
+	
+	for (int i = 0; i < (int)_DOD_vect.size(); i++)
+	{
+		D = _DOD_vect[i];
+		if (D == D_lo)
+			low_indices.push_back(i);
+		else if (D == D_hi)
+			high_indices.push_back(i);
+
+		if (D < D_min){ D_min = D; }
+		else if (D > D_max){ D_max = D; }
+	}
 
-		// Seperate table into bins
-		double D_min = 100.;
-		double D_max = 0.;
-		
-		for (int i = 0; i < (int)_DOD_vect.size(); i++)
+	// if we're out of the bounds, just make the upper bound equal to the highest input
+	if (high_indices.size() == 0)
+	{
+		for (int i = 0; i != (int)_DOD_vect.size(); i++)
 		{
-			D = _DOD_vect[i];
-			if (D == D_lo)
-				low_indices.push_back(i);
-			else if (D == D_hi)
+			if (_DOD_vect[i] == D_max)
 				high_indices.push_back(i);
-
-			if (D < D_min){ D_min = D; }
-			else if (D > D_max){ D_max = D; }
-		}
-
-		// if we're out of the bounds, just make the upper bound equal to the highest input
-		if (high_indices.size() == 0)
-		{
-			for (int i = 0; i != (int)_DOD_vect.size(); i++)
-			{
-				if (_DOD_vect[i] == D_max)
-					high_indices.push_back(i);
-			}
 		}
+	}
 
-		size_t n_rows_lo = low_indices.size();
-		size_t n_rows_hi = high_indices.size();
-		size_t n_cols = 2;
+	size_t n_rows_lo = low_indices.size();
+	size_t n_rows_hi = high_indices.size();
+	size_t n_cols = 2;
 
-		// If we aren't bounded, fill in values
-		if (n_rows_lo == 0)
-		{
-			// Assumes 0% DOD
-			for (int i = 0; i < (int)n_rows_hi; i++)
-			{
-				C_n_low_vect.push_back(0. + i * 500); // cycles
-				C_n_low_vect.push_back(100.); // 100 % capacity
-			}
-		}
-		
-		if (n_rows_lo != 0)
+	// If we aren't bounded, fill in values
+	if (n_rows_lo == 0)
+	{
+		// Assumes 0% DOD
+		for (int i = 0; i < (int)n_rows_hi; i++)
 		{
-			for (int i = 0; i < (int)n_rows_lo; i++)
-			{
-				C_n_low_vect.push_back(_cycles_vect[low_indices[i]]);
-				C_n_low_vect.push_back(_capacities_vect[low_indices[i]]);
-			}
+			C_n_low_vect.push_back(0. + i * 500); // cycles
+			C_n_low_vect.push_back(100.); // 100 % capacity
 		}
-		if (n_rows_hi != 0)
+	}
+	
+	if (n_rows_lo != 0)
+	{
+		for (int i = 0; i < (int)n_rows_lo; i++)
 		{
-			for (int i = 0; i < (int)n_rows_hi; i++)
-			{
-				C_n_high_vect.push_back(_cycles_vect[high_indices[i]]);
-				C_n_high_vect.push_back(_capacities_vect[high_indices[i]]);
-			}
+			C_n_low_vect.push_back(_cycles_vect[low_indices[i]]);
+			C_n_low_vect.push_back(_capacities_vect[low_indices[i]]);
 		}
-		n_rows_lo = C_n_low_vect.size() / n_cols;
-		n_rows_hi = C_n_high_vect.size() / n_cols;
-
-		if (n_rows_lo == 0 || n_rows_hi == 0)
+	}
+	if (n_rows_hi != 0)
+	{
+		for (int i = 0; i < (int)n_rows_hi; i++)
 		{
-			// need a safeguard here
+			C_n_high_vect.push_back(_cycles_vect[high_indices[i]]);
+			C_n_high_vect.push_back(_capacities_vect[high_indices[i]]);
 		}
+	}
+	n_rows_lo = C_n_low_vect.size() / n_cols;
+	n_rows_hi = C_n_high_vect.size() / n_cols;
 
-		util::matrix_t<double> C_n_low(n_rows_lo, n_cols, &C_n_low_vect);
-		util::matrix_t<double> C_n_high(n_rows_lo, n_cols, &C_n_high_vect);
+	if (n_rows_lo == 0 || n_rows_hi == 0)
+	{
+		// need a safeguard here
+	}
 
-		// Compute C(D_lo, n), C(D_hi, n)
-		double C_Dlo = util::linterp_col(C_n_low, 0, cycle_number, 1);
-		double C_Dhi = util::linterp_col(C_n_high, 0, cycle_number, 1);
+	dod_bracket bracket;
+	bracket.D_lo = D_lo;
+	bracket.D_hi = D_hi;
+	bracket.C_n_low = util::matrix_t<double>(n_rows_lo, n_cols, &C_n_low_vect);
+	bracket.C_n_high = util::matrix_t<double>(n_rows_lo, n_cols, &C_n_high_vect);
+	return bracket;
+}
 
-		if (C_Dlo < 0.)
-			C_Dlo = 0.;
-		if (C_Dhi > 100.)
-			C_Dhi = 100.;
+double lifetime_cycle_t::bilinear(double DOD, int cycle_number)
+{
+	/*
+	Interpolate first along the C = f(n) curves for the DOD levels bracketing DOD to get C_DOD_, C_DOD_+ 
+	Then interpolate C_, C+ to get C at the DOD of interest
+	*/
 
-		// Interpolate to get C(D, n)
-		C = util::interpolate(D_lo, C_Dlo, D_hi, C_Dhi, DOD);
-	}
 	// just have one row, single level interpolation
-	else
-	{
-		C = util::linterp_col(_batt_lifetime_matrix, 1, cycle_number, 2);
-	}
+	if (_brackets.empty())
+		return util::linterp_col(_batt_lifetime_matrix, 1, cycle_number, 2);
+
+	size_t k = std::lower_bound(_DOD_levels.begin(), _DOD_levels.end(), DOD) - _DOD_levels.begin();
+	const dod_bracket &bracket = _brackets[k];
+
+	// Compute C(D_lo, n), C(D_hi, n)
+	double C_Dlo = util::linterp_col(bracket.C_n_low, 0, cycle_number, 1);
+	double C_Dhi = util::linterp_col(bracket.C_n_high, 0, cycle_number, 1);
 
-	return C;
+	if (C_Dlo < 0.)
+		C_Dlo = 0.;
+	if (C_Dhi > 100.)
+		C_Dhi = 100.;
+
+	// Interpolate to get C(D, n)
+	return util::interpolate(bracket.D_lo, C_Dlo, bracket.D_hi, C_Dhi, DOD);
 }
 
 /*
@@ -1194,8 +1298,13 @@ lifetime_calendar_t * lifetime_calendar_t::clone(){ return new lifetime_calendar
 void lifetime_calendar_t::copy(lifetime_calendar_t * lifetime_calendar)
 {
 	_calendar_choice = lifetime_calendar->_calendar_choice;
-	_calendar_days = lifetime_calendar->_calendar_days;
-	_calendar_capacity = lifetime_calendar->_calendar_capacity;
+
+	// the tables don't change after construction, so only copy them into a model built with different ones
+	if (_calendar_days != lifetime_calendar->_calendar_days || _calendar_capacity != lifetime_calendar->_calendar_capacity)
+	{
+		_calendar_days = lifetime_calendar->_calendar_days;
+		_calendar_capacity = lifetime_calendar->_calendar_capacity;
+	}
 	_day_age_of_battery = lifetime_calendar->_day_age_of_battery;
 	_dt_hour = lifetime_calendar->_dt_hour;
 	_dt_day = lifetime_calendar->_dt_day;
@@ -1208,6 +1317,22 @@ void lifetime_calendar_t::copy(lifetime_calendar_t * lifetime_calendar)
 	_b = lifetime_calendar->_b;
 	_c = lifetime_calendar->_c;
 }
+void lifetime_calendar_t::save_state(battery_state::lifetime_state &state)
+{
+	state.calendar_day_age_of_battery = _day_age_of_battery;
+	state.calendar_last_idx = _last_idx;
+	state.calendar_q = _q;
+	state.calendar_dq_old = _dq_old;
+	state.calendar_dq_new = _dq_new;
+}
+void lifetime_calendar_t::restore_state(const battery_state::lifetime_state &state)
+{
+	_day_age_of_battery = state.calendar_day_age_of_battery;
+	_last_idx = state.calendar_last_idx;
+	_q = state.calendar_q;
+	_dq_old = state.calendar_dq_old;
+	_dq_new = state.calendar_dq_new;
+}
 double lifetime_calendar_t::runLifetimeCalendarModel(size_t idx, double T, double SOC)
 {
 	if (_calendar_choice != lifetime_calendar_t::NONE)
@@ -1335,6 +1460,18 @@ void thermal_t::copy(thermal_t * thermal)
 	_capacity_percent = thermal->_capacity_percent;
 	_T_max = thermal->_T_max;
 }
+void thermal_t::save_state(battery_state::thermal_state &state)
+{
+	state.R = _R;
+	state.T_battery = _T_battery;
+	state.capacity_percent = _capacity_percent;
+}
+void thermal_t::restore_state(const battery_state::thermal_state &state)
+{
+	_R = state.R;
+	_T_battery = state.T_battery;
+	_capacity_percent = state.capacity_percent;
+}
 void thermal_t::replace_battery()
 { 
 	_T_battery = _T_room; 
@@ -1431,6 +1568,8 @@ void losses_t::copy(losses_t * losses)
 	_idle_loss = losses->_idle_loss;
 	_full_loss = losses->_full_loss;*/
 }
+void losses_t::save_state(battery_state &state){ state.losses_nCycle = _nCycle; }
+void losses_t::restore_state(const battery_state &state){ _nCycle = state.losses_nCycle; }
 
 void losses_t::replace_battery(){ _nCycle = 0; }
 void losses_t::run_losses(double dt_hour, size_t idx)
@@ -1496,12 +1635,11 @@ battery_t::~battery_t()
 }
 
 // copy from battery to this
+// _capacity_initial and _thermal_initial are not copied, they are only used within run() and are set at its start
 void battery_t::copy(const battery_t * battery)
 {
 	_capacity->copy(battery->capacity_model());
-	_capacity_initial->copy(battery->capacity_initial_model());
 	_thermal->copy(battery->thermal_model());
-	_thermal_initial->copy(battery->thermal_initial_model());
 	_lifetime->copy(battery->lifetime_model());
 	_voltage->copy(battery->voltage_model());
 	_losses->copy(battery->losses_model());
@@ -1512,6 +1650,27 @@ void battery_t::copy(const battery_t * battery)
 	_last_idx = battery->_last_idx;
 }
 
+// save the state of this battery, the dispatch restores it between iterations.
+// _capacity_initial and _thermal_initial are not saved, they are only used within run() and are set at its start
+void battery_t::save_state(battery_state &state)
+{
+	_capacity->save_state(state.capacity);
+	_thermal->save_state(state.thermal);
+	_lifetime->save_state(state.lifetime);
+	_voltage->save_state(state.voltage);
+	_losses->save_state(state);
+	state.last_idx = _last_idx;
+}
+void battery_t::restore_state(const battery_state &state)
+{
+	_capacity->restore_state(state.capacity);
+	_thermal->restore_state(state.thermal);
+	_lifetime->restore_state(state.lifetime);
+	_voltage->restore_state(state.voltage);
+	_losses->restore_state(state);
+	_last_idx = state.last_idx;
+}
+
 void battery_t::delete_clone()
 {
 	if (_capacity) delete _capacity;
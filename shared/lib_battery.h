@@ -84,6 +84,80 @@ protected:
 	std::vector<int> count;
 };
 
+/*
+Snapshot of the mutable state of a battery and its models, without the tables that are fixed at construction.
+The dispatch saves the battery into one before iterating on the current and restores it for each retry.
+All members are plain values except the rainflow peaks, which keep their allocation between saves.
+*/
+struct battery_state
+{
+	struct capacity_state
+	{
+		double q0;
+		double qmax;
+		double qmax_thermal;
+		double qmax0;
+		double I;
+		double I_loss;
+		double SOC;
+		double DOD;
+		double DOD_prev;
+		double dt_hour;
+		bool chargeChange;
+		int prev_charge;
+		int charge;
+
+		// capacity_kibam_t
+		double q1;
+		double q2;
+		double q1_0;
+		double q2_0;
+	} capacity;
+
+	struct voltage_state
+	{
+		double cell_voltage;
+
+		// voltage_vanadium_redox_t
+		double I;
+	} voltage;
+
+	struct lifetime_state
+	{
+		int replacements;
+		bool replacement_scheduled;
+		double q;
+
+		// lifetime_cycle_t
+		int cycle_nCycles;
+		double cycle_q;
+		double cycle_Dlt;
+		int cycle_jlt;
+		double cycle_Xlt;
+		double cycle_Ylt;
+		std::vector<double> cycle_Peaks;
+		double cycle_Range;
+		double cycle_average_range;
+
+		// lifetime_calendar_t
+		int calendar_day_age_of_battery;
+		size_t calendar_last_idx;
+		double calendar_q;
+		double calendar_dq_old;
+		double calendar_dq_new;
+	} lifetime;
+
+	struct thermal_state
+	{
+		double R;
+		double T_battery;
+		double capacity_percent;
+	} thermal;
+
+	int losses_nCycle;
+	size_t last_idx;
+};
+
 /*
 Base class from which capacity models derive
 Note, all capacity models are based on the capacity of one battery
@@ -102,6 +176,10 @@ public:
 	// shallow copy from capacity to this
 	virtual void copy(capacity_t *);
 
+	// save and restore the mutable state
+	virtual void save_state(battery_state::capacity_state &state);
+	virtual void restore_state(const battery_state::capacity_state &state);
+
 	// virtual destructor
 	virtual ~capacity_t(){};
 	
@@ -170,6 +248,10 @@ public:
 	// copy from capacity to this
 	void copy(capacity_t *);
 
+	// save and restore the mutable state
+	void save_state(battery_state::capacity_state &state);
+	void restore_state(const battery_state::capacity_state &state);
+
 	void updateCapacity(double &I, double dt);
 	void updateCapacityForThermal(double capacity_percent);
 	void updateCapacityForLifetime(double capacity_percent);
@@ -254,6 +336,10 @@ public:
 	// copy from voltage to this
 	virtual void copy(voltage_t *);
 
+	// save and restore the mutable state
+	virtual void save_state(battery_state::voltage_state &state);
+	virtual void restore_state(const battery_state::voltage_state &state);
+
 
 	virtual ~voltage_t(){};
 
@@ -364,6 +450,10 @@ public:
 	// copy from voltage to this
 	void copy(voltage_t *);
 
+	// save and restore the mutable state
+	void save_state(battery_state::voltage_state &state);
+	void restore_state(const battery_state::voltage_state &state);
+
 	void updateVoltage(capacity_t * capacity, thermal_t * thermal, double dt);
 
 protected:
@@ -398,6 +488,10 @@ public:
 	// copy from lifetime_cycle to this
 	void copy(lifetime_cycle_t *);
 
+	// save and restore the mutable state
+	void save_state(battery_state::lifetime_state &state);
+	void restore_state(const battery_state::lifetime_state &state);
+
 	// return q, the effective capacity percent
 	double runCycleLifetime(double DOD);
 
@@ -416,12 +510,24 @@ protected:
 	int rainflow_compareRanges();
 	double bilinear(double DOD, int cycle_number);
 
+	// capacity vs cycles at the DOD levels bracketing a DOD, see bilinear()
+	struct dod_bracket
+	{
+		double D_lo;
+		double D_hi;
+		util::matrix_t<double> C_n_low;
+		util::matrix_t<double> C_n_high;
+	};
+	void init_brackets();
+	dod_bracket make_bracket(double DOD);
+
 	util::matrix_t<double> _cycles_vs_DOD;
 	util::matrix_t<double> _batt_lifetime_matrix;
 	std::vector<double> _DOD_vect;
 	std::vector<double> _cycles_vect;
 	std::vector<double> _capacities_vect;
-
+	std::vector<double> _DOD_levels;		// sorted unique DOD values in the lifetime matrix
+	std::vector<dod_bracket> _brackets;		// _brackets[k] applies to DOD in (_DOD_levels[k-1], _DOD_levels[k]], empty if there is one level
 
 	int _nCycles;
 	double _q;				// relative capacity %
@@ -456,6 +562,10 @@ public:
 	// copy from lifetime_calendar to this
 	void copy(lifetime_calendar_t *);
 
+	// save and restore the mutable state
+	void save_state(battery_state::lifetime_state &state);
+	void restore_state(const battery_state::lifetime_state &state);
+
 	/// Given the index of the simulation, the tempertature and SOC, return the effective capacity percent
 	double runLifetimeCalendarModel(size_t idx, double T, double SOC);
 
@@ -512,6 +622,10 @@ public:
 	// copy lifetime to this
 	void copy(lifetime_t *);
 
+	// save and restore the mutable state, including the cycle and calendar models
+	void save_state(battery_state::lifetime_state &state);
+	void restore_state(const battery_state::lifetime_state &state);
+
 	void runLifetimeModels(size_t idx, capacity_t *, double T_battery);
 
 	double capacity_percent();
@@ -558,6 +672,10 @@ public:
 	// copy thermal to this
 	void copy(thermal_t *);
 
+	// save and restore the mutable state
+	void save_state(battery_state::thermal_state &state);
+	void restore_state(const battery_state::thermal_state &state);
+
 	void updateTemperature(double I, double R, double dt);
 	void replace_battery();
 
@@ -605,6 +723,10 @@ public:
 	// copy losses to this
 	void copy(losses_t *);
 
+	// save and restore the mutable state
+	void save_state(battery_state &state);
+	void restore_state(const battery_state &state);
+
 	// main APIs
 	void run_losses(double dt_hour, size_t index);
 	void replace_battery();
@@ -642,6 +764,10 @@ public:
 	// copy members from battery to this
 	void copy(const battery_t * battery);
 
+	// save the state of this battery and its models, and restore it, without copying the models' tables
+	void save_state(battery_state &state);
+	void restore_state(const battery_state &state);
+
 	// virtual destructor, does nothing as no memory allocated in constructor
 	virtual ~battery_t();
 
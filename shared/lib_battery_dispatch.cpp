@@ -50,6 +50,8 @@
 #include <algorithm>
 #include <numeric>
 
+#include "lp_lib.h"
+
 /*
 Dispatch base class
 */
@@ -68,9 +70,8 @@ dispatch_t::dispatch_t(battery_t * Battery, double dt_hour, double SOC_min, doub
 	m_batteryPower->powerBatteryDischargeMax = Pd_max;
 	m_batteryPower->meterPosition = battMeterPosition;
 
-	// initalize Battery and a copy of the Battery for iteration
+	// initalize Battery, its state is saved for iteration
 	_Battery = Battery;
-	_Battery_initial = new battery_t(*_Battery);
 
 	// Call the dispatch init method
 	init(_Battery, dt_hour, current_choice, t_min, mode);
@@ -114,7 +115,7 @@ dispatch_t::dispatch_t(const dispatch_t& dispatch)
 	m_batteryPower = m_batteryPowerFlow->getBatteryPower();
 
 	_Battery = new battery_t(*dispatch._Battery);
-	_Battery_initial = new battery_t(*dispatch._Battery_initial);
+	_Battery_initial = dispatch._Battery_initial;
 	init(_Battery, dispatch._dt_hour, dispatch._current_choice, dispatch._t_min, dispatch._mode);
 }
 
@@ -122,7 +123,7 @@ dispatch_t::dispatch_t(const dispatch_t& dispatch)
 void dispatch_t::copy(const dispatch_t * dispatch)
 {
 	_Battery->copy(dispatch->_Battery);
-	_Battery_initial->copy(dispatch->_Battery_initial);
+	_Battery_initial = dispatch->_Battery_initial;
 	init(_Battery, dispatch->_dt_hour,  dispatch->_current_choice, dispatch->_t_min, dispatch->_mode);
 
 	// can't create shallow copy of unique ptr
@@ -132,15 +133,12 @@ void dispatch_t::copy(const dispatch_t * dispatch)
 }
 void dispatch_t::delete_clone()
 {
-	// need to delete both, since allocated memory for both in deep copy 
+	// allocated memory for the battery in deep copy 
 	if (_Battery) delete _Battery;
-	if (_Battery_initial) delete _Battery_initial;
 }
 dispatch_t::~dispatch_t()
 {
 	// original _Battery doesn't need deleted, since was a pointer passed in
-	_Battery_initial->delete_clone();
-	delete _Battery_initial;
 }
 bool dispatch_t::check_constraints(double &I, int count)
 {
@@ -193,7 +191,7 @@ bool dispatch_t::check_constraints(double &I, int count)
 	// reset
 	if (iterate)
 	{
-		_Battery->copy(_Battery_initial);
+		_Battery->restore_state(_Battery_initial);
 		m_batteryPower->powerBattery = 0;
 		m_batteryPower->powerGridToBattery = 0;
 		m_batteryPower->powerBatteryToGrid = 0;
@@ -324,7 +322,7 @@ void dispatch_t::runDispatch(size_t year, size_t hour_of_year, size_t step)
 	double I = current_controller(_Battery->battery_voltage_nominal());
 
 	// Setup battery iteration
-	_Battery_initial->copy(_Battery);
+	_Battery->save_state(_Battery_initial);
 	bool iterate = true;
 	int count = 0;
 	size_t idx = util::index_year_hour_step(year, hour_of_year, step, static_cast<size_t>(1 / _dt_hour));
@@ -522,7 +520,7 @@ bool dispatch_manual_t::check_constraints(double &I, int count)
 		// reset
 		if (iterate)
 		{
-			_Battery->copy(_Battery_initial);
+			_Battery->restore_state(_Battery_initial);
 			m_batteryPower->powerBattery = 0;
 			m_batteryPower->powerGridToBattery = 0;
 			m_batteryPower->powerBatteryToGrid = 0;
@@ -755,7 +753,7 @@ bool dispatch_automatic_t::check_constraints(double &I, int count)
 		// reset
 		if (iterate)
 		{
-			_Battery->copy(_Battery_initial);
+			_Battery->restore_state(_Battery_initial);
 			m_batteryPower->powerBattery = 0;
 			m_batteryPower->powerGridToBattery = 0;
 			m_batteryPower->powerBatteryToGrid = 0;
@@ -1177,10 +1175,17 @@ dispatch_automatic_front_of_meter_t::dispatch_automatic_front_of_meter_t(
 	if (battCycleCostChoice == dispatch_t::INPUT_CYCLE_COST) {
 		m_cycleCost = battCycleCost;
 	}
+
+	// built on first use
+	m_lp = NULL;
 	
 	setup_cost_vector(ppa_weekday_schedule, ppa_weekend_schedule);
 }
-dispatch_automatic_front_of_meter_t::~dispatch_automatic_front_of_meter_t(){ /* NOTHING TO DO */}
+dispatch_automatic_front_of_meter_t::~dispatch_automatic_front_of_meter_t()
+{
+	if (m_lp)
+		delete_lp(m_lp);
+}
 void dispatch_automatic_front_of_meter_t::init_with_pointer(const dispatch_automatic_front_of_meter_t* tmp)
 {
 	_look_ahead_hours = tmp->_look_ahead_hours;
@@ -1225,6 +1230,9 @@ dispatch_automatic_t(dispatch)
 {
 	const dispatch_automatic_front_of_meter_t * tmp = dynamic_cast<const dispatch_automatic_front_of_meter_t *>(&dispatch);
 	init_with_pointer(tmp);
+
+	// the copy builds its own linear program if it needs one
+	m_lp = NULL;
 }
 
 // shallow copy from dispatch to this
@@ -1258,7 +1266,22 @@ void dispatch_automatic_front_of_meter_t::update_dispatch(size_t hour_of_year, s
 	m_batteryPower->powerBattery = 0;
 	m_batteryPower->powerBatteryTarget = 0;
 
-	if (_mode != dispatch_t::FOM_CUSTOM_DISPATCH)
+	if (_mode == dispatch_t::FOM_OPTIMIZED)
+	{
+		if (idx == _index_last_updated + _d_index_update || idx == 0)
+		{
+			if (idx > 0) {
+				_index_last_updated += _d_index_update;
+			}
+			optimize_dispatch(hour_of_year, idx);
+		}
+
+		// follow the plan until the next update
+		size_t i = idx - _index_last_updated;
+		if (i < _P_battery_use.size())
+			m_batteryPower->powerBatteryTarget = _P_battery_use[i];
+	}
+	else if (_mode != dispatch_t::FOM_CUSTOM_DISPATCH)
 	{
 
 		// Power to charge (<0) or discharge (>0)
@@ -1367,6 +1390,160 @@ void dispatch_automatic_front_of_meter_t::update_dispatch(size_t hour_of_year, s
 	m_batteryPower->powerBattery = m_batteryPower->powerBatteryTarget;
 }
 
+void dispatch_automatic_front_of_meter_t::optimize_dispatch(size_t hour_of_year, size_t idx)
+{
+	/*
+	Linear program over the look-ahead horizon, maximizing revenue net of cycling cost.  Each step t has the columns
+		c_pv	PV power drawn to charge that could otherwise be sold [kW]
+		c_clip	PV power drawn to charge that would be clipped [kW]
+		c_grid	grid power drawn to charge [kW]
+		d		power delivered by discharging [kW]
+		e		energy stored at the end of the step, relative to now [kWh]
+	and the rows
+		e(t) - e(t-1) - dt*(eta_pv*(c_pv + c_clip) + eta_grid*c_grid - d/eta_d) = 0		energy balance
+		eta_pv*(c_pv + c_clip) + eta_grid*c_grid <= charge power limit
+		d - c_pv <= inverter limit - unclipped PV				AC capacity left for discharge
+	The conversion efficiencies relate the power drawn or delivered to the power into or out of the battery.
+	Prices, PV, power limits and the stored energy window change every solve; the structure does not, so the program
+	is built once and each solve is warm-started from the basis of the previous one.
+	*/
+	const int nc = 5;
+	enum { C_PV, C_CLIP, C_GRID, D, E };
+	size_t nt = std::max((size_t)1, _look_ahead_hours * _steps_per_hour);
+	int ncol = (int)(nc * nt);
+
+	if (!m_lp)
+	{
+		m_lp = make_lp(0, ncol);
+		set_add_rowmode(m_lp, TRUE);
+
+		REAL row[6];
+		int col[6];
+		for (size_t t = 0; t != nt; t++)
+		{
+			int c0 = (int)(nc * t) + 1;
+			int i = 0;
+			col[i] = c0 + E; row[i++] = 1.;
+			if (t > 0) {
+				col[i] = c0 + E - nc; row[i++] = -1.;
+			}
+			col[i] = c0 + C_PV; row[i++] = -_dt_hour * m_etaPVCharge;
+			col[i] = c0 + C_CLIP; row[i++] = -_dt_hour * m_etaPVCharge;
+			col[i] = c0 + C_GRID; row[i++] = -_dt_hour * m_etaGridCharge;
+			col[i] = c0 + D; row[i++] = _dt_hour / m_etaDischarge;
+			add_constraintex(m_lp, i, row, col, EQ, 0.);
+
+			col[0] = c0 + C_PV; row[0] = m_etaPVCharge;
+			col[1] = c0 + C_CLIP; row[1] = m_etaPVCharge;
+			col[2] = c0 + C_GRID; row[2] = m_etaGridCharge;
+			add_constraintex(m_lp, 3, row, col, LE, 0.);
+
+			col[0] = c0 + D; row[0] = 1.;
+			col[1] = c0 + C_PV; row[1] = -1.;
+			add_constraintex(m_lp, 2, row, col, LE, 0.);
+		}
+		set_add_rowmode(m_lp, FALSE);
+		set_maxim(m_lp);
+		set_verbose(m_lp, NEUTRAL);
+	}
+
+	/*! Cost to cycle the battery at all, using maximum DOD or user input */
+	costToCycle();
+
+	// Power limits at the current battery voltage
+	double voltage = _Battery->battery_voltage();
+	double powerChargeMax = 1e10;
+	double powerDischargeMax = 1e10;
+	if (_current_choice == RESTRICT_POWER || _current_choice == RESTRICT_BOTH)
+	{
+		powerChargeMax = m_batteryPower->powerBatteryChargeMax;
+		powerDischargeMax = m_batteryPower->powerBatteryDischargeMax;
+	}
+	if (_current_choice == RESTRICT_CURRENT || _current_choice == RESTRICT_BOTH)
+	{
+		powerChargeMax = std::fmin(powerChargeMax, fabs(m_batteryPower->currentChargeMax) * voltage * util::watt_to_kilowatt);
+		powerDischargeMax = std::fmin(powerDischargeMax, fabs(m_batteryPower->currentDischargeMax) * voltage * util::watt_to_kilowatt);
+	}
+
+	// Energy that can be stored or released before reaching the state of charge limits [kWh]
+	double energyPerPercent = voltage * _Battery->battery_charge_maximum() * util::watt_to_kilowatt * 0.01;
+	double energyToFill = std::fmax(0, _Battery->battery_energy_to_fill(m_batteryPower->stateOfChargeMax));
+	double energyToEmpty = 0;
+	if (_Battery->battery_soc() >= m_batteryPower->stateOfChargeMin + 1.0) {
+		energyToEmpty = (_Battery->battery_soc() - m_batteryPower->stateOfChargeMin) * energyPerPercent;
+	}
+
+	std::vector<REAL> objective(ncol + 1, 0.);
+	for (size_t t = 0; t != nt; t++)
+	{
+		int c0 = (int)(nc * t) + 1;
+		size_t hour = hour_of_year + t / _steps_per_hour;
+
+		double ppa_cost = _ppa_cost_vector[hour];
+		double usage_cost = ppa_cost;
+		if (m_utilityRateCalculator) {
+			usage_cost = m_utilityRateCalculator->getEnergyRate(hour % 8760);
+		}
+
+		// current step is known, later steps come from the forecast
+		double powerPV = m_batteryPower->powerPV;
+		double powerPVClipped = m_batteryPower->powerPVClipped;
+		if (t > 0)
+		{
+			powerPV = idx + t < _P_pv_dc.size() ? _P_pv_dc[idx + t] : 0;
+			powerPVClipped = idx + t < _P_cliploss_dc.size() ? _P_cliploss_dc[idx + t] : 0;
+		}
+		double powerPVUnclipped = std::fmax(0, powerPV - powerPVClipped);
+
+		// among plans of equal value, prefer the one that charges and discharges earliest.  The battery may not accept
+		// all of the planned charge, and a deferred plan leaves no time to make up for it
+		double preferEarly = 1e-5 * t;
+
+		// cycling cost is per kWh out of the battery
+		objective[c0 + C_PV] = (-ppa_cost - preferEarly) * _dt_hour;
+		objective[c0 + C_CLIP] = -preferEarly * _dt_hour;
+		objective[c0 + C_GRID] = (-usage_cost - preferEarly) * _dt_hour;
+		objective[c0 + D] = (ppa_cost - m_cycleCost / m_etaDischarge - preferEarly) * _dt_hour;
+
+		set_upbo(m_lp, c0 + C_PV, m_batteryPower->canPVCharge ? powerPVUnclipped : 0.);
+		set_upbo(m_lp, c0 + C_CLIP, m_batteryPower->canClipCharge ? std::fmax(0, powerPVClipped) : 0.);
+		set_upbo(m_lp, c0 + C_GRID, m_batteryPower->canGridCharge ? powerChargeMax / m_etaGridCharge : 0.);
+		set_upbo(m_lp, c0 + D, powerDischargeMax * m_etaDischarge);
+		set_bounds(m_lp, c0 + E, -energyToEmpty, energyToFill);
+
+		int r0 = (int)(3 * t) + 1;
+		set_rh(m_lp, r0 + 1, powerChargeMax);
+		set_rh(m_lp, r0 + 2, std::fmax(0, _inverter_paco - powerPVUnclipped));
+	}
+	set_obj_fn(m_lp, &objective[0]);
+
+	// warm start, include the nonbasic variables so that those at their upper bounds stay there
+	if (m_lpBasis.size() == (size_t)(1 + get_Nrows(m_lp) + ncol))
+		set_basis(m_lp, &m_lpBasis[0], TRUE);
+
+	int ret = solve(m_lp);
+
+	_P_battery_use.assign(nt, 0.);
+	if (ret == OPTIMAL || ret == SUBOPTIMAL)
+	{
+		REAL *vars;
+		get_ptr_variables(m_lp, &vars);
+		for (size_t t = 0; t != nt; t++)
+		{
+			const REAL *x = vars + nc * t;
+			_P_battery_use[t] = x[D] / m_etaDischarge - (m_etaPVCharge * (x[C_PV] + x[C_CLIP]) + m_etaGridCharge * x[C_GRID]);
+		}
+		m_lpBasis.resize(1 + get_Nrows(m_lp) + ncol);
+		get_basis(m_lp, &m_lpBasis[0], TRUE);
+	}
+	else
+	{
+		// leave the battery idle until the next update and don't start from this basis again
+		m_lpBasis.clear();
+		default_basis(m_lp);
+	}
+}
+
 void dispatch_automatic_front_of_meter_t::update_cliploss_data(double_vec P_cliploss)
 {
 	_P_cliploss_dc = P_cliploss;
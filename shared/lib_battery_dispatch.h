@@ -58,6 +58,8 @@
 
 
 
+struct _lprec; // lp_solve model, see lp_lib.h
+
 /*
 Dispatch Base Class - can envision many potential modifications. Goal is to define standard API
 */
@@ -65,7 +67,7 @@ class dispatch_t
 {
 public:
 
-	enum FOM_MODES { FOM_LOOK_AHEAD, FOM_LOOK_BEHIND, FOM_FORECAST, FOM_CUSTOM_DISPATCH, FOM_MANUAL };
+	enum FOM_MODES { FOM_LOOK_AHEAD, FOM_LOOK_BEHIND, FOM_FORECAST, FOM_CUSTOM_DISPATCH, FOM_MANUAL, FOM_OPTIMIZED };
 	enum BTM_MODES { LOOK_AHEAD, LOOK_BEHIND, MAINTAIN_TARGET, CUSTOM_DISPATCH, MANUAL };
 	enum METERING { BEHIND, FRONT };
 	enum PV_PRIORITY { MEET_LOAD, CHARGE_BATTERY };
@@ -166,7 +168,7 @@ protected:
 	bool restrict_power(double &I);
 
 	battery_t * _Battery;
-	battery_t * _Battery_initial;
+	battery_state _Battery_initial;	// state of _Battery at the start of the step, restored before each iteration
 
 	double _dt_hour;
 
@@ -532,6 +534,10 @@ public:
 	 2. Charging from the grid during times of low electricity buy-rates (if grid charging allowed)
 	 3. Charging from the PV array during times of low PPA sell rates
 	 4. Charging from the PV array during times where the PV power would be clipped due to inverter limits (if DC-connected)
+
+	 In FOM_OPTIMIZED mode the same objectives are met by solving the look-ahead horizon as a linear program with lp_solve
+	 instead of the rules above.  The program is built on the first solve, and each re-optimization starts from
+	 the basis of the previous one.
 	*/
 	dispatch_automatic_front_of_meter_t(
 		battery_t * Battery,
@@ -588,6 +594,9 @@ public:
 	/// Update cliploss data
 	void update_cliploss_data(double_vec P_cliploss);
 
+	/*! Solve for the battery power over the look-ahead horizon (FOM_OPTIMIZED) */
+	void optimize_dispatch(size_t hour_of_year, size_t idx);
+
 	/*! Calculate the cost to cycle */
 	void costToCycle();
 
@@ -623,6 +632,10 @@ protected:
 	double m_etaPVCharge;
 	double m_etaGridCharge;
 	double m_etaDischarge;
+
+	/*! Horizon linear program for FOM_OPTIMIZED and the basis of its last solution, kept for warm starts */
+	_lprec * m_lp;
+	std::vector<int> m_lpBasis;
 };
 
 /*! Battery metrics class */
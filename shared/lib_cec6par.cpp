@@ -151,6 +151,7 @@ cec6par_module_t::cec6par_module_t( )
 {
 	Area = Vmp = Imp = Voc = Isc = alpha_isc = beta_voc 
 		= a = Il = Io = Rs = Rsh = Adj = std::numeric_limits<double>::quiet_NaN();
+	SolverMode = SINGLEDIODE_LAMBERTW;
 }
 double air_mass_modifier( double Zenith_deg, double Elev_m, double a[5] )
 {
@@ -214,20 +215,24 @@ bool cec6par_module_t::operator() ( pvinput_t &input, double TcellC, double opvo
 		double A_oper = a * T_cell / Tc_ref;
 		double Rsh_oper = Rsh*(I_ref/Geff_total);
 			
-		double V_oc = openvoltage_5par( Voc, A_oper, IL_oper, IO_oper, Rsh_oper );
+		bool iterative = ( SolverMode == SINGLEDIODE_ITERATIVE );
+		double V_oc = iterative ? openvoltage_5par( Voc, A_oper, IL_oper, IO_oper, Rsh_oper )
+			: openvoltage_5par_lambertw( A_oper, IL_oper, IO_oper, Rsh_oper );
 		double I_sc = IL_oper/(1+Rs/Rsh_oper);
 		
 		double P, V, I;
 		
 		if ( opvoltage < 0 )
 		{
-			P = maxpower_5par( V_oc, A_oper, IL_oper, IO_oper, Rs, Rsh_oper, &V, &I );			
+			if ( iterative ) P = maxpower_5par( V_oc, A_oper, IL_oper, IO_oper, Rs, Rsh_oper, &V, &I );
+			else P = maxpower_5par_lambertw( A_oper, IL_oper, IO_oper, Rs, Rsh_oper, &V, &I );
 		}
 		else
 		{ // calculate power at specified operating voltage
 			V = opvoltage;
 			if (V >= V_oc) I = 0;
-			else I = current_5par( V, 0.9*IL_oper, A_oper, IL_oper, IO_oper, Rs, Rsh_oper );
+			else if ( iterative ) I = current_5par( V, 0.9*IL_oper, A_oper, IL_oper, IO_oper, Rs, Rsh_oper );
+			else I = current_5par_lambertw( V, A_oper, IL_oper, IO_oper, Rs, Rsh_oper );
 
 			P = V*I;
 		}
@@ -76,6 +76,7 @@ public:
 	double Rs;
 	double Rsh;
 	double Adj;
+	int SolverMode; // SINGLEDIODE_LAMBERTW (default) or SINGLEDIODE_ITERATIVE
 
 	cec6par_module_t();
 
@@ -94,6 +94,8 @@ public:
 	bool GlassAR;
 	double AMA[5];
 
+	int SolverMode; // SINGLEDIODE_LAMBERTW (default) or SINGLEDIODE_ITERATIVE
+
 	Imessage_api *_imsg;
 
 
@@ -1274,6 +1274,418 @@ int irrad::calc()
 
 }
 
+size_t solarpos_table::bytes() const
+{
+	return sizeof(solarpos_table) + size() * ( 4*sizeof(int) + 10*sizeof(double) );
+}
+
+// tables for a 1-minute year are about 50 MB
+static solarpos_cache g_solarpos_cache( 64*1024*1024 );
+
+solarpos_cache &solarpos_cache::instance()
+{
+	return g_solarpos_cache;
+}
+
+solarpos_cache::solarpos_cache( size_t capacity_bytes )
+	: m_capacity( capacity_bytes ), m_bytes( 0 )
+{
+}
+
+std::shared_ptr<const solarpos_table> solarpos_cache::find( double lat, double lon, double tz,
+	const std::vector<int> &year, const std::vector<int> &month, const std::vector<int> &day,
+	const std::vector<int> &hour, const std::vector<double> &minute )
+{
+	// caller holds m_mutex
+	for ( std::list< std::shared_ptr<const solarpos_table> >::iterator it = m_tables.begin(); it != m_tables.end(); ++it )
+	{
+		const solarpos_table &t = **it;
+		if ( t.lat != lat || t.lon != lon || t.tz != tz || t.size() != year.size()
+			|| t.year != year || t.month != month || t.day != day || t.hour != hour || t.minute != minute )
+			continue;
+
+		m_tables.splice( m_tables.begin(), m_tables, it );
+		return m_tables.front();
+	}
+	return std::shared_ptr<const solarpos_table>();
+}
+
+std::shared_ptr<const solarpos_table> solarpos_cache::get( double lat, double lon, double tz,
+	const std::vector<int> &year, const std::vector<int> &month, const std::vector<int> &day,
+	const std::vector<int> &hour, const std::vector<double> &minute )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		std::shared_ptr<const solarpos_table> t = find( lat, lon, tz, year, month, day, hour, minute );
+		if ( t ) return t;
+	}
+
+	// calculate outside of the lock so that other sites are not held up
+	std::shared_ptr<solarpos_table> t( new solarpos_table );
+	size_t n = year.size();
+	t->lat = lat;
+	t->lon = lon;
+	t->tz = tz;
+	t->year = year;
+	t->month = month;
+	t->day = day;
+	t->hour = hour;
+	t->minute = minute;
+	for ( int k=0;k<9;k++ )
+		t->sun[k].resize( n );
+
+	double sunn[9];
+	for ( size_t i=0;i<n;i++ )
+	{
+		solarpos( year[i], month[i], day[i], hour[i], minute[i], lat, lon, tz, sunn );
+		for ( int k=0;k<9;k++ )
+			t->sun[k][i] = sunn[k];
+	}
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	// another thread may have added the same table in the meantime
+	std::shared_ptr<const solarpos_table> existing = find( lat, lon, tz, year, month, day, hour, minute );
+	if ( existing ) return existing;
+
+	if ( t->bytes() <= m_capacity )
+	{
+		m_tables.push_front( t );
+		m_bytes += t->bytes();
+		while ( m_bytes > m_capacity )
+		{
+			m_bytes -= m_tables.back()->bytes();
+			m_tables.pop_back();
+		}
+	}
+	return t;
+}
+
+void solarpos_cache::set_capacity( size_t bytes )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_capacity = bytes;
+	while ( m_bytes > m_capacity )
+	{
+		m_bytes -= m_tables.back()->bytes();
+		m_tables.pop_back();
+	}
+}
+
+size_t solarpos_cache::capacity()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_capacity;
+}
+
+size_t solarpos_cache::bytes()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_bytes;
+}
+
+size_t solarpos_cache::count()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_tables.size();
+}
+
+void solarpos_cache::clear()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_tables.clear();
+	m_bytes = 0;
+}
+
+void irrad_timeseries::resize( size_t n )
+{
+	year.resize( n );
+	month.resize( n );
+	day.resize( n );
+	hour.resize( n );
+	minute.resize( n );
+	gh.resize( n );
+	dn.resize( n );
+	df.resize( n );
+	alb.resize( n );
+}
+
+irrad_batch::irrad_batch()
+{
+	lat=lon=tz = -999;
+	delt = IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET;
+	radmode=skymodel=track = -1;
+	tilt=sazm=rlim = -999;
+	gcr = std::numeric_limits<double>::quiet_NaN();
+	en_backtrack = false;
+}
+
+void irrad_batch::set_location( double lat, double lon, double tz )
+{
+	this->lat = lat;
+	this->lon = lon;
+	this->tz = tz;
+}
+
+void irrad_batch::set_sky_model( int skymodel )
+{
+	this->skymodel = skymodel;
+}
+
+void irrad_batch::set_surface( int tracking, double tilt_deg, double azimuth_deg, double rotlim_deg, bool en_backtrack, double gcr )
+{
+	this->track = tracking;
+	this->tilt = tilt_deg;
+	this->sazm = azimuth_deg;
+	this->rlim = rotlim_deg;
+	this->en_backtrack = en_backtrack;
+	this->gcr = gcr;
+}
+
+void irrad_batch::set_radmode( int radmode )
+{
+	this->radmode = radmode;
+}
+
+void irrad_batch::set_time_step( double delt_hr )
+{
+	this->delt = delt_hr;
+}
+
+int irrad_batch::check()
+{
+	// same codes as irrad::check for the values that are constant over the period
+	if ( delt > 1 ) return -1;
+	if ( lat < -90 || lat > 90 || lon < -180 || lon > 180 || tz < -15 || tz > 15 ) return -2;
+	if ( radmode < DN_DF || radmode > GH_DF || skymodel < 0 || skymodel > 2 ) return -3;
+	if ( track < 0 || track > 4 ) return -4;
+	if ( tilt < 0 || tilt > 90 ) return -8;
+	if ( sazm < 0 || sazm >= 360 ) return -9;
+	if ( rlim < -90 || rlim > 90 ) return -10;
+	return 0;
+}
+
+int irrad_batch::calc( const irrad_timeseries &ts )
+{
+	int code = check();
+	if ( code < 0 )
+		return -100+code;
+
+	size_t n = ts.size();
+	bool tilt_series = ( track == 4 && ts.tilt.size() == n );
+	int mode = ( track == 4 ) ? 0 : track; // timeseries tilt is treated as fixed tilt, as in irrad::set_surface
+
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	status.assign( n, 0 );
+	sunup.assign( n, 0 );
+	solazi.assign( n, nan );
+	solzen.assign( n, nan );
+	solalt.assign( n, nan );
+	sunpos_hour.assign( n, nan );
+	aoi.assign( n, nan );
+	stilt.assign( n, nan );
+	sazi.assign( n, nan );
+	rot.assign( n, nan );
+	btd.assign( n, nan );
+	poa_beam.assign( n, nan );
+	poa_skydiff.assign( n, nan );
+	poa_gnddiff.assign( n, nan );
+
+	// per step input checks, same codes as irrad::check
+	for ( size_t i=0;i<n;i++ )
+	{
+		int c = 0;
+		if ( ts.year[i] < 0 || ts.month[i] < 0 || ts.day[i] < 0 || ts.hour[i] < 0 || ts.minute[i] < 0 ) c = -1;
+		else if ( radmode == DN_DF && (ts.dn[i] < 0 || ts.dn[i] > 1500 || ts.df[i] < 0 || ts.df[i] > 1500)) c = -5;
+		else if ( radmode == DN_GH && (ts.gh[i] < 0 || ts.gh[i] > 1500 || ts.dn[i] < 0 || ts.dn[i] > 1500)) c = -6;
+		else if ( ts.alb[i] < 0 || ts.alb[i] > 1 ) c = -7;
+		else if ( tilt_series && (ts.tilt[i] < 0 || ts.tilt[i] > 90) ) c = -8;
+		else if ( radmode == GH_DF && (ts.gh[i] < 0 || ts.gh[i] > 1500 || ts.df[i] < 0 || ts.df[i] > 1500)) c = -11;
+		status[i] = ( c < 0 ) ? -100+c : 0;
+	}
+
+	// effective time for the sun position at each step.  sunrise and sunset are calculated once per day
+	std::vector<int> hr_calc( n, 0 );
+	std::vector<double> min_calc( n, 0.0 );
+	double sun[9];
+	double t_sunrise = 0, t_sunset = 0;
+	int cur_year = -1, cur_month = -1, cur_day = -1;
+	for ( size_t i=0;i<n;i++ )
+	{
+		if ( status[i] != 0 ) continue;
+
+		if ( ts.year[i] != cur_year || ts.month[i] != cur_month || ts.day[i] != cur_day )
+		{
+			cur_year = ts.year[i];
+			cur_month = ts.month[i];
+			cur_day = ts.day[i];
+			solarpos( cur_year, cur_month, cur_day, 12, 0.0, lat, lon, tz, sun );
+			t_sunrise = sun[4];
+			t_sunset = sun[5];
+		}
+
+		double t_cur = ts.hour[i] + ts.minute[i]/60.0;
+		if ( delt > 0
+			&& t_cur >= t_sunrise - delt/2.0
+			&& t_cur < t_sunrise + delt/2.0 )
+		{
+			double t_calc = (t_sunrise + (t_cur+delt/2.0))/2.0; // midpoint of sunrise and end of timestep
+			hr_calc[i] = (int)t_calc;
+			min_calc[i] = (t_calc-hr_calc[i])*60.0;
+			sunup[i] = 2;
+		}
+		else if ( delt > 0
+			&& t_cur > t_sunset - delt/2.0
+			&& t_cur <= t_sunset + delt/2.0 )
+		{
+			double t_calc = ( (t_cur-delt/2.0) + t_sunset )/2.0; // midpoint of beginning of timestep and sunset
+			hr_calc[i] = (int)t_calc;
+			min_calc[i] = (t_calc-hr_calc[i])*60.0;
+			sunup[i] = 3;
+		}
+		else if ( t_cur >= t_sunrise && t_cur <= t_sunset )
+		{
+			hr_calc[i] = ts.hour[i];
+			min_calc[i] = ts.minute[i];
+			sunup[i] = 1;
+		}
+		else
+			sunup[i] = 0;
+	}
+
+	// sun position at the effective times of the steps when the sun is up, shared through the cache
+	// with other surfaces and runs at the same site
+	std::vector<int> sp_year, sp_month, sp_day, sp_hour;
+	std::vector<double> sp_minute;
+	for ( size_t i=0;i<n;i++ )
+	{
+		if ( status[i] != 0 || sunup[i] <= 0 ) continue;
+		sp_year.push_back( ts.year[i] );
+		sp_month.push_back( ts.month[i] );
+		sp_day.push_back( ts.day[i] );
+		sp_hour.push_back( hr_calc[i] );
+		sp_minute.push_back( min_calc[i] );
+	}
+	std::shared_ptr<const solarpos_table> sp = solarpos_cache::instance().get( lat, lon, tz,
+		sp_year, sp_month, sp_day, sp_hour, sp_minute );
+
+	std::vector<double> azm( n, 0.0 ), zen( n, 0.0 ), hextra( n, 0.0 );
+	size_t isp = 0;
+	for ( size_t i=0;i<n;i++ )
+	{
+		if ( status[i] != 0 ) continue;
+
+		if ( sunup[i] > 0 )
+		{
+			azm[i] = sp->sun[0][isp];
+			zen[i] = sp->sun[1][isp];
+			hextra[i] = sp->sun[8][isp];
+			solazi[i] = sp->sun[0][isp] * (180/M_PI);
+			solzen[i] = sp->sun[1][isp] * (180/M_PI);
+			solalt[i] = sp->sun[2][isp] * (180/M_PI);
+			sunpos_hour[i] = ((double)hr_calc[i]) + ((double)((int)min_calc[i]))/60.0;
+			isp++;
+		}
+		else
+		{
+			solazi[i] = solzen[i] = solalt[i] = (-999*DTOR) * (180/M_PI);
+			sunpos_hour[i] = 0;
+		}
+		aoi[i] = stilt[i] = sazi[i] = rot[i] = btd[i] = 0;
+		poa_beam[i] = poa_skydiff[i] = poa_gnddiff[i] = 0;
+	}
+
+	// incidence angles onto the fixed or tracking surface
+	std::vector<double> inc( n, 0.0 ), surf_tilt( n, 0.0 );
+	for ( size_t i=0;i<n;i++ )
+	{
+		if ( status[i] != 0 || sunup[i] <= 0 ) continue;
+
+		double angle[5];
+		incidence( mode, tilt_series ? ts.tilt[i] : tilt, sazm, rlim, zen[i], azm[i], en_backtrack, gcr, angle );
+		inc[i] = angle[0];
+		surf_tilt[i] = angle[1];
+		aoi[i] = angle[0] * (180/M_PI);
+		stilt[i] = angle[1] * (180/M_PI);
+		sazi[i] = angle[2] * (180/M_PI);
+		rot[i] = angle[3] * (180/M_PI);
+		btd[i] = angle[4] * (180/M_PI);
+	}
+
+	// beam and diffuse inputs (DNI and DHI, not in the plane of array) from the irradiance input mode
+	std::vector<double> ibeam( n, 0.0 ), idiff( n, 0.0 );
+	for ( size_t i=0;i<n;i++ )
+	{
+		if ( status[i] != 0 || sunup[i] <= 0 ) continue;
+
+		// irrad::set_global_diffuse leaves the beam input unset (-999), so it never exceeds the extraterrestrial value
+		double hbeam = ( radmode == GH_DF ? -999 : ts.dn[i] )*cos( zen[i] );
+		if ( hbeam > hextra[i] )
+		{
+			//beam irradiance on horizontal W/m2 exceeded calculated extraterrestrial irradiance
+			status[i] = -1;
+			continue;
+		}
+
+		if ( radmode == DN_DF )
+		{
+			idiff[i] = ts.df[i];
+			ibeam[i] = ts.dn[i];
+		}
+		else if ( radmode == DN_GH )
+		{
+			idiff[i] = ts.gh[i] - hbeam;
+			if ( idiff[i] < 0 ) idiff[i] = 0;
+			ibeam[i] = ts.dn[i];
+		}
+		else
+		{
+			idiff[i] = ts.df[i];
+			ibeam[i] = (ts.gh[i] - ts.df[i]) / cos( zen[i] );
+			if ( ibeam[i] > 1500 ) ibeam[i] = 1500;
+			if ( ibeam[i] < 0 ) ibeam[i] = 0;
+		}
+	}
+
+	// incident irradiance on the tilted surface, one loop per sky model
+	double poa[3], diffc[3];
+	switch( skymodel )
+	{
+	case 0:
+		for ( size_t i=0;i<n;i++ )
+		{
+			if ( status[i] != 0 || sunup[i] <= 0 ) continue;
+			isotropic( hextra[i], ibeam[i], idiff[i], ts.alb[i], inc[i], surf_tilt[i], zen[i], poa, diffc );
+			poa_beam[i] = poa[0];
+			poa_skydiff[i] = poa[1];
+			poa_gnddiff[i] = poa[2];
+		}
+		break;
+	case 1:
+		for ( size_t i=0;i<n;i++ )
+		{
+			if ( status[i] != 0 || sunup[i] <= 0 ) continue;
+			hdkr( hextra[i], ibeam[i], idiff[i], ts.alb[i], inc[i], surf_tilt[i], zen[i], poa, diffc );
+			poa_beam[i] = poa[0];
+			poa_skydiff[i] = poa[1];
+			poa_gnddiff[i] = poa[2];
+		}
+		break;
+	default:
+		for ( size_t i=0;i<n;i++ )
+		{
+			if ( status[i] != 0 || sunup[i] <= 0 ) continue;
+			perez( hextra[i], ibeam[i], idiff[i], ts.alb[i], inc[i], surf_tilt[i], zen[i], poa, diffc );
+			poa_beam[i] = poa[0];
+			poa_skydiff[i] = poa[1];
+			poa_gnddiff[i] = poa[2];
+		}
+		break;
+	}
+
+	return 0;
+}
+
 static double cosd( double x ) { return cos( DTOR*x ); }
 static double sind( double x ) { return sin( DTOR*x ); }
 //static double tand( double x ) { return tan( DTOR*x ); }
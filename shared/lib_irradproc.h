@@ -50,6 +50,11 @@
 #ifndef __irradproc_h
 #define __irradproc_h
 
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+
 /* aug2011 - apd
 	solar position and radiation processing split out from pvwatts.
 	added isotropic sky model and hdkr model for diffuse on a tilted surface
@@ -148,6 +153,101 @@ public:
 	double get_sunpos_calc_hour();
 };
 
+// solarpos results for a list of local standard time stamps at one location.  sun[k][i] is
+// sunn[k] from solarpos for time stamp i; the time stamps and location are the cache key
+struct solarpos_table
+{
+	double lat, lon, tz;
+	std::vector<int> year, month, day, hour;
+	std::vector<double> minute;
+	std::vector<double> sun[9];
+
+	size_t size() const { return year.size(); }
+	size_t bytes() const;
+};
+
+/* solarpos_cache: process-wide cache of solarpos_tables so that everything simulating the same
+	site and time grid (pv subarrays, parametric and batch runs, the CSP weather reader) calculates
+	the sun position once.  Tables are shared read-only, safe to use from several threads, and the
+	least recently used tables are released when the memory held exceeds the capacity.  irrad::calc
+	works one time step at a time with no time grid to key on, so only irrad_batch uses the cache. */
+class solarpos_cache
+{
+private:
+	std::list< std::shared_ptr<const solarpos_table> > m_tables; // most recently used first
+	size_t m_capacity, m_bytes;
+	std::mutex m_mutex;
+
+	std::shared_ptr<const solarpos_table> find( double lat, double lon, double tz,
+		const std::vector<int> &year, const std::vector<int> &month, const std::vector<int> &day,
+		const std::vector<int> &hour, const std::vector<double> &minute );
+
+public:
+	solarpos_cache( size_t capacity_bytes );
+
+	static solarpos_cache &instance();
+
+	// returns the sun position at each time stamp, calculated if not already cached
+	std::shared_ptr<const solarpos_table> get( double lat, double lon, double tz,
+		const std::vector<int> &year, const std::vector<int> &month, const std::vector<int> &day,
+		const std::vector<int> &hour, const std::vector<double> &minute );
+
+	void set_capacity( size_t bytes ); // 0 disables caching
+	size_t capacity();
+	size_t bytes();
+	size_t count();
+	void clear();
+};
+
+// time and irradiance columns for a whole simulation period, one entry per time step
+struct irrad_timeseries
+{
+	std::vector<int> year, month, day, hour;
+	std::vector<double> minute;
+	std::vector<double> gh, dn, df; // W/m2, which two are used depends on the radiation mode
+	std::vector<double> alb;
+	std::vector<double> tilt; // optional surface tilt per step in degrees, for timeseries tilt (tracking mode 4)
+
+	void resize( size_t n );
+	size_t size() const { return year.size(); }
+};
+
+/* irrad_batch: whole-period counterpart to irrad for one location, sky model and surface.
+	Each stage of the calculation (sunrise/sunset, sun position, incidence, beam/diffuse
+	conversion, sky model) runs as its own loop over struct-of-arrays columns, and sunrise and
+	sunset are only evaluated once per day instead of at every step.  Sun positions are taken from
+	solarpos_cache, so surfaces at the same site share them.  Results are the same as
+	calling irrad::calc at each step, and are reported in the units of the irrad getters.
+	POA decomposition (POA_R, POA_P) is not supported. */
+class irrad_batch
+{
+private:
+	double lat, lon, tz, delt;
+	int radmode, skymodel, track;
+	double tilt, sazm, rlim, gcr;
+	bool en_backtrack;
+
+	int check();
+
+public:
+	irrad_batch();
+
+	// same conventions as the corresponding irrad setters
+	void set_location( double lat, double lon, double tz );
+	void set_sky_model( int skymodel );
+	void set_surface( int tracking, double tilt_deg, double azimuth_deg, double rotlim_deg, bool en_backtrack, double gcr );
+	void set_radmode( int radmode ); // DN_DF, DN_GH or GH_DF
+	void set_time_step( double delt_hr ); // IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET for instantaneous data
+
+	// returns 0, or a negative code if the configuration is invalid.  the irrad::calc return code for each step is in 'status'
+	int calc( const irrad_timeseries &ts );
+
+	std::vector<int> status, sunup;
+	std::vector<double> solazi, solzen, solalt, sunpos_hour; // deg, deg, deg, hr
+	std::vector<double> aoi, stilt, sazi, rot, btd; // deg
+	std::vector<double> poa_beam, poa_skydiff, poa_gnddiff; // W/m2
+};
+
 
 
 
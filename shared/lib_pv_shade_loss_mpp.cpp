@@ -52,8 +52,12 @@
 #include <algorithm>    // std::sort
 #include <math.h> // logarithm function
 #include <cstring> // memcpy
+#include <cstdio>
+#include <mutex>
+#include <map>
 
 #include "lib_miniz.h" // decompression
+#include "lib_util.h" // mapped_file
 #include "DB8_vmpp_impp_uint8_bin.h" // char* of binary compressed file
 
 // define the following to use ssc message formatting 
@@ -65,9 +69,76 @@ typedef unsigned char uint8;
 typedef unsigned short uint16;
 typedef unsigned int uint;
 
+static const size_t DB8_UINT8_SIZE = 12091680; // size of each of vmpp and impp in uint8, from matlab
+static const size_t DB8_COMPRESSED_SIZE = 3133517; // from modified example5.c in miniz project
+
+// vmpp followed by impp, either inflated into 'inflated' or mapped from a pre-decoded file
+struct ShadeDB8_data
+{
+	std::vector<uint8> inflated;
+	util::mapped_file mapped;
+	const uint8 *p;
+
+	ShadeDB8_data() : p(0) {}
+};
+
+// decoded databases by the decoded file they were loaded with, "" for the built-in one
+static std::map< std::string, std::shared_ptr<const ShadeDB8_data> > g_db8_data;
+static std::mutex g_db8_mutex;
+
+static std::shared_ptr<const ShadeDB8_data> load_db8_data( const std::string &decoded_file, std::string &error )
+{
+	std::shared_ptr<ShadeDB8_data> data( new ShadeDB8_data() );
+	size_t mem_size = 2 * DB8_UINT8_SIZE;
+
+	if ( !decoded_file.empty() && data->mapped.open( decoded_file ) )
+	{
+		if ( data->mapped.size() == mem_size )
+		{
+			data->p = data->mapped.data();
+			return data;
+		}
+		data->mapped.close();
+		error = "shading database file " + decoded_file + " has the wrong size, using the built-in database";
+	}
+
+	data->inflated.resize( mem_size );
+	size_t status = tinfl_decompress_mem_to_mem( (void *)&data->inflated[0], mem_size, pCmp_data, DB8_COMPRESSED_SIZE, TINFL_FLAG_PARSE_ZLIB_HEADER );
+	if ( status == TINFL_DECOMPRESS_MEM_TO_MEM_FAILED )
+	{
+		std::stringstream outm;
+		outm << "tinfl_decompress_mem_to_mem() failed with status " << (int)status;
+		error = outm.str();
+		return std::shared_ptr<const ShadeDB8_data>();
+	}
+	data->p = &data->inflated[0];
+
+	if ( !decoded_file.empty() && error.empty() && !util::file_exists( decoded_file.c_str() ) )
+	{
+		// write to a temporary name first so that other processes never map a partial file
+		std::string tmp = decoded_file + ".tmp";
+		FILE *fp = fopen( tmp.c_str(), "wb" );
+		if ( fp )
+		{
+			bool ok = fwrite( data->p, 1, mem_size, fp ) == mem_size;
+			ok = ( fclose( fp ) == 0 ) && ok;
+			if ( !ok || rename( tmp.c_str(), decoded_file.c_str() ) != 0 )
+				remove( tmp.c_str() );
+		}
+	}
+
+	return data;
+}
+
+void ShadeDB8_mpp::release_shared_data()
+{
+	std::lock_guard<std::mutex> lock( g_db8_mutex );
+	g_db8_data.clear();
+}
+
 short ShadeDB8_mpp::get_vmpp(size_t i)
 {
-	if (i < 6045840) // uint16 check
+	if (i < 6045840 && p_vmpp) // uint16 check
 		return (short)((p_vmpp[2 * i + 1] << 8) | p_vmpp[2 * i]); 
 	else 
 		return -1;
@@ -75,7 +146,7 @@ short ShadeDB8_mpp::get_vmpp(size_t i)
 
 short ShadeDB8_mpp::get_impp(size_t i)
 { 
-	if (i < 6045840) // uint16 check
+	if (i < 6045840 && p_impp) // uint16 check
 		return (short)((p_impp[2 * i + 1] << 8) | p_impp[2 * i]); 
 	else 
 		return -1; 
@@ -184,55 +255,33 @@ std::vector<double> ShadeDB8_mpp::get_vector(const size_t &N, const size_t &d, c
 	return ret_vec;
 }
 
-void ShadeDB8_mpp::init()
+void ShadeDB8_mpp::init( const std::string &decoded_file )
 {
 	p_error_msg = "";
 	p_warning_msg = "";
-	p_vmpp_uint8_size = 12091680; // uint8 size from matlab
-	p_impp_uint8_size = 12091680; // uint8 size from matlab
-	p_vmpp = (unsigned char *)malloc(p_vmpp_uint8_size);//malloc(12091680); uint8 size
-	p_impp = (unsigned char *)malloc(p_impp_uint8_size);//malloc(12091680); uint8 size
-	p_compressed_size = 3133517; // from modified example5.c in miniz project
-	decompress_file_to_uint8();
+
+	{
+		std::lock_guard<std::mutex> lock( g_db8_mutex );
+		std::shared_ptr<const ShadeDB8_data> &shared = g_db8_data[decoded_file];
+		if ( !shared )
+		{
+			std::string error;
+			shared = load_db8_data( decoded_file, error );
+			if ( shared ) p_warning_msg = error;
+			else p_error_msg = error;
+		}
+		p_data = shared;
+	}
+
+	p_vmpp = p_data ? p_data->p : NULL;
+	p_impp = p_data ? p_data->p + DB8_UINT8_SIZE : NULL;
 }
 
 ShadeDB8_mpp::~ShadeDB8_mpp()
 {
-	if (p_vmpp)
-		free(p_vmpp);
-	if (p_impp)
-		free(p_impp);
+	// the decoded database is released with the last reference to it
 }
 
-
-
-bool ShadeDB8_mpp::decompress_file_to_uint8()
-{
-	size_t status;
-	uint8 *pTmp_data;
-
-	size_t mem_size = p_vmpp_uint8_size + p_impp_uint8_size;
-
-	pTmp_data = (uint8 *)malloc(mem_size);
-
-	status = tinfl_decompress_mem_to_mem((void *)pTmp_data, mem_size, pCmp_data, p_compressed_size, TINFL_FLAG_PARSE_ZLIB_HEADER);
-
-	memcpy(p_vmpp, pTmp_data, p_vmpp_uint8_size);
-	memcpy(p_impp, pTmp_data + p_vmpp_uint8_size, p_impp_uint8_size);
-
-	free(pTmp_data);
-
-	if (status == TINFL_DECOMPRESS_MEM_TO_MEM_FAILED)
-	{
-		std::stringstream outm;
-		outm << "tinfl_decompress_mem_to_mem() failed with status " << (int)status;
-		p_error_msg = outm.str();
-		return EXIT_FAILURE;
-	}
-
-	return true;
-};
-
 double ShadeDB8_mpp::get_shade_loss(double &gpoa, double &dpoa, std::vector<double> &shade_frac, bool use_pv_cell_temp, double pv_cell_temp, int mods_per_str, double str_vmp_stc, double mppt_lo, double mppt_hi)
 {
 	double shade_loss = 0;
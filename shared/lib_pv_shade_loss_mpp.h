@@ -56,8 +56,12 @@
 #include <vector>
 #include <stdlib.h>
 #include <string>
+#include <memory>
 
 extern const unsigned char pCmp_data[3133517];
+
+struct ShadeDB8_data; // decoded vmpp and impp tables
+
 // shading database with up to 8 strings
 class ShadeDB8_mpp
 {
@@ -68,7 +72,16 @@ public:
 		p_impp=NULL ;
 	};
 	~ShadeDB8_mpp();
-	void init();
+
+	/* the decoded database is shared read-only by all instances, threads and runs in the process that
+	   use the same 'decoded_file'.  it is inflated from pCmp_data on first use, or memory mapped from
+	   'decoded_file' when given.  if 'decoded_file' does not exist, it is written after inflating so
+	   that later processes can map it */
+	void init( const std::string &decoded_file = "" );
+
+	// drops the process-wide references to the decoded databases.  instances that are already
+	// initialized keep it alive until they are destroyed
+	static void release_shared_data();
 	short vmpp(size_t ndx){
 		return get_vmpp(ndx);
 	};
@@ -85,14 +98,11 @@ public:
 
 
 private:
-	unsigned char *p_vmpp;
-	unsigned char *p_impp;
+	std::shared_ptr<const ShadeDB8_data> p_data;
+	const unsigned char *p_vmpp;
+	const unsigned char *p_impp;
 	short get_vmpp(size_t i);
 	short get_impp(size_t i);
-	bool decompress_file_to_uint8();
-	size_t p_vmpp_uint8_size;
-	size_t p_impp_uint8_size;
-	size_t p_compressed_size;
 	std::string p_warning_msg;
 	std::string p_error_msg;
 };
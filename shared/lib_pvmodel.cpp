@@ -398,6 +398,139 @@ double maxpower_5par( double Voc_ubound, double a, double Il, double Io, double
 	return P;
 }
 
+/******** LAMBERT W SINGLE DIODE SOLUTIONS *********/
+
+/*
+	Explicit solutions of the single diode equation
+
+		I = IL - IO*(exp((V+I*RS)/A)-1) - (V+I*RS)/RSH
+
+	in terms of the Lambert W function (Jain and Kapoor, Solar Energy Materials & Solar Cells 81, 2004).
+	The arguments of W grow like exp(V/A), so W is evaluated from the logarithm of its argument.
+*/
+
+static const int LAMBERTW_MAXITER = 4;
+
+// principal branch of W(exp(L)), i.e. the solution w of w + ln(w) = L
+static double lambertw_exp( double L )
+{
+	if ( L < -40.0 )
+		return exp(L); // W(x) = x - x^2 + ..., exact in double precision here
+
+	double w;
+	if ( L > 1.0 )
+	{
+		// asymptotic expansion for large arguments
+		double lnL = log(L);
+		w = L - lnL + lnL/L;
+	}
+	else
+	{
+		// Winitzki's approximation, good to a few percent for x < e
+		double lnx = log(1.0 + exp(L));
+		w = lnx * (1.0 - log(1.0 + lnx)/(2.0 + lnx));
+	}
+
+	// Fritsch, Shafer and Crowley iteration: converges to machine precision in one or two steps
+	for ( int i=0;i<LAMBERTW_MAXITER;i++ )
+	{
+		double z = L - w - log(w);
+		double q = 2.0*(1.0+w)*(1.0+w+2.0/3.0*z);
+		double e = z/(1.0+w)*(q-z)/(q-2.0*z);
+		w *= 1.0 + e;
+		if ( fabs(e) < 1e-15 ) break;
+	}
+	return w;
+}
+
+// current and, optionally, its first and second derivatives with respect to voltage
+static double current_lambertw( double V, double a, double Il, double Io, double Rs, double Rsh, double *dIdV, double *d2IdV2 )
+{
+	if ( Rs <= 0.0 )
+	{
+		double e = Io*exp(V/a);
+		if ( dIdV ) *dIdV = -e/a - 1.0/Rsh;
+		if ( d2IdV2 ) *d2IdV2 = -e/(a*a);
+		return Il - (e - Io) - V/Rsh;
+	}
+
+	double Rt = Rs + Rsh;
+	double L = log( Rs*Rsh*Io/(a*Rt) ) + Rsh*(Rs*(Il+Io) + V)/(a*Rt);
+	double W = lambertw_exp( L );
+	double f = W/(1.0+W); // derivative of W with respect to L
+	if ( dIdV ) *dIdV = -1.0/Rt - Rsh/(Rs*Rt)*f;
+	if ( d2IdV2 ) *d2IdV2 = -(Rsh/Rt)*(Rsh/Rt)/(Rs*a) * f/((1.0+W)*(1.0+W));
+	return (Rsh*(Il+Io) - V)/Rt - a/Rs*W;
+}
+
+double current_5par_lambertw( double V, double a, double Il, double Io, double Rs, double Rsh )
+{
+	double I = current_lambertw( V, a, Il, Io, Rs, Rsh, 0, 0 );
+	return I > 0.0 ? I : 0.0;
+}
+
+double openvoltage_5par_lambertw( double a, double Il, double Io, double Rsh )
+{
+	if ( Il <= 0.0 ) return 0.0;
+	double L = log( Io*Rsh/a ) + Rsh*(Il+Io)/a;
+	double Voc = Rsh*(Il+Io) - a*lambertw_exp( L );
+	return Voc > 0.0 ? Voc : 0.0;
+}
+
+double maxpower_5par_lambertw( double a, double Il, double Io, double Rs, double Rsh, double *__Vmp, double *__Imp, double *__Voc )
+{
+	double Voc = openvoltage_5par_lambertw( a, Il, Io, Rsh );
+	if ( __Voc ) *__Voc = Voc;
+
+	double V = 0, I = 0;
+	if ( Voc > 0 )
+	{
+		/* dP/dV = I + V*dI/dV decreases monotonically from I(0) > 0 to Voc*dI/dV(Voc) < 0, so the
+		maximum power point is found with Newton's method, safeguarded by bisection of the bracket */
+		double Vlo = 0, Vhi = Voc;
+
+		// initial guess from the explicit solution without series and shunt resistance
+		double w = lambertw_exp( 1.0 + log( (Il+Io)/Io ) );
+		V = a*(w - 1.0) - Rs*(Il+Io)*(1.0 - 1.0/w);
+		if ( !(V > 0 && V < Voc) ) V = 0.5*Voc;
+
+		const int maxiter = 40;
+		for ( int i=0;i<maxiter;i++ )
+		{
+			double dIdV, d2IdV2;
+			I = current_lambertw( V, a, Il, Io, Rs, Rsh, &dIdV, &d2IdV2 );
+			double g = I + V*dIdV;
+			if ( g > 0 ) Vlo = V;
+			else Vhi = V;
+
+			double Vnew = V - g/(2.0*dIdV + V*d2IdV2);
+			if ( !(Vnew > Vlo && Vnew < Vhi) )
+				Vnew = 0.5*(Vlo + Vhi);
+
+			if ( fabs(Vnew - V) < 1e-7*Voc )
+			{
+				I += dIdV*(Vnew - V); // error is second order in the last step
+				V = Vnew;
+				break;
+			}
+			V = Vnew;
+		}
+
+		if ( I < 0 ) I = 0;
+	}
+
+	if ( __Vmp ) *__Vmp = V;
+	if ( __Imp ) *__Imp = I;
+	return V*I;
+}
+
+void maxpower_5par_lambertw( size_t n, const double *a, const double *Il, const double *Io, const double *Rs, const double *Rsh,
+	double *Pmp, double *Vmp, double *Imp, double *Voc )
+{
+	for ( size_t i=0;i<n;i++ )
+		Pmp[i] = maxpower_5par_lambertw( a[i], Il[i], Io[i], Rs[i], Rsh[i], &Vmp[i], &Imp[i], Voc ? &Voc[i] : 0 );
+}
+
 double transmittance( double theta1_deg, /* incidence angle of incoming radiation (deg) */
 		double n_cover,  /* refractive index of cover material, n_glass = 1.586 */
 		double n_incoming, /* refractive index of incoming material, typically n_air = 1.0 */
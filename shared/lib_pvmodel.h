@@ -162,6 +162,16 @@ public:
 double current_5par( double V, double IMR, double A, double IL, double IO, double RS, double RSH );
 double openvoltage_5par( double Voc0, double a, double IL, double IO, double Rsh );
 double maxpower_5par( double Voc_ubound, double a, double Il, double Io, double Rs, double Rsh, double *Vmp=0, double *Imp=0 );
+
+// explicit Lambert W solutions of the single diode equation, with a fixed bound on the number of iterations.
+// the iterative functions above are kept as the reference solution for validation
+enum { SINGLEDIODE_LAMBERTW, SINGLEDIODE_ITERATIVE };
+double current_5par_lambertw( double V, double a, double Il, double Io, double Rs, double Rsh );
+double openvoltage_5par_lambertw( double a, double Il, double Io, double Rsh );
+double maxpower_5par_lambertw( double a, double Il, double Io, double Rs, double Rsh, double *Vmp=0, double *Imp=0, double *Voc=0 );
+// solves the maximum power point for n operating conditions at once.  Voc can be null
+void maxpower_5par_lambertw( size_t n, const double *a, const double *Il, const double *Io, const double *Rs, const double *Rsh,
+	double *Pmp, double *Vmp, double *Imp, double *Voc );
 double air_mass_modifier( double Zenith_deg, double Elev_m, double a[5] );
 double transmittance( double theta1_deg, /* incidence angle of incoming radiation (deg) */
 		double n_cover,  /* refractive index of cover material, n_glass = 1.586 */
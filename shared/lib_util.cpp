@@ -61,6 +61,8 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #endif
 
 #include "lib_util.h"
@@ -344,6 +346,84 @@ bool util::set_cwd( const std::string &path )
 #endif
 }
 
+util::mapped_file::mapped_file()
+	: m_data(0), m_size(0), m_handle(0)
+{
+}
+
+util::mapped_file::~mapped_file()
+{
+	close();
+}
+
+bool util::mapped_file::open( const std::string &file )
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE hfile = ::CreateFileA( file.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( hfile == INVALID_HANDLE_VALUE ) return false;
+
+	LARGE_INTEGER len;
+	if ( !::GetFileSizeEx( hfile, &len ) || len.QuadPart == 0 )
+	{
+		::CloseHandle( hfile );
+		return false;
+	}
+
+	// the mapping object keeps the file open, so the file handle can be released here
+	HANDLE hmap = ::CreateFileMappingA( hfile, NULL, PAGE_READONLY, 0, 0, NULL );
+	::CloseHandle( hfile );
+	if ( hmap == NULL ) return false;
+
+	void *p = ::MapViewOfFile( hmap, FILE_MAP_READ, 0, 0, 0 );
+	if ( p == NULL )
+	{
+		::CloseHandle( hmap );
+		return false;
+	}
+
+	m_handle = hmap;
+	m_size = (size_t)len.QuadPart;
+	m_data = (const unsigned char*)p;
+#else
+	int fd = ::open( file.c_str(), O_RDONLY );
+	if ( fd < 0 ) return false;
+
+	struct stat st;
+	if ( ::fstat( fd, &st ) != 0 || st.st_size <= 0 )
+	{
+		::close( fd );
+		return false;
+	}
+
+	void *p = ::mmap( 0, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+	::close( fd );
+	if ( p == MAP_FAILED ) return false;
+
+	m_size = (size_t)st.st_size;
+	m_data = (const unsigned char*)p;
+#endif
+
+	return true;
+}
+
+void util::mapped_file::close()
+{
+	if ( !m_data ) return;
+
+#ifdef _WIN32
+	::UnmapViewOfFile( (LPCVOID)m_data );
+	::CloseHandle( (HANDLE)m_handle );
+#else
+	::munmap( (void*)m_data, m_size );
+#endif
+
+	m_data = 0;
+	m_size = 0;
+	m_handle = 0;
+}
+
 std::string util::read_file( const std::string &file )
 {
 	std::string buf;
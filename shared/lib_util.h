@@ -53,6 +53,7 @@
 #include <cstdio>
 #include <string>
 #include <vector>
+#include <utility>
 #include <cassert>
 
 #include <unordered_map>
@@ -194,6 +195,27 @@ namespace util
 		FILE *p;
 	};
 
+	/* read-only memory mapping of an entire file.  the mapping
+	   is released by close() or when the object is destroyed */
+	class mapped_file
+	{
+	public:
+		mapped_file();
+		~mapped_file();
+		bool open( const std::string &file );
+		void close();
+		bool ok() const { return 0 != m_data; }
+		const unsigned char *data() const { return m_data; }
+		size_t size() const { return m_size; }
+	private:
+		mapped_file( const mapped_file & ); // not copyable
+		mapped_file &operator=( const mapped_file & );
+
+		const unsigned char *m_data;
+		size_t m_size;
+		void *m_handle;
+	};
+
 	template< typename T, size_t n_rows, size_t n_cols >
 	class matrix_static_t
 	{
@@ -279,6 +301,16 @@ namespace util
 			t_array = NULL;
 			copy( cc );
 		}
+
+		matrix_t( matrix_t &&rhs )
+		{
+			// take over the buffer, leaving 'rhs' empty (0x0, no storage)
+			t_array = rhs.t_array;
+			n_rows = rhs.n_rows;
+			n_cols = rhs.n_cols;
+			rhs.t_array = NULL;
+			rhs.n_rows = rhs.n_cols = 0;
+		}
 		
 		matrix_t(size_t len)
 		{
@@ -335,6 +367,14 @@ namespace util
 		{
 			if (this != &rhs)
 			{
+				if (!rhs.t_array)
+				{
+					// copying a moved-from matrix: become empty as well
+					if (t_array) delete [] t_array;
+					t_array = NULL;
+					n_rows = n_cols = 0;
+					return;
+				}
 				resize( rhs.nrows(), rhs.ncols() );
 				size_t nn = n_rows*n_cols;
 				for (size_t i=0;i<nn;i++)
@@ -342,6 +382,23 @@ namespace util
 			}
 		}
 
+		void swap( matrix_t &rhs )
+		{
+			std::swap( t_array, rhs.t_array );
+			std::swap( n_rows, rhs.n_rows );
+			std::swap( n_cols, rhs.n_cols );
+		}
+
+		// takes ownership of 'pvalues', which must have been allocated with new T[nr*nc]
+		void assign_owned( T *pvalues, size_t nr, size_t nc )
+		{
+			if ( !pvalues || nr < 1 || nc < 1 ) return;
+			if ( t_array && t_array != pvalues ) delete [] t_array;
+			t_array = pvalues;
+			n_rows = nr;
+			n_cols = nc;
+		}
+
 		void assign( const T *pvalues, size_t len )
 		{
 			resize( len );
@@ -368,6 +425,21 @@ namespace util
 
 			return *this;
 		}
+
+		matrix_t &operator=(matrix_t &&rhs)
+		{
+			if ( this != &rhs )
+			{
+				if (t_array) delete [] t_array;
+				t_array = rhs.t_array;
+				n_rows = rhs.n_rows;
+				n_cols = rhs.n_cols;
+				rhs.t_array = NULL;
+				rhs.n_rows = rhs.n_cols = 0;
+			}
+
+			return *this;
+		}
 		
 		matrix_t &operator=(const T &val)
 		{
@@ -398,6 +398,56 @@ void weather_record::reset()
 	tdry = twet = tdew = rhum = pres = snow = alb =  aod = std::numeric_limits<double>::quiet_NaN();
 }
 
+void weather_columns::reset( size_t nrec )
+{
+	m_nrec = nrec;
+	for ( size_t i = 0; i < weather_data_provider::_MAXCOL_; i++ )
+	{
+		std::vector<float>().swap( m_data[i] );
+		m_borrowed[i] = 0;
+		m_default[i] = std::numeric_limits<float>::quiet_NaN();
+	}
+
+	m_default[weather_data_provider::YEAR] = m_default[weather_data_provider::MONTH]
+		= m_default[weather_data_provider::DAY] = m_default[weather_data_provider::HOUR] = 0;
+}
+
+float *weather_columns::alloc( size_t id, float fill )
+{
+	m_borrowed[id] = 0;
+	m_data[id].assign( m_nrec, fill );
+	return data( id );
+}
+
+void weather_columns::borrow( size_t id, const float *values )
+{
+	std::vector<float>().swap( m_data[id] );
+	m_borrowed[id] = values;
+}
+
+void weather_columns::get( size_t i, weather_record *r ) const
+{
+	r->year = (int)value( weather_data_provider::YEAR, i );
+	r->month = (int)value( weather_data_provider::MONTH, i );
+	r->day = (int)value( weather_data_provider::DAY, i );
+	r->hour = (int)value( weather_data_provider::HOUR, i );
+	r->minute = value( weather_data_provider::MINUTE, i );
+	r->gh = value( weather_data_provider::GHI, i );
+	r->dn = value( weather_data_provider::DNI, i );
+	r->df = value( weather_data_provider::DHI, i );
+	r->poa = value( weather_data_provider::POA, i );
+	r->wspd = value( weather_data_provider::WSPD, i );
+	r->wdir = value( weather_data_provider::WDIR, i );
+	r->tdry = value( weather_data_provider::TDRY, i );
+	r->twet = value( weather_data_provider::TWET, i );
+	r->tdew = value( weather_data_provider::TDEW, i );
+	r->rhum = value( weather_data_provider::RH, i );
+	r->pres = value( weather_data_provider::PRES, i );
+	r->snow = value( weather_data_provider::SNOW, i );
+	r->alb = value( weather_data_provider::ALB, i );
+	r->aod = value( weather_data_provider::AOD, i );
+}
+
 
 
 #define NBUF 2048
@@ -435,6 +485,10 @@ void weatherfile::reset()
 	m_startYear = 1900;
 
 	m_hdr.reset();
+	m_map.reset();
+	m_columns.reset( 0 );
+	for (size_t i = 0; i < _MAXCOL_; i++)
+		m_colindex[i] = -1;
 	//m_rec.reset();
 }
 
@@ -457,6 +511,11 @@ bool weatherfile::open(const std::string &file, bool header_only)
 		return false;
 	}
 
+	m_file = file;
+
+	if (cmp_ext(file, "wfbin"))
+		return open_binary(file, header_only);
+
 	if (cmp_ext(file, "tm2") || cmp_ext(file, "tmy2"))
 		m_type = TMY2;
 	else if (cmp_ext(file, "tm3") || cmp_ext(file, "tmy3"))
@@ -825,11 +884,14 @@ bool weatherfile::open(const std::string &file, bool header_only)
 		return true;
 	}
 
-	// preallocate memory for data
+	// columns are allocated when a record is first written to them, so columns
+	// missing from the file read back as NaN without being stored
+	m_map.reset();
+	m_columns.reset(m_nRecords);
 	for (size_t i = 0; i<_MAXCOL_; i++)
 	{
-		m_columns[i].index = -1;
-		m_columns[i].data.resize(m_nRecords, std::numeric_limits<float>::quiet_NaN());
+		m_colindex[i] = -1;
+		m_columns.set_default(i, std::numeric_limits<float>::quiet_NaN());
 	}
 
 	if (m_type == WFCSV)
@@ -870,102 +932,102 @@ bool weatherfile::open(const std::string &file, bool header_only)
 			{
 			  	std::string lowname = util::lower_case(name);
 
-				if (lowname == "yr" || lowname == "year") m_columns[YEAR].index = i;
-				else if (lowname == "mo" || lowname == "month") m_columns[MONTH].index = i;
-				else if (lowname == "day") m_columns[DAY].index = i;
-				else if (lowname == "hour" || lowname == "hr") m_columns[HOUR].index = i;
-				else if (lowname == "min" || lowname == "minute") m_columns[MINUTE].index = i;
-				else if (lowname == "ghi" || lowname == "gh" || lowname == "global" || lowname == "global horizontal" || lowname == "global horizontal irradiance") m_columns[GHI].index = i;
-				else if (lowname == "dni" || lowname == "dn" || lowname == "beam" || lowname == "direct normal" || lowname == "direct normal irradiance" || lowname == "direct (beam) normal irradiance" ) m_columns[DNI].index = i;
-				else if (lowname == "dhi" || lowname == "df" || lowname == "diffuse" || lowname == "diffuse horizontal" || lowname == "diffuse horizontal irradiance") m_columns[DHI].index = i;
-				else if (lowname == "poa" || lowname == "pa" || lowname == "plane" || lowname == "plane of array" || lowname == "plane of array irradiance") m_columns[POA].index = i;
-				else if (lowname == "tdry" || lowname == "dry bulb" || lowname == "dry bulb temp" || lowname == "dry bulb temperature" || lowname == "temperature" || lowname == "ambient" || lowname == "ambient temp" || lowname == "tamb" ) m_columns[TDRY].index = i;
-				else if (lowname == "twet" || lowname == "wet bulb" || lowname == "wet bulb temperature") m_columns[TWET].index = i;
-				else if (lowname == "tdew" || lowname == "dew point" || lowname == "dew point temperature") m_columns[TDEW].index = i;
-				else if (lowname == "wspd" || lowname == "wind speed" || lowname == "windspeed" || lowname == "ws" || lowname == "windvel" ) m_columns[WSPD].index = i;
-				else if (lowname == "wdir" || lowname == "wind direction" || lowname == "wd" ) m_columns[WDIR].index = i;
-				else if (lowname == "rh" || lowname == "rhum" || lowname == "relative humidity" || lowname == "humidity") m_columns[RH].index = i;
-				else if (lowname == "pres" || lowname == "pressure" || lowname == "air pressure") m_columns[PRES].index = i;
-				else if (lowname == "snow" || lowname == "snow cover" || lowname == "snow depth") m_columns[SNOW].index = i;
-				else if (lowname == "alb" || lowname == "albedo") m_columns[ALB].index = i;
-				else if (lowname == "aod" || lowname == "aerosol" || lowname == "aerosol optical depth") m_columns[AOD].index = i;
+				if (lowname == "yr" || lowname == "year") m_colindex[YEAR] = i;
+				else if (lowname == "mo" || lowname == "month") m_colindex[MONTH] = i;
+				else if (lowname == "day") m_colindex[DAY] = i;
+				else if (lowname == "hour" || lowname == "hr") m_colindex[HOUR] = i;
+				else if (lowname == "min" || lowname == "minute") m_colindex[MINUTE] = i;
+				else if (lowname == "ghi" || lowname == "gh" || lowname == "global" || lowname == "global horizontal" || lowname == "global horizontal irradiance") m_colindex[GHI] = i;
+				else if (lowname == "dni" || lowname == "dn" || lowname == "beam" || lowname == "direct normal" || lowname == "direct normal irradiance" || lowname == "direct (beam) normal irradiance" ) m_colindex[DNI] = i;
+				else if (lowname == "dhi" || lowname == "df" || lowname == "diffuse" || lowname == "diffuse horizontal" || lowname == "diffuse horizontal irradiance") m_colindex[DHI] = i;
+				else if (lowname == "poa" || lowname == "pa" || lowname == "plane" || lowname == "plane of array" || lowname == "plane of array irradiance") m_colindex[POA] = i;
+				else if (lowname == "tdry" || lowname == "dry bulb" || lowname == "dry bulb temp" || lowname == "dry bulb temperature" || lowname == "temperature" || lowname == "ambient" || lowname == "ambient temp" || lowname == "tamb" ) m_colindex[TDRY] = i;
+				else if (lowname == "twet" || lowname == "wet bulb" || lowname == "wet bulb temperature") m_colindex[TWET] = i;
+				else if (lowname == "tdew" || lowname == "dew point" || lowname == "dew point temperature") m_colindex[TDEW] = i;
+				else if (lowname == "wspd" || lowname == "wind speed" || lowname == "windspeed" || lowname == "ws" || lowname == "windvel" ) m_colindex[WSPD] = i;
+				else if (lowname == "wdir" || lowname == "wind direction" || lowname == "wd" ) m_colindex[WDIR] = i;
+				else if (lowname == "rh" || lowname == "rhum" || lowname == "relative humidity" || lowname == "humidity") m_colindex[RH] = i;
+				else if (lowname == "pres" || lowname == "pressure" || lowname == "air pressure") m_colindex[PRES] = i;
+				else if (lowname == "snow" || lowname == "snow cover" || lowname == "snow depth") m_colindex[SNOW] = i;
+				else if (lowname == "alb" || lowname == "albedo") m_colindex[ALB] = i;
+				else if (lowname == "aod" || lowname == "aerosol" || lowname == "aerosol optical depth") m_colindex[AOD] = i;
 			}
 		}
 	}
 	else if ( m_type == TMY2 )
 	{
 		// indicate which columns are available in TMY2 files
-		m_columns[YEAR].index 
-			= m_columns[MONTH].index
-			= m_columns[DAY].index
-			= m_columns[HOUR].index
-			= m_columns[GHI].index
-			= m_columns[DNI].index
-			= m_columns[DHI].index
-			= m_columns[TDRY].index
-			= m_columns[TDEW].index
-			= m_columns[WSPD].index
-			= m_columns[WDIR].index
-			= m_columns[RH].index
-			= m_columns[PRES].index
-			= m_columns[SNOW].index
+		m_colindex[YEAR] 
+			= m_colindex[MONTH]
+			= m_colindex[DAY]
+			= m_colindex[HOUR]
+			= m_colindex[GHI]
+			= m_colindex[DNI]
+			= m_colindex[DHI]
+			= m_colindex[TDRY]
+			= m_colindex[TDEW]
+			= m_colindex[WSPD]
+			= m_colindex[WDIR]
+			= m_colindex[RH]
+			= m_colindex[PRES]
+			= m_colindex[SNOW]
 			= 1;
 	}
 	else if ( m_type == TMY3 )
 	{
 		// indicate which columns are available in TMY3 files
-		m_columns[YEAR].index 
-			= m_columns[MONTH].index
-			= m_columns[DAY].index
-			= m_columns[HOUR].index
-			= m_columns[GHI].index
-			= m_columns[DNI].index
-			= m_columns[DHI].index
-			= m_columns[TDRY].index
-			= m_columns[TDEW].index
-			= m_columns[WSPD].index
-			= m_columns[WDIR].index
-			= m_columns[RH].index
-			= m_columns[PRES].index
-			= m_columns[ALB].index
+		m_colindex[YEAR] 
+			= m_colindex[MONTH]
+			= m_colindex[DAY]
+			= m_colindex[HOUR]
+			= m_colindex[GHI]
+			= m_colindex[DNI]
+			= m_colindex[DHI]
+			= m_colindex[TDRY]
+			= m_colindex[TDEW]
+			= m_colindex[WSPD]
+			= m_colindex[WDIR]
+			= m_colindex[RH]
+			= m_colindex[PRES]
+			= m_colindex[ALB]
 			= 1;
 	}
 	else if ( m_type == EPW )
 	{
 		// indicate which columns are available in EPW files
-		m_columns[YEAR].index 
-			= m_columns[MONTH].index
-			= m_columns[DAY].index
-			= m_columns[HOUR].index
-			= m_columns[GHI].index
-			= m_columns[DNI].index
-			= m_columns[DHI].index
-			= m_columns[TDRY].index
-			= m_columns[TWET].index
-			= m_columns[WSPD].index
-			= m_columns[WDIR].index
-			= m_columns[RH].index
-			= m_columns[PRES].index
-			= m_columns[SNOW].index
+		m_colindex[YEAR] 
+			= m_colindex[MONTH]
+			= m_colindex[DAY]
+			= m_colindex[HOUR]
+			= m_colindex[GHI]
+			= m_colindex[DNI]
+			= m_colindex[DHI]
+			= m_colindex[TDRY]
+			= m_colindex[TWET]
+			= m_colindex[WSPD]
+			= m_colindex[WDIR]
+			= m_colindex[RH]
+			= m_colindex[PRES]
+			= m_colindex[SNOW]
 			= 1;
 	}
 	else if ( m_type == SMW )
 	{				
 		// indicate which columns are available in SMW files
-		m_columns[YEAR].index 
-			= m_columns[MONTH].index
-			= m_columns[DAY].index
-			= m_columns[HOUR].index
-			= m_columns[GHI].index
-			= m_columns[DNI].index
-			= m_columns[DHI].index
-			= m_columns[TDRY].index
-			= m_columns[TWET].index
-			= m_columns[WSPD].index
-			= m_columns[WDIR].index
-			= m_columns[RH].index
-			= m_columns[PRES].index
-			= m_columns[SNOW].index
+		m_colindex[YEAR] 
+			= m_colindex[MONTH]
+			= m_colindex[DAY]
+			= m_colindex[HOUR]
+			= m_colindex[GHI]
+			= m_colindex[DNI]
+			= m_colindex[DHI]
+			= m_colindex[TDRY]
+			= m_colindex[TWET]
+			= m_colindex[WSPD]
+			= m_colindex[WDIR]
+			= m_colindex[RH]
+			= m_colindex[PRES]
+			= m_colindex[SNOW]
 			= 1;
 	}
 
@@ -1030,29 +1092,29 @@ bool weatherfile::open(const std::string &file, bool header_only)
 					continue;
 				}
 
-				m_columns[YEAR].data[i] = (float)yr + 1900;
-				m_columns[MONTH].data[i] = (float)mn;
-				m_columns[DAY].data[i] = (float)dy;
-				m_columns[HOUR].data[i] = (float)hr - 1;  // hour goes 0-23, not 1-24
-				m_columns[MINUTE].data[i] = 30;
-				m_columns[GHI].data[i] = (float)(d1*1.0);
-				m_columns[DNI].data[i] = (float)d2;           /* Direct radiation */
-				m_columns[DHI].data[i] = (float)d3;           /* Diffuse radiation */
-				m_columns[POA].data[i] = (float)(-999);       /* No POA in TMY2 */
-				m_columns[TDRY].data[i] = (float)(d10 / 10.0);       /* Ambient dry bulb temperature(C) */
-				m_columns[TDEW].data[i] = (float)(d11 / 10.0); /* dew point temp */
-				m_columns[WSPD].data[i] = (float)(d15 / 10.0);       /* Wind speed(m/s) */
-				m_columns[WDIR].data[i] = (float)d14; /* wind dir */
-				m_columns[RH].data[i] = (float)d12;
-				m_columns[PRES].data[i] = (float)d13;
-				m_columns[SNOW].data[i] = (float)d20;
-				m_columns[ALB].data[i] = -999; /* no albedo in TMY2 */
-				m_columns[AOD].data[i] = -999; /* no AOD in TMY2 */
-				m_columns[TWET].data[i] 
+				m_columns.column(YEAR)[i] = (float)yr + 1900;
+				m_columns.column(MONTH)[i] = (float)mn;
+				m_columns.column(DAY)[i] = (float)dy;
+				m_columns.column(HOUR)[i] = (float)hr - 1;  // hour goes 0-23, not 1-24
+				m_columns.column(MINUTE)[i] = 30;
+				m_columns.column(GHI)[i] = (float)(d1*1.0);
+				m_columns.column(DNI)[i] = (float)d2;           /* Direct radiation */
+				m_columns.column(DHI)[i] = (float)d3;           /* Diffuse radiation */
+				m_columns.column(POA)[i] = (float)(-999);       /* No POA in TMY2 */
+				m_columns.column(TDRY)[i] = (float)(d10 / 10.0);       /* Ambient dry bulb temperature(C) */
+				m_columns.column(TDEW)[i] = (float)(d11 / 10.0); /* dew point temp */
+				m_columns.column(WSPD)[i] = (float)(d15 / 10.0);       /* Wind speed(m/s) */
+				m_columns.column(WDIR)[i] = (float)d14; /* wind dir */
+				m_columns.column(RH)[i] = (float)d12;
+				m_columns.column(PRES)[i] = (float)d13;
+				m_columns.column(SNOW)[i] = (float)d20;
+				m_columns.column(ALB)[i] = -999; /* no albedo in TMY2 */
+				m_columns.column(AOD)[i] = -999; /* no AOD in TMY2 */
+				m_columns.column(TWET)[i] 
 					= (float)calc_twet( 
-					(double)m_columns[TDRY].data[i],
-					(double)m_columns[RH].data[i],
-					(double)m_columns[PRES].data[i] ); /* must calculate wet bulb */
+					(double)m_columns.column(TDRY)[i],
+					(double)m_columns.column(RH)[i],
+					(double)m_columns.column(PRES)[i] ); /* must calculate wet bulb */
 
 				break;
 			}
@@ -1112,34 +1174,34 @@ bool weatherfile::open(const std::string &file, bool header_only)
 					continue;
 				}
 
-				m_columns[YEAR].data[i] = (float)year;
-				m_columns[MONTH].data[i] = (float)month;
-				m_columns[DAY].data[i] = (float)day;
-				m_columns[HOUR].data[i] = (float)hour;
-				m_columns[MINUTE].data[i] = 30;
+				m_columns.column(YEAR)[i] = (float)year;
+				m_columns.column(MONTH)[i] = (float)month;
+				m_columns.column(DAY)[i] = (float)day;
+				m_columns.column(HOUR)[i] = (float)hour;
+				m_columns.column(MINUTE)[i] = 30;
 
-				m_columns[GHI].data[i] = (float)stof(cols[4]);
-				m_columns[DNI].data[i] = (float)stof(cols[7]);
-				m_columns[DHI].data[i] = (float)stof(cols[10]);
-				m_columns[POA].data[i] = (float)(-999);       /* No POA in TMY3 */
+				m_columns.column(GHI)[i] = (float)stof(cols[4]);
+				m_columns.column(DNI)[i] = (float)stof(cols[7]);
+				m_columns.column(DHI)[i] = (float)stof(cols[10]);
+				m_columns.column(POA)[i] = (float)(-999);       /* No POA in TMY3 */
 
-				m_columns[TDRY].data[i] = (float)stof(cols[31]);
-				m_columns[TDEW].data[i] = (float)stof(cols[34]);
+				m_columns.column(TDRY)[i] = (float)stof(cols[31]);
+				m_columns.column(TDEW)[i] = (float)stof(cols[34]);
 				
-				m_columns[WSPD].data[i] = (float)stof(cols[46]);
-				m_columns[WDIR].data[i] = (float)stof(cols[43]);
+				m_columns.column(WSPD)[i] = (float)stof(cols[46]);
+				m_columns.column(WDIR)[i] = (float)stof(cols[43]);
 
-				m_columns[RH].data[i] = (float)stof(cols[37]);
-				m_columns[PRES].data[i] = (float)stof(cols[40]);
-				m_columns[SNOW].data[i] = -999.0; // no snowfall in TMY3
-				m_columns[ALB].data[i] = (float)stof(cols[61]);
-				m_columns[AOD].data[i] = -999; /* no AOD in TMY3 */
+				m_columns.column(RH)[i] = (float)stof(cols[37]);
+				m_columns.column(PRES)[i] = (float)stof(cols[40]);
+				m_columns.column(SNOW)[i] = -999.0; // no snowfall in TMY3
+				m_columns.column(ALB)[i] = (float)stof(cols[61]);
+				m_columns.column(AOD)[i] = -999; /* no AOD in TMY3 */
 
-				m_columns[TWET].data[i] 
+				m_columns.column(TWET)[i] 
 					= (float)calc_twet( 
-					(double)m_columns[TDRY].data[i],
-					(double)m_columns[RH].data[i],
-					(double)m_columns[PRES].data[i]); /* must calculate wet bulb */
+					(double)m_columns.column(TDRY)[i],
+					(double)m_columns.column(RH)[i],
+					(double)m_columns.column(PRES)[i]); /* must calculate wet bulb */
 
 				break;
 			}
@@ -1172,30 +1234,30 @@ bool weatherfile::open(const std::string &file, bool header_only)
 					continue;
 				}
 
-				m_columns[YEAR].data[i] = (float)stoi(cols[0]);
-				m_columns[MONTH].data[i] = (float)stoi(cols[1]);
-				m_columns[DAY].data[i] = (float)stoi(cols[2]);
-				m_columns[HOUR].data[i] = (float)stoi(cols[3]) - 1;  // hour goes 0-23, not 1-24;
-				m_columns[MINUTE].data[i] = 30;
+				m_columns.column(YEAR)[i] = (float)stoi(cols[0]);
+				m_columns.column(MONTH)[i] = (float)stoi(cols[1]);
+				m_columns.column(DAY)[i] = (float)stoi(cols[2]);
+				m_columns.column(HOUR)[i] = (float)stoi(cols[3]) - 1;  // hour goes 0-23, not 1-24;
+				m_columns.column(MINUTE)[i] = 30;
 
-				m_columns[GHI].data[i] = (float)stof(cols[13]);
-				m_columns[DNI].data[i] = (float)stof(cols[14]);
-				m_columns[DHI].data[i] = (float)stof(cols[15]);
-				m_columns[POA].data[i] = (float)(-999);       /* No POA in EPW */
+				m_columns.column(GHI)[i] = (float)stof(cols[13]);
+				m_columns.column(DNI)[i] = (float)stof(cols[14]);
+				m_columns.column(DHI)[i] = (float)stof(cols[15]);
+				m_columns.column(POA)[i] = (float)(-999);       /* No POA in EPW */
 
-				m_columns[WSPD].data[i] = (float)stof(cols[21]);
-				m_columns[WDIR].data[i] = (float)stof(cols[20]);
+				m_columns.column(WSPD)[i] = (float)stof(cols[21]);
+				m_columns.column(WDIR)[i] = (float)stof(cols[20]);
 
-				m_columns[TDRY].data[i] = (float)stof(cols[6]);
-				m_columns[TWET].data[i] = (float)stof(cols[7]);
+				m_columns.column(TDRY)[i] = (float)stof(cols[6]);
+				m_columns.column(TWET)[i] = (float)stof(cols[7]);
 
-				m_columns[RH].data[i] = (float)stof(cols[8]);
-				m_columns[PRES].data[i] = (float)(stof(cols[9]) * 0.01); /* convert Pa in to mbar */
-				m_columns[SNOW].data[i] = (float)stof(cols[30]); // snowfall
-				m_columns[ALB].data[i] = -999; /* no albedo in EPW file */
-				m_columns[AOD].data[i] = -999; /* no AOD in EPW */
+				m_columns.column(RH)[i] = (float)stof(cols[8]);
+				m_columns.column(PRES)[i] = (float)(stof(cols[9]) * 0.01); /* convert Pa in to mbar */
+				m_columns.column(SNOW)[i] = (float)stof(cols[30]); // snowfall
+				m_columns.column(ALB)[i] = -999; /* no albedo in EPW file */
+				m_columns.column(AOD)[i] = -999; /* no AOD in EPW */
 
-				m_columns[TDEW].data[i] = (float)wiki_dew_calc(m_columns[TDRY].data[i], m_columns[RH].data[i]);
+				m_columns.column(TDEW)[i] = (float)wiki_dew_calc(m_columns.column(TDRY)[i], m_columns.column(RH)[i]);
 
 				break;
 			}
@@ -1219,31 +1281,31 @@ bool weatherfile::open(const std::string &file, bool header_only)
 
 			double T = m_time;
 
-			m_columns[YEAR].data[i] = (float)m_startYear; // start year
-			m_columns[MONTH].data[i] = (float)util::month_of(T / 3600.0); // 1-12
-			m_columns[DAY].data[i] = (float)util::day_of_month((int)m_columns[MONTH].data[i], T / 3600.0); // 1-nday
-			m_columns[HOUR].data[i] = (float)(((int)(T / 3600.0)) % 24);  // hour goes 0-23, not 1-24;
-			m_columns[MINUTE].data[i] = (float)fmod(T / 60.0, 60.0);      // minute goes 0-59
+			m_columns.column(YEAR)[i] = (float)m_startYear; // start year
+			m_columns.column(MONTH)[i] = (float)util::month_of(T / 3600.0); // 1-12
+			m_columns.column(DAY)[i] = (float)util::day_of_month((int)m_columns.column(MONTH)[i], T / 3600.0); // 1-nday
+			m_columns.column(HOUR)[i] = (float)(((int)(T / 3600.0)) % 24);  // hour goes 0-23, not 1-24;
+			m_columns.column(MINUTE)[i] = (float)fmod(T / 60.0, 60.0);      // minute goes 0-59
 
 			m_time += m_stepSec; // increment by step
 
-			m_columns[GHI].data[i] = (float)stof(cols[7]);
-			m_columns[DNI].data[i] = (float)stof(cols[8]);
-			m_columns[DHI].data[i] = (float)stof(cols[9]);
-			m_columns[POA].data[i] = (double)(-999);       /* No POA in SMW */
+			m_columns.column(GHI)[i] = (float)stof(cols[7]);
+			m_columns.column(DNI)[i] = (float)stof(cols[8]);
+			m_columns.column(DHI)[i] = (float)stof(cols[9]);
+			m_columns.column(POA)[i] = (double)(-999);       /* No POA in SMW */
 
-			m_columns[WSPD].data[i] = (float)stof(cols[4]);
-			m_columns[WDIR].data[i] = (float)stof(cols[5]);
+			m_columns.column(WSPD)[i] = (float)stof(cols[4]);
+			m_columns.column(WDIR)[i] = (float)stof(cols[5]);
 
-			m_columns[TDRY].data[i] = (float)stof(cols[0]);
-			m_columns[TDEW].data[i] = (float)stof(cols[1]);
-			m_columns[TWET].data[i] = (float)stof(cols[2]);
+			m_columns.column(TDRY)[i] = (float)stof(cols[0]);
+			m_columns.column(TDEW)[i] = (float)stof(cols[1]);
+			m_columns.column(TWET)[i] = (float)stof(cols[2]);
 
-			m_columns[RH].data[i] = (float)stof(cols[3]);
-			m_columns[PRES].data[i] = (float)stof(cols[6]);
-			m_columns[SNOW].data[i] = (float)stof(cols[11]);
-			m_columns[ALB].data[i] = (float)stof(cols[10]);
-			m_columns[AOD].data[i] = -999; /* no AOD in SMW */
+			m_columns.column(RH)[i] = (float)stof(cols[3]);
+			m_columns.column(PRES)[i] = (float)stof(cols[6]);
+			m_columns.column(SNOW)[i] = (float)stof(cols[11]);
+			m_columns.column(ALB)[i] = (float)stof(cols[10]);
+			m_columns.column(AOD)[i] = -999; /* no AOD in SMW */
 
 			if (ifs.eof())
 			{
@@ -1268,15 +1330,15 @@ bool weatherfile::open(const std::string &file, bool header_only)
 				int ncols = cols.size();
 				for (size_t k = 0; k < _MAXCOL_; k++)
 				{
-					if (m_columns[k].index >= 0
-						&& m_columns[k].index < ncols)
+					if (m_colindex[k] >= 0
+						&& m_colindex[k] < ncols)
 					{
-						m_columns[k].data[i] = (float)stof(trimboth(cols[m_columns[k].index]));
+						m_columns.column(k)[i] = (float)stof(trimboth(cols[m_colindex[k]]));
 					} 
 				}
 
-				if ( m_columns[MONTH].data[i] == 2
-					&& m_columns[DAY].data[i] == 29 )
+				if ( m_columns.column(MONTH)[i] == 2
+					&& m_columns.column(DAY)[i] == 29 )
 				{
 					n_leap_data_removed++;
 					continue;
@@ -1298,69 +1360,69 @@ bool weatherfile::open(const std::string &file, bool header_only)
 		// special handling for certain columns that we can calculate from others
 		// if the data doesn't exist
 
-		if (m_columns[TWET].index < 0
-			&& m_columns[TDRY].index >= 0
-			&& m_columns[PRES].index >= 0
-			&& m_columns[RH].index >= 0)
+		if (m_colindex[TWET] < 0
+			&& m_colindex[TDRY] >= 0
+			&& m_colindex[PRES] >= 0
+			&& m_colindex[RH] >= 0)
 		{
 			for (size_t i = 0; i<m_nRecords; i++)
-				m_columns[TWET].data[i] = (float)calc_twet(m_columns[TDRY].data[i], m_columns[RH].data[i], m_columns[PRES].data[i]);
+				m_columns.column(TWET)[i] = (float)calc_twet(m_columns.column(TDRY)[i], m_columns.column(RH)[i], m_columns.column(PRES)[i]);
 		}
 
-		if (m_columns[TDEW].index < 0
-			&& m_columns[TDRY].index >= 0
-			&& m_columns[RH].index >= 0)
+		if (m_colindex[TDEW] < 0
+			&& m_colindex[TDRY] >= 0
+			&& m_colindex[RH] >= 0)
 		{
 			for (size_t i = 0; i<m_nRecords; i++)
-				m_columns[TDEW].data[i] = (float)wiki_dew_calc(m_columns[TDRY].data[i], m_columns[RH].data[i]);
+				m_columns.column(TDEW)[i] = (float)wiki_dew_calc(m_columns.column(TDRY)[i], m_columns.column(RH)[i]);
 		}
 
-		if (m_columns[YEAR].index < 0)
+		if (m_colindex[YEAR] < 0)
 		{
 			for (size_t i = 0; i<m_nRecords; i++)
-				m_columns[YEAR].data[i] = (float)m_startYear;
+				m_columns.column(YEAR)[i] = (float)m_startYear;
 		}
 
-		if (m_columns[MONTH].index < 0
+		if (m_colindex[MONTH] < 0
 			&& m_stepSec == 3600 && m_nRecords == 8760)
 		{
 			for (size_t i = 0; i<m_nRecords; i++)
-				m_columns[MONTH].data[i] = (float)util::month_of((double)i);
+				m_columns.column(MONTH)[i] = (float)util::month_of((double)i);
 		}
 
-		if (m_columns[DAY].index < 0
+		if (m_colindex[DAY] < 0
 			&& m_stepSec == 3600 && m_nRecords == 8760)
 		{
 			for (size_t i = 0; i<m_nRecords; i++)
 			{
 				int month = util::month_of((double)i);
-				m_columns[DAY].data[i] = (float)util::day_of_month(month, (double)i);
+				m_columns.column(DAY)[i] = (float)util::day_of_month(month, (double)i);
 			}
 		}
 
-		if (m_columns[HOUR].index < 0
+		if (m_colindex[HOUR] < 0
 			&& m_stepSec == 3600 && m_nRecords == 8760)
 		{
 			for (size_t i = 0; i<m_nRecords; i++)
 			{
 				size_t day = i / 24;
 				size_t start_of_day = day * 24;
-				m_columns[HOUR].data[i] = (float)(i - start_of_day);
+				m_columns.column(HOUR)[i] = (float)(i - start_of_day);
 			}
 		}
 
-		if (m_columns[MINUTE].index < 0 && (int)m_columns[HOUR].data[1] == m_columns[HOUR].data[1])
+		if (m_colindex[MINUTE] < 0 && (int)m_columns.column(HOUR)[1] == m_columns.column(HOUR)[1])
 		{
 			for (size_t i = 0; i<m_nRecords; i++)
-				m_columns[MINUTE].data[i] = (float)((m_stepSec / 2) / 60);
+				m_columns.column(MINUTE)[i] = (float)((m_stepSec / 2) / 60);
 		}
-        else if( m_columns[MINUTE].index < 0 )  //implies fractional hours are provided
+        else if( m_colindex[MINUTE] < 0 )  //implies fractional hours are provided
         {
             for (size_t i = 0; i<m_nRecords; i++)
             {
-                float hr = m_columns[HOUR].data[i];
-                m_columns[MINUTE].data[i] = (float)((hr - (int)hr)*60.);
-                m_columns[HOUR].data[i] = (float)(int)hr;
+                float hr = m_columns.column(HOUR)[i];
+                m_columns.column(MINUTE)[i] = (float)((hr - (int)hr)*60.);
+                m_columns.column(HOUR)[i] = (float)(int)hr;
             }
         }
 	}
@@ -1372,26 +1434,7 @@ bool weatherfile::read( weather_record *r )
 {
 	if ( r && m_index < m_nRecords)
 	{
-		r->year = (int)m_columns[YEAR].data[m_index];
-		r->month = (int)m_columns[MONTH].data[m_index];
-		r->day = (int)m_columns[DAY].data[m_index];
-		r->hour = (int)m_columns[HOUR].data[m_index];
-		r->minute = m_columns[MINUTE].data[m_index];
-		r->gh = m_columns[GHI].data[m_index];
-		r->dn = m_columns[DNI].data[m_index];
-		r->df = m_columns[DHI].data[m_index];
-		r->poa = m_columns[POA].data[m_index];
-		r->wspd = m_columns[WSPD].data[m_index];
-		r->wdir = m_columns[WDIR].data[m_index];
-		r->tdry = m_columns[TDRY].data[m_index];
-		r->twet = m_columns[TWET].data[m_index];
-		r->tdew = m_columns[TDEW].data[m_index];
-		r->rhum = m_columns[RH].data[m_index];
-		r->pres = m_columns[PRES].data[m_index];
-		r->snow = m_columns[SNOW].data[m_index];
-		r->alb = m_columns[ALB].data[m_index];
-		r->aod = m_columns[AOD].data[m_index];
-
+		m_columns.get( m_index, r );
 		m_index++;
 		return true;
 	}
@@ -1401,7 +1444,191 @@ bool weatherfile::read( weather_record *r )
 
 bool weatherfile::has_data_column( size_t id )
 {
-	return m_columns[id].index >= 0;
+	return m_colindex[id] >= 0;
+}
+
+/* Binary weather file layout (native byte order, checked with a marker):
+
+	char[8]   "SSCWFBIN"
+	uint32    format version
+	uint32    byte order marker 0x01020304
+	int32     original file type (TMY2, TMY3, EPW, SMW, WFCSV)
+	int32     start year
+	uint64    start second, step seconds, number of records
+	double    tz, lat, lon, elev
+	int32     has units flag
+	int32     number of columns (_MAXCOL_)
+	int32     column availability index per column (-1 = not in original file)
+	          location, city, state, country, source, description, url (each uint32 length + chars)
+	          zero padding to a multiple of 8 bytes
+	float     data, one contiguous column of nrecords values after another */
+
+static const char WFBIN_MAGIC[8] = { 'S', 'S', 'C', 'W', 'F', 'B', 'I', 'N' };
+static const unsigned int WFBIN_VERSION = 1;
+static const unsigned int WFBIN_BYTE_ORDER = 0x01020304;
+
+template< typename T >
+static void wfbin_put( std::string &buf, const T &val )
+{
+	buf.append( (const char*)&val, sizeof(T) );
+}
+
+static void wfbin_put_str( std::string &buf, const std::string &str )
+{
+	wfbin_put( buf, (unsigned int)str.size() );
+	buf.append( str );
+}
+
+template< typename T >
+static bool wfbin_get( const unsigned char *data, size_t size, size_t &pos, T &val )
+{
+	if ( pos + sizeof(T) > size ) return false;
+	memcpy( &val, data + pos, sizeof(T) );
+	pos += sizeof(T);
+	return true;
+}
+
+static bool wfbin_get_str( const unsigned char *data, size_t size, size_t &pos, std::string &str )
+{
+	unsigned int len = 0;
+	if ( !wfbin_get( data, size, pos, len ) || pos + len > size ) return false;
+	str.assign( (const char*)data + pos, len );
+	pos += len;
+	return true;
+}
+
+bool weatherfile::open_binary( const std::string &file, bool header_only )
+{
+	std::shared_ptr<util::mapped_file> map( new util::mapped_file );
+	if ( !map->open( file ) )
+	{
+		m_message = "could not open file for reading: " + file;
+		m_type = INVALID;
+		return false;
+	}
+
+	const unsigned char *data = map->data();
+	size_t size = map->size();
+	size_t pos = sizeof(WFBIN_MAGIC);
+
+	unsigned int version = 0, order = 0;
+	if ( size < pos || memcmp( data, WFBIN_MAGIC, sizeof(WFBIN_MAGIC) ) != 0
+		|| !wfbin_get( data, size, pos, version ) || version != WFBIN_VERSION
+		|| !wfbin_get( data, size, pos, order ) || order != WFBIN_BYTE_ORDER )
+	{
+		m_message = "not a binary weather file, or written by an incompatible version or platform: " + file;
+		m_type = INVALID;
+		return false;
+	}
+
+	int type = INVALID, start_year = 0, hasunits = 0, ncols = 0;
+	unsigned long long start_sec = 0, step_sec = 0, nrec = 0;
+	bool hdr_ok = wfbin_get( data, size, pos, type )
+		&& wfbin_get( data, size, pos, start_year )
+		&& wfbin_get( data, size, pos, start_sec )
+		&& wfbin_get( data, size, pos, step_sec )
+		&& wfbin_get( data, size, pos, nrec )
+		&& wfbin_get( data, size, pos, m_hdr.tz )
+		&& wfbin_get( data, size, pos, m_hdr.lat )
+		&& wfbin_get( data, size, pos, m_hdr.lon )
+		&& wfbin_get( data, size, pos, m_hdr.elev )
+		&& wfbin_get( data, size, pos, hasunits )
+		&& wfbin_get( data, size, pos, ncols )
+		&& ncols == _MAXCOL_;
+
+	for ( size_t i = 0; hdr_ok && i < _MAXCOL_; i++ )
+		hdr_ok = wfbin_get( data, size, pos, m_colindex[i] );
+
+	hdr_ok = hdr_ok
+		&& wfbin_get_str( data, size, pos, m_hdr.location )
+		&& wfbin_get_str( data, size, pos, m_hdr.city )
+		&& wfbin_get_str( data, size, pos, m_hdr.state )
+		&& wfbin_get_str( data, size, pos, m_hdr.country )
+		&& wfbin_get_str( data, size, pos, m_hdr.source )
+		&& wfbin_get_str( data, size, pos, m_hdr.description )
+		&& wfbin_get_str( data, size, pos, m_hdr.url );
+
+	pos = (pos + 7) & ~(size_t)7;
+	if ( !hdr_ok || pos > size || nrec > (size - pos) / (sizeof(float)*_MAXCOL_) )
+	{
+		m_message = "binary weather file is truncated or corrupt: " + file;
+		m_type = INVALID;
+		return false;
+	}
+
+	m_type = type;
+	m_startYear = start_year;
+	m_startSec = (size_t)start_sec;
+	m_stepSec = (size_t)step_sec;
+	m_nRecords = (size_t)nrec;
+	m_hdr.hasunits = hasunits != 0;
+
+	if ( header_only )
+		return true;
+
+	const float *values = (const float*)( data + pos );
+	m_columns.reset( m_nRecords );
+	for ( size_t i = 0; i < _MAXCOL_; i++ )
+		m_columns.borrow( i, values + i * m_nRecords );
+
+	m_map = map;
+	return true;
+}
+
+bool weatherfile::convert_to_binary( const std::string &input, const std::string &output )
+{
+	weatherfile wf( input );
+	if ( !wf.ok() ) return false;
+
+	std::string buf;
+	buf.append( WFBIN_MAGIC, sizeof(WFBIN_MAGIC) );
+	wfbin_put( buf, WFBIN_VERSION );
+	wfbin_put( buf, WFBIN_BYTE_ORDER );
+	wfbin_put( buf, (int)wf.m_type );
+	wfbin_put( buf, (int)wf.m_startYear );
+	wfbin_put( buf, (unsigned long long)wf.m_startSec );
+	wfbin_put( buf, (unsigned long long)wf.m_stepSec );
+	wfbin_put( buf, (unsigned long long)wf.m_nRecords );
+	wfbin_put( buf, wf.m_hdr.tz );
+	wfbin_put( buf, wf.m_hdr.lat );
+	wfbin_put( buf, wf.m_hdr.lon );
+	wfbin_put( buf, wf.m_hdr.elev );
+	wfbin_put( buf, (int)(wf.m_hdr.hasunits ? 1 : 0) );
+	wfbin_put( buf, (int)_MAXCOL_ );
+	for ( size_t i = 0; i < _MAXCOL_; i++ )
+		wfbin_put( buf, (int)wf.m_colindex[i] );
+	wfbin_put_str( buf, wf.m_hdr.location );
+	wfbin_put_str( buf, wf.m_hdr.city );
+	wfbin_put_str( buf, wf.m_hdr.state );
+	wfbin_put_str( buf, wf.m_hdr.country );
+	wfbin_put_str( buf, wf.m_hdr.source );
+	wfbin_put_str( buf, wf.m_hdr.description );
+	wfbin_put_str( buf, wf.m_hdr.url );
+	buf.append( ((buf.size() + 7) & ~(size_t)7) - buf.size(), '\0' );
+
+	util::stdfile fp( output, "wb" );
+	if ( !fp.ok() ) return false;
+
+	if ( fwrite( buf.c_str(), 1, buf.size(), fp ) != buf.size() ) return false;
+
+	for ( size_t i = 0; i < _MAXCOL_; i++ )
+	{
+		if ( wf.m_nRecords == 0 ) break;
+
+		// the binary format stores every column, so write the constant for columns the file didn't have
+		std::vector<float> fill;
+		const float *values = wf.m_columns.values(i);
+		if ( values == 0 )
+		{
+			fill.assign( wf.m_nRecords, wf.m_columns.value(i, 0) );
+			values = &fill[0];
+		}
+
+		if ( fwrite( values, sizeof(float), wf.m_nRecords, fp ) != wf.m_nRecords )
+			return false;
+	}
+
+	return true;
 }
 
 bool weatherfile::convert_to_wfcsv( const std::string &input, const std::string &output )
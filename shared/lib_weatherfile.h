@@ -53,6 +53,9 @@
 #include <string>
 #include <vector>  // needed to compile in typelib_vc2012
 #include <cmath>
+#include <memory>
+
+namespace util { class mapped_file; }
 
 /***************************************************************************\
 
@@ -225,18 +228,61 @@ public:
 	}
 };
 
+/* weather_columns: contiguous struct-of-arrays storage for the records of a weather data provider,
+	one float array per weather_data_provider column.  A column is either owned, or borrowed from
+	memory that outlives the store (a memory mapped binary weather file, or the arrays of an ssc data
+	table).  Columns that are never set are not allocated and read back as a constant, which defaults
+	to the weather_record::reset value.  Copies of the store share borrowed columns. */
+class weather_columns
+{
+private:
+	std::vector<float> m_data[weather_data_provider::_MAXCOL_];
+	const float *m_borrowed[weather_data_provider::_MAXCOL_];
+	float m_default[weather_data_provider::_MAXCOL_];
+	size_t m_nrec;
+
+public:
+	weather_columns() { reset( 0 ); }
+
+	// drops all columns and restores the default constants
+	void reset( size_t nrec );
+	size_t size() const { return m_nrec; }
+
+	// owned column of size() values set to 'fill'.  returns the writable data
+	float *alloc( size_t id, float fill );
+	// borrowed column of at least size() values
+	void borrow( size_t id, const float *values );
+	// constant returned for every record of a column that is not set
+	void set_default( size_t id, float value ) { m_default[id] = value; }
+
+	bool has( size_t id ) const { return m_borrowed[id] != 0 || !m_data[id].empty(); }
+	float *data( size_t id ) { return m_data[id].empty() ? 0 : &m_data[id][0]; } // owned columns only
+	// owned column, allocated and filled with the default constant on first access
+	float *column( size_t id ) { if ( !has( id ) ) alloc( id, m_default[id] ); return data( id ); }
+	const float *values( size_t id ) const { return m_borrowed[id] ? m_borrowed[id] : ( m_data[id].empty() ? 0 : &m_data[id][0] ); }
+	float value( size_t id, size_t i ) const
+	{
+		const float *p = values( id );
+		return p ? p[i] : m_default[id];
+	}
+
+	// fills all fields of 'r' from record i
+	void get( size_t i, weather_record *r ) const;
+};
+
 class weatherfile : public weather_data_provider
 {
 private:
 	int m_type;
 	std::string m_file;
 
-	struct column
-	{
-		int index; // used for wfcsv to get column index in CSV file from which to read
-		std::vector<float> data;
-	};
-	column m_columns[_MAXCOL_];
+	weather_columns m_columns;
+	int m_colindex[_MAXCOL_]; // used for wfcsv to get column index in CSV file from which to read, -1 if not in the file
+
+	// binary weather files are read in place from a memory mapping shared by copies of this object
+	std::shared_ptr<util::mapped_file> m_map;
+
+	bool open_binary( const std::string &file, bool header_only );
 
 public:
 	weatherfile();
@@ -258,6 +304,11 @@ public:
 	
 	static std::string normalize_city( const std::string &in );
 	static bool convert_to_wfcsv( const std::string &input, const std::string &output );
+
+	/* Writes the header and all data columns of any readable weather file to the
+	compact binary (.wfbin) format, which open() maps into memory instead of parsing.
+	The original file type is preserved, so type() reports it for the binary file too. */
+	static bool convert_to_binary( const std::string &input, const std::string &output );
 	
 };
 
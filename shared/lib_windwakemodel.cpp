@@ -48,6 +48,8 @@
 *******************************************************************************************************/
 
 #include <cmath>
+#include <algorithm>
+#include <limits>
 #include "lib_physics.h"
 #include "lib_util.h"
 #include "lib_windwatts.h"
@@ -148,6 +150,40 @@ void windTurbine::turbinePower(double windVelocity, double airDensity, double *t
 }
 
 
+void crosswindIndex::build(const double distanceCrosswind[], size_t n)
+{
+	order.resize(n);
+	for (size_t i = 0; i < n; i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [distanceCrosswind](size_t a, size_t b){ return distanceCrosswind[a] < distanceCrosswind[b]; });
+
+	crosswind.resize(n);
+	for (size_t k = 0; k < n; k++)
+		crosswind[k] = distanceCrosswind[order[k]];
+}
+
+void crosswindIndex::query(double c, double halfWidth, size_t jEnd, std::vector<size_t> &found) const
+{
+	found.clear();
+
+	// widen the range slightly so that rounding never drops a turbine at the edge; the wake models check each candidate exactly
+	halfWidth = halfWidth * (1.0 + 1e-9) + 1e-9;
+	if (!cull || !(halfWidth < std::numeric_limits<double>::infinity())) // culling off, or infinite or NaN: every turbine is a candidate
+	{
+		for (size_t j = 0; j < jEnd; j++)
+			found.push_back(j);
+		return;
+	}
+
+	std::vector<double>::const_iterator it = std::lower_bound(crosswind.begin(), crosswind.end(), c - halfWidth);
+	for (size_t k = it - crosswind.begin(); k < crosswind.size() && crosswind[k] <= c + halfWidth; k++)
+		if (order[k] < jEnd)
+			found.push_back(order[k]);
+
+	std::sort(found.begin(), found.end());
+}
+
+
 /// Calculates the velocity deficit (% reduction in wind speed) and the turbulence intensity (TI) due to an upwind turbine.
 double simpleWakeModel::velDeltaPQ(double radiiCrosswind, double axialDistInRadii, double thrustCoeff, double *newTurbulenceIntensity)
 {
@@ -166,11 +202,18 @@ double simpleWakeModel::velDeltaPQ(double radiiCrosswind, double axialDistInRadi
 void simpleWakeModel::wakeCalculations(const double airDensity, const double distanceDownwind[], const double distanceCrosswind[],
 	double power[], double eff[], double thrust[], double windSpeed[], double turbulenceIntensity[])
 {
+	upwindIndex.build(distanceCrosswind, nTurbines);
+
 	for (size_t i = 1; i < nTurbines; i++) // loop through all turbines, starting with most upwind turbine. i=0 has already been done
 	{
 		double dDeficit = 1;
-		for (size_t j = 0; j < i; j++) // loop through all turbines upwind of turbine[i]
+
+		// velDeltaPQ has no effect beyond 20 radii crosswind, so only the upwind turbines within that distance are visited
+		upwindIndex.query(distanceCrosswind[i], 20.0, i, upwindCandidates);
+		for (size_t k = 0; k < upwindCandidates.size(); k++)
 		{
+			size_t j = upwindCandidates[k];
+
 			// distance downwind (axial distance) = distance from turbine j to turbine i along axis of wind direction (units of wind turbine blade radii)
 			double fDistanceDownwind = fabs(distanceDownwind[j] - distanceDownwind[i]);
 
@@ -243,11 +286,21 @@ void parkWakeModel::wakeCalculations(const double airDensity, const double dista
 {
 	double turbineRadius = wTurbine->rotorDiameter / 2;
 
+	upwindIndex.build(distanceCrosswind, nTurbines);
+	double minDownwind = distanceDownwind[0], maxDownwind = distanceDownwind[0]; // range of the turbines before i
+
 	for (size_t i = 1; i < nTurbines; i++) // downwind turbines, i=0 has already been done
 	{
 		double newSpeed = windSpeed[0];
-		for (size_t j = 0; j < i; j++) // upwind turbines
+
+		// the wake and rotor circles cannot overlap beyond two radii plus the wake growth over the largest downwind separation (in radii)
+		double maxSeparation = max_of(distanceDownwind[i] - minDownwind, maxDownwind - distanceDownwind[i]);
+		minDownwind = min_of(minDownwind, distanceDownwind[i]);
+		maxDownwind = max_of(maxDownwind, distanceDownwind[i]);
+		upwindIndex.query(distanceCrosswind[i], 2.0 + wakeDecayCoefficient * maxSeparation, i, upwindCandidates);
+		for (size_t k = 0; k < upwindCandidates.size(); k++) // upwind turbines
 		{
+			size_t j = upwindCandidates[k];
 			double distanceDownwindMeters = turbineRadius*fabs(distanceDownwind[i] - distanceDownwind[j]);
 			double distanceCrosswindMeters = turbineRadius*fabs(distanceCrosswind[i] - distanceCrosswind[j]);
 
@@ -504,6 +557,30 @@ bool eddyViscosityWakeModel::fillWakeArrays(int turbineIndex, double ambientVelo
 }
 
 
+double eddyViscosityWakeModel::wakeReach(int turbineIndex)
+{
+	// widest wake and largest deficit that getWakeWidth and getVelocityDeficit can return for this turbine
+	double maxWidth = 1.0, maxDeficit = rotorDiameter * matEVWakeDeficits.at(turbineIndex, 0);
+	for (size_t j = 0; j < matEVWakeWidths.ncols(); j++)
+	{
+		double w = matEVWakeWidths.at(turbineIndex, j), d = matEVWakeDeficits.at(turbineIndex, j);
+		if (w != w || d != d)
+			return std::numeric_limits<double>::infinity();
+		maxWidth = max_of(maxWidth, w);
+		maxDeficit = max_of(maxDeficit, d);
+	}
+	maxWidth *= rotorDiameter;
+
+	// Past the edge of the wake the intersection and added turbulence are zero, and the Gaussian deficit profile in
+	// wakeDeficit is below 1e-20 once the rotor edge is this many wake widths from the centerline. A deficit that small
+	// leaves (1 - deficit) equal to one, so turbines further away give exactly the same result as skipping them.
+	double widths = 1.0;
+	if (maxDeficit > 0.0)
+		widths = max_of(1.0, sqrt(max_of(0.0, log(maxDeficit / 1e-20)) / 3.56));
+
+	return (rotorDiameter / 2.0 + maxWidth * widths) * 1.000001;
+}
+
 /// Simplified Eddy-Viscosity model as per "Simplified Solution To The Eddy Viscosity Wake Model" - 2009 by Dr Mike Anderson of RES
 void eddyViscosityWakeModel::wakeCalculations(/*INPUTS */ const double air_density, const double aDistanceDownwind[], const double aDistanceCrosswind[],
 	/*OUTPUTS*/ double power[], double eff[], double Thrust[], double adWindSpeed[], double aTurbulence_intensity[])
@@ -513,14 +590,20 @@ void eddyViscosityWakeModel::wakeCalculations(/*INPUTS */ const double air_densi
 	matEVWakeWidths.fill(0.0);
 	std::vector<VMLN> vmln(nTurbines);
 	std::vector<double> Iamb(nTurbines, turbulenceCoeff);
+	double maxReach = 0.0; // largest wakeReach of the turbines done so far (m)
+
+	upwindIndex.build(aDistanceCrosswind, nTurbines);
 
 	// Note that this 'i' loop starts with i=0, which is necessary to initialize stuff for turbine[0]
 	for (size_t i = 0; i<nTurbines; i++) // downwind turbines, but starting with most upwind and working downwind
 	{
 		double dDeficit = 0, Iadd = 0, dTotalTI = aTurbulence_intensity[i];
 		//		double dTOut=0, dThrustCoeff=0;
-		for (size_t j = 0; j<i; j++) // upwind turbines - turbines upwind of turbine[i]
+		upwindIndex.query(aDistanceCrosswind[i], maxReach / dTurbineRadius, i, upwindCandidates);
+		for (size_t k = 0; k < upwindCandidates.size(); k++) // upwind turbines - turbines upwind of turbine[i] whose wake can reach it
 		{
+			size_t j = upwindCandidates[k];
+
 			// distance downwind = distance from turbine i to turbine j along axis of wind direction
 			double dDistAxialInDiameters = fabs(aDistanceDownwind[i] - aDistanceDownwind[j]) / 2.0;
 			if (std::abs(dDistAxialInDiameters) <= 0.0001)
@@ -561,6 +644,7 @@ void eddyViscosityWakeModel::wakeCalculations(/*INPUTS */ const double air_densi
 			if (errDetails.length() == 0) errDetails = "Could not calculate the turbine wake arrays in the Eddy-Viscosity model.";
 		}
 		nearWakeRegionLength(adWindSpeed[i], Iamb[i], Thrust[i], air_density, vmln[i]);
+		maxReach = max_of(maxReach, wakeReach((int)i));
 	}
 }
 
@@ -107,6 +107,27 @@ public:
 	}
 };
 
+/**
+ * crosswindIndex sorts the turbines of a farm by crosswind coordinate so that a wake model can find the upwind turbines
+ * within a crosswind distance of a downwind turbine without looping over the whole farm. Wake models only skip turbines
+ * that are outside the distance at which their wake is exactly zero, so results are the same as checking every pair.
+ */
+
+class crosswindIndex
+{
+private:
+	std::vector<size_t> order;			// turbine indices sorted by crosswind coordinate
+	std::vector<double> crosswind;		// crosswind coordinate of each entry in order
+	bool cull;							// false returns every turbine j < jEnd from query
+public:
+	crosswindIndex(){ cull = true; }
+	void build(const double distanceCrosswind[], size_t n);
+	void setCulling(bool enable){ cull = enable; }
+
+	/// Fills 'found' with the turbines j < jEnd whose crosswind coordinate is within halfWidth of c, in increasing order of j
+	void query(double c, double halfWidth, size_t jEnd, std::vector<size_t> &found) const;
+};
+
 /**
  * Wake models are used to calculate the wind velocity deficit at a turbine and the following changes to power, efficient, thrust and
  * turbulence intensity. The class requires an turbine with initialized values to run. Error messages can be propagated via errDetails.
@@ -117,11 +138,15 @@ class wakeModelBase
 protected:
 	size_t nTurbines;
 	windTurbine* wTurbine;
+	crosswindIndex upwindIndex;				// turbines by crosswind coordinate, used to find the turbines whose wake can reach another
+	std::vector<size_t> upwindCandidates;
 public:
 	wakeModelBase(){}
 	virtual std::string getModelName(){ return ""; };
 	std::string errDetails;
 	virtual int test(int a){ return a + 10; }
+	/// Visit every upwind turbine instead of only those within reach of their wake, as a reference for the culled results
+	void setCulling(bool enable){ upwindIndex.setCulling(enable); }
 	virtual void wakeCalculations(
 		const double airDensity, const double distanceDownwind[], const double distanceCrosswind[],
 		double power[], double eff[], double thrust[], double windSpeed[], double turbulenceIntensity[]) = 0;
@@ -202,7 +227,7 @@ private:
 	double rotorDiameter, turbulenceCoeff;
 	double axialResolution, minThrustCoeff, nBlades;
 	double minDeficit;
-	int MIN_DIAM_EV, EV_SCALE, MAX_WIND_TURBINES;
+	int MIN_DIAM_EV, EV_SCALE;
 	bool useFilterFx;
 	// EV wake matrices: each turbine is row, each col is wake data for that turbine at dist
 	util::matrix_t<double> matEVWakeDeficits;	// wind velocity deficit behind each turbine, indexed by axial distance downwind
@@ -241,6 +266,9 @@ private:
 
 	bool fillWakeArrays(int turbineIndex, double ambientVelocity, double velocityAtTurbine, double power, double thrustCoeff, double turbulenceIntensity, double maxX);
 
+	/// Crosswind distance (m) beyond which the wake of a turbine has no effect on the wind speed or turbulence intensity of another
+	double wakeReach(int turbineIndex);
+
 	/// Using Ii, ambient turbulence intensity, and thrust coeff, calculates the length of the near wake region
 	void nearWakeRegionLength(double U, double Ii, double Ct, double airDensity, VMLN& vmln);
 
@@ -262,7 +290,6 @@ public:
 		minDeficit = 0.0002;
 		MIN_DIAM_EV = 2;
 		EV_SCALE = 1;
-		MAX_WIND_TURBINES = 300;
 		axialResolution = 0.5; // in rotor diameters, default in openWind=0.5
 		//double radialResolution = 0.2; // in rotor diameters, default in openWind=0.2
 		double maxRotorDiameters = 50; // in rotor diameters, default in openWind=50
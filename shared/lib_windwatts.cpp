@@ -51,6 +51,7 @@
 #include "lib_physics.h"
 
 #include <iostream>
+#include <algorithm>
 #include <math.h>
 #include "lib_util.h"
 #include "lib_windwakemodel.h"
@@ -140,26 +141,59 @@ void windPowerCalculator::coordtrans(double metersNorth, double metersEast, doub
 	*metersCrosswind = metersEast*sin(fWind_dir_radians) + (metersNorth * cos(fWind_dir_radians));
 }
 
-int windPowerCalculator::windPowerUsingResource(/*INPUTS */ double windSpeed, double windDirDeg, double airPressureAtm, double TdryC,
-	/*OUTPUTS*/ double *farmPower, double power[], double thrust[], double eff[], double adWindSpeed[], double TI[],
-	double distanceDownwind[], double distanceCrosswind[])
+const std::vector<size_t> &windPowerCalculator::getDownwindOrder(double windDirDeg)
 {
-	if ((nTurbines > MAX_WIND_TURBINES) || (nTurbines < 1))
+	// the orders depend on the layout, so start over if it changed
+	if (downwindOrder.size() != DIRECTION_BINS || downwindOrderX != XCoords || downwindOrderY != YCoords)
 	{
-		errDetails = "The number of wind turbines was greater than the maximum allowed in the wake model.";
-		return 0;
+		downwindOrder.assign(DIRECTION_BINS, std::vector<size_t>());
+		downwindOrderX = XCoords;
+		downwindOrderY = YCoords;
 	}
 
-	size_t i, j;
-	//unsigned char wt_id[MAX_WIND_TURBINES], wid; // unsigned char has 256 limit
-	size_t wt_id[MAX_WIND_TURBINES], wid;
+	double dir = fmod(windDirDeg, 360.0);
+	if (dir < 0) dir += 360.0;
+	if (!(dir >= 0 && dir < 360.0)) dir = 0; // not a number
+	int bin = std::min(DIRECTION_BINS - 1, (int)(dir * DIRECTION_BINS / 360.0));
 
-	for (i = 0; i<nTurbines; i++)
-		wt_id[i] = i;
+	std::vector<size_t> &order = downwindOrder[bin];
+	if (order.size() != nTurbines)
+	{
+		std::vector<double> downwind(nTurbines);
+		double crosswind;
+		for (size_t i = 0; i < nTurbines; i++)
+			coordtrans(YCoords[i], XCoords[i], (bin + 0.5) * 360.0 / DIRECTION_BINS, &downwind[i], &crosswind);
+
+		order.resize(nTurbines);
+		for (size_t i = 0; i < nTurbines; i++)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&downwind](size_t a, size_t b){ return downwind[a] < downwind[b]; });
+	}
+	return order;
+}
 
+int windPowerCalculator::windPowerUsingResource(/*INPUTS */ double windSpeed, double windDirDeg, double airPressureAtm, double TdryC,
+	/*OUTPUTS*/ double *farmPower, double power[], double thrust[], double eff[], double adWindSpeed[], double TI[],
+	double distanceDownwind[], double distanceCrosswind[])
+{
 	// convert barometric pressure in ATM to air density
 	double fAirDensity = (airPressureAtm * physics::Pa_PER_Atm) / (physics::R_GAS_DRY_AIR * physics::CelciusToKelvin(TdryC));   //!Air Density, kg/m^3
 
+	return windPowerUsingDensity(windSpeed, windDirDeg, fAirDensity, farmPower, power, thrust, eff, adWindSpeed, TI, distanceDownwind, distanceCrosswind);
+}
+
+int windPowerCalculator::windPowerUsingDensity(/*INPUTS */ double windSpeed, double windDirDeg, double fAirDensity,
+	/*OUTPUTS*/ double *farmPower, double power[], double thrust[], double eff[], double adWindSpeed[], double TI[],
+	double distanceDownwind[], double distanceCrosswind[])
+{
+	if (nTurbines < 1)
+	{
+		errDetails = "The wind farm must have at least one turbine.";
+		return 0;
+	}
+
+	size_t i, j, wid;
+
 	// calculate output power of a turbine
 	double fTurbine_output(0.0), fThrust_coeff(0.0);
 	windTurb->turbinePower(windSpeed, fAirDensity, &fTurbine_output, &fThrust_coeff);
@@ -232,29 +266,34 @@ int windPowerCalculator::windPowerUsingResource(/*INPUTS */ double windSpeed, do
 	eff[0] = (fTurbine_output < 1.0) ? 0.0 : 100.0;
 
 
-	// Sort aDistanceDownwind, aDistanceCrosswind arrays by downwind distance, aDistanceDownwind[0] is smallest downwind distance, presumably zero
+	// Sort turbines by downwind distance, turbineOrder[0] is the most upwind turbine, presumably at zero. Turbines at the same
+	// downwind distance stay in index order. Starting from the order for this direction bin, only a few turbines move.
+	const std::vector<size_t> &binOrder = getDownwindOrder(windDirDeg);
+	turbineOrder.assign(binOrder.begin(), binOrder.end());
 	for (j = 1; j<nTurbines; j++)
 	{
-		d = distanceDownwind[j]; // pick out each element
-		c = distanceCrosswind[j];
-		wid = wt_id[j];
+		wid = turbineOrder[j]; // pick out each element
+		d = distanceDownwind[wid];
 
 		i = j;
-		while (i > 0 && distanceDownwind[i - 1] > d) // look for place to insert item
+		while (i > 0 && (distanceDownwind[turbineOrder[i - 1]] > d || (distanceDownwind[turbineOrder[i - 1]] == d && turbineOrder[i - 1] > wid))) // look for place to insert item
 		{
-			distanceDownwind[i] = distanceDownwind[i - 1];
-			distanceCrosswind[i] = distanceCrosswind[i - 1];
-			wt_id[i] = wt_id[i - 1];
+			turbineOrder[i] = turbineOrder[i - 1];
 			i--;
 		}
+		turbineOrder[i] = wid; // insert it
+	}
 
-		distanceDownwind[i] = d; // insert it
-		distanceCrosswind[i] = c;
-		wt_id[i] = wid;
+	sortedDownwind.resize(nTurbines);
+	sortedCrosswind.resize(nTurbines);
+	for (i = 0; i<nTurbines; i++)
+	{
+		sortedDownwind[i] = distanceDownwind[turbineOrder[i]];
+		sortedCrosswind[i] = distanceCrosswind[turbineOrder[i]];
 	}
 
 	// calculate the power output of downwind turbines using wake model
-	wakeModel->wakeCalculations(fAirDensity, &distanceDownwind[0], &distanceCrosswind[0], power, eff, thrust, adWindSpeed, TI);
+	wakeModel->wakeCalculations(fAirDensity, &sortedDownwind[0], &sortedCrosswind[0], power, eff, thrust, adWindSpeed, TI);
 	if (wakeModel->errDetails.length() > 0){
 		errDetails = wakeModel->errDetails;
 		return 0;
@@ -265,46 +304,20 @@ int windPowerCalculator::windPowerUsingResource(/*INPUTS */ double windSpeed, do
 	for (i = 0; i<nTurbines; i++)
 		*farmPower += power[i];
 
-	// Update down/cross wind distance units for turbine zero (convert from radii to meters)
-	distanceDownwind[0] *= windTurb->rotorDiameter / 2;
-	distanceCrosswind[0] *= windTurb->rotorDiameter / 2;
-
-	// Re-sort output arrays by wind turbine ID (0..nwt-1)
-	// for consistent reporting
-	double p(0.0), t(0.0), e(0.0), w(0.0), b(0.0), dd(0.0), dc(0.0);
-	for (j = 1; j<nTurbines; j++)
+	// Put output arrays back in wind turbine ID order (0..nwt-1) for consistent reporting
+	double *outputs[] = { power, thrust, eff, adWindSpeed, TI };
+	for (size_t k = 0; k < sizeof(outputs) / sizeof(outputs[0]); k++)
 	{
-		p = power[j];// pick out each element
-		t = thrust[j];
-		e = eff[j];
-		w = adWindSpeed[j];
-		b = TI[j];
-		dd = distanceDownwind[j] * windTurb->rotorDiameter / 2; // convert back to meters from radii
-		dc = distanceCrosswind[j] * windTurb->rotorDiameter / 2;
-		wid = wt_id[j];
-
-		i = j;
-		while (i > 0 && wt_id[i - 1] > wid) // look for place to insert item
-		{
-			power[i] = power[i - 1];
-			thrust[i] = thrust[i - 1];
-			eff[i] = eff[i - 1];
-			adWindSpeed[i] = adWindSpeed[i - 1];
-			TI[i] = TI[i - 1];
-			distanceDownwind[i] = distanceDownwind[i - 1];
-			distanceCrosswind[i] = distanceCrosswind[i - 1];
-			wt_id[i] = wt_id[i - 1];
-			i--;
-		}
+		sortedOutput.assign(outputs[k], outputs[k] + nTurbines);
+		for (i = 0; i<nTurbines; i++)
+			outputs[k][turbineOrder[i]] = sortedOutput[i];
+	}
 
-		power[i] = p;
-		thrust[i] = t;
-		eff[i] = e;
-		adWindSpeed[i] = w;
-		TI[i] = b;
-		distanceDownwind[i] = dd;
-		distanceCrosswind[i] = dc;
-		wt_id[i] = wid;
+	// convert down/cross wind distances back to meters from radii
+	for (i = 0; i<nTurbines; i++)
+	{
+		distanceDownwind[i] = distanceDownwind[i] * windTurb->rotorDiameter / 2;
+		distanceCrosswind[i] = distanceCrosswind[i] * windTurb->rotorDiameter / 2;
 	}
 
 	return (int)nTurbines;
@@ -354,3 +367,118 @@ double windPowerCalculator::windPowerUsingWeibull(double weibull_k, double avg_s
 	// calculate output accounting for losses
 	return total_energy_turbine;
 }
+
+
+wakeResultCache::wakeResultCache(windPowerCalculator *calculator, double dirStepDeg, double speedStepMS, double densityStepKgM3, double toleranceFraction)
+{
+	wpc = calculator;
+	nDirections = (int)ceil(360.0 / dirStepDeg - 1e-6);
+	if (nDirections < 1) nDirections = 1;
+	dirStep = 360.0 / nDirections; // whole number of bins around the compass
+	speedStep = speedStepMS;
+	densityStep = densityStepKgM3;
+
+	std::vector<double> powerCurveKW = wpc->windTurb->getPowerCurveKW();
+	double ratedPower = 0;
+	for (size_t i = 0; i < powerCurveKW.size(); i++)
+		ratedPower = max_of(ratedPower, powerCurveKW[i]);
+	tolerance = toleranceFraction * ratedPower * wpc->nTurbines;
+
+	power.resize(wpc->nTurbines);
+	thrust.resize(wpc->nTurbines);
+	eff.resize(wpc->nTurbines);
+	wind.resize(wpc->nTurbines);
+	turbul.resize(wpc->nTurbines);
+	distDown.resize(wpc->nTurbines);
+	distCross.resize(wpc->nTurbines);
+	nFullCalculations = 0;
+}
+
+bool wakeResultCache::calculate(double windSpeed, double windDirDeg, double airDensity, double *farmPower)
+{
+	if ((int)wpc->nTurbines != wpc->windPowerUsingDensity(windSpeed, windDirDeg, airDensity, farmPower,
+		&power[0], &thrust[0], &eff[0], &wind[0], &turbul[0], &distDown[0], &distCross[0]))
+	{
+		errDetails = wpc->GetErrorDetails();
+		return false;
+	}
+	return true;
+}
+
+// grid indices are packed 21 bits each into the map keys
+static const int WAKE_CACHE_MAX_INDEX = (1 << 21) - 2;
+static unsigned long long wakeCacheKey(int iDir, int iSpeed, int iDensity)
+{
+	return ((unsigned long long)iDir << 42) | ((unsigned long long)iSpeed << 21) | (unsigned long long)iDensity;
+}
+
+bool wakeResultCache::getGridPower(int iDir, int iSpeed, int iDensity, double *farmPower)
+{
+	unsigned long long key = wakeCacheKey(iDir, iSpeed, iDensity);
+	std::unordered_map<unsigned long long, double>::const_iterator it = gridPower.find(key);
+	if (it != gridPower.end())
+	{
+		*farmPower = it->second;
+		return true;
+	}
+	if (!calculate(iSpeed * speedStep, iDir * dirStep, iDensity * densityStep, farmPower))
+		return false;
+	gridPower[key] = *farmPower;
+	return true;
+}
+
+bool wakeResultCache::interpolate(int iDir, int iSpeed, int iDensity, double tDir, double tSpeed, double tDensity, double *farmPower)
+{
+	*farmPower = 0;
+	for (int k = 0; k < 8; k++)
+	{
+		int dDir = k & 1, dSpeed = (k >> 1) & 1, dDensity = (k >> 2) & 1;
+		double weight = (dDir ? tDir : 1 - tDir) * (dSpeed ? tSpeed : 1 - tSpeed) * (dDensity ? tDensity : 1 - tDensity);
+		double corner;
+		if (!getGridPower((iDir + dDir) % nDirections, iSpeed + dSpeed, iDensity + dDensity, &corner))
+			return false;
+		*farmPower += weight * corner;
+	}
+	return true;
+}
+
+int wakeResultCache::farmPower(double windSpeed, double windDirDeg, double airPressureAtm, double TdryC, double *farmPwer)
+{
+	double airDensity = (airPressureAtm * physics::Pa_PER_Atm) / (physics::R_GAS_DRY_AIR * physics::CelciusToKelvin(TdryC));   //!Air Density, kg/m^3
+
+	double dir = fmod(windDirDeg, 360.0);
+	if (dir < 0) dir += 360.0;
+	double fDir = dir / dirStep, fSpeed = windSpeed / speedStep, fDensity = airDensity / densityStep;
+
+	// anything off the grid, including missing values, gets the full calculation
+	if (!(fDir >= 0 && fSpeed >= 0 && fDensity > 0 && fSpeed < WAKE_CACHE_MAX_INDEX && fDensity < WAKE_CACHE_MAX_INDEX))
+	{
+		nFullCalculations++;
+		return calculate(windSpeed, windDirDeg, airDensity, farmPwer) ? (int)wpc->nTurbines : 0;
+	}
+
+	int iDir = std::min(nDirections - 1, (int)fDir);
+	int iSpeed = (int)fSpeed, iDensity = (int)fDensity;
+
+	unsigned long long cell = wakeCacheKey(iDir, iSpeed, iDensity);
+	std::unordered_map<unsigned long long, bool>::const_iterator it = cellAccepted.find(cell);
+	bool accepted;
+	if (it != cellAccepted.end())
+		accepted = it->second;
+	else
+	{
+		double interpolated, exact;
+		if (!interpolate(iDir, iSpeed, iDensity, 0.5, 0.5, 0.5, &interpolated)
+			|| !calculate((iSpeed + 0.5) * speedStep, (iDir + 0.5) * dirStep, (iDensity + 0.5) * densityStep, &exact))
+			return 0;
+		accepted = fabs(interpolated - exact) <= tolerance;
+		cellAccepted[cell] = accepted;
+	}
+
+	if (!accepted)
+	{
+		nFullCalculations++;
+		return calculate(windSpeed, windDirDeg, airDensity, farmPwer) ? (int)wpc->nTurbines : 0;
+	}
+	return interpolate(iDir, iSpeed, iDensity, fDir - iDir, fSpeed - iSpeed, fDensity - iDensity, farmPwer) ? (int)wpc->nTurbines : 0;
+}
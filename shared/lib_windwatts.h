@@ -52,6 +52,7 @@
 
 #include <memory>
 #include <vector>
+#include <unordered_map>
 #include "lib_util.h"
 #include "lib_windwakemodel.h"
 
@@ -76,6 +77,16 @@ private:
 	void coordtrans(double metersNorth, double metersEast, double fWind_dir_degrees, double *fMetersDownWind, double *metersCrosswind);
 	double gammaln(double x);
 
+	/// Turbine indices sorted by downwind distance at the center of each wind direction bin, calculated when a bin is first used.
+	/// Each timestep starts from its bin's order, which is already sorted or nearly so.
+	static const int DIRECTION_BINS = 360;
+	std::vector< std::vector<size_t> > downwindOrder;
+	std::vector<double> downwindOrderX, downwindOrderY;	// coordinates the orders were calculated for
+	const std::vector<size_t> &getDownwindOrder(double windDirDeg);
+
+	std::vector<size_t> turbineOrder;		// turbine index at each position in downwind order for the current timestep
+	std::vector<double> sortedDownwind, sortedCrosswind, sortedOutput;
+
 public:
 	windTurbine* windTurb;
 	size_t nTurbines;
@@ -88,7 +99,6 @@ public:
 		errDetails="";
 	}
 	
-	static const int MAX_WIND_TURBINES = 300;	// Max turbines in the farm
 	static const int MIN_DIAM_EV = 2;			// Minimum number of rotor diameters between turbines for EV wake modeling to work
 	static const int EV_SCALE = 1;				// Uo or 1.0 depending on how you read Ainslie 1988
 
@@ -99,7 +109,6 @@ public:
 
 	std::vector<double> XCoords, YCoords;
 
-	size_t GetMaxTurbines() {return MAX_WIND_TURBINES;}
 	bool InitializeModel(std::shared_ptr<wakeModelBase>selectedWakeModel);
 	std::string GetWakeModelName();
 	std::string GetErrorDetails() { return errDetails; }
@@ -122,6 +131,10 @@ public:
 			double distCross[] // distance cross wind
 		);
 
+	/// Same as windPowerUsingResource, with the air density (kg/m^3) given instead of pressure and temperature
+	int windPowerUsingDensity(double windSpeed, double windDirDeg, double airDensity,
+		double *farmPwer, double power[], double thrust[], double eff[], double wind[], double turbul[], double distDown[], double distCross[]);
+
 	double windPowerUsingWeibull(
 		double weibull_k, 
 		double avg_speed, 
@@ -130,4 +143,43 @@ public:
 	);
 };
 
+/**
+ * wakeResultCache memoizes the farm power from windPowerCalculator over a grid of wind direction, wind speed and air density, so that
+ * a long time series only runs the wake model once per grid point. Grid points are calculated when they are first needed, and farm
+ * power between them is interpolated linearly in all three dimensions. The first time a grid cell is used, its interpolated power at
+ * the cell center is compared to the full calculation there; if they differ by more than the tolerance, given as a fraction of the
+ * farm's rated power, timesteps in that cell are always calculated in full. This catches cells spanning cut-in, cut-out or a sharp
+ * change in wake losses with direction.
+ */
+
+class wakeResultCache
+{
+private:
+	windPowerCalculator *wpc;
+	int nDirections;
+	double dirStep, speedStep, densityStep;
+	double tolerance;		// largest accepted interpolation error at a cell center, kW
+
+	std::unordered_map<unsigned long long, double> gridPower;		// farm power at each grid point calculated so far, kW
+	std::unordered_map<unsigned long long, bool> cellAccepted;		// whether interpolation is used in each grid cell checked so far
+	std::vector<double> power, thrust, eff, wind, turbul, distDown, distCross;
+	size_t nFullCalculations;
+	std::string errDetails;
+
+	bool calculate(double windSpeed, double windDirDeg, double airDensity, double *farmPower);
+	bool getGridPower(int iDir, int iSpeed, int iDensity, double *farmPower);
+	bool interpolate(int iDir, int iSpeed, int iDensity, double tDir, double tSpeed, double tDensity, double *farmPower);
+
+public:
+	wakeResultCache(windPowerCalculator *calculator, double dirStepDeg, double speedStepMS, double densityStepKgM3, double toleranceFraction);
+
+	/// Returns the number of turbines on success and 0 on error, like windPowerCalculator::windPowerUsingResource
+	int farmPower(double windSpeed, double windDirDeg, double airPressureAtm, double TdryC, double *farmPwer);
+
+	std::string GetErrorDetails() { return errDetails; }
+	size_t gridPointCount() { return gridPower.size(); }
+	size_t cellCount() { return cellAccepted.size(); }
+	size_t fullCalculationCount() { return nFullCalculations; }	// timesteps calculated in full, excluding grid points and cell checks
+};
+
 #endif
@@ -2115,8 +2115,8 @@ bool AutoPilot_S::CalculateOpticalEfficiencyTable(sp_optical_table &opttab)
 			//if(! _cancel_simulation)
 				//interop::AimpointUpdateHandler(*_SF);
             double azzen[2];
-            azzen[0] = opttab.azimuths.at(i)-180.;
-            azzen[1] = opttab.zeniths.at(j) ;
+            azzen[0] = (opttab.azimuths.at(i)-180.)*D2R;
+            azzen[1] = opttab.zeniths.at(j)*D2R;
 			//Run the performance simulation
 			if(! _cancel_simulation)
 				_SF->Simulate(azzen[0], azzen[1], P);
@@ -2264,10 +2264,17 @@ AutoPilot_MT::AutoPilot_MT()
 	_detail_callback_data = 0;
 	_summary_siminfo = 0;
 	_SF = 0;
+	_simthread = 0;
+	_queue = new LayoutSimQueue();
 	//initialize with the maximum number of threads
 	SetMaxThreadCount(999999);
 }
 
+AutoPilot_MT::~AutoPilot_MT()
+{
+	delete _queue;
+}
+
 bool AutoPilot_MT::CreateLayout(sp_layout &layout, bool do_post_process)
 {
 	/* 
@@ -2278,6 +2285,9 @@ bool AutoPilot_MT::CreateLayout(sp_layout &layout, bool do_post_process)
 	PreSimCallbackUpdate();
 	try
 	{
+		//Shadowing in the master field uses the same thread count as the simulations
+		_SF->setThreadCount(_n_threads);
+
 		//Is it possible to run a multithreaded simulation?
 		int nsim_req = _SF->calcNumRequiredSimulations();
 		if(_has_detail_callback){
@@ -2300,7 +2310,7 @@ bool AutoPilot_MT::CreateLayout(sp_layout &layout, bool do_post_process)
 
 				//update progress
 				if(_has_detail_callback)
-					_detail_siminfo->addSimulationNotice("Preparing " + my_to_string(_n_threads) + " threads for simulation");
+					_detail_siminfo->addSimulationNotice("Preparing " + my_to_string(nthreads) + " threads for simulation");
 				
 				
 				//Duplicate SF objects in memory
@@ -2308,28 +2318,18 @@ bool AutoPilot_MT::CreateLayout(sp_layout &layout, bool do_post_process)
 				SFarr = new SolarField*[nthreads];
 				for(int i=0; i<nthreads; i++){
 					SFarr[i] = new SolarField(*_SF);
+					SFarr[i]->setThreadCount( max(_n_threads / nthreads, 1) );	//cores not used by the simulation threads
 				}
 			
 				//Create sufficient results arrays in memory
 				sim_results results;
 				results.resize(nsim_req);
 						
-				//Calculate the number of simulations per thread
-				int npert = (int)ceil((float)nsim_req/(float)nthreads);
-
-				//Create thread objects
+				//Create thread objects. Simulations are handed out to the threads from a shared queue
 				_simthread = new LayoutSimThread[nthreads];
-				_n_threads_active = nthreads;	//Keep track of how many threads are active
-				_in_mt_simulation = true;
-			
-				int
-					sim_first = 0,
-					sim_last = npert;
 				for(int i=0; i<nthreads; i++){
                     std::string istr = my_to_string(i+1);
-                    _simthread[i].Setup(istr, SFarr[i], &results, &wdata, sim_first, sim_last, false, false);
-					sim_first = sim_last;
-					sim_last = min(sim_last+npert, nsim_req);
+                    _simthread[i].Setup(istr, SFarr[i], &results, &wdata, 0, nsim_req, false, false);
 				}
 				
 				if(_has_detail_callback){
@@ -2339,73 +2339,19 @@ bool AutoPilot_MT::CreateLayout(sp_layout &layout, bool do_post_process)
 				}
 				
 				//Run
-				for(int i=0; i<nthreads; i++)
-					thread( &LayoutSimThread::StartThread, std::ref( _simthread[i] ) ).detach();
-			
-
-				//Wait loop
-				while(true){
-					int nsim_done = 0, nsim_remain=0, nthread_done=0;
-					for(int i=0; i<nthreads; i++){
-						if( _simthread[i].IsFinished() )
-							nthread_done ++;
-					
-						int ns, nr;
-						_simthread[i].GetStatus(&ns, &nr);
-						nsim_done += ns;
-						nsim_remain += nr;
-					
-					
-					}
-					_sim_total = nsim_req;
-					_sim_complete = nsim_done;
-
-					if(_has_detail_callback){
-						if(! _detail_siminfo->setCurrentSimulation(nsim_done) )
-                            break;
-                    }
-					
-				
-					if(nthread_done == nthreads) break;
-					std::this_thread::sleep_for(std::chrono::milliseconds(75));
-
-				}
-
-				//Check to see whether the simulation was cancelled
-				bool cancelled = false;
-				for(int i=0; i<nthreads; i++){
-					cancelled = cancelled || _simthread[i].IsSimulationCancelled();
-				}
-			    //check to see whether simulation errored out
-                bool errored_out = false;
-                for(int i=0; i<_n_threads; i++){
-                    errored_out = errored_out || _simthread[i].IsFinishedWithErrors();
-                }
-                if( errored_out )
-                {
-                    CancelSimulation();
-                    //Get the error messages, if any
-                    string errmsgs;
-                    for(int i=0; i<_n_threads; i++){
-                        for(int j=0; j<(int)_simthread[i].GetSimMessages()->size(); j++)
-                            errmsgs.append( _simthread[i].GetSimMessages()->at(j) + "\n");
-                    }
-                    //Display error messages
-                    if(! errmsgs.empty() && _has_summary_callback)
-                        _summary_siminfo->addSimulationNotice( errmsgs.c_str() );
-            
-                }
+				_sim_total = nsim_req;
+				bool sim_ok = RunSimThreads(nthreads, nsim_req, _has_detail_callback ? _detail_siminfo : 0);
 
 	            //Clean up dynamic memory
-	            for(int i=0; i<_n_threads; i++){
+	            for(int i=0; i<nthreads; i++){
 		            delete SFarr[i];
 	            }
 	            delete [] SFarr;
 	            delete [] _simthread;
 	            _simthread = 0;
 
-	            //If the simulation was cancelled per the check above, exit out
-	            if(cancelled || errored_out){
+	            //If the simulation was cancelled or failed, exit out
+	            if(! sim_ok){
 		            return false;
 	            }
 			
@@ -2455,8 +2401,9 @@ bool AutoPilot_MT::SetMaxThreadCount(int nt)
 	//check to make sure the max number of threads is less
 	//than the machine's capacity
 	try{
-		unsigned int nmax = std::thread::hardware_concurrency();
-		_n_threads = min(max(nt,1), (int)nmax);
+		int nmax = (int)std::thread::hardware_concurrency();
+		if(nmax < 1) nmax = 1;	//hardware_concurrency() returns 0 when the count is unknown
+		_n_threads = min(max(nt,1), nmax);
 	}
 	catch(...)
 	{
@@ -2524,96 +2471,40 @@ bool AutoPilot_MT::CalculateOpticalEfficiencyTable(sp_optical_table &opttab)
 
 	//------------do the multithreaded run----------------
 	
+	int nthreads = min(_sim_total, _n_threads);
+
 	//Create copies of the solar field
 	SolarField **SFarr;
-	SFarr = new SolarField*[_n_threads];
-	for(int i=0; i<_n_threads; i++){
+	SFarr = new SolarField*[nthreads];
+	for(int i=0; i<nthreads; i++){
 		SFarr[i] = new SolarField(*_SF);
+		SFarr[i]->setThreadCount( max(_n_threads / nthreads, 1) );	//cores not used by the simulation threads
 	}
 
 	//Create sufficient results arrays in memory
 	sim_results results;
 	results.resize(_sim_total);
 						
-	//Calculate the number of simulations per thread
-	int npert = (int)ceil((float)_sim_total/(float)_n_threads);
-
-	//Create thread objects
-	_simthread = new LayoutSimThread[_n_threads];
-	_n_threads_active = _n_threads;	//Keep track of how many threads are active
-				
-	int
-		sim_first = 0,
-		sim_last = npert;
-	for(int i=0; i<_n_threads; i++){
+	//Create thread objects. Simulations are handed out to the threads from a shared queue
+	_simthread = new LayoutSimThread[nthreads];
+	for(int i=0; i<nthreads; i++){
         std::string istr = my_to_string(i);
-		_simthread[i].Setup(istr, SFarr[i], &results, &sunpos, P, sim_first, sim_last, true, false);
-		sim_first = sim_last;
-		sim_last = min(sim_last+npert, _sim_total);
-	}
-	//Run
-	for(int i=0; i<_n_threads; i++)
-		thread( &LayoutSimThread::StartThread, std::ref( _simthread[i] ) ).detach();
-			
-
-	//Wait loop
-	while(true){
-		int nsim_done = 0, nsim_remain=0, nthread_done=0;
-		for(int i=0; i<_n_threads; i++){
-			if( _simthread[i].IsFinished() )
-				nthread_done ++;
-					
-			int ns, nr;
-			_simthread[i].GetStatus(&ns, &nr);
-			nsim_done += ns;
-			nsim_remain += nr;
-					
-					
-		}
-		if(_has_summary_callback){
-			if( ! _summary_siminfo->setCurrentSimulation(nsim_done) )
-				CancelSimulation();
-		}
-		if(nthread_done == _n_threads) break;
-		std::this_thread::sleep_for(std::chrono::milliseconds(75));
+		_simthread[i].Setup(istr, SFarr[i], &results, &sunpos, P, 0, _sim_total, true, false);
 	}
 
-	//Check to see whether the simulation was cancelled
-	bool cancelled = false;
-	for(int i=0; i<_n_threads; i++){
-		cancelled = cancelled || _simthread[i].IsSimulationCancelled();
-	}
-    
-    //check to see whether simulation errored out
-    bool errored_out = false;
-    for(int i=0; i<_n_threads; i++){
-        errored_out = errored_out || _simthread[i].IsFinishedWithErrors();
-    }
-    if( errored_out )
-    {
-        CancelSimulation();
-        //Get the error messages, if any
-        string errmsgs;
-        for(int i=0; i<_n_threads; i++){
-            for(int j=0; j<(int)_simthread[i].GetSimMessages()->size(); j++)
-                errmsgs.append( _simthread[i].GetSimMessages()->at(j) + "\n");
-        }
-        //Display error messages
-        if(! errmsgs.empty() && _has_summary_callback)
-            _summary_siminfo->addSimulationNotice( errmsgs.c_str() );
-            
-    }
+	//Run
+	bool sim_ok = RunSimThreads(nthreads, _sim_total, _has_summary_callback ? _summary_siminfo : 0);
 
 	//Clean up dynamic memory
-	for(int i=0; i<_n_threads; i++){
+	for(int i=0; i<nthreads; i++){
 		delete SFarr[i];
 	}
 	delete [] SFarr;
 	delete [] _simthread;
 	_simthread = 0;
 
-	//If the simulation was cancelled per the check above, exit out
-	if(cancelled || errored_out){
+	//If the simulation was cancelled or failed, exit out
+	if(! sim_ok){
 		return false;
 	}
 
@@ -2694,96 +2585,41 @@ bool AutoPilot_MT::CalculateFluxMaps(sp_flux_table &fluxtab, int flux_res_x, int
 
 	//------------do the multithreaded run----------------
 	
+	int nthreads = min(_sim_total, _n_threads);
+
 	//Create copies of the solar field
 	SolarField **SFarr;
-	SFarr = new SolarField*[_n_threads];
-	for(int i=0; i<_n_threads; i++){
+	SFarr = new SolarField*[nthreads];
+	for(int i=0; i<nthreads; i++){
 		SFarr[i] = new SolarField(*_SF);
+		SFarr[i]->setThreadCount( max(_n_threads / nthreads, 1) );	//cores not used by the simulation threads
 	}
 
 	//Create sufficient results arrays in memory
 	sim_results results;
 	results.resize(_sim_total);
 
-	//Calculate the number of simulations per thread
-	int npert = (int)ceil((float)_sim_total/(float)_n_threads);
-
-	//Create thread objects
-	_simthread = new LayoutSimThread[_n_threads];
-	_n_threads_active = _n_threads;	//Keep track of how many threads are active
-	
-	int
-		sim_first = 0,
-		sim_last = npert;
-	for(int i=0; i<_n_threads; i++){
+	//Create thread objects. Simulations are handed out to the threads from a shared queue
+	_simthread = new LayoutSimThread[nthreads];
+	for(int i=0; i<nthreads; i++){
         std::string istr = my_to_string(i);
-        _simthread[i].Setup(istr, SFarr[i], &results, &sunpos, P, sim_first, sim_last, true, true);
+        _simthread[i].Setup(istr, SFarr[i], &results, &sunpos, P, 0, _sim_total, true, true);
 		_simthread[i].IsFluxmapNormalized(is_normalized);
-		sim_first = sim_last;
-		sim_last = min(sim_last+npert, _sim_total);
 	}
-	//Run
-	for(int i=0; i<_n_threads; i++)
-		thread( &LayoutSimThread::StartThread, std::ref( _simthread[i] ) ).detach();
-			
 
-	//Wait loop
-	while(true){
-		int nsim_done = 0, nsim_remain=0, nthread_done=0;
-		for(int i=0; i<_n_threads; i++){
-			if( _simthread[i].IsFinished() )
-				nthread_done ++;
-					
-			int ns, nr;
-			_simthread[i].GetStatus(&ns, &nr);
-			nsim_done += ns;
-			nsim_remain += nr;
-					
-					
-		}
-		if(_has_summary_callback){
-			if( ! _summary_siminfo->setCurrentSimulation(nsim_done) ) 
-				CancelSimulation();
-		}
-		if(nthread_done == _n_threads) break;
-		std::this_thread::sleep_for(std::chrono::milliseconds(75));
-	}
-
-	//Check to see whether the simulation was cancelled
-	bool cancelled = false;
-	for(int i=0; i<_n_threads; i++){
-		cancelled = cancelled || _simthread[i].IsSimulationCancelled();
-	}
-	//check to see whether simulation errored out
-    bool errored_out = false;
-    for(int i=0; i<_n_threads; i++){
-        errored_out = errored_out || _simthread[i].IsFinishedWithErrors();
-    }
-    if( errored_out )
-    {
-        CancelSimulation();
-        //Get the error messages, if any
-        string errmsgs;
-        for(int i=0; i<_n_threads; i++){
-            for(int j=0; j<(int)_simthread[i].GetSimMessages()->size(); j++)
-                errmsgs.append( _simthread[i].GetSimMessages()->at(j) + "\n");
-        }
-        //Display error messages
-        if(! errmsgs.empty() && _has_summary_callback)
-            _summary_siminfo->addSimulationNotice( errmsgs.c_str() );
-            
-    }
+	//Run
+	bool sim_ok = RunSimThreads(nthreads, _sim_total, _has_summary_callback ? _summary_siminfo : 0);
 
 	//Clean up dynamic memory
-	for(int i=0; i<_n_threads; i++){
+	for(int i=0; i<nthreads; i++){
 		delete SFarr[i];
 	}
 	delete [] SFarr;
 	delete [] _simthread;
 	_simthread = 0;
 
-	//If the simulation was cancelled per the check above, exit out
-	if(cancelled || errored_out){
+	//If the simulation was cancelled or failed, exit out
+	if(! sim_ok){
 		return false;
 	}
 
@@ -2807,9 +2643,74 @@ void AutoPilot_MT::CancelSimulation()
 	CancelMTSimulation();
 }
 
+bool AutoPilot_MT::RunSimThreads(int nthreads, int nsim, simulation_info *siminfo)
+{
+	/* 
+	Run simulations 0..nsim-1 on the first 'nthreads' prepared _simthread objects. The threads
+	take simulations from a shared queue, and progress is reported to 'siminfo' (if provided) 
+	each time a simulation finishes. A 'false' return from the progress update cancels the run.
+
+	Returns false if the simulation was cancelled or any thread finished with errors.
+	*/
+	_queue->Reset(0, nsim, nthreads);
+	_n_threads_active = nthreads;	//Keep track of how many threads are active
+	_in_mt_simulation = true;
+
+	vector<thread> threads;
+	for(int i=0; i<nthreads; i++){
+		_simthread[i].SetQueue(_queue);
+		threads.push_back( thread( &LayoutSimThread::StartThread, std::ref( _simthread[i] ) ) );
+	}
+
+	//Wait for the threads, updating progress as simulations complete
+	int nsim_done = 0;
+	bool running = true;
+	while(running){
+		running = _queue->WaitForProgress(&nsim_done);
+		_sim_complete = nsim_done;
+		if(siminfo != 0 && ! _cancel_simulation){
+			if(! siminfo->setCurrentSimulation(nsim_done) )
+				CancelSimulation();
+		}
+	}
+	for(int i=0; i<nthreads; i++)
+		threads.at(i).join();
+
+	_in_mt_simulation = false;
+
+	//Check to see whether the simulation was cancelled
+	bool cancelled = false;
+	for(int i=0; i<nthreads; i++){
+		cancelled = cancelled || _simthread[i].IsSimulationCancelled();
+	}
+    
+    //check to see whether simulation errored out
+    bool errored_out = false;
+    for(int i=0; i<nthreads; i++){
+        errored_out = errored_out || _simthread[i].IsFinishedWithErrors();
+    }
+    if( errored_out )
+    {
+        CancelSimulation();
+        //Get the error messages, if any
+        string errmsgs;
+        for(int i=0; i<nthreads; i++){
+            for(int j=0; j<(int)_simthread[i].GetSimMessages()->size(); j++)
+                errmsgs.append( _simthread[i].GetSimMessages()->at(j) + "\n");
+        }
+        //Display error messages
+        if(! errmsgs.empty() && _has_summary_callback)
+            _summary_siminfo->addSimulationNotice( errmsgs.c_str() );
+            
+    }
+
+	return !(cancelled || errored_out);
+}
+
 void AutoPilot_MT::CancelMTSimulation()
 {
 	_cancel_simulation = true;
+	_queue->Clear();
 	if(_in_mt_simulation && _simthread != 0){
 		for(int i=0; i<_n_threads_active; i++){
 			_simthread[i].CancelSimulation();
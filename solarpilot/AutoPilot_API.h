@@ -66,6 +66,7 @@ class simulation_info;
 class sim_result;
 class SolarField;
 class LayoutSimThread;
+class LayoutSimQueue;
 
 
 
@@ -168,12 +169,15 @@ class SPEXPORT AutoPilot_MT : public AutoPilot
 	int _n_threads;	//the maximum number of threads to simulate
 	int _n_threads_active;	//the number of threads currently used for simulation
 	LayoutSimThread *_simthread;
+	LayoutSimQueue *_queue;	//simulations waiting for a thread
 	bool _in_mt_simulation;
 	void CancelMTSimulation();
+	bool RunSimThreads(int nthreads, int nsim, simulation_info *siminfo);
 
 public:
 	//constructor
 	AutoPilot_MT();
+	~AutoPilot_MT();
 
 	//methods
 	bool CreateLayout(sp_layout &layout, bool do_post_process = true);
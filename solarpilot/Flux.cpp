@@ -58,6 +58,9 @@
 //#include <vector>
 #include <iostream>
 #include <algorithm>
+#ifdef SP_USE_THREADS
+#include <thread>
+#endif
 
 #include <iostream>
 #include <fstream>
@@ -2163,7 +2166,120 @@ void Flux::hermiteIntegral(double G[5], double F[5], double X[2], double A[2], d
 #endif
 }
 
-void Flux::fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvector &helios, bool clear_grid, bool norm_grid, bool show_progress){
+//Flux surface points in contiguous arrays (see Flux::fluxDensity)
+struct flux_node_arrays
+{
+	vector<double> x, y, z, ni, nj, nk;
+
+	void resize(int n)
+	{
+		x.resize(n); y.resize(n); z.resize(n);
+		ni.resize(n); nj.resize(n); nk.resize(n);
+	}
+	int size() const { return (int)x.size(); }
+};
+
+//Heliostat quantities that are constant over the flux surface (see Flux::fluxDensity)
+struct flux_helio_data
+{
+	bool is_enabled;
+	double sigx, sigy;		//normalized image size
+	double aim[3];			//aim point
+	double tht;				//receiver optical height
+	double cnorm;			//normalizing constant
+	double tvr[3];			//receiver-to-heliostat vector
+	double tvr_dot_tvr;
+	double cos_az, sin_az, cos_zen, sin_zen;	//rotation into image plane coordinates
+	const double *coefs;	//Hermite coefficients
+};
+
+static void hermiteFluxKernel(const flux_node_arrays *nodes, const flux_helio_data *hdata, int h_first, int h_last, 
+	const vector<int> *hx_index, const vector<int> *hy_index, int n_terms, double *grid)
+{
+	/* 
+	Add the flux from heliostats h_first to h_last-1 to each flux point in 'grid'. This is the
+	fluxDensity() calculation restructured so that each step runs over all flux points of a heliostat 
+	in a simple loop over contiguous arrays, which the compiler can vectorize. For each point and 
+	heliostat the arithmetic is the same as projecting with Toolbox::plane_intersect and 
+	Toolbox::rotation, and evaluating the series as in hermiteFluxEval().
+	*/
+	int nn = nodes->size();
+	int ncoef = (int)hx_index->size();
+	const double 
+		*px = &nodes->x.front(), *py = &nodes->y.front(), *pz = &nodes->z.front(),
+		*ni = &nodes->ni.front(), *nj = &nodes->nj.front(), *nk = &nodes->nk.front();
+
+	vector<double> vfdt(nn), vxn(nn), vyn(nn), vflux(nn);
+	vector<double> vHX((n_terms+2)*nn), vHY((n_terms+2)*nn);	//Hermite polynomial m of point n at [m*nn + n]
+	double 
+		*fdt = &vfdt.front(), *xn = &vxn.front(), *yn = &vyn.front(), *flux = &vflux.front(),
+		*HX = &vHX.front(), *HY = &vHY.front();
+
+	for(int h=h_first; h<h_last; h++){
+		const flux_helio_data &d = hdata[h];
+		if(! d.is_enabled)
+			continue;
+
+		//Project each flux point into the image plane and normalize by the image size
+		for(int n=0; n<nn; n++){
+			fdt[n] = ni[n]*d.tvr[0] + nj[n]*d.tvr[1] + nk[n]*d.tvr[2];
+
+			double gz = pz[n] + d.tht;	//tht include z offset
+			double pcdn = (d.aim[0] - px[n])*d.tvr[0] + (d.aim[1] - py[n])*d.tvr[1] + (d.aim[2] - gz)*d.tvr[2];
+			double dist = pcdn / d.tvr_dot_tvr;
+			//intersection relative to the aim point
+			double 
+				ix = px[n] + dist*d.tvr[0] - d.aim[0],
+				iy = py[n] + dist*d.tvr[1] - d.aim[1],
+				iz = gz + dist*d.tvr[2] - d.aim[2];
+			//rotate about z, then about x
+			double 
+				x1 = d.cos_az*ix + d.sin_az*iy,
+				y1 = -d.sin_az*ix + d.cos_az*iy,
+				y2 = d.cos_zen*y1 + d.sin_zen*iz;
+
+			xn[n] = -x1/d.tht / d.sigx;       //with delsol formulation, image is flipped in x direction. Not sure why.
+			yn[n] = y2/d.tht / d.sigy;
+		}
+
+		//Hermite polynomials
+		for(int n=0; n<nn; n++){
+			HX[n] = 1.;
+			HX[nn + n] = 0.;
+			HY[n] = 1.;
+			HY[nn + n] = 0.;
+		}
+		double FX = -2.;
+		for(int i=1; i<n_terms+1; i++){
+			FX ++;
+			double *hx0 = HX + (i-1)*nn, *hx1 = HX + i*nn, *hx2 = HX + (i+1)*nn;
+			double *hy0 = HY + (i-1)*nn, *hy1 = HY + i*nn, *hy2 = HY + (i+1)*nn;
+			for(int n=0; n<nn; n++){
+				hx2[n] = xn[n]*hx1[n] - FX*hx0[n];
+				hy2[n] = yn[n]*hy1[n] - FX*hy0[n];
+			}
+		}
+
+		//Hermite series
+		for(int n=0; n<nn; n++)
+			flux[n] = 0.;
+		for(int c=0; c<ncoef; c++){
+			double coef = d.coefs[c];
+			const double *hx = HX + hx_index->at(c)*nn, *hy = HY + hy_index->at(c)*nn;
+			for(int n=0; n<nn; n++)
+				flux[n] += coef*hx[n]*hy[n];
+		}
+
+		for(int n=0; n<nn; n++){
+			//If the dot product is negative, the point is not in view of the heliostat
+			if(fdt[n] < 0. || fdt[n] > 1.) continue;
+			double hfe = (flux[n] < 0. ? 0. : flux[n]) * exp( -0.5 *( xn[n]*xn[n] + yn[n]*yn[n]) );
+			grid[n] += fdt[n] * hfe * d.cnorm;
+		}
+	}
+}
+
+void Flux::fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvector &helios, bool clear_grid, bool norm_grid, bool show_progress, int nthreads){
 	/* 
 	Take a set of points defining the flux plane within the flux_surface object, a solar field geometry, 
 	and calculate the flux intensity at each point. Fills and returns these values into the FluxSurface
@@ -2204,6 +2320,11 @@ void Flux::fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvec
 
 	Here, (x,y) is normalized by the standard deviation of the image error in x and y respectively.
 
+	The flux points and the heliostat Hermite coefficients are copied into contiguous arrays so that
+	the Hermite series is evaluated for all flux points of a heliostat at once (see hermiteFluxKernel).
+	When nthreads > 1, the heliostats are split between threads that sum into separate grids, which 
+	are added together at the end.
+
 	*/
 	
 	//get the flux grid
@@ -2221,89 +2342,131 @@ void Flux::fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvec
 	//Get the flux surface offset
 	sp_point *offset = flux_surface.getSurfaceOffset();
 	
-	int nh = (int)helios.size();
-	if(show_progress){
-		siminfo->setTotalSimulationCount(nh);
+	//Lay out the flux points in contiguous arrays. Node n corresponds to grid point (n / nfy, n % nfy)
+	flux_node_arrays nodes;
+	nodes.resize(nfx*nfy);
+	for(int j=0; j<nfx; j++){
+		for(int k=0; k<nfy; k++){
+			FluxPoint *pt = &grid->at(j).at(k);
+			int n = j*nfy + k;
+			nodes.x[n] = pt->location.x + offset->x;	//global coordinates
+			nodes.y[n] = pt->location.y + offset->y;
+			nodes.z[n] = pt->location.z;	//relative to the receiver optical height
+			nodes.ni[n] = pt->normal.i;
+			nodes.nj[n] = pt->normal.j;
+			nodes.nk[n] = pt->normal.k;
+		}
 	}
-	//Loop through each heliostat
-	int update_every = max(nh/20,1);
 
+	//Index of the x and y Hermite polynomials for each coefficient in the heliostat coefficient arrays
+	vector<int> hx_index, hy_index;
+	for(int i=1; i<_n_terms+1; i++){
+		for(int j=JMN(i-1); j<JMX(i-1)+1; j+=2){
+			hx_index.push_back(i+1);
+			hy_index.push_back(j+1);
+		}
+	}
+	int ncoef = (int)hx_index.size();
+
+	int nh = (int)helios.size();
+
+	//Collect the heliostat quantities used by the flux kernel
+	vector<flux_helio_data> hdata(nh);
+	vector<double> coefs(nh*ncoef);
 	for(int i=0; i<nh; i++){
-		if(show_progress && i % update_every == 0)
-			siminfo->setCurrentSimulation(i+1);
-		
-        if(! helios.at(i)->IsEnabled() )
+		flux_helio_data &d = hdata.at(i);
+		Heliostat *H = helios.at(i);
+
+		d.is_enabled = H->IsEnabled();
+        if(! d.is_enabled )
             continue;
 
 		//Get the image error std dev's
-		double sigx, sigy;	
-		helios.at(i)->getImageSize(sigx, sigy);	//Image size is normalized by the tower height
+		H->getImageSize(d.sigx, d.sigy);	//Image size is normalized by the tower height
 		
 		//Get the heliostat aim point
-		sp_point *aim = helios.at(i)->getAimPoint();
+		sp_point *aim = H->getAimPoint();
+		d.aim[0] = aim->x;
+		d.aim[1] = aim->y;
+		d.aim[2] = aim->z;
 		//Get the height of the receiver that the heliostat is aiming at
-		double tht = helios.at(i)->getWhichReceiver()->getVarMap()->optical_height.Val();
+		d.tht = H->getWhichReceiver()->getVarMap()->optical_height.Val();
 
 		//Calculate the normalizing constant. This is equal to the normalized power delivered by the heliostat to the
 		//reciever divided by the tower height squared. (the tht^2 term falls out of the normalizing procedure
 		//that we previously used in defining the Hermite moments). See DELSOL 7634.
-		double cnorm = helios.at(i)->getArea() * helios.at(i)->getEfficiencyTotal()/(tht*tht);
-		//Loop through each flux point
-		//Rows
-		for(int j=0; j<nfx; j++){
-			//Cols
-			for(int k=0; k<nfy; k++){
-				//Get the flux point
-				FluxPoint *pt = &grid->at(j).at(k);
-				//Calculate the dot product between the flux point normal and the helio->tower vector
-				Vect *tv = helios.at(i)->getTowerVector();
-				Vect tvr;
-				tvr.Set( -tv->i, -tv->j, -tv->k );	//Reverse
-
-				double f_dot_t = Toolbox::dotprod(pt->normal, tvr);	
-				//If the dot product is negative, the point is not in view of the heliostat, so continue.
-				if(f_dot_t < 0.) continue;
-				if(f_dot_t>1.){
-					continue;
-				}
-				//Translate the flux point location into global coordinates
-				sp_point pt_g;
-				pt_g.Set(pt->location.x + offset->x, pt->location.y + offset->y, pt->location.z + tht); //tht include z offset
-
-				//Project the current flux point into the image plane as defined by the 
-				//aim point and the heliostat-to-receiver vector.
-				sp_point pt_ip;
-				Toolbox::plane_intersect(*aim, tvr, pt_g, tvr, pt_ip); 
-				
-				//Now the point pt_ip indicates in global coordinates the projection of the flux point onto the image plane.
-				
-				//Translate the flux point into coordinates relative to the aim point
-				pt_ip.Subtract( *aim );
-				
-				//Express this point in image plane coordinates
-                double azpt = atan2(tvr.i, tvr.j);
-                double zenpt = acos(tvr.k);
+		d.cnorm = H->getArea() * H->getEfficiencyTotal()/(d.tht*d.tht);
+
+		//Receiver-to-heliostat vector. This is both the normal of the image plane and the projection direction.
+		Vect *tv = H->getTowerVector();
+		d.tvr[0] = -tv->i;
+		d.tvr[1] = -tv->j;
+		d.tvr[2] = -tv->k;
+		d.tvr_dot_tvr = d.tvr[0]*d.tvr[0] + d.tvr[1]*d.tvr[1] + d.tvr[2]*d.tvr[2];
+
+		//Rotations that express a point in image plane coordinates
+        double azpt = atan2(d.tvr[0], d.tvr[1]);
+        double zenpt = acos(d.tvr[2]);
+		d.cos_az = cos(pi-azpt);
+		d.sin_az = sin(pi-azpt);
+		d.cos_zen = cos(zenpt);
+		d.sin_zen = sin(zenpt);
+
+		matrix_t<double> *hc = H->getHermiteCoefObject();
+		for(int c=0; c<ncoef; c++)
+			coefs.at(i*ncoef + c) = hc->at(c);
+		d.coefs = &coefs.at(i*ncoef);
+	}
 
-				Toolbox::rotation(pi-azpt, 2, pt_ip);
-				Toolbox::rotation(zenpt, 0, pt_ip);
+	//Accumulation grids, one per thread. The first one starts from the current flux values.
+	int nnode = nfx*nfy;
+	nthreads = max(1, min(nthreads, nh / 50));
+	vector<vector<double> > thread_grids(nthreads, vector<double>(nnode, 0.));
+	for(int j=0; j<nfx; j++)
+		for(int k=0; k<nfy; k++)
+			thread_grids.front().at(j*nfy + k) = grid->at(j).at(k).flux;
 
-				//This rotation now expresses pt_ip in x,y coordinates of the image plane.
+	if(show_progress){
+		siminfo->setTotalSimulationCount(nh);
+	}
+	//Loop through the heliostats in blocks, updating progress between blocks
+	int update_every = max(nh/20,1);
 
-				//Normalize the x,y coordinates with respect to the image error size
-				double
-					xn = -pt_ip.x/tht / sigx,       //with delsol formulation, image is flipped in x direction. Not sure why.
-					yn = pt_ip.y/tht / sigy;
-				
-				//Calculate the flux
-                double hfe = hermiteFluxEval(helios.at(i), xn, yn) * exp( -0.5 *( xn*xn + yn*yn) );
-                //if( hfe != hfe )
-                //{
-                //    double xxxxx = 0.;
-                //}
-				pt->flux += f_dot_t * hfe * cnorm;
+	for(int h_block=0; h_block<nh; h_block+=update_every){
+		if(show_progress)
+			siminfo->setCurrentSimulation(h_block+1);
+		
+		int h_block_end = min(h_block + update_every, nh);
+
+#ifdef SP_USE_THREADS
+		if(nthreads > 1){
+			//split the block between the threads, each summing into its own grid
+			vector<std::thread> threads;
+			int nper = (h_block_end - h_block)/nthreads;
+			for(int t=0; t<nthreads; t++){
+				int h_first = h_block + t*nper;
+				int h_last = t == nthreads-1 ? h_block_end : h_first + nper;
+				threads.push_back( std::thread( hermiteFluxKernel, &nodes, &hdata.front(), h_first, h_last, 
+					&hx_index, &hy_index, _n_terms, &thread_grids.at(t).front() ) );
 			}
+			for(int t=0; t<nthreads; t++)
+				threads.at(t).join();
 		}
+		else
+#endif
+			hermiteFluxKernel(&nodes, &hdata.front(), h_block, h_block_end, &hx_index, &hy_index, _n_terms, &thread_grids.front().front());
 	}
+
+	//Sum the thread grids into the flux surface
+	for(int j=0; j<nfx; j++){
+		for(int k=0; k<nfy; k++){
+			double flux = 0.;
+			for(int t=0; t<nthreads; t++)
+				flux += thread_grids.at(t).at(j*nfy + k);
+			grid->at(j).at(k).flux = flux;
+		}
+	}
+
 	if(show_progress){
 		siminfo->Reset();
 		siminfo->setCurrentSimulation(0);
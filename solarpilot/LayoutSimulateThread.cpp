@@ -53,6 +53,63 @@
 #ifdef SP_USE_THREADS
 
 using namespace std;
+
+LayoutSimQueue::LayoutSimQueue()
+{
+	_sim_next = _sim_last = _nsim_complete = _nthreads_running = 0;
+}
+
+void LayoutSimQueue::Reset(int sim_first, int sim_last, int nthreads)
+{
+	lock_guard<mutex> lock(_lock);
+	_sim_next = sim_first;
+	_sim_last = sim_last;
+	_nsim_complete = 0;
+	_nthreads_running = nthreads;
+}
+
+bool LayoutSimQueue::Next(int *sim)
+{
+	lock_guard<mutex> lock(_lock);
+	if(_sim_next >= _sim_last)
+		return false;
+	*sim = _sim_next++;
+	return true;
+}
+
+void LayoutSimQueue::Clear()
+{
+	lock_guard<mutex> lock(_lock);
+	_sim_next = _sim_last;
+}
+
+void LayoutSimQueue::SimulationComplete()
+{
+	{
+		lock_guard<mutex> lock(_lock);
+		_nsim_complete++;
+	}
+	_progress.notify_all();
+}
+
+void LayoutSimQueue::ThreadComplete()
+{
+	{
+		lock_guard<mutex> lock(_lock);
+		_nthreads_running--;
+	}
+	_progress.notify_all();
+}
+
+bool LayoutSimQueue::WaitForProgress(int *nsim_complete)
+{
+	unique_lock<mutex> lock(_lock);
+	int nsim_prev = *nsim_complete;
+	int nthreads_prev = _nthreads_running;
+	_progress.wait(lock, [&]{ return _nsim_complete != nsim_prev || _nthreads_running != nthreads_prev || _nthreads_running == 0; });
+	*nsim_complete = _nsim_complete;
+	return _nthreads_running > 0;
+}
 	
 void LayoutSimThread::Setup(string &tname, SolarField *SF, sim_results *results, WeatherData *wdata, 
 	int sim_first, int sim_last, bool is_shadow_detail, bool is_flux_detail)
@@ -64,6 +121,7 @@ void LayoutSimThread::Setup(string &tname, SolarField *SF, sim_results *results,
 	_SF = SF;
 	_results = results;
 	_wdata = wdata;
+	_queue = 0;
 	_sol_azzen = 0;
 	_sim_first = sim_first;
 	_sim_last = sim_last;
@@ -101,6 +159,7 @@ void LayoutSimThread::Setup(string &tname, SolarField *SF, sim_results *results,
 	_SF = SF;
 	_results = results;
 	_wdata = 0;
+	_queue = 0;
 	_sol_azzen = sol_azzen;
 	_sim_first = sim_first;
 	_sim_last = sim_last;
@@ -120,6 +179,11 @@ void LayoutSimThread::IsFluxmapNormalized(bool is_normal)
 	_is_flux_normalized = is_normal;
 }
 
+void LayoutSimThread::SetQueue(LayoutSimQueue *queue)
+{
+	_queue = queue;
+}
+
 void LayoutSimThread::CancelSimulation()
 {
 	CancelLock.lock();
@@ -185,7 +249,16 @@ void LayoutSimThread::StartThread() //Entry()
 	PrepareFieldLayout(...), and use the deep copy constructor in SolarField to create as many duplicate
 	objects as there are threads. Call this method for each duplicate object.
 
+	If a queue has been set with SetQueue(), simulations are taken from the queue instead of 
+	the sim_first..sim_last range, and the queue is notified when this thread exits.
+
 	*/
+	struct queue_exit
+	{
+		LayoutSimQueue *queue;
+		~queue_exit(){ if(queue != 0) queue->ThreadComplete(); }
+	} on_exit = { _queue };
+
     try{
         
         FinErrLock.lock();
@@ -219,7 +292,20 @@ void LayoutSimThread::StartThread() //Entry()
 	    if(_sim_last < 0) _sim_last = _wdata->size();
 
 	    int nsim = _sim_last - _sim_first + 1;
-	    for(int i=_sim_first; i<_sim_last; i++){
+		int isim = _sim_first;
+	    while(true){
+			//next simulation from the shared queue or this thread's range
+			int i;
+			if(_queue != 0){
+				if(! _queue->Next(&i))
+					break;
+			}
+			else{
+				if(isim >= _sim_last)
+					break;
+				i = isim++;
+			}
+
 		    //_SF->getSimInfoObject()->setCurrentSimulation(i+1);
 		    //double args[5];
             sim_params P;
@@ -245,8 +331,11 @@ void LayoutSimThread::StartThread() //Entry()
 			    //latitude, longitude, and elevation should be set in the input file
 			    Ambient::calcSunPosition(*_SF->getVarMap(), DT, &az, &zen, true );
 		        //If the sun is not above the horizon, don't continue
-		        if( zen > 90. )
-				        continue;
+		        if( zen > 90. ){
+					if(_queue != 0)
+						_queue->SimulationComplete();
+				    continue;
+				}
 		
 		        az *= D2R;
                 zen *= D2R;
@@ -300,6 +389,8 @@ void LayoutSimThread::StartThread() //Entry()
 
 		    //Update progress
 		    UpdateStatus(i-_sim_first+1,nsim);
+			if(_queue != 0)
+				_queue->SimulationComplete();
 		    //Check for user cancel
 		    StatusLock.lock();
 		    is_cancel = this->CancelFlag; 
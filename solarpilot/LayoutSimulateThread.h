@@ -56,6 +56,7 @@
 #ifdef SP_USE_THREADS
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 
 
 class Heliostat;	//Forward declaration
@@ -64,6 +65,35 @@ class WeatherData;
 typedef std::vector<Heliostat*> Hvector;	//Needs declaring here
 
 
+class LayoutSimQueue
+{
+	/* 
+	Simulation indices shared by a group of LayoutSimThreads. Each thread takes the next 
+	unstarted simulation until none are left, so threads that get quick simulations (e.g. 
+	sun below the horizon) pick up more of the work. The caller blocks in WaitForProgress()
+	and is woken whenever a simulation or a thread finishes.
+	*/
+	int
+		_sim_next,
+		_sim_last,
+		_nsim_complete,
+		_nthreads_running;
+	std::mutex _lock;
+	std::condition_variable _progress;
+
+public:
+	LayoutSimQueue();
+
+	void Reset(int sim_first, int sim_last, int nthreads);
+	bool Next(int *sim);		//false when all simulations have been handed out
+	void Clear();				//hand out no more simulations (cancel)
+	void SimulationComplete();
+	void ThreadComplete();
+	//wait until a simulation or thread finishes. Returns false once all threads have finished.
+	bool WaitForProgress(int *nsim_complete);
+};
+
+
 class LayoutSimThread 
 {
 	bool _is_user_sun_pos;		//Has the user specified sun positions? (opposed to day/time combos)
@@ -82,6 +112,7 @@ class LayoutSimThread
 	SolarField *_SF;
 	int _sim_first, _sim_last, _sort_metric;
 	WeatherData *_wdata;
+	LayoutSimQueue *_queue;
 	sim_results *_results;
 	matrix_t<double> *_sol_azzen;
 	sim_params _sim_params; 
@@ -104,6 +135,8 @@ public:
 
 	void IsFluxmapNormalized(bool is_normal);	//set whether the fluxmap should be normalized (default TRUE)
 
+	void SetQueue(LayoutSimQueue *queue);	//take simulations from a shared queue instead of the sim_first..sim_last range
+
 	void CancelSimulation();
 
 	bool IsSimulationCancelled();
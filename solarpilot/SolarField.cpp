@@ -50,6 +50,9 @@
 #include <assert.h>
 #include <algorithm>
 #include <math.h>
+#ifdef SP_USE_THREADS
+#include <thread>
+#endif
 
 #include "exceptions.hpp"
 #include "SolarField.h"
@@ -136,6 +139,8 @@ SolarField::SolarField(){
     _var_map = 0;
 	_is_created = false;	//The Create() method hasn't been called yet.
 	_estimated_annual_power = 0.;
+	_neighbor_key.is_valid = false;
+	_n_threads = 1;		//shadowing threads are set by the caller (see AutoPilot_MT)
 };		
 
 SolarField::~SolarField(){ 
@@ -164,8 +169,11 @@ SolarField::SolarField( const SolarField &sf )
 	_fluxsim( sf._fluxsim ),
 	_sim_info( sf._sim_info ),
 	_sim_error( sf._sim_error ),
-	_var_map( sf._var_map )    //point to original variable map
+	_var_map( sf._var_map ),    //point to original variable map
+	_n_threads( sf._n_threads )
 {
+	_neighbor_key.is_valid = false;	//the copied neighbor lists are valid, but keyed to the original heliostat objects
+
 	//------- Reconstruct pointer maps, etc ----------
 	for(int i=0; i<4; i++){
 		_helio_extents[i] = sf._helio_extents[i]; 
@@ -461,6 +469,7 @@ void SolarField::Clean(){
 	_helio_groups.clear();
 	_helio_by_id.clear();
 	_neighbors.clear();
+	_neighbor_key.is_valid = false;
 	_receivers.clear();
 	
 	_is_created = false;
@@ -568,11 +577,41 @@ bool SolarField::UpdateNeighborList(double lims[4], double zen){
 	dcol = (xmax - xmin)/float(ncol);
 	drow = (ymax - ymin)/float(nrow);			//The column and row node width
 
+	/* 
+	The mesh only depends on the sun position through the interaction radius, which is constant over 
+	most of the sky. If the mesh and the heliostat positions haven't changed since the last call, the 
+	existing neighbor lists are still correct.
+	*/
+	int Npos = (int)_helio_objects.size();
+	neighbor_mesh_key key;
+	key.is_valid = true;
+	key.nrow = nrow;
+	key.ncol = ncol;
+	key.xmin = xmin;
+	key.ymin = ymin;
+	key.dcol = dcol;
+	key.drow = drow;
+	key.helio_first = Npos > 0 ? &_helio_objects.front() : 0;
+	key.locs.resize(2*Npos);
+	for(int i=0; i<Npos; i++){
+		sp_point *loc = _helio_objects.at(i).getLocation();
+		key.locs[2*i] = loc->x;
+		key.locs[2*i+1] = loc->y;
+	}
+	
+	if(_neighbor_key.is_valid 
+		&& key.nrow == _neighbor_key.nrow && key.ncol == _neighbor_key.ncol
+		&& key.xmin == _neighbor_key.xmin && key.ymin == _neighbor_key.ymin 
+		&& key.dcol == _neighbor_key.dcol && key.drow == _neighbor_key.drow
+		&& key.helio_first == _neighbor_key.helio_first
+		&& key.locs == _neighbor_key.locs)
+		return true;
+	_neighbor_key.is_valid = false;
+
 	//resize the mesh array accordingly
 	_helio_groups.resize_fill(nrow, ncol, Hvector());
 
 	int col, row;	//indicates which node the heliostat is in
-	int Npos = (int)_helio_objects.size();
 	for(int i=0; i<Npos; i++){
 		Heliostat *hptr = &_helio_objects.at(i);
 		//Find which node to add this heliostat to
@@ -611,6 +650,7 @@ bool SolarField::UpdateNeighborList(double lims[4], double zen){
 		Heliostat *hptr = &_helio_objects.at(i);
 		hptr->setNeighborList( &_neighbors.at( hptr->getGroupId()[0], hptr->getGroupId()[1] ) );	//Set the neighbor list according to the stored _neighbors indices
 	}
+	_neighbor_key = std::move(key);
 	return true;
 
 }
@@ -3090,19 +3130,25 @@ void SolarField::Simulate(double azimuth, double zenith, sim_params &P)
 		}
 	}
 	
+	//Shadowing and blocking for all heliostats
+	calcAllShadowBlock(Sun, P);
+
 	//Simulate efficiency for all heliostats
 	for(int i=0; i<nh; i++)
-		SimulateHeliostatEfficiency(this, Sun, _heliostats.at(i), P); 
+		SimulateHeliostatEfficiency(this, Sun, _heliostats.at(i), P, false); 
 	
 	
 
 
 }
 
-void SolarField::SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliostat *helios, sim_params &P)
+void SolarField::SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliostat *helios, sim_params &P, bool calc_shadow_block)
 {
 	/*
 	Simulate the heliostats in the specified range
+
+	If calc_shadow_block is false, the shading and blocking efficiencies already set on the heliostat 
+	are used (see calcAllShadowBlock).
 	*/
 	
     //if a heliostat has been disabled, handle here and return
@@ -3142,27 +3188,30 @@ void SolarField::SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliosta
 	}
 
 	//Shadowing and blocking
-	double
-		shad_tot = 1.,
-		block_tot = 1.;
+	if(calc_shadow_block)
+	{
+		double
+			shad_tot = 1.,
+			block_tot = 1.;
 		
-	Hvector *neibs = helios->getNeighborList();
-	int nn = (int)neibs->size();
-	for(int j=0; j<nn; j++){
-		if(helios == neibs->at(j) ) continue;	//Don't calculate blocking or shading for the same heliostat
+		Hvector *neibs = helios->getNeighborList();
+		int nn = (int)neibs->size();
+		for(int j=0; j<nn; j++){
+			if(helios == neibs->at(j) ) continue;	//Don't calculate blocking or shading for the same heliostat
 		
-        if(!P.is_layout) shad_tot += -SF->calcShadowBlock(helios, neibs->at(j), 0, Sun);	//Don't calculate shadowing for layout simulations. Cascaded shadowing effects can skew the layout.
+			if(!P.is_layout) shad_tot += -SF->calcShadowBlock(helios, neibs->at(j), 0, Sun);	//Don't calculate shadowing for layout simulations. Cascaded shadowing effects can skew the layout.
 		
-        block_tot += -SF->calcShadowBlock(helios, neibs->at(j), 1, Sun);
-	}
+			block_tot += -SF->calcShadowBlock(helios, neibs->at(j), 1, Sun);
+		}
 		
-	if(shad_tot < 0.) shad_tot = 0.;
-	if(shad_tot > 1.) shad_tot = 1.;
-	helios->setEfficiencyShading(shad_tot);
+		if(shad_tot < 0.) shad_tot = 0.;
+		if(shad_tot > 1.) shad_tot = 1.;
+		helios->setEfficiencyShading(shad_tot);
 
-	if(block_tot < 0.) block_tot = 0.;
-	if(block_tot > 1.) block_tot = 1.;
-	helios->setEfficiencyBlocking(block_tot);
+		if(block_tot < 0.) block_tot = 0.;
+		if(block_tot > 1.) block_tot = 1.;
+		helios->setEfficiencyBlocking(block_tot);
+	}
 	
 	//Soiling, reflectivity, and receiver absorptance factors are included in the total calculation
 	double eta_rec_abs = Rec->getVarMap()->absorptance.val; // * eta_rec_acc,
@@ -3175,6 +3224,97 @@ void SolarField::SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliosta
 	
 }
 
+void SolarField::calcAllShadowBlock(Vect &Sun, sim_params &P)
+{
+	/* 
+	Calculate the shading and blocking efficiency of each heliostat from its neighbor list. Each heliostat 
+	only reads the tracking state of its neighbors, so the heliostats are split into contiguous ranges 
+	that are evaluated in parallel. The neighbor lists must be current (see UpdateNeighborList).
+	*/
+
+	int nh = (int)_heliostats.size();
+
+	//Don't start threads for small fields
+	int nthreads = min(_n_threads, nh / 500);
+
+	bool is_error = false;
+#ifdef SP_USE_THREADS
+	if(nthreads > 1)
+	{
+		std::vector<std::thread> threads;
+		bool *errors = new bool[nthreads];
+		int nper = nh / nthreads;
+		for(int i=0; i<nthreads; i++){
+			int h_first = i*nper;
+			int h_last = i == nthreads-1 ? nh : h_first + nper;
+			threads.push_back( std::thread( calcShadowBlockRange, this, &Sun, P.is_layout, h_first, h_last, &errors[i] ) );
+		}
+		for(int i=0; i<nthreads; i++){
+			threads.at(i).join();
+			is_error = is_error || errors[i];
+		}
+		delete [] errors;
+	}
+	else
+#endif
+		calcShadowBlockRange(this, &Sun, P.is_layout, 0, nh, &is_error);
+
+	if(is_error)
+		throw spexception("An error occurred when calculating heliostat shading and blocking.");
+}
+
+void SolarField::calcShadowBlockRange(SolarField *SF, Vect *Sun, bool is_layout, int h_first, int h_last, bool *is_error)
+{
+	/* 
+	Shading and blocking efficiency for heliostats h_first to h_last-1. This is the thread entry point for 
+	calcAllShadowBlock(), so errors are reported through 'is_error' rather than thrown.
+	*/
+	*is_error = false;
+	try{
+		Hvector *helios = SF->getHeliostats();
+		for(int i=h_first; i<h_last; i++){
+			Heliostat *H = helios->at(i);
+			if(! H->IsEnabled() ) continue;	//handled in SimulateHeliostatEfficiency
+
+			double
+				shad_tot = 1.,
+				block_tot = 1.;
+		
+			Hvector *neibs = H->getNeighborList();
+			int nn = (int)neibs->size();
+			for(int j=0; j<nn; j++){
+				Heliostat *HI = neibs->at(j);
+				if(H == HI) continue;	//Don't calculate blocking or shading for the same heliostat
+		
+				if(!is_layout) shad_tot += -SF->calcShadowBlock(H, HI, 0, *Sun);	//Don't calculate shadowing for layout simulations. Cascaded shadowing effects can skew the layout.
+		
+				block_tot += -SF->calcShadowBlock(H, HI, 1, *Sun);
+			}
+		
+			if(shad_tot < 0.) shad_tot = 0.;
+			if(shad_tot > 1.) shad_tot = 1.;
+			H->setEfficiencyShading(shad_tot);
+
+			if(block_tot < 0.) block_tot = 0.;
+			if(block_tot > 1.) block_tot = 1.;
+			H->setEfficiencyBlocking(block_tot);
+		}
+	}
+	catch(...){
+		*is_error = true;
+	}
+}
+
+void SolarField::setThreadCount(int nthreads)
+{
+	_n_threads = max(nthreads, 1);
+}
+
+int SolarField::getThreadCount()
+{
+	return _n_threads;
+}
+
 double SolarField::calcShadowBlock(Heliostat *H, Heliostat *HI, int mode, Vect &Sun)
 {
 	/*
@@ -3874,7 +4014,7 @@ void SolarField::AnalyticalFluxSimulation(Hvector &helios)
 		if(! _receivers.at(n)->isReceiverEnabled() ) continue;
 		FluxSurfaces *surfaces = _receivers.at(n)->getFluxSurfaces();
 		for(unsigned int i=0; i<surfaces->size(); i++){
-			_flux->fluxDensity(&_sim_info, surfaces->at(i), helios, true, true, true);		
+			_flux->fluxDensity(&_sim_info, surfaces->at(i), helios, true, true, true, _n_threads);		
 		}
 	}
 
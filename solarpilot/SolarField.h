@@ -168,6 +168,17 @@ protected:
 
     var_map *_var_map;
 
+	int _n_threads;	//Number of threads used for the heliostat shadowing/blocking and flux density calculations
+
+	struct neighbor_mesh_key	//Mesh dimensions and field used for the current _neighbors lists
+	{
+		bool is_valid;
+		int nrow, ncol;
+		double xmin, ymin, dcol, drow;
+		Heliostat *helio_first;	//Address of the first heliostat object
+		std::vector<double> locs;	//x and y position of each heliostat, compared exactly
+	} _neighbor_key;
+
 	class clouds : public mod_base
 	{ 
 		//members
@@ -257,8 +268,12 @@ public:
     void Simulate(double az, double zen, sim_params &P);		//Method to simulate the performance of the field
 	bool SimulateTime(int hour, int day_of_Month, int month, sim_params &P);
 	
-    static void SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliostat *helio, sim_params &P);
+    static void SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliostat *helio, sim_params &P, bool calc_shadow_block=true);
 	double calcShadowBlock(Heliostat *H, Heliostat *HS, int mode, Vect &Sun);	//Calculate the shadowing or blocking between two heliostats
+	void calcAllShadowBlock(Vect &Sun, sim_params &P);	//Shadowing and blocking efficiency for all heliostats, split across threads
+	static void calcShadowBlockRange(SolarField *SF, Vect *Sun, bool is_layout, int h_first, int h_last, bool *is_error);
+	void setThreadCount(int nthreads);
+	int getThreadCount();
 	void updateAllTrackVectors(Vect &Sun);	//Macro for calculating corner positions
 	void calcHeliostatShadows(Vect &Sun);	//Macro for calculating heliostat shadows
 	void calcAllAimPoints(Vect &Sun, sim_params &P); //bool force_simple=false, bool quiet=true); 
@@ -159,7 +159,7 @@ var_info vtab_battery_inputs[] = {
 	{ SSC_INPUT,        SSC_ARRAY,      "batt_target_power_monthly",                   "Grid target power on monthly basis",                     "kW",       "",                     "Battery",       "?=0",                        "",                             "" },
 	{ SSC_INPUT,        SSC_NUMBER,     "batt_target_choice",                          "Target power input option",                              "0/1",      "",                     "Battery",       "?=0",                        "",                             "" },
 	{ SSC_INPUT,        SSC_ARRAY,      "batt_custom_dispatch",                        "Custom battery power for every time step",               "kW",       "",                     "Battery",       "?=0",                        "",                             "" },
-	{ SSC_INPUT,        SSC_NUMBER,     "batt_dispatch_choice",                        "Battery dispatch algorithm",                             "0/1/2/3/4", "",                    "Battery",       "?=0",                        "",                             "" },
+	{ SSC_INPUT,        SSC_NUMBER,     "batt_dispatch_choice",                        "Battery dispatch algorithm",                             "0/1/2/3/4/5", "",                    "Battery",       "?=0",                        "",                             "" },
 	{ SSC_INPUT,        SSC_NUMBER,     "batt_pv_choice",                              "Prioritize PV usage for load or battery",                "0/1",      "",                     "Battery",       "?=0",                        "",                             "" },
 	{ SSC_INPUT,        SSC_ARRAY,      "batt_pv_clipping_forecast",                   "PV clipping forecast",                                   "kW",       "",                     "Battery",       "en_batt=1&batt_meter_position=1&batt_dispatch_choice=2",  "",          "" },
 	{ SSC_INPUT,        SSC_ARRAY,      "batt_pv_dc_forecast",                         "PV dc power forecast",                                   "kW",       "",                     "Battery",       "en_batt=1&batt_meter_position=1&batt_dispatch_choice=2",  "",          "" },
@@ -374,7 +374,8 @@ battstor::battstor(compute_module &cm, bool setup_model, size_t nrec, double dt_
 
 				if (batt_vars->batt_dispatch == dispatch_t::FOM_LOOK_AHEAD || 
 					batt_vars->batt_dispatch == dispatch_t::FOM_FORECAST || 
-					batt_vars->batt_dispatch == dispatch_t::FOM_LOOK_BEHIND)
+					batt_vars->batt_dispatch == dispatch_t::FOM_LOOK_BEHIND ||
+					batt_vars->batt_dispatch == dispatch_t::FOM_OPTIMIZED)
 				{
 					batt_vars->batt_look_ahead_hours = cm.as_unsigned_long("batt_look_ahead_hours");
 					batt_vars->batt_dispatch_update_frequency_hours = cm.as_double("batt_dispatch_update_frequency_hours");
@@ -928,7 +929,7 @@ void battstor::parse_configuration()
 		}
 		else if (batt_meter_position == dispatch_t::FRONT)
 		{
-			if (batt_dispatch == dispatch_t::FOM_LOOK_AHEAD) {
+			if (batt_dispatch == dispatch_t::FOM_LOOK_AHEAD || batt_dispatch == dispatch_t::FOM_OPTIMIZED) {
 				look_ahead = true;
 			}
 			else if (batt_dispatch == dispatch_t::FOM_LOOK_BEHIND) {
@@ -81,12 +81,15 @@ static var_info _cm_vtab_pvsamv1[] = {
 	{ SSC_INPUT,        SSC_ARRAY,       "albedo",                                      "User specified ground albedo",                         "0..1",     "",                              "pvsamv1",              "*",						  "LENGTH=12",					  "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "irrad_mode",                                  "Irradiance input translation mode",                    "",         "0=beam&diffuse,1=total&beam,2=total&diffuse,3=poa_reference,4=poa_pyranometer",   "pvsamv1",              "?=0",      "INTEGER,MIN=0,MAX=4",           "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "sky_model",                                   "Diffuse sky model",                                    "",         "0=isotropic,1=hkdr,2=perez",    "pvsamv1",              "?=2",                      "INTEGER,MIN=0,MAX=2",           "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "irrad_batch",                                 "Calculate POA irradiance for all time steps before the simulation", "0/1", "not available with POA irradiance input", "pvsamv1", "?=0",             "BOOLEAN",                       "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "lifetime_replay",                             "Reuse first year DC power in later years of lifetime simulations", "0/1", "not available with snow model or POA irradiance input", "pvsamv1", "?=1",   "BOOLEAN",                       "" },
 	 
 	{ SSC_INPUT,        SSC_NUMBER,      "modules_per_string",                          "Modules per string",                                    "",        "",                              "pvsamv1",              "*",                        "INTEGER,POSITIVE",              "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "strings_in_parallel",                         "String in parallel",                                    "",        "",                              "pvsamv1",              "*",                        "INTEGER,POSITIVE",              "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "inverter_count",                              "Number of inverters",                                   "",        "",                              "pvsamv1",              "*",                        "INTEGER,POSITIVE",              "" },
 	
 	{ SSC_INPUT,        SSC_NUMBER,      "enable_mismatch_vmax_calc",                   "Enable mismatched subarray Vmax calculation",           "",        "",                              "pvsamv1",              "?=0",                      "BOOLEAN",                       "" },
+	{ SSC_INPUT,        SSC_STRING,      "shading_db_file",                             "Pre-decoded shading database file",                     "",        "Memory mapped if it exists, otherwise written from the built-in database", "pvsamv1", "?",              "",                              "" },
 
 	{ SSC_INPUT,        SSC_NUMBER,      "subarray1_tilt",                              "Sub-array 1 Tilt",                                      "deg",     "0=horizontal,90=vertical",      "pvsamv1",              "naof:subarray1_tilt_eq_lat", "MIN=0,MAX=90",                "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "subarray1_tilt_eq_lat",                       "Sub-array 1 Tilt=latitude override",                    "0/1",     "",                              "pvsamv1",              "na:subarray1_tilt",          "BOOLEAN",                     "" },
@@ -820,7 +823,7 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 	}
 	else if ( is_assigned( "solar_resource_data" ) )
 	{
-		wdprov = smart_ptr<weather_data_provider>::ptr( new weatherdata( lookup("solar_resource_data") ) );
+		wdprov = smart_ptr<weather_data_provider>::ptr( new weatherdata( lookup("solar_resource_data"), true ) );
 		if (wdprov->has_message()) log(wdprov->message(), SSC_WARNING);
 	}
 	else
@@ -997,7 +1000,11 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 	if (create_shade_db)
 	{
 		p_shade_db = smart_ptr<ShadeDB8_mpp>::ptr(new ShadeDB8_mpp());
-		p_shade_db->init();
+		p_shade_db->init( is_assigned("shading_db_file") ? as_string("shading_db_file") : std::string() );
+		if ( !p_shade_db->get_error().empty() )
+			throw exec_error("pvsamv1", "shading database: " + p_shade_db->get_error());
+		if ( !p_shade_db->get_warning().empty() )
+			log( "shading database: " + p_shade_db->get_warning(), SSC_WARNING );
 	}
 
 
@@ -1525,7 +1532,7 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 	std::unique_ptr<SharedInverter> sharedInverter(new SharedInverter(inv_type, num_inverters, &snlinv, &plinv));
 
 	// Warning workaround
-	static bool is32BitLifetime = (__ARCHBITS__ == 32 && system_use_lifetime_output);
+	bool is32BitLifetime = (__ARCHBITS__ == 32 && system_use_lifetime_output);
 	if (is32BitLifetime)
 		throw exec_error( "pvsamv1", "Lifetime simulation of PV systems is only available in the 64 bit version of SAM.");
 
@@ -1579,14 +1586,14 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 
 	// output arrays for weather info- same for all four subarrays	
 	ssc_number_t *p_glob = allocate( "gh", nrec );
-	ssc_number_t *p_beam = allocate("dn", nrec);
-	ssc_number_t *p_diff = allocate("df", nrec);
-	ssc_number_t *p_wfpoa = allocate("wfpoa", nrec);    // POA irradiance from weather file
-	ssc_number_t *p_sunpos_hour = allocate("sunpos_hour", nrec);
-	ssc_number_t *p_wspd = allocate("wspd", nrec);
-	ssc_number_t *p_tdry = allocate("tdry", nrec);
-	ssc_number_t *p_albedo = allocate("alb", nrec);
-	ssc_number_t *p_snowdepth = allocate("snowdepth", nrec);
+	ssc_number_t *p_beam = allocate_output("dn", nrec);
+	ssc_number_t *p_diff = allocate_output("df", nrec);
+	ssc_number_t *p_wfpoa = allocate_output("wfpoa", nrec);    // POA irradiance from weather file
+	ssc_number_t *p_sunpos_hour = allocate_output("sunpos_hour", nrec);
+	ssc_number_t *p_wspd = allocate_output("wspd", nrec);
+	ssc_number_t *p_tdry = allocate_output("tdry", nrec);
+	ssc_number_t *p_albedo = allocate_output("alb", nrec);
+	ssc_number_t *p_snowdepth = allocate_output("snowdepth", nrec);
 
 	//set up the calculated components of irradiance such that they aren't reported if they aren't assigned
 	//three possible calculated irradiance: gh, df, dn
@@ -1596,11 +1603,11 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 	if (radmode == GH_DF || radmode == POA_R || radmode == POA_P) p_irrad_calc[2] = allocate("dn_calc", nrec);
 
 	//output arrays for solar position calculations- same for all four subarrays
-	ssc_number_t *p_solzen = allocate("sol_zen", nrec);
-	ssc_number_t *p_solalt = allocate("sol_alt", nrec);
-	ssc_number_t *p_solazi = allocate("sol_azi", nrec);
-	ssc_number_t *p_airmass = allocate("airmass", nrec);
-	ssc_number_t *p_sunup = allocate("sunup", nrec);
+	ssc_number_t *p_solzen = allocate_output("sol_zen", nrec);
+	ssc_number_t *p_solalt = allocate_output("sol_alt", nrec);
+	ssc_number_t *p_solazi = allocate_output("sol_azi", nrec);
+	ssc_number_t *p_airmass = allocate_output("airmass", nrec);
+	ssc_number_t *p_sunup = allocate_output("sunup", nrec);
 
 	/*
 	ssc_number_t *p_nonlinear_dc_derate0 = allocate("p_nonlinear_dc_derate0", nrec);
@@ -1658,9 +1665,9 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 
 
 	// transformer loss outputs
-	ssc_number_t *p_xfmr_nll_ts = allocate("xfmr_nll_ts", nrec);
-	ssc_number_t *p_xfmr_ll_ts = allocate("xfmr_ll_ts", nrec);
-	ssc_number_t *p_xfmr_loss_ts = allocate("xfmr_loss_ts", nrec);
+	ssc_number_t *p_xfmr_nll_ts = allocate_output("xfmr_nll_ts", nrec);
+	ssc_number_t *p_xfmr_ll_ts = allocate_output("xfmr_ll_ts", nrec);
+	ssc_number_t *p_xfmr_loss_ts = allocate_output("xfmr_loss_ts", nrec);
 
 
 	ssc_number_t xfmr_rating = (ssc_number_t)(ratedACOutput * util::watt_to_kilowatt); // W to kW
@@ -1674,46 +1681,46 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 		if ( sa[nn].enable )
 		{
 			std::string prefix = "subarray" + util::to_string( (int)(nn+1) ) + "_";
-			p_aoi[nn]        = allocate( prefix+"aoi", nrec );
-			p_surftilt[nn]   = allocate( prefix+"surf_tilt", nrec);
-			p_surfazi[nn]    = allocate( prefix+"surf_azi", nrec);		
-			p_rot[nn]        = allocate( prefix+"axisrot", nrec );
-			p_idealrot[nn]   = allocate( prefix+"idealrot", nrec);
-			p_poanom[nn]     = allocate( prefix+"poa_nom", nrec);
-			p_poashaded[nn] = allocate(prefix + "poa_shaded", nrec);
-			p_poaeffbeam[nn]    = allocate( prefix+"poa_eff_beam", nrec );
-			p_poaeffdiff[nn]    = allocate( prefix+"poa_eff_diff", nrec );
-			p_poaeff[nn]   = allocate( prefix+"poa_eff", nrec );		
-			p_soiling[nn]    = allocate( prefix+"soiling_derate", nrec);
-			p_shad[nn]       = allocate( prefix+"beam_shading_factor", nrec );
-			p_tcell[nn]      = allocate( prefix+"celltemp", nrec );
-			p_modeff[nn]     = allocate( prefix+"modeff", nrec );
-			p_dcv[nn]        = allocate( prefix+"dc_voltage", nrec );
-			p_voc[nn]        = allocate( prefix+"voc", nrec );
-			p_isc[nn]        = allocate( prefix+"isc", nrec );
-			p_dcsubarray[nn] = allocate( prefix+"dc_gross", nrec );
-			p_linear_derate[nn] = allocate(prefix + "linear_derate", nrec);
-			p_ss_derate[nn] = allocate(prefix + "ss_derate", nrec);
-			p_ss_diffuse_derate[nn] = allocate(prefix + "ss_diffuse_derate", nrec);
-			p_ss_reflected_derate[nn] = allocate(prefix + "ss_reflected_derate", nrec);
+			p_aoi[nn]        = allocate_output( prefix+"aoi", nrec );
+			p_surftilt[nn]   = allocate_output( prefix+"surf_tilt", nrec);
+			p_surfazi[nn]    = allocate_output( prefix+"surf_azi", nrec);		
+			p_rot[nn]        = allocate_output( prefix+"axisrot", nrec );
+			p_idealrot[nn]   = allocate_output( prefix+"idealrot", nrec);
+			p_poanom[nn]     = allocate_output( prefix+"poa_nom", nrec);
+			p_poashaded[nn] = allocate_output(prefix + "poa_shaded", nrec);
+			p_poaeffbeam[nn]    = allocate_output( prefix+"poa_eff_beam", nrec );
+			p_poaeffdiff[nn]    = allocate_output( prefix+"poa_eff_diff", nrec );
+			p_poaeff[nn]   = allocate_output( prefix+"poa_eff", nrec );		
+			p_soiling[nn]    = allocate_output( prefix+"soiling_derate", nrec);
+			p_shad[nn]       = allocate_output( prefix+"beam_shading_factor", nrec );
+			p_tcell[nn]      = allocate_output( prefix+"celltemp", nrec );
+			p_modeff[nn]     = allocate_output( prefix+"modeff", nrec );
+			p_dcv[nn]        = allocate_output( prefix+"dc_voltage", nrec );
+			p_voc[nn]        = allocate_output( prefix+"voc", nrec );
+			p_isc[nn]        = allocate_output( prefix+"isc", nrec );
+			p_dcsubarray[nn] = allocate_output( prefix+"dc_gross", nrec );
+			p_linear_derate[nn] = allocate_output(prefix + "linear_derate", nrec);
+			p_ss_derate[nn] = allocate_output(prefix + "ss_derate", nrec);
+			p_ss_diffuse_derate[nn] = allocate_output(prefix + "ss_diffuse_derate", nrec);
+			p_ss_reflected_derate[nn] = allocate_output(prefix + "ss_reflected_derate", nrec);
 
 			if (en_snow_model){
-				p_snowloss[nn] = allocate(prefix + "snow_loss", nrec);
-				p_snowcoverage[nn] = allocate(prefix + "snow_coverage", nrec);
+				p_snowloss[nn] = allocate_output(prefix + "snow_loss", nrec);
+				p_snowcoverage[nn] = allocate_output(prefix + "snow_coverage", nrec);
 			}
 
 #ifdef SHADE_DB_OUTPUTS
 			// ShadeDB validation
-			p_shadedb_gpoa[nn] = allocate("shadedb_" + prefix + "gpoa", nrec);
-			p_shadedb_dpoa[nn] = allocate("shadedb_" + prefix + "dpoa", nrec);
-			p_shadedb_pv_cell_temp[nn] = allocate("shadedb_" + prefix + "pv_cell_temp", nrec);
-			p_shadedb_mods_per_str[nn] = allocate("shadedb_" + prefix + "mods_per_str", nrec);
-			p_shadedb_str_vmp_stc[nn] = allocate("shadedb_" + prefix + "str_vmp_stc", nrec);
-			p_shadedb_mppt_lo[nn] = allocate("shadedb_" + prefix + "mppt_lo", nrec);
-			p_shadedb_mppt_hi[nn] = allocate("shadedb_" + prefix + "mppt_hi", nrec);
+			p_shadedb_gpoa[nn] = allocate_output("shadedb_" + prefix + "gpoa", nrec);
+			p_shadedb_dpoa[nn] = allocate_output("shadedb_" + prefix + "dpoa", nrec);
+			p_shadedb_pv_cell_temp[nn] = allocate_output("shadedb_" + prefix + "pv_cell_temp", nrec);
+			p_shadedb_mods_per_str[nn] = allocate_output("shadedb_" + prefix + "mods_per_str", nrec);
+			p_shadedb_str_vmp_stc[nn] = allocate_output("shadedb_" + prefix + "str_vmp_stc", nrec);
+			p_shadedb_mppt_lo[nn] = allocate_output("shadedb_" + prefix + "mppt_lo", nrec);
+			p_shadedb_mppt_hi[nn] = allocate_output("shadedb_" + prefix + "mppt_hi", nrec);
 
 #endif
-			p_shadedb_shade_frac[nn] = allocate("shadedb_" + prefix + "shade_frac", nrec);
+			p_shadedb_shade_frac[nn] = allocate_output("shadedb_" + prefix + "shade_frac", nrec);
 		}
 	}
 		
@@ -1727,14 +1734,14 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 	ssc_number_t *p_dcsnowloss = allocate("dc_snow_loss", nrec);
 
 	ssc_number_t *p_inv_dc_voltage = allocate( "inverter_dc_voltage", nlifetime);
-	ssc_number_t *p_inveff = allocate("inv_eff", nrec);
+	ssc_number_t *p_inveff = allocate_output("inv_eff", nrec);
 	ssc_number_t *p_invcliploss = allocate( "inv_cliploss", nrec );
 	ssc_number_t *p_invmpptloss = allocate("dc_invmppt_loss", nrec);
 		
 	ssc_number_t *p_invpsoloss = allocate( "inv_psoloss", nrec );
 	ssc_number_t *p_invpntloss = allocate( "inv_pntloss", nrec );
-	ssc_number_t *p_ac_wiringloss = allocate("ac_wiring_loss", nrec);
-	ssc_number_t *p_transmissionloss = allocate("ac_transmission_loss", nrec);
+	ssc_number_t *p_ac_wiringloss = allocate_output("ac_wiring_loss", nrec);
+	ssc_number_t *p_transmissionloss = allocate_output("ac_transmission_loss", nrec);
 
 	// lifetime outputs
 	ssc_number_t *p_dcpwr = allocate("dc_net", nlifetime);
@@ -1915,6 +1922,94 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 			wdprov->rewind();
 		}
 	}
+	// Optionally calculate sun position and POA irradiance for every weather record up front.  The irradiance
+	// is the same in every year of a lifetime simulation, so each subarray is only processed once.
+	bool use_irrad_batch = as_boolean("irrad_batch");
+	if (use_irrad_batch && (radmode == POA_R || radmode == POA_P))
+	{
+		log("Whole-year irradiance calculation is not available with POA irradiance input, irradiance is calculated at each time step", SSC_NOTICE);
+		use_irrad_batch = false;
+	}
+
+	irrad_batch sa_irrad[4];
+	if (use_irrad_batch)
+	{
+		// same missing and out of range handling as in the simulation loop below, without the messages
+		irrad_timeseries its;
+		its.resize(nrec);
+		for (size_t i = 0; i < nrec; i++)
+		{
+			if (!wdprov->read(&wf))
+				throw exec_error("pvsamv1", "could not read data line " + util::to_string((int)(i + 1)) + " in weather file");
+
+			its.year[i] = wf.year;
+			its.month[i] = wf.month;
+			its.day[i] = wf.day;
+			its.hour[i] = wf.hour;
+			its.minute[i] = wf.minute;
+			its.gh[i] = (wf.gh < 0 || wf.gh > 1500) ? 0 : wf.gh;
+			its.dn[i] = (wf.dn < 0 || wf.dn > 1500) ? 0 : wf.dn;
+			its.df[i] = (wf.df < 0 || wf.df > 1500) ? 0 : wf.df;
+
+			int month_idx = wf.month - 1;
+			if (use_wf_alb && std::isfinite(wf.alb) && wf.alb > 0 && wf.alb < 1)
+				its.alb[i] = wf.alb;
+			else if (month_idx >= 0 && month_idx < 12)
+				its.alb[i] = alb_array[month_idx];
+			else
+				its.alb[i] = 0.2; // invalid month, reported in the simulation loop
+		}
+		wdprov->rewind();
+
+		for (int nn = 0; nn < 4; nn++)
+		{
+			if (!sa[nn].enable
+				|| sa[nn].nstrings < 1)
+				continue;
+
+			if (sa[nn].track_mode == 4) //timeseries tilt input
+			{
+				its.tilt.resize(nrec);
+				for (size_t i = 0; i < nrec; i++)
+				{
+					int month_idx = its.month[i] - 1;
+					its.tilt[i] = (month_idx >= 0 && month_idx < 12) ? sa[nn].monthly_tilt[month_idx] : sa[nn].tilt;
+				}
+			}
+			else
+				its.tilt.clear();
+
+			sa_irrad[nn].set_location(hdr.lat, hdr.lon, hdr.tz);
+			sa_irrad[nn].set_sky_model(skymodel);
+			sa_irrad[nn].set_radmode(radmode);
+			sa_irrad[nn].set_surface(sa[nn].track_mode,
+				sa[nn].tilt,
+				sa[nn].azimuth,
+				sa[nn].rotlim,
+				sa[nn].backtrack == 1, // mode 1 is backtracking enabled
+				sa[nn].gcr);
+			sa_irrad[nn].set_time_step(instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour);
+
+			int code = sa_irrad[nn].calc(its);
+			if (code != 0)
+				throw exec_error("pvsamv1",
+				util::format("failed to calculate irradiance incident on surface (POA) %d (code: %d)", nn + 1, code));
+		}
+	}
+
+	// in lifetime simulations the irradiance, shading, cell temperature and module power calculations
+	// are the same in every year, so later years replay the first year dc power and voltage and only
+	// apply degradation, availability and lifetime losses.  the snow model and POA decomposition carry
+	// state from one year into the next, so they are always recalculated
+	bool lifetime_replay = nyears > 1 && as_boolean("lifetime_replay")
+		&& !en_snow_model && radmode != POA_R && radmode != POA_P;
+	std::vector<double> dc_replay_net, dc_replay_voltage;
+	if (lifetime_replay)
+	{
+		dc_replay_net.resize(nrec);
+		dc_replay_voltage.resize(nrec);
+	}
+
 	/* *********************************************************************************************
 	PV DC calculation
 	*********************************************************************************************** */
@@ -1951,684 +2046,755 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 				//						iyear, hour, jj, cur_load), SSC_WARNING, (float)idx);
 				p_load_full.push_back((ssc_number_t)cur_load);
 
-				if (!wdprov->read(&wf))
-					throw exec_error("pvsamv1", "could not read data line " + util::to_string((int)(idx + 1)) + " in weather file");
-
-				//update POA data structure indicies if radmode is POA model is enabled
-				if (radmode == POA_R || radmode == POA_P){
-					for (int nn = 0; nn < 4; nn++){
-						if (!sa[nn].enable) continue;
-
-						sa[nn].poa.poaAll.tDew = wf.tdew;
-						sa[nn].poa.poaAll.i = idx;
-						if (jj == 0 && wf.hour == 0) {
-							sa[nn].poa.poaAll.dayStart = idx;
-							sa[nn].poa.poaAll.doy += 1;
-						}
-
-					}
-				}
-
-				double solazi = 0, solzen = 0, solalt = 0;
-				int sunup = 0;
 				double dcpwr_net = 0.0, dc_string_voltage = 0.0;
-				double alb = 0.2;
-
-				// accumulators for radiation power (W) over this 
-				// timestep from each subarray
-				double ts_accum_poa_nom = 0.0;
-				double ts_accum_poa_beam_nom = 0.0;
-				double ts_accum_poa_shaded = 0.0;
-				double ts_accum_poa_eff = 0.0;
-				double ts_accum_poa_beam_eff = 0.0;
-
-				int month_idx = wf.month - 1;
-
-				if (use_wf_alb && std::isfinite(wf.alb) && wf.alb > 0 && wf.alb < 1)
-					alb = wf.alb;
-				else if (month_idx >= 0 && month_idx < 12)
-					alb = alb_array[month_idx];
+				if (lifetime_replay && iyear > 0)
+				{
+					// same weather record in every year, only the losses below change
+					dcpwr_net = dc_replay_net[idx % nrec];
+					dc_string_voltage = dc_replay_voltage[idx % nrec];
+				}
 				else
-					throw exec_error("pvsamv1",
-					util::format("Error retrieving albedo value: Invalid month in weather file or invalid albedo value in weather file"));
-
-				// calculate incident irradiance on each subarray
-				for (int nn = 0; nn < 4; nn++)
 				{
-					if (!sa[nn].enable
-						|| sa[nn].nstrings < 1)
-						continue; // skip disabled subarrays
-#define IRRMAX 1500
-					// Sev 2015-09-15 Update check for bad irradiance values
-
-					// Check for missing data
-					// *note this method may not work for all compilers (lookin at you, MACs!)
-					if ((wf.gh != wf.gh) && (radmode == DN_GH || radmode == GH_DF)){
-						log(util::format("missing global irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
-							wf.gh, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
-						return;
-					}
-					if ((wf.dn != wf.dn) && (radmode == DN_DF || radmode == DN_GH)){
-						log(util::format("missing beam irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
-							wf.dn, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
-						return;
-					}
-					if ((wf.df != wf.df) && (radmode == DN_DF || radmode == GH_DF)){
-						log(util::format("missing diffuse irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
-							wf.df, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
-						return;
-					}
-					if ((wf.poa != wf.poa) && (radmode == POA_R || radmode == POA_P)){
-						log(util::format("missing POA irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
-							wf.poa, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
-						return;
-					}
-					if (wf.tdry != wf.tdry){
-						log(util::format("missing temperature %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
-							wf.tdry, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
-						return;
-					}
-					if (wf.wspd != wf.wspd){
-						log(util::format("missing wind speed %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
-							wf.wspd, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
-						return;
-					}
+					if (!wdprov->read(&wf))
+						throw exec_error("pvsamv1", "could not read data line " + util::to_string((int)(idx + 1)) + " in weather file");
+
+					//update POA data structure indicies if radmode is POA model is enabled
+					if (radmode == POA_R || radmode == POA_P){
+						for (int nn = 0; nn < 4; nn++){
+							if (!sa[nn].enable) continue;
+
+							sa[nn].poa.poaAll.tDew = wf.tdew;
+							sa[nn].poa.poaAll.i = idx;
+							if (jj == 0 && wf.hour == 0) {
+								sa[nn].poa.poaAll.dayStart = idx;
+								sa[nn].poa.poaAll.doy += 1;
+							}
 
-					// Check for bad data
-					if ((wf.gh < 0 || wf.gh > IRRMAX) && (radmode == DN_GH || radmode == GH_DF))
-					{
-						log(util::format("out of range global irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero",
-							wf.gh, wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
-						wf.gh = 0;
-					}
-					if ((wf.dn < 0 || wf.dn > IRRMAX) && (radmode == DN_DF || radmode == DN_GH))
-					{
-						log(util::format("out of range beam irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero",
-							wf.dn, wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
-						wf.dn = 0;
-					}
-					if ((wf.df < 0 || wf.df > IRRMAX) && (radmode == DN_DF || radmode == GH_DF))
-					{
-						log(util::format("out of range diffuse irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero",
-							wf.df, wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
-						wf.df = 0;
-					}
-					if ((wf.poa < 0 || wf.poa > IRRMAX) && (radmode == POA_R || radmode == POA_P))
-					{
-						log(util::format("out of range POA irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero",
-							wf.poa, wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
-						wf.poa = 0;
+						}
 					}
 
-					irrad irr;
-					irr.set_time(wf.year, wf.month, wf.day, wf.hour, wf.minute,
-						instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour);
-					irr.set_location(hdr.lat, hdr.lon, hdr.tz);
+					double solazi = 0, solzen = 0, solalt = 0;
+					int sunup = 0;
+					double alb = 0.2;
 
-					irr.set_sky_model(skymodel, alb);
-					if (radmode == DN_DF) irr.set_beam_diffuse(wf.dn, wf.df);
-					else if (radmode == DN_GH) irr.set_global_beam(wf.gh, wf.dn);
-					else if (radmode == GH_DF) irr.set_global_diffuse(wf.gh, wf.df);
-					else if (radmode == POA_R) irr.set_poa_reference(wf.poa, &sa[nn].poa.poaAll);
-					else if (radmode == POA_P) irr.set_poa_pyranometer(wf.poa, &sa[nn].poa.poaAll);
+					// accumulators for radiation power (W) over this 
+					// timestep from each subarray
+					double ts_accum_poa_nom = 0.0;
+					double ts_accum_poa_beam_nom = 0.0;
+					double ts_accum_poa_shaded = 0.0;
+					double ts_accum_poa_eff = 0.0;
+					double ts_accum_poa_beam_eff = 0.0;
 
-					if (sa[nn].track_mode == 4) //timeseries tilt input
-						sa[nn].tilt = sa[nn].monthly_tilt[month_idx]; //overwrite the tilt input with the current tilt to be used in calculations
-
-					irr.set_surface(sa[nn].track_mode,
-						sa[nn].tilt,
-						sa[nn].azimuth,
-						sa[nn].rotlim,
-						sa[nn].backtrack == 1, // mode 1 is backtracking enabled
-						sa[nn].gcr);
-
-					int code = irr.calc();
+					int month_idx = wf.month - 1;
 
-					if (code != 0)
+					if (use_wf_alb && std::isfinite(wf.alb) && wf.alb > 0 && wf.alb < 1)
+						alb = wf.alb;
+					else if (month_idx >= 0 && month_idx < 12)
+						alb = alb_array[month_idx];
+					else
 						throw exec_error("pvsamv1",
-						util::format("failed to calculate irradiance incident on surface (POA) %d (code: %d) [y:%d m:%d d:%d h:%d]",
-						nn + 1, code, wf.year, wf.month, wf.day, wf.hour));
+						util::format("Error retrieving albedo value: Invalid month in weather file or invalid albedo value in weather file"));
 
-					// p_irrad_calc is only weather file records long...
-					if (iyear == 0)
+					// calculate incident irradiance on each subarray
+					for (int nn = 0; nn < 4; nn++)
 					{
-						if (radmode == POA_R || radmode == POA_P) {
-							double gh_temp, df_temp, dn_temp;
-							gh_temp = df_temp = dn_temp = 0;
-							irr.get_irrad(&gh_temp, &dn_temp, &df_temp);
-							p_irrad_calc[1][idx] = (ssc_number_t)df_temp;
-							p_irrad_calc[2][idx] = (ssc_number_t)dn_temp;
+						if (!sa[nn].enable
+							|| sa[nn].nstrings < 1)
+							continue; // skip disabled subarrays
+	#define IRRMAX 1500
+						// Sev 2015-09-15 Update check for bad irradiance values
+
+						// Check for missing data
+						// *note this method may not work for all compilers (lookin at you, MACs!)
+						if ((wf.gh != wf.gh) && (radmode == DN_GH || radmode == GH_DF)){
+							log(util::format("missing global irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
+								wf.gh, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
+							return;
+						}
+						if ((wf.dn != wf.dn) && (radmode == DN_DF || radmode == DN_GH)){
+							log(util::format("missing beam irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
+								wf.dn, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
+							return;
+						}
+						if ((wf.df != wf.df) && (radmode == DN_DF || radmode == GH_DF)){
+							log(util::format("missing diffuse irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
+								wf.df, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
+							return;
+						}
+						if ((wf.poa != wf.poa) && (radmode == POA_R || radmode == POA_P)){
+							log(util::format("missing POA irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
+								wf.poa, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
+							return;
+						}
+						if (wf.tdry != wf.tdry){
+							log(util::format("missing temperature %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
+								wf.tdry, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
+							return;
+						}
+						if (wf.wspd != wf.wspd){
+							log(util::format("missing wind speed %lg W/m2 at time [y:%d m:%d d:%d h:%d], exiting",
+								wf.wspd, wf.year, wf.month, wf.day, wf.hour), SSC_ERROR, (float)idx);
+							return;
 						}
-					}
-					// beam, skydiff, and grounddiff IN THE PLANE OF ARRAY
-					double ibeam, iskydiff, ignddiff;
-					double ipoa=0; // Container for direct POA measurements
-					double aoi, stilt, sazi, rot, btd;
-
-
-					// Ensure that the usePOAFromWF flag is false unless a reference cell has been used. 
-					//  This will later get forced to false if any shading has been applied (in any scenario)
-					//  also this will also be forced to false if using the cec mcsp thermal model OR if using the spe module model with a diffuse util. factor < 1.0
-					sa[nn].poa.usePOAFromWF = false;
-					if (radmode == POA_R){
-						ipoa = wf.poa;
-						sa[nn].poa.usePOAFromWF = true;
-					}
-					else if (radmode == POA_P){
-						ipoa = wf.poa;
-					}
-
-					if (speForceNoPOA && (radmode == POA_R || radmode == POA_P)){  // only will be true if using a poa model AND spe module model AND spe_fp is < 1
-						sa[nn].poa.usePOAFromWF = false;
-						if (idx == 0)
-							log("The combination of POA irradiance as in input, single point efficiency module model, and module diffuse utilization factor less than one means that SAM must use a POA decomposition model to calculate the incident diffuse irradiance", SSC_WARNING);
-					}
-
-					if (mcspForceNoPOA && (radmode == POA_R || radmode == POA_P)){
-						sa[nn].poa.usePOAFromWF = false;
-						if (idx == 0)
-							log("The combination of POA irradiance as input and heat transfer method for cell temperature means that SAM must use a POA decomposition model to calculate the beam irradiance required by the cell temperature model", SSC_WARNING);
-					}
-
 
-					// Get Incident angles and irradiances
+						// Check for bad data
+						if ((wf.gh < 0 || wf.gh > IRRMAX) && (radmode == DN_GH || radmode == GH_DF))
+						{
+							log(util::format("out of range global irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero",
+								wf.gh, wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
+							wf.gh = 0;
+						}
+						if ((wf.dn < 0 || wf.dn > IRRMAX) && (radmode == DN_DF || radmode == DN_GH))
+						{
+							log(util::format("out of range beam irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero",
+								wf.dn, wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
+							wf.dn = 0;
+						}
+						if ((wf.df < 0 || wf.df > IRRMAX) && (radmode == DN_DF || radmode == GH_DF))
+						{
+							log(util::format("out of range diffuse irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero",
+								wf.df, wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
+							wf.df = 0;
+						}
+						if ((wf.poa < 0 || wf.poa > IRRMAX) && (radmode == POA_R || radmode == POA_P))
+						{
+							log(util::format("out of range POA irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero",
+								wf.poa, wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
+							wf.poa = 0;
+						}
 
-					irr.get_sun(&solazi, &solzen, &solalt, 0, 0, 0, &sunup, 0, 0, 0);
-					irr.get_angles(&aoi, &stilt, &sazi, &rot, &btd);
-					irr.get_poa(&ibeam, &iskydiff, &ignddiff, 0, 0, 0);
+						if (sa[nn].track_mode == 4) //timeseries tilt input
+							sa[nn].tilt = sa[nn].monthly_tilt[month_idx]; //overwrite the tilt input with the current tilt to be used in calculations
 
-					if (iyear == 0)
-						p_sunpos_hour[idx] = (ssc_number_t)irr.get_sunpos_calc_hour();
+						// weather file record index, the same in every year
+						size_t irec = idx % nrec;
 
-					// save weather file beam, diffuse, and global for output and for use later in pvsamv1- year 1 only
-					/*jmf 2016: these calculations are currently redundant with calculations in irrad.calc() because ibeam and idiff in that function are DNI and DHI, **NOT** in the plane of array
-					we'll have to fix this redundancy in the pvsamv1 rewrite. it will require allowing irradproc to report the errors below
-					and deciding what to do if the weather file DOES contain the third component but it's not being used in the calculations.*/
-					if (iyear == 0)
-					{
-						// Apply all irradiance component data from weather file (if it exists)
-						p_wfpoa[idx] = (ssc_number_t)wf.poa;
-						p_beam[idx] = (ssc_number_t)wf.dn;
-						p_glob[idx] = (ssc_number_t)(wf.gh);
-						p_diff[idx] = (ssc_number_t)(wf.df);
-
-						// calculate beam if global & diffuse are selected as inputs
-						if (radmode == GH_DF)
+						irrad irr;
+						int code = 0;
+						if (use_irrad_batch)
+							code = sa_irrad[nn].status[irec];
+						else
 						{
-							p_irrad_calc[2][idx] = (ssc_number_t)((wf.gh - wf.df) / cos(solzen*3.1415926 / 180));
-							if (p_irrad_calc[2][idx] < -1)
-							{
-								log(util::format("SAM calculated negative direct normal irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero.",
-									p_irrad_calc[2][idx], wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
-								p_irrad_calc[2][idx] = 0;
-							}
+							irr.set_time(wf.year, wf.month, wf.day, wf.hour, wf.minute,
+								instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour);
+							irr.set_location(hdr.lat, hdr.lon, hdr.tz);
+
+							irr.set_sky_model(skymodel, alb);
+							if (radmode == DN_DF) irr.set_beam_diffuse(wf.dn, wf.df);
+							else if (radmode == DN_GH) irr.set_global_beam(wf.gh, wf.dn);
+							else if (radmode == GH_DF) irr.set_global_diffuse(wf.gh, wf.df);
+							else if (radmode == POA_R) irr.set_poa_reference(wf.poa, &sa[nn].poa.poaAll);
+							else if (radmode == POA_P) irr.set_poa_pyranometer(wf.poa, &sa[nn].poa.poaAll);
+
+							irr.set_surface(sa[nn].track_mode,
+								sa[nn].tilt,
+								sa[nn].azimuth,
+								sa[nn].rotlim,
+								sa[nn].backtrack == 1, // mode 1 is backtracking enabled
+								sa[nn].gcr);
+
+							code = irr.calc();
 						}
 
-						// calculate global if beam & diffuse are selected as inputs
-						if (radmode == DN_DF)
-						{
-							p_irrad_calc[0][idx] = (ssc_number_t)(wf.df + wf.dn * cos(solzen*3.1415926 / 180));
-							if (p_irrad_calc[0][idx] < -1)
-							{
-								log(util::format("SAM calculated negative global horizontal irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero.",
-									p_irrad_calc[0][idx], wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
-								p_irrad_calc[0][idx] = 0;
-							}
-						}
+						if (code != 0)
+							throw exec_error("pvsamv1",
+							util::format("failed to calculate irradiance incident on surface (POA) %d (code: %d) [y:%d m:%d d:%d h:%d]",
+							nn + 1, code, wf.year, wf.month, wf.day, wf.hour));
 
-						// calculate diffuse if total & beam are selected as inputs
-						if (radmode == DN_GH)
+						// p_irrad_calc is only weather file records long...
+						if (iyear == 0)
 						{
-							p_irrad_calc[1][idx] = (ssc_number_t)(wf.gh - wf.dn * cos(solzen*3.1415926 / 180));
-							if (p_irrad_calc[1][idx] < -1)
-							{
-								log(util::format("SAM calculated negative diffuse horizontal irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero.",
-									p_irrad_calc[1][idx], wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
-								p_irrad_calc[1][idx] = 0;
+							if (radmode == POA_R || radmode == POA_P) {
+								double gh_temp, df_temp, dn_temp;
+								gh_temp = df_temp = dn_temp = 0;
+								irr.get_irrad(&gh_temp, &dn_temp, &df_temp);
+								p_irrad_calc[1][idx] = (ssc_number_t)df_temp;
+								p_irrad_calc[2][idx] = (ssc_number_t)dn_temp;
 							}
 						}
-					}
+						// beam, skydiff, and grounddiff IN THE PLANE OF ARRAY
+						double ibeam, iskydiff, ignddiff;
+						double ipoa=0; // Container for direct POA measurements
+						double aoi, stilt, sazi, rot, btd;
 
-					// record sub-array plane of array output before computing shading and soiling
-					if (iyear == 0)
-					{
-						if (radmode != POA_R)
-							p_poanom[nn][idx] = (ssc_number_t)((ibeam + iskydiff + ignddiff));
-						else
-							p_poanom[nn][idx] = (ssc_number_t)((ipoa));
-					}
 
-					// note: ibeam, iskydiff, ignddiff are in units of W/m2
+						// Ensure that the usePOAFromWF flag is false unless a reference cell has been used. 
+						//  This will later get forced to false if any shading has been applied (in any scenario)
+						//  also this will also be forced to false if using the cec mcsp thermal model OR if using the spe module model with a diffuse util. factor < 1.0
+						sa[nn].poa.usePOAFromWF = false;
+						if (radmode == POA_R){
+							ipoa = wf.poa;
+							sa[nn].poa.usePOAFromWF = true;
+						}
+						else if (radmode == POA_P){
+							ipoa = wf.poa;
+						}
 
-					// record sub-array contribution to total POA power for this time step  (W)
-					if (radmode != POA_R)
-						ts_accum_poa_nom += (ibeam + iskydiff + ignddiff) * ref_area_m2 * modules_per_string * sa[nn].nstrings;
-					else
-						ts_accum_poa_nom += (ipoa)* ref_area_m2 * modules_per_string * sa[nn].nstrings;
+						if (speForceNoPOA && (radmode == POA_R || radmode == POA_P)){  // only will be true if using a poa model AND spe module model AND spe_fp is < 1
+							sa[nn].poa.usePOAFromWF = false;
+							if (idx == 0)
+								log("The combination of POA irradiance as in input, single point efficiency module model, and module diffuse utilization factor less than one means that SAM must use a POA decomposition model to calculate the incident diffuse irradiance", SSC_WARNING);
+						}
 
-					// record sub-array contribution to total POA beam power for this time step (W)
-					ts_accum_poa_beam_nom += ibeam * ref_area_m2 * modules_per_string * sa[nn].nstrings;
+						if (mcspForceNoPOA && (radmode == POA_R || radmode == POA_P)){
+							sa[nn].poa.usePOAFromWF = false;
+							if (idx == 0)
+								log("The combination of POA irradiance as input and heat transfer method for cell temperature means that SAM must use a POA decomposition model to calculate the beam irradiance required by the cell temperature model", SSC_WARNING);
+						}
 
-					// for non-linear shading from shading database
-					if (sa[nn].shad.use_shade_db())
-					{
-						double shadedb_gpoa = ibeam + iskydiff + ignddiff;
-						double shadedb_dpoa = iskydiff + ignddiff;
 
-						// update cell temperature - unshaded value per Sara 1/25/16
-						double tcell = wf.tdry;
-						if (sunup > 0)
-						{
-							// calculate cell temperature using selected temperature model
-							pvinput_t in(ibeam, iskydiff, ignddiff, ipoa,
-								wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
-								solzen, aoi, hdr.elev,
-								stilt, sazi,
-								((double)wf.hour) + wf.minute / 60.0,
-								radmode, sa[nn].poa.usePOAFromWF);
-							// voltage set to -1 for max power
-							(*celltemp_model)(in, *module_model, -1.0, tcell);
-						}
-						double shadedb_str_vmp_stc = modules_per_string * ssVmp;
-						double shadedb_mppt_lo = V_mppt_lo_1module * modules_per_string;;
-						double shadedb_mppt_hi = V_mppt_hi_1module * modules_per_string;;
+						// Get Incident angles and irradiances
 
-						if (!sa[nn].shad.fbeam_shade_db(p_shade_db, hour, solalt, solazi, jj, step_per_hour, shadedb_gpoa, shadedb_dpoa, tcell, modules_per_string, shadedb_str_vmp_stc, shadedb_mppt_lo, shadedb_mppt_hi))
+						if (use_irrad_batch)
 						{
-							throw exec_error("pvsamv1", util::format("Error calculating shading factor for subarray %d", nn));
+							const irrad_batch &ib = sa_irrad[nn];
+							solazi = ib.solazi[irec];
+							solzen = ib.solzen[irec];
+							solalt = ib.solalt[irec];
+							sunup = ib.sunup[irec];
+							aoi = ib.aoi[irec];
+							stilt = ib.stilt[irec];
+							sazi = ib.sazi[irec];
+							rot = ib.rot[irec];
+							btd = ib.btd[irec];
+							ibeam = ib.poa_beam[irec];
+							iskydiff = ib.poa_skydiff[irec];
+							ignddiff = ib.poa_gnddiff[irec];
 						}
-						if (iyear == 0)
+						else
 						{
-#ifdef SHADE_DB_OUTPUTS
-							p_shadedb_gpoa[nn][idx] = (ssc_number_t)shadedb_gpoa;
-							p_shadedb_dpoa[nn][idx] = (ssc_number_t)shadedb_dpoa;
-							p_shadedb_pv_cell_temp[nn][idx] = (ssc_number_t)tcell;
-							p_shadedb_mods_per_str[nn][idx] = (ssc_number_t)modules_per_string;
-							p_shadedb_str_vmp_stc[nn][idx] = (ssc_number_t)shadedb_str_vmp_stc;
-							p_shadedb_mppt_lo[nn][idx] = (ssc_number_t)shadedb_mppt_lo;
-							p_shadedb_mppt_hi[nn][idx] = (ssc_number_t)shadedb_mppt_hi;
-							log("shade db hour " + util::to_string((int)hour) +"\n" + p_shade_db->get_warning());
-#endif
-							// fraction shaded for comparison
-							p_shadedb_shade_frac[nn][idx] = (ssc_number_t)(sa[nn].shad.dc_shade_factor());
+							irr.get_sun(&solazi, &solzen, &solalt, 0, 0, 0, &sunup, 0, 0, 0);
+							irr.get_angles(&aoi, &stilt, &sazi, &rot, &btd);
+							irr.get_poa(&ibeam, &iskydiff, &ignddiff, 0, 0, 0);
 						}
-					}
-					else
-					{
-						if (!sa[nn].shad.fbeam(hour, solalt, solazi, jj, step_per_hour))
+
+						if (iyear == 0)
+							p_sunpos_hour[idx] = (ssc_number_t)(use_irrad_batch ? sa_irrad[nn].sunpos_hour[irec] : irr.get_sunpos_calc_hour());
+
+						// save weather file beam, diffuse, and global for output and for use later in pvsamv1- year 1 only
+						/*jmf 2016: these calculations are currently redundant with calculations in irrad.calc() because ibeam and idiff in that function are DNI and DHI, **NOT** in the plane of array
+						we'll have to fix this redundancy in the pvsamv1 rewrite. it will require allowing irradproc to report the errors below
+						and deciding what to do if the weather file DOES contain the third component but it's not being used in the calculations.*/
+						if (iyear == 0)
 						{
-							throw exec_error("pvsamv1", util::format("Error calculating shading factor for subarray %d", nn));
-						}
-					}
+							// Apply all irradiance component data from weather file (if it exists)
+							p_wfpoa[idx] = (ssc_number_t)wf.poa;
+							p_beam[idx] = (ssc_number_t)wf.dn;
+							p_glob[idx] = (ssc_number_t)(wf.gh);
+							p_diff[idx] = (ssc_number_t)(wf.df);
+
+							// calculate beam if global & diffuse are selected as inputs
+							if (radmode == GH_DF)
+							{
+								p_irrad_calc[2][idx] = (ssc_number_t)((wf.gh - wf.df) / cos(solzen*3.1415926 / 180));
+								if (p_irrad_calc[2][idx] < -1)
+								{
+									log(util::format("SAM calculated negative direct normal irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero.",
+										p_irrad_calc[2][idx], wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
+									p_irrad_calc[2][idx] = 0;
+								}
+							}
 
-					// apply hourly shading factors to beam (if none enabled, factors are 1.0) 
-					// shj 3/21/16 - update to handle negative shading loss
-					if (sa[nn].shad.beam_shade_factor() != 1.0){
-						//							if (sa[nn].shad.beam_shade_factor() < 1.0){
-						// Sara 1/25/16 - shading database derate applied to dc only
-						// shading loss applied to beam if not from shading database
-						ibeam *= sa[nn].shad.beam_shade_factor();
-						if (radmode == POA_R || radmode == POA_P){
-							sa[nn].poa.usePOAFromWF = false;
-							if (sa[nn].poa.poaShadWarningCount == 0){
-								log(util::format("Combining POA irradiance as input with the beam shading losses at time [y:%d m:%d d:%d h:%d] forces SAM to use a POA decomposition model to calculate incident beam irradiance",
-									wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
+							// calculate global if beam & diffuse are selected as inputs
+							if (radmode == DN_DF)
+							{
+								p_irrad_calc[0][idx] = (ssc_number_t)(wf.df + wf.dn * cos(solzen*3.1415926 / 180));
+								if (p_irrad_calc[0][idx] < -1)
+								{
+									log(util::format("SAM calculated negative global horizontal irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero.",
+										p_irrad_calc[0][idx], wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
+									p_irrad_calc[0][idx] = 0;
+								}
 							}
-							else{
-								log(util::format("Combining POA irradiance as input with the beam shading losses at time [y:%d m:%d d:%d h:%d] forces SAM to use a POA decomposition model to calculate incident beam irradiance",
-									wf.year, wf.month, wf.day, wf.hour), SSC_NOTICE, (float)idx);
+
+							// calculate diffuse if total & beam are selected as inputs
+							if (radmode == DN_GH)
+							{
+								p_irrad_calc[1][idx] = (ssc_number_t)(wf.gh - wf.dn * cos(solzen*3.1415926 / 180));
+								if (p_irrad_calc[1][idx] < -1)
+								{
+									log(util::format("SAM calculated negative diffuse horizontal irradiance %lg W/m2 at time [y:%d m:%d d:%d h:%d], set to zero.",
+										p_irrad_calc[1][idx], wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
+									p_irrad_calc[1][idx] = 0;
+								}
 							}
-							sa[nn].poa.poaShadWarningCount++;
 						}
-					}
 
-					// apply sky diffuse shading factor (specified as constant, nominally 1.0 if disabled in UI)
-					if (sa[nn].shad.fdiff() < 1.0){
-						iskydiff *= sa[nn].shad.fdiff();
-						if (radmode == POA_R || radmode == POA_P){
-							if (idx == 0)
-								log("Combining POA irradiance as input with the diffuse shading losses forces SAM to use a POA decomposition model to calculate incident diffuse irradiance", SSC_WARNING);
-							sa[nn].poa.usePOAFromWF = false;
+						// record sub-array plane of array output before computing shading and soiling
+						if (iyear == 0)
+						{
+							if (radmode != POA_R)
+								p_poanom[nn][idx] = (ssc_number_t)((ibeam + iskydiff + ignddiff));
+							else
+								p_poanom[nn][idx] = (ssc_number_t)((ipoa));
 						}
-					}
 
-					double beam_shading_factor = sa[nn].shad.beam_shade_factor();
-
-					//self-shading calculations
-					if (((sa[nn].track_mode == 0 || sa[nn].track_mode == 4) && (sa[nn].shade_mode == 1 || sa[nn].shade_mode == 2)) //fixed tilt or timeseries tilt, self-shading (linear or non-linear) OR
-						|| (sa[nn].track_mode == 1 && (sa[nn].shade_mode == 1 || sa[nn].shade_mode == 2) && sa[nn].backtrack == 0)) //one-axis tracking, self-shading, not backtracking
-					{
+						// note: ibeam, iskydiff, ignddiff are in units of W/m2
 
-						if (radmode == POA_R || radmode == POA_P){
-							if (idx == 0)
-								log("Combining POA irradiance as input with self shading forces SAM to employ a POA decomposition model to calculate incident beam irradiance", SSC_WARNING);
-							sa[nn].poa.usePOAFromWF = false;
-						}
+						// record sub-array contribution to total POA power for this time step  (W)
+						if (radmode != POA_R)
+							ts_accum_poa_nom += (ibeam + iskydiff + ignddiff) * ref_area_m2 * modules_per_string * sa[nn].nstrings;
+						else
+							ts_accum_poa_nom += (ipoa)* ref_area_m2 * modules_per_string * sa[nn].nstrings;
 
-						// info to be passed to self-shading function
-						bool trackbool = (sa[nn].track_mode == 1);	// 0 for fixed tilt and timeseries tilt, 1 for one-axis
-						bool linear = (sa[nn].shade_mode == 2); //0 for full self-shading, 1 for linear self-shading
+						// record sub-array contribution to total POA beam power for this time step (W)
+						ts_accum_poa_beam_nom += ibeam * ref_area_m2 * modules_per_string * sa[nn].nstrings;
 
-						//geometric fraction of the array that is shaded for one-axis trackers.
-						//USES A DIFFERENT FUNCTION THAN THE SELF-SHADING BECAUSE SS IS MEANT FOR FIXED ONLY. SHADE_FRACTION_1X IS FOR ONE-AXIS TRACKERS ONLY.
-						//used in the non-linear self-shading calculator for one-axis tracking only
-						double shad1xf = 0;
-						if (trackbool)
-							shad1xf = shade_fraction_1x(solazi, solzen, sa[nn].tilt, sa[nn].azimuth, sa[nn].gcr, rot);
+						// for non-linear shading from shading database
+						if (sa[nn].shad.use_shade_db())
+						{
+							double shadedb_gpoa = ibeam + iskydiff + ignddiff;
+							double shadedb_dpoa = iskydiff + ignddiff;
 
-						//execute self-shading calculations
-						ssc_number_t beam_to_use; //some self-shading calculations require DNI, NOT ibeam (beam in POA). Need to know whether to use DNI from wf or calculated, depending on radmode
-						if (radmode == DN_DF || radmode == DN_GH) beam_to_use = (ssc_number_t)wf.dn;
-						else beam_to_use = p_irrad_calc[2][hour * step_per_hour]; // top of hour in first year
+							// update cell temperature - unshaded value per Sara 1/25/16
+							double tcell = wf.tdry;
+							if (sunup > 0)
+							{
+								// calculate cell temperature using selected temperature model
+								pvinput_t in(ibeam, iskydiff, ignddiff, ipoa,
+									wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
+									solzen, aoi, hdr.elev,
+									stilt, sazi,
+									((double)wf.hour) + wf.minute / 60.0,
+									radmode, sa[nn].poa.usePOAFromWF);
+								// voltage set to -1 for max power
+								(*celltemp_model)(in, *module_model, -1.0, tcell);
+							}
+							double shadedb_str_vmp_stc = modules_per_string * ssVmp;
+							double shadedb_mppt_lo = V_mppt_lo_1module * modules_per_string;;
+							double shadedb_mppt_hi = V_mppt_hi_1module * modules_per_string;;
 
-						if (linear && trackbool) //one-axis linear
-						{
-							ibeam *= (1 - shad1xf); //derate beam irradiance linearly by the geometric shading fraction calculated above per Chris Deline 2/10/16
-							beam_shading_factor *= (1 - shad1xf);
+							if (!sa[nn].shad.fbeam_shade_db(p_shade_db, hour, solalt, solazi, jj, step_per_hour, shadedb_gpoa, shadedb_dpoa, tcell, modules_per_string, shadedb_str_vmp_stc, shadedb_mppt_lo, shadedb_mppt_hi))
+							{
+								throw exec_error("pvsamv1", util::format("Error calculating shading factor for subarray %d", nn));
+							}
 							if (iyear == 0)
 							{
-								p_ss_derate[nn][idx] = (ssc_number_t)1;
-								p_linear_derate[nn][idx] = (ssc_number_t)(1 - shad1xf);
-								p_ss_diffuse_derate[nn][idx] = (ssc_number_t)1; //no diffuse derate for linear shading
-								p_ss_reflected_derate[nn][idx] = (ssc_number_t)1; //no reflected derate for linear shading
+	#ifdef SHADE_DB_OUTPUTS
+								p_shadedb_gpoa[nn][idx] = (ssc_number_t)shadedb_gpoa;
+								p_shadedb_dpoa[nn][idx] = (ssc_number_t)shadedb_dpoa;
+								p_shadedb_pv_cell_temp[nn][idx] = (ssc_number_t)tcell;
+								p_shadedb_mods_per_str[nn][idx] = (ssc_number_t)modules_per_string;
+								p_shadedb_str_vmp_stc[nn][idx] = (ssc_number_t)shadedb_str_vmp_stc;
+								p_shadedb_mppt_lo[nn][idx] = (ssc_number_t)shadedb_mppt_lo;
+								p_shadedb_mppt_hi[nn][idx] = (ssc_number_t)shadedb_mppt_hi;
+								log("shade db hour " + util::to_string((int)hour) +"\n" + p_shade_db->get_warning());
+	#endif
+								// fraction shaded for comparison
+								p_shadedb_shade_frac[nn][idx] = (ssc_number_t)(sa[nn].shad.dc_shade_factor());
+							}
+						}
+						else
+						{
+							if (!sa[nn].shad.fbeam(hour, solalt, solazi, jj, step_per_hour))
+							{
+								throw exec_error("pvsamv1", util::format("Error calculating shading factor for subarray %d", nn));
+							}
+						}
+
+						// apply hourly shading factors to beam (if none enabled, factors are 1.0) 
+						// shj 3/21/16 - update to handle negative shading loss
+						if (sa[nn].shad.beam_shade_factor() != 1.0){
+							//							if (sa[nn].shad.beam_shade_factor() < 1.0){
+							// Sara 1/25/16 - shading database derate applied to dc only
+							// shading loss applied to beam if not from shading database
+							ibeam *= sa[nn].shad.beam_shade_factor();
+							if (radmode == POA_R || radmode == POA_P){
+								sa[nn].poa.usePOAFromWF = false;
+								if (sa[nn].poa.poaShadWarningCount == 0){
+									log(util::format("Combining POA irradiance as input with the beam shading losses at time [y:%d m:%d d:%d h:%d] forces SAM to use a POA decomposition model to calculate incident beam irradiance",
+										wf.year, wf.month, wf.day, wf.hour), SSC_WARNING, (float)idx);
+								}
+								else{
+									log(util::format("Combining POA irradiance as input with the beam shading losses at time [y:%d m:%d d:%d h:%d] forces SAM to use a POA decomposition model to calculate incident beam irradiance",
+										wf.year, wf.month, wf.day, wf.hour), SSC_NOTICE, (float)idx);
+								}
+								sa[nn].poa.poaShadWarningCount++;
+							}
+						}
+
+						// apply sky diffuse shading factor (specified as constant, nominally 1.0 if disabled in UI)
+						if (sa[nn].shad.fdiff() < 1.0){
+							iskydiff *= sa[nn].shad.fdiff();
+							if (radmode == POA_R || radmode == POA_P){
+								if (idx == 0)
+									log("Combining POA irradiance as input with the diffuse shading losses forces SAM to use a POA decomposition model to calculate incident diffuse irradiance", SSC_WARNING);
+								sa[nn].poa.usePOAFromWF = false;
 							}
 						}
 
-						else if (ss_exec(sa[nn].sscalc, stilt, sazi, solzen, solazi, beam_to_use, ibeam, (iskydiff + ignddiff), alb, trackbool, linear, shad1xf, sa[nn].ssout))
+						double beam_shading_factor = sa[nn].shad.beam_shade_factor();
+
+						//self-shading calculations
+						if (((sa[nn].track_mode == 0 || sa[nn].track_mode == 4) && (sa[nn].shade_mode == 1 || sa[nn].shade_mode == 2)) //fixed tilt or timeseries tilt, self-shading (linear or non-linear) OR
+							|| (sa[nn].track_mode == 1 && (sa[nn].shade_mode == 1 || sa[nn].shade_mode == 2) && sa[nn].backtrack == 0)) //one-axis tracking, self-shading, not backtracking
 						{
-							if (linear) //fixed tilt linear
+
+							if (radmode == POA_R || radmode == POA_P){
+								if (idx == 0)
+									log("Combining POA irradiance as input with self shading forces SAM to employ a POA decomposition model to calculate incident beam irradiance", SSC_WARNING);
+								sa[nn].poa.usePOAFromWF = false;
+							}
+
+							// info to be passed to self-shading function
+							bool trackbool = (sa[nn].track_mode == 1);	// 0 for fixed tilt and timeseries tilt, 1 for one-axis
+							bool linear = (sa[nn].shade_mode == 2); //0 for full self-shading, 1 for linear self-shading
+
+							//geometric fraction of the array that is shaded for one-axis trackers.
+							//USES A DIFFERENT FUNCTION THAN THE SELF-SHADING BECAUSE SS IS MEANT FOR FIXED ONLY. SHADE_FRACTION_1X IS FOR ONE-AXIS TRACKERS ONLY.
+							//used in the non-linear self-shading calculator for one-axis tracking only
+							double shad1xf = 0;
+							if (trackbool)
+								shad1xf = shade_fraction_1x(solazi, solzen, sa[nn].tilt, sa[nn].azimuth, sa[nn].gcr, rot);
+
+							//execute self-shading calculations
+							ssc_number_t beam_to_use; //some self-shading calculations require DNI, NOT ibeam (beam in POA). Need to know whether to use DNI from wf or calculated, depending on radmode
+							if (radmode == DN_DF || radmode == DN_GH) beam_to_use = (ssc_number_t)wf.dn;
+							else beam_to_use = p_irrad_calc[2][hour * step_per_hour]; // top of hour in first year
+
+							if (linear && trackbool) //one-axis linear
 							{
-								ibeam *= (1 - sa[nn].ssout.m_shade_frac_fixed);
-								beam_shading_factor *= (1 - sa[nn].ssout.m_shade_frac_fixed);
+								ibeam *= (1 - shad1xf); //derate beam irradiance linearly by the geometric shading fraction calculated above per Chris Deline 2/10/16
+								beam_shading_factor *= (1 - shad1xf);
 								if (iyear == 0)
 								{
 									p_ss_derate[nn][idx] = (ssc_number_t)1;
-									p_linear_derate[nn][idx] = (ssc_number_t)(1 - sa[nn].ssout.m_shade_frac_fixed);
+									p_linear_derate[nn][idx] = (ssc_number_t)(1 - shad1xf);
 									p_ss_diffuse_derate[nn][idx] = (ssc_number_t)1; //no diffuse derate for linear shading
 									p_ss_reflected_derate[nn][idx] = (ssc_number_t)1; //no reflected derate for linear shading
 								}
 							}
-							else //non-linear: fixed tilt AND one-axis
+
+							else if (ss_exec(sa[nn].sscalc, stilt, sazi, solzen, solazi, beam_to_use, ibeam, (iskydiff + ignddiff), alb, trackbool, linear, shad1xf, sa[nn].ssout))
 							{
-								if (iyear == 0)
+								if (linear) //fixed tilt linear
 								{
-									p_ss_diffuse_derate[nn][idx] = (ssc_number_t)sa[nn].ssout.m_diffuse_derate;
-									p_ss_reflected_derate[nn][idx] = (ssc_number_t)sa[nn].ssout.m_reflected_derate;
-									p_ss_derate[nn][idx] = (ssc_number_t)sa[nn].ssout.m_dc_derate;
-									p_linear_derate[nn][idx] = (ssc_number_t)1;
+									ibeam *= (1 - sa[nn].ssout.m_shade_frac_fixed);
+									beam_shading_factor *= (1 - sa[nn].ssout.m_shade_frac_fixed);
+									if (iyear == 0)
+									{
+										p_ss_derate[nn][idx] = (ssc_number_t)1;
+										p_linear_derate[nn][idx] = (ssc_number_t)(1 - sa[nn].ssout.m_shade_frac_fixed);
+										p_ss_diffuse_derate[nn][idx] = (ssc_number_t)1; //no diffuse derate for linear shading
+										p_ss_reflected_derate[nn][idx] = (ssc_number_t)1; //no reflected derate for linear shading
+									}
+								}
+								else //non-linear: fixed tilt AND one-axis
+								{
+									if (iyear == 0)
+									{
+										p_ss_diffuse_derate[nn][idx] = (ssc_number_t)sa[nn].ssout.m_diffuse_derate;
+										p_ss_reflected_derate[nn][idx] = (ssc_number_t)sa[nn].ssout.m_reflected_derate;
+										p_ss_derate[nn][idx] = (ssc_number_t)sa[nn].ssout.m_dc_derate;
+										p_linear_derate[nn][idx] = (ssc_number_t)1;
+									}
+
+									// Sky diffuse and ground-reflected diffuse are derated according to C. Deline's algorithm
+									iskydiff *= sa[nn].ssout.m_diffuse_derate;
+									ignddiff *= sa[nn].ssout.m_reflected_derate;
+									// Beam is not derated- all beam derate effects (linear and non-linear) are taken into account in the nonlinear_dc_shading_derate
+									sa[nn].poa.nonlinear_dc_shading_derate = sa[nn].ssout.m_dc_derate;
 								}
-
-								// Sky diffuse and ground-reflected diffuse are derated according to C. Deline's algorithm
-								iskydiff *= sa[nn].ssout.m_diffuse_derate;
-								ignddiff *= sa[nn].ssout.m_reflected_derate;
-								// Beam is not derated- all beam derate effects (linear and non-linear) are taken into account in the nonlinear_dc_shading_derate
-								sa[nn].poa.nonlinear_dc_shading_derate = sa[nn].ssout.m_dc_derate;
 							}
+							else
+								throw exec_error("pvsamv1", util::format("Self-shading calculation failed at %d", (int)idx));
 						}
-						else
-							throw exec_error("pvsamv1", util::format("Self-shading calculation failed at %d", (int)idx));
-					}
 
-					double poashad = (radmode == POA_R) ? ipoa : (ibeam + iskydiff + ignddiff);
+						double poashad = (radmode == POA_R) ? ipoa : (ibeam + iskydiff + ignddiff);
 
-					// determine sub-array contribution to total shaded plane of array for this hour
-					ts_accum_poa_shaded += poashad * ref_area_m2 * modules_per_string * sa[nn].nstrings;
+						// determine sub-array contribution to total shaded plane of array for this hour
+						ts_accum_poa_shaded += poashad * ref_area_m2 * modules_per_string * sa[nn].nstrings;
 
 
-					// apply soiling derate to all components of irradiance
-					double soiling_factor = 1.0;
-					if (month_idx >= 0 && month_idx < 12)
-					{
-						soiling_factor = sa[nn].soiling[month_idx];
-						ibeam *= soiling_factor;
-						iskydiff *= soiling_factor;
-						ignddiff *= soiling_factor;
-						if (radmode == POA_R || radmode == POA_P){
-							ipoa *= soiling_factor;
-							if (soiling_factor < 1 && idx == 0)
-								log("Soiling may already be accounted for in the input POA data. Please confirm that the input data does not contain soiling effects, or remove the additional losses on the Losses page.", SSC_WARNING);
+						// apply soiling derate to all components of irradiance
+						double soiling_factor = 1.0;
+						if (month_idx >= 0 && month_idx < 12)
+						{
+							soiling_factor = sa[nn].soiling[month_idx];
+							ibeam *= soiling_factor;
+							iskydiff *= soiling_factor;
+							ignddiff *= soiling_factor;
+							if (radmode == POA_R || radmode == POA_P){
+								ipoa *= soiling_factor;
+								if (soiling_factor < 1 && idx == 0)
+									log("Soiling may already be accounted for in the input POA data. Please confirm that the input data does not contain soiling effects, or remove the additional losses on the Losses page.", SSC_WARNING);
+							}
+							beam_shading_factor *= soiling_factor;
 						}
-						beam_shading_factor *= soiling_factor;
-					}
 
-					if (iyear == 0)
-					{
-						// save sub-array level outputs			
-						p_poashaded[nn][idx] = (ssc_number_t)poashad;
-						p_poaeffbeam[nn][idx] = (ssc_number_t)ibeam;
-						p_poaeffdiff[nn][idx] = (ssc_number_t)(iskydiff + ignddiff);
-						p_poaeff[nn][idx] = (radmode == POA_R) ? (ssc_number_t)ipoa : (ssc_number_t)(ibeam + iskydiff + ignddiff);
-						p_shad[nn][idx] = (ssc_number_t)beam_shading_factor;
-						p_rot[nn][idx] = (ssc_number_t)rot;
-						p_idealrot[nn][idx] = (ssc_number_t)(rot - btd);
-						p_aoi[nn][idx] = (ssc_number_t)aoi;
-						p_surftilt[nn][idx] = (ssc_number_t)stilt;
-						p_surfazi[nn][idx] = (ssc_number_t)sazi;
-						p_soiling[nn][idx] = (ssc_number_t)soiling_factor;
+						if (iyear == 0)
+						{
+							// save sub-array level outputs			
+							p_poashaded[nn][idx] = (ssc_number_t)poashad;
+							p_poaeffbeam[nn][idx] = (ssc_number_t)ibeam;
+							p_poaeffdiff[nn][idx] = (ssc_number_t)(iskydiff + ignddiff);
+							p_poaeff[nn][idx] = (radmode == POA_R) ? (ssc_number_t)ipoa : (ssc_number_t)(ibeam + iskydiff + ignddiff);
+							p_shad[nn][idx] = (ssc_number_t)beam_shading_factor;
+							p_rot[nn][idx] = (ssc_number_t)rot;
+							p_idealrot[nn][idx] = (ssc_number_t)(rot - btd);
+							p_aoi[nn][idx] = (ssc_number_t)aoi;
+							p_surftilt[nn][idx] = (ssc_number_t)stilt;
+							p_surfazi[nn][idx] = (ssc_number_t)sazi;
+							p_soiling[nn][idx] = (ssc_number_t)soiling_factor;
 
 
-					}
+						}
 
-					// accumulate incident total radiation (W) in this timestep (all subarrays)
-					ts_accum_poa_eff += ((radmode == POA_R) ? ipoa : (ibeam + iskydiff + ignddiff)) * ref_area_m2 * modules_per_string * sa[nn].nstrings;
-					ts_accum_poa_beam_eff += ibeam * ref_area_m2 * modules_per_string * sa[nn].nstrings;
+						// accumulate incident total radiation (W) in this timestep (all subarrays)
+						ts_accum_poa_eff += ((radmode == POA_R) ? ipoa : (ibeam + iskydiff + ignddiff)) * ref_area_m2 * modules_per_string * sa[nn].nstrings;
+						ts_accum_poa_beam_eff += ibeam * ref_area_m2 * modules_per_string * sa[nn].nstrings;
 
-					// save the required irradiance inputs on array plane for the module output calculations.
-					sa[nn].poa.ibeam = ibeam;
-					sa[nn].poa.iskydiff = iskydiff;
-					sa[nn].poa.ignddiff = ignddiff;
-					sa[nn].poa.ipoa = ipoa;
-					sa[nn].poa.aoi = aoi;
-					sa[nn].poa.sunup = sunup;
-					sa[nn].poa.stilt = stilt;
-					sa[nn].poa.sazi = sazi;
+						// save the required irradiance inputs on array plane for the module output calculations.
+						sa[nn].poa.ibeam = ibeam;
+						sa[nn].poa.iskydiff = iskydiff;
+						sa[nn].poa.ignddiff = ignddiff;
+						sa[nn].poa.ipoa = ipoa;
+						sa[nn].poa.aoi = aoi;
+						sa[nn].poa.sunup = sunup;
+						sa[nn].poa.stilt = stilt;
+						sa[nn].poa.sazi = sazi;
 
-				}
+					}
 
-				// compute dc power output of one module in each subarray
-				double module_voltage = -1;
+					// compute dc power output of one module in each subarray
+					double module_voltage = -1;
 
-				if (enable_mismatch_vmax_calc)
-				{
-					if (num_subarrays <= 1)
-						throw exec_error("pvsamv1", "Subarray voltage mismatch calculation requires more than one subarray. Please check your inputs.");
-					double vmax = module_model->VocRef()*1.3; // maximum voltage
-					double vmin = 0.4 * vmax; // minimum voltage
-					const int NP = 100;
-					double V[NP], I[NP], P[NP];
-					double Pmax = 0;
-					// sweep voltage, calculating current for each subarray module, and adding
-					for (int i = 0; i < NP; i++)
+					if (enable_mismatch_vmax_calc)
 					{
-						V[i] = vmin + (vmax - vmin)*i / ((double)NP);
-						I[i] = 0;
-						for (int nn = 0; nn < 4; nn++)
+						if (num_subarrays <= 1)
+							throw exec_error("pvsamv1", "Subarray voltage mismatch calculation requires more than one subarray. Please check your inputs.");
+						double vmax = module_model->VocRef()*1.3; // maximum voltage
+						double vmin = 0.4 * vmax; // minimum voltage
+						const int NP = 100;
+						double V[NP], I[NP], P[NP];
+						double Pmax = 0;
+						// sweep voltage, calculating current for each subarray module, and adding
+						for (int i = 0; i < NP; i++)
 						{
-							if (!sa[nn].enable || sa[nn].nstrings < 1) continue; // skip disabled subarrays
-
-							pvinput_t in(sa[nn].poa.ibeam, sa[nn].poa.iskydiff, sa[nn].poa.ignddiff, sa[nn].poa.ipoa,
-								wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
-								solzen, sa[nn].poa.aoi, hdr.elev,
-								sa[nn].poa.stilt, sa[nn].poa.sazi,
-								((double)wf.hour) + wf.minute / 60.0,
-								radmode, sa[nn].poa.usePOAFromWF);
-							pvoutput_t out(0, 0, 0, 0, 0, 0, 0);
-							if (sa[nn].poa.sunup > 0)
+							V[i] = vmin + (vmax - vmin)*i / ((double)NP);
+							I[i] = 0;
+							for (int nn = 0; nn < 4; nn++)
 							{
-								double tcell = wf.tdry;
-								// calculate cell temperature using selected temperature model
-								(*celltemp_model)(in, *module_model, V[i], tcell);
-								// calculate module power output using conversion model previously specified
-								(*module_model)(in, tcell, V[i], out);
+								if (!sa[nn].enable || sa[nn].nstrings < 1) continue; // skip disabled subarrays
+
+								pvinput_t in(sa[nn].poa.ibeam, sa[nn].poa.iskydiff, sa[nn].poa.ignddiff, sa[nn].poa.ipoa,
+									wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
+									solzen, sa[nn].poa.aoi, hdr.elev,
+									sa[nn].poa.stilt, sa[nn].poa.sazi,
+									((double)wf.hour) + wf.minute / 60.0,
+									radmode, sa[nn].poa.usePOAFromWF);
+								pvoutput_t out(0, 0, 0, 0, 0, 0, 0);
+								if (sa[nn].poa.sunup > 0)
+								{
+									double tcell = wf.tdry;
+									// calculate cell temperature using selected temperature model
+									(*celltemp_model)(in, *module_model, V[i], tcell);
+									// calculate module power output using conversion model previously specified
+									(*module_model)(in, tcell, V[i], out);
+								}
+								I[i] += out.Current;
+							}
+
+							P[i] = V[i] * I[i];
+							if (P[i] > Pmax)
+							{
+								Pmax = P[i];
+								module_voltage = V[i];
 							}
-							I[i] += out.Current;
 						}
 
-						P[i] = V[i] * I[i];
-						if (P[i] > Pmax)
+						if (clip_mppt_window)
 						{
-							Pmax = P[i];
-							module_voltage = V[i];
+							if (module_voltage < V_mppt_lo_1module) module_voltage = V_mppt_lo_1module;
+							if (module_voltage > V_mppt_hi_1module) module_voltage = V_mppt_hi_1module;
 						}
-					}
 
-					if (clip_mppt_window)
-					{
-						if (module_voltage < V_mppt_lo_1module) module_voltage = V_mppt_lo_1module;
-						if (module_voltage > V_mppt_hi_1module) module_voltage = V_mppt_hi_1module;
 					}
 
-				}
-
 
-				//  at this point we have 
-				// a array maximum power module voltage
+					//  at this point we have 
+					// a array maximum power module voltage
 
-				// for averaging voltage in the case that mismatch calcs are disabled.
-				int n_voltage_values = 0;
-				double voltage_sum = 0.0;
-				double mppt_clip_window = 0;
+					// for averaging voltage in the case that mismatch calcs are disabled.
+					int n_voltage_values = 0;
+					double voltage_sum = 0.0;
+					double mppt_clip_window = 0;
 
-				for (int nn = 0; nn < 4; nn++)
-				{
-					if (!sa[nn].enable
-						|| sa[nn].nstrings < 1)
-						continue; // skip disabled subarrays
-
-					pvinput_t in(sa[nn].poa.ibeam, sa[nn].poa.iskydiff, sa[nn].poa.ignddiff, sa[nn].poa.ipoa,
-						wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
-						solzen, sa[nn].poa.aoi, hdr.elev,
-						sa[nn].poa.stilt, sa[nn].poa.sazi,
-						((double)wf.hour) + wf.minute / 60.0,
-						radmode, sa[nn].poa.usePOAFromWF);
-					pvoutput_t out(0, 0, 0, 0, 0, 0, 0);
-
-					double tcell = wf.tdry;
-					if (sa[nn].poa.sunup > 0)
+					for (int nn = 0; nn < 4; nn++)
 					{
-						// calculate cell temperature using selected temperature model
-						// calculate module power output using conversion model previously specified
-						(*celltemp_model)(in, *module_model, module_voltage, tcell);
-						(*module_model)(in, tcell, module_voltage, out);
-
-						// if mismatch was enabled, the module voltage already was clipped to the inverter MPPT range if appropriate
-						// here, if the module was running at mppt by default, and mppt window clipping is possible, recalculate
-						// module power output to determine actual module power using the voltage window of the inverter
-						if (iyear == 0) mppt_clip_window = out.Power;
-						if (!enable_mismatch_vmax_calc && clip_mppt_window)
+						if (!sa[nn].enable
+							|| sa[nn].nstrings < 1)
+							continue; // skip disabled subarrays
+
+						pvinput_t in(sa[nn].poa.ibeam, sa[nn].poa.iskydiff, sa[nn].poa.ignddiff, sa[nn].poa.ipoa,
+							wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
+							solzen, sa[nn].poa.aoi, hdr.elev,
+							sa[nn].poa.stilt, sa[nn].poa.sazi,
+							((double)wf.hour) + wf.minute / 60.0,
+							radmode, sa[nn].poa.usePOAFromWF);
+						pvoutput_t out(0, 0, 0, 0, 0, 0, 0);
+
+						double tcell = wf.tdry;
+						if (sa[nn].poa.sunup > 0)
 						{
-							if (out.Voltage < V_mppt_lo_1module)
-							{
-								module_voltage = V_mppt_lo_1module;
-								(*celltemp_model)(in, *module_model, module_voltage, tcell);
-								(*module_model)(in, tcell, module_voltage, out);
-							}
-							else if (out.Voltage > V_mppt_hi_1module)
+							// calculate cell temperature using selected temperature model
+							// calculate module power output using conversion model previously specified
+							(*celltemp_model)(in, *module_model, module_voltage, tcell);
+							(*module_model)(in, tcell, module_voltage, out);
+
+							// if mismatch was enabled, the module voltage already was clipped to the inverter MPPT range if appropriate
+							// here, if the module was running at mppt by default, and mppt window clipping is possible, recalculate
+							// module power output to determine actual module power using the voltage window of the inverter
+							if (iyear == 0) mppt_clip_window = out.Power;
+							if (!enable_mismatch_vmax_calc && clip_mppt_window)
 							{
-								module_voltage = V_mppt_hi_1module;
-								(*celltemp_model)(in, *module_model, module_voltage, tcell);
-								(*module_model)(in, tcell, module_voltage, out);
+								if (out.Voltage < V_mppt_lo_1module)
+								{
+									module_voltage = V_mppt_lo_1module;
+									(*celltemp_model)(in, *module_model, module_voltage, tcell);
+									(*module_model)(in, tcell, module_voltage, out);
+								}
+								else if (out.Voltage > V_mppt_hi_1module)
+								{
+									module_voltage = V_mppt_hi_1module;
+									(*celltemp_model)(in, *module_model, module_voltage, tcell);
+									(*module_model)(in, tcell, module_voltage, out);
+								}
+								// MPPT loss
 							}
-							// MPPT loss
+							if (iyear == 0)	mppt_clip_window -= out.Power;
 						}
-						if (iyear == 0)	mppt_clip_window -= out.Power;
-					}
 
-					if (out.Voltage > module_model->VocRef()*1.3)
-						log(util::format("Module voltage is unrealistically high (exceeds 1.3*VocRef) at [mdhm: %d %d %d %lg]: %lg V\n", wf.month, wf.day, wf.hour, wf.minute, out.Voltage), SSC_NOTICE);
+						if (out.Voltage > module_model->VocRef()*1.3)
+							log(util::format("Module voltage is unrealistically high (exceeds 1.3*VocRef) at [mdhm: %d %d %d %lg]: %lg V\n", wf.month, wf.day, wf.hour, wf.minute, out.Voltage), SSC_NOTICE);
 
-					if (!std::isfinite(out.Power))
-					{
-						out.Power = 0;
-						out.Voltage = 0;
-						out.Current = 0;
-						out.Efficiency = 0;
-						out.CellTemp = tcell;
-						log(util::format("Non-finite power output calculated at [mdhm: %d %d %d %lg], set to zero.\n"
-							"could be due to anomolous equation behavior at very low irradiances (poa: %lg W/m2)",
-							wf.month, wf.day, wf.hour, wf.minute, sa[nn].poa.ipoa), SSC_NOTICE);
+						if (!std::isfinite(out.Power))
+						{
+							out.Power = 0;
+							out.Voltage = 0;
+							out.Current = 0;
+							out.Efficiency = 0;
+							out.CellTemp = tcell;
+							log(util::format("Non-finite power output calculated at [mdhm: %d %d %d %lg], set to zero.\n"
+								"could be due to anomolous equation behavior at very low irradiances (poa: %lg W/m2)",
+								wf.month, wf.day, wf.hour, wf.minute, sa[nn].poa.ipoa), SSC_NOTICE);
+						}
+
+						// save DC module outputs for this subarray
+						sa[nn].module.dcpwr = out.Power;
+						sa[nn].module.dceff = out.Efficiency * 100;
+						sa[nn].module.dcv = out.Voltage;
+						sa[nn].module.tcell = out.CellTemp;
+						sa[nn].module.isc = out.Isc_oper;
+						sa[nn].module.voc = out.Voc_oper;
+
+						voltage_sum += out.Voltage;
+						n_voltage_values++;
 					}
 
-					// save DC module outputs for this subarray
-					sa[nn].module.dcpwr = out.Power;
-					sa[nn].module.dceff = out.Efficiency * 100;
-					sa[nn].module.dcv = out.Voltage;
-					sa[nn].module.tcell = out.CellTemp;
-					sa[nn].module.isc = out.Isc_oper;
-					sa[nn].module.voc = out.Voc_oper;
 
-					voltage_sum += out.Voltage;
-					n_voltage_values++;
-				}
+					if (enable_mismatch_vmax_calc && num_subarrays > 1)
+						dc_string_voltage = module_voltage * modules_per_string;
+					else // when mismatch calculation is disabled and subarrays are enabled, simply average the voltages together for the inverter input
+						dc_string_voltage = voltage_sum / n_voltage_values * modules_per_string;
 
+					// sum up all DC power from the whole array
+					for (int nn = 0; nn < 4; nn++)
+					{
+						if (!sa[nn].enable
+							|| sa[nn].nstrings < 1)
+							continue; // skip disabled subarrays
 
-				if (enable_mismatch_vmax_calc && num_subarrays > 1)
-					dc_string_voltage = module_voltage * modules_per_string;
-				else // when mismatch calculation is disabled and subarrays are enabled, simply average the voltages together for the inverter input
-					dc_string_voltage = voltage_sum / n_voltage_values * modules_per_string;
+						// apply self-shading derate (by default it is 1.0 if disbled)
+						sa[nn].module.dcpwr *= sa[nn].poa.nonlinear_dc_shading_derate;
 
-				// sum up all DC power from the whole array
-				for (int nn = 0; nn < 4; nn++)
-				{
-					if (!sa[nn].enable
-						|| sa[nn].nstrings < 1)
-						continue; // skip disabled subarrays
+						if (iyear == 0) mppt_clip_window *= sa[nn].poa.nonlinear_dc_shading_derate;
 
-					// apply self-shading derate (by default it is 1.0 if disbled)
-					sa[nn].module.dcpwr *= sa[nn].poa.nonlinear_dc_shading_derate;
+						// scale power and voltage to array dimensions
+						sa[nn].module.dcpwr *= modules_per_string*sa[nn].nstrings;
+						if (iyear == 0) mppt_clip_window *= modules_per_string*sa[nn].nstrings;
 
-					if (iyear == 0) mppt_clip_window *= sa[nn].poa.nonlinear_dc_shading_derate;
+						// Calculate and apply snow coverage losses if activated
+						if (en_snow_model)
+						{
+							float smLoss = 0.0f;
 
-					// scale power and voltage to array dimensions
-					sa[nn].module.dcpwr *= modules_per_string*sa[nn].nstrings;
-					if (iyear == 0) mppt_clip_window *= modules_per_string*sa[nn].nstrings;
+							if (!sa[nn].sm.getLoss((float)(sa[nn].poa.ibeam + sa[nn].poa.iskydiff + sa[nn].poa.ignddiff),
+								(float)sa[nn].poa.stilt, (float)wf.wspd, (float)wf.tdry, (float)wf.snow, sunup, 1.0f / step_per_hour, &smLoss))
+							{
+								if (!sa[nn].sm.good)
+									throw exec_error("pvsamv1", sa[nn].sm.msg);
+							}
 
-					// Calculate and apply snow coverage losses if activated
-					if (en_snow_model)
-					{
-						float smLoss = 0.0f;
+							if (iyear == 0)
+							{
+								p_snowloss[nn][idx] = (ssc_number_t)(util::watt_to_kilowatt*sa[nn].module.dcpwr*smLoss);
+								p_dcsnowloss[idx] += (ssc_number_t)(util::watt_to_kilowatt*sa[nn].module.dcpwr*smLoss);
+								p_snowcoverage[nn][idx] = (ssc_number_t)(sa[nn].sm.coverage);
+								annual_snow_loss += (ssc_number_t)(util::watt_to_kilowatt*sa[nn].module.dcpwr*smLoss);
+							}
 
-						if (!sa[nn].sm.getLoss((float)(sa[nn].poa.ibeam + sa[nn].poa.iskydiff + sa[nn].poa.ignddiff),
-							(float)sa[nn].poa.stilt, (float)wf.wspd, (float)wf.tdry, (float)wf.snow, sunup, 1.0f / step_per_hour, &smLoss))
-						{
-							if (!sa[nn].sm.good)
-								throw exec_error("pvsamv1", sa[nn].sm.msg);
+							sa[nn].module.dcpwr *= (1 - smLoss);
 						}
 
+						// apply pre-inverter power derate
+						// apply yearly degradation as necessary
+
 						if (iyear == 0)
 						{
-							p_snowloss[nn][idx] = (ssc_number_t)(util::watt_to_kilowatt*sa[nn].module.dcpwr*smLoss);
-							p_dcsnowloss[idx] += (ssc_number_t)(util::watt_to_kilowatt*sa[nn].module.dcpwr*smLoss);
-							p_snowcoverage[nn][idx] = (ssc_number_t)(sa[nn].sm.coverage);
-							annual_snow_loss += (ssc_number_t)(util::watt_to_kilowatt*sa[nn].module.dcpwr*smLoss);
+							dc_gross[nn] += sa[nn].module.dcpwr*util::watt_to_kilowatt*ts_hour; //power W to	energy kWh
+							annual_mppt_window_clipping += mppt_clip_window*util::watt_to_kilowatt*ts_hour; //power W to	energy kWh
+							// save to SSC output arrays
+							p_tcell[nn][idx] = (ssc_number_t)sa[nn].module.tcell;
+							p_modeff[nn][idx] = (ssc_number_t)sa[nn].module.dceff;
+							p_dcv[nn][idx] = (ssc_number_t)sa[nn].module.dcv * modules_per_string;
+							p_voc[nn][idx] = (ssc_number_t)sa[nn].module.voc * modules_per_string;
+							p_isc[nn][idx] = (ssc_number_t)sa[nn].module.isc;
+							p_dcsubarray[nn][idx] = (ssc_number_t)(sa[nn].module.dcpwr * util::watt_to_kilowatt);
 						}
+						// Sara 1/25/16 - shading database derate applied to dc only
+						// shading loss applied to beam if not from shading database
+						sa[nn].module.dcpwr *= sa[nn].shad.dc_shade_factor();
 
-						sa[nn].module.dcpwr *= (1 - smLoss);
-					}
 
-					// apply pre-inverter power derate
-					// apply yearly degradation as necessary
+						dcpwr_net += sa[nn].module.dcpwr * sa[nn].derate;
 
+					}
+
+					// save other array-level environmental and irradiance outputs	- year 1 only outputs
 					if (iyear == 0)
 					{
-						dc_gross[nn] += sa[nn].module.dcpwr*util::watt_to_kilowatt*ts_hour; //power W to	energy kWh
-						annual_mppt_window_clipping += mppt_clip_window*util::watt_to_kilowatt*ts_hour; //power W to	energy kWh
-						// save to SSC output arrays
-						p_tcell[nn][idx] = (ssc_number_t)sa[nn].module.tcell;
-						p_modeff[nn][idx] = (ssc_number_t)sa[nn].module.dceff;
-						p_dcv[nn][idx] = (ssc_number_t)sa[nn].module.dcv * modules_per_string;
-						p_voc[nn][idx] = (ssc_number_t)sa[nn].module.voc * modules_per_string;
-						p_isc[nn][idx] = (ssc_number_t)sa[nn].module.isc;
-						p_dcsubarray[nn][idx] = (ssc_number_t)(sa[nn].module.dcpwr * util::watt_to_kilowatt);
+						p_wspd[idx] = (ssc_number_t)wf.wspd;
+						p_tdry[idx] = (ssc_number_t)wf.tdry;
+						p_albedo[idx] = (ssc_number_t)alb;
+						p_snowdepth[idx] = (ssc_number_t)wf.snow;
+
+						p_solzen[idx] = (ssc_number_t)solzen;
+						p_solalt[idx] = (ssc_number_t)solalt;
+						p_solazi[idx] = (ssc_number_t)solazi;
+
+						// absolute relative airmass calculation as f(zenith angle, site elevation)
+						p_airmass[idx] = sunup > 0 ? (ssc_number_t)(exp(-0.0001184 * hdr.elev) / (cos(solzen*3.1415926 / 180) + 0.5057*pow(96.080 - solzen, -1.634))) : 0.0f;
+						p_sunup[idx] = (ssc_number_t)sunup;
+
+						// save radiation values.  the ts_accum_* variables are units of (W), 
+						// and are sums of radiation power on each subarray for the current timestep
+						p_poanom_ts_total[idx] = (ssc_number_t)(ts_accum_poa_nom * util::watt_to_kilowatt); // kW
+						p_poabeamnom_ts_total[idx] = (ssc_number_t)(ts_accum_poa_beam_nom * util::watt_to_kilowatt); // kW
+						p_poashaded_ts_total[idx] = (ssc_number_t)(ts_accum_poa_shaded * util::watt_to_kilowatt); // kW
+						p_poaeff_ts_total[idx] = (ssc_number_t)(ts_accum_poa_eff * util::watt_to_kilowatt); // kW
+						p_poabeameff_ts_total[idx] = (ssc_number_t)(ts_accum_poa_beam_eff * util::watt_to_kilowatt); // kW
+						p_invmpptloss[idx] = (ssc_number_t)(mppt_clip_window * util::watt_to_kilowatt);
 					}
-					// Sara 1/25/16 - shading database derate applied to dc only
-					// shading loss applied to beam if not from shading database
-					sa[nn].module.dcpwr *= sa[nn].shad.dc_shade_factor();
-
-
-					dcpwr_net += sa[nn].module.dcpwr * sa[nn].derate;
 
+					// keep the weather driven dc power and voltage for replaying later years
+					if (lifetime_replay && iyear == 0)
+					{
+						dc_replay_net[idx] = dcpwr_net;
+						dc_replay_voltage[idx] = dc_string_voltage;
+					}
 				}
+
 				// bug fix jmf 12/13/16- losses that apply to ALL subarrays need to be applied OUTSIDE of the subarray summing loop
 				// if they're applied WITHIN the loop, as they had been, then the power from subarrays 1-3 get the SAME derate/degradation applied nn-1 times, instead of just once!!
 
@@ -2649,32 +2815,6 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 					dcpwr_net *= (100 - dc_lifetime_losses[dc_loss_index]) / 100;
 				}
 
-				// save other array-level environmental and irradiance outputs	- year 1 only outputs
-				if (iyear == 0)
-				{
-					p_wspd[idx] = (ssc_number_t)wf.wspd;
-					p_tdry[idx] = (ssc_number_t)wf.tdry;
-					p_albedo[idx] = (ssc_number_t)alb;
-					p_snowdepth[idx] = (ssc_number_t)wf.snow;
-
-					p_solzen[idx] = (ssc_number_t)solzen;
-					p_solalt[idx] = (ssc_number_t)solalt;
-					p_solazi[idx] = (ssc_number_t)solazi;
-
-					// absolute relative airmass calculation as f(zenith angle, site elevation)
-					p_airmass[idx] = sunup > 0 ? (ssc_number_t)(exp(-0.0001184 * hdr.elev) / (cos(solzen*3.1415926 / 180) + 0.5057*pow(96.080 - solzen, -1.634))) : 0.0f;
-					p_sunup[idx] = (ssc_number_t)sunup;
-
-					// save radiation values.  the ts_accum_* variables are units of (W), 
-					// and are sums of radiation power on each subarray for the current timestep
-					p_poanom_ts_total[idx] = (ssc_number_t)(ts_accum_poa_nom * util::watt_to_kilowatt); // kW
-					p_poabeamnom_ts_total[idx] = (ssc_number_t)(ts_accum_poa_beam_nom * util::watt_to_kilowatt); // kW
-					p_poashaded_ts_total[idx] = (ssc_number_t)(ts_accum_poa_shaded * util::watt_to_kilowatt); // kW
-					p_poaeff_ts_total[idx] = (ssc_number_t)(ts_accum_poa_eff * util::watt_to_kilowatt); // kW
-					p_poabeameff_ts_total[idx] = (ssc_number_t)(ts_accum_poa_beam_eff * util::watt_to_kilowatt); // kW
-					p_invmpptloss[idx] = (ssc_number_t)(mppt_clip_window * util::watt_to_kilowatt);
-				}
-				
 				p_inv_dc_voltage[idx] = (ssc_number_t)dc_string_voltage;
 				p_dcpwr[idx] = (ssc_number_t)(dcpwr_net * util::watt_to_kilowatt);
 
@@ -99,6 +99,8 @@ static var_info _cm_vtab_pvwattsv5_part2[] = {
 	/* battery */
 	{ SSC_INPUT,        SSC_NUMBER,      "batt_simple_enable",             "Enable Battery",                              "0/1",        "",                      "battwatts",     "?=0",                     "BOOLEAN",                        "" },
 
+	{ SSC_INPUT,        SSC_NUMBER,      "irrad_batch",                    "Calculate POA irradiance for all time steps before the simulation", "0/1", "",            "PVWatts",      "?=0",                     "BOOLEAN",                        "" },
+
 	/* outputs */
 	{ SSC_OUTPUT,       SSC_ARRAY,       "gh",                             "Global horizontal irradiance",                "W/m2",   "",                        "Time Series",      "*",                       "",                          "" },
 	{ SSC_OUTPUT,       SSC_ARRAY,       "dn",                             "Beam irradiance",                             "W/m2",   "",                        "Time Series",      "*",                       "",                          "" },
@@ -268,6 +270,24 @@ public:
 		return code;
 	}
 
+	int process_irradiance( irrad_batch &irr, size_t idx )
+	{
+		solazi = irr.solazi[idx];
+		solzen = irr.solzen[idx];
+		solalt = irr.solalt[idx];
+		sunup = irr.sunup[idx];
+		aoi = irr.aoi[idx];
+		stilt = irr.stilt[idx];
+		sazi = irr.sazi[idx];
+		rot = irr.rot[idx];
+		btd = irr.btd[idx];
+		ibeam = irr.poa_beam[idx];
+		iskydiff = irr.poa_skydiff[idx];
+		ignddiff = irr.poa_gnddiff[idx];
+
+		return irr.status[idx];
+	}
+
 	void powerout(double time, double &shad_beam, double shad_diff, double dni, double alb, double wspd, double tdry)
 	{
 		
@@ -405,7 +425,7 @@ public:
 		}
 		else if ( is_assigned( "solar_resource_data" ) )
 		{
-			wdprov = std::unique_ptr<weather_data_provider>( new weatherdata( lookup("solar_resource_data") ) );
+			wdprov = std::unique_ptr<weather_data_provider>( new weatherdata( lookup("solar_resource_data"), true ) );
 		}
 		else
 			throw exec_error("pvwattsv5", "no weather data supplied");
@@ -480,6 +500,43 @@ public:
 
 		initialize_cell_temp( ts_hour );
 
+		// optionally run the sun position and transposition calculations for the whole year up front
+		bool use_irrad_batch = as_boolean("irrad_batch");
+		irrad_batch irr_batch;
+		if ( use_irrad_batch )
+		{
+			irrad_timeseries its;
+			its.resize( nrec );
+			for( size_t i=0;i<nrec;i++ )
+			{
+				if (!wdprov->read( &wf ))
+					throw exec_error("pvwattsv5", util::format("could not read data line %d of %d in weather file", (int)(i+1), (int)nrec ));
+
+				its.year[i] = wf.year;
+				its.month[i] = wf.month;
+				its.day[i] = wf.day;
+				its.hour[i] = wf.hour;
+				its.minute[i] = wf.minute;
+				its.gh[i] = wf.gh;
+				its.dn[i] = wf.dn;
+				its.df[i] = wf.df;
+				its.alb[i] = ( std::isfinite( wf.alb ) && wf.alb > 0 && wf.alb < 1 ) ? wf.alb : 0.2;
+			}
+			wdprov->rewind();
+
+			irr_batch.set_location( hdr.lat, hdr.lon, hdr.tz );
+			irr_batch.set_sky_model( 2 );
+			irr_batch.set_radmode( DN_DF );
+			irr_batch.set_surface( track_mode, tilt, azimuth, 45.0,
+				shade_mode_1x == 1, // backtracking mode
+				gcr );
+			irr_batch.set_time_step( instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour );
+
+			int code = irr_batch.calc( its );
+			if ( code != 0 )
+				throw exec_error( "pvwattsv5", util::format("failed to process irradiation on surface (code: %d)", code) );
+		}
+
 		double annual_kwh = 0; 
 					
 		size_t hour=0, idx=0;
@@ -512,9 +569,10 @@ public:
 				if ( std::isfinite( wf.alb ) && wf.alb > 0 && wf.alb < 1 )
 					alb = wf.alb;					
 				
-				int code = process_irradiance(wf.year, wf.month, wf.day, wf.hour, wf.minute, 
-					instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour,
-					hdr.lat, hdr.lon, hdr.tz, wf.dn, wf.df, alb );
+				int code = use_irrad_batch ? process_irradiance( irr_batch, idx )
+					: process_irradiance(wf.year, wf.month, wf.day, wf.hour, wf.minute, 
+						instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour,
+						hdr.lat, hdr.lon, hdr.tz, wf.dn, wf.df, alb );
 
 				if ( -1 == code )
 				{
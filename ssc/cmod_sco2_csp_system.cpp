@@ -53,6 +53,7 @@
 #include <ctime>
 
 #include "sco2_pc_csp_int.h"
+#include "co2_props_table.h"
 
 static var_info _cm_vtab_sco2_csp_system[] = {
 
@@ -79,6 +80,7 @@ static var_info _cm_vtab_sco2_csp_system[] = {
 	{ SSC_INPUT,  SSC_NUMBER,  "LT_recup_eff_max",     "Maximum allowable effectiveness in LT recuperator",      "-",          "",    "",      "*",     "",       "" },
 	{ SSC_INPUT,  SSC_NUMBER,  "HT_recup_eff_max",     "Maximum allowable effectiveness in LT recuperator",      "-",          "",    "",      "*",     "",       "" },
 	{ SSC_INPUT,  SSC_NUMBER,  "P_high_limit",         "High pressure limit in cycle",                           "MPa",        "",    "",      "*",     "",       "" },
+	{ SSC_INPUT,  SSC_NUMBER,  "co2_props_table_tol",  "Relative accuracy of tabulated CO2 (P,h) and (P,s) properties, 0 = exact", "-", "", "", "?=0", "MIN=0", "" },
 		// PHX Design
 	{ SSC_INPUT,  SSC_NUMBER,  "dT_PHX_cold_approach", "Temp diff btw cold HTF and cold CO2",                    "C",          "",    "",      "*",     "",       "" },
 		// Air Cooler Design
@@ -299,6 +301,10 @@ public:
 
 		sco2_rc_des_par.m_is_recomp_ok = as_integer("is_recomp_ok");
 
+		// Tabulated CO2 properties for the cycle component and heat exchanger models; e.g. 1.E-8
+		// Applies to this thread until exec() returns
+		C_co2_props_table_tol_scope co2_props_table_tol(as_double("co2_props_table_tol"));
+
 		double mc_PR_in = as_double("is_PR_fixed");		//[-]
 		if (mc_PR_in != 0.0)
 		{
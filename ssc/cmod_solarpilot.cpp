@@ -133,6 +133,7 @@ static var_info _cm_vtab_solarpilot[] = {
     { SSC_INPUT,        SSC_NUMBER,      "opt_conv_tol",              "Optimization convergence tol",               "",       "",         "SolarPILOT",   "?=0.001",          "",                "" },
     { SSC_INPUT,        SSC_NUMBER,      "opt_algorithm",             "Optimization algorithm",                     "",       "",         "SolarPILOT",   "?=0",              "",                "" },
     { SSC_INPUT,        SSC_NUMBER,      "opt_flux_penalty",          "Optimization flux overage penalty",          "",       "",         "SolarPILOT",   "*",                "",                "" },
+    { SSC_INPUT,        SSC_NUMBER,      "solarpilot_threads",        "Number of SolarPILOT simulation threads",    "",       "1=serial,0=all cores", "SolarPILOT", "?=1",              "MIN=0,INTEGER",   "" },
 	{ SSC_INPUT,        SSC_MATRIX,      "helio_positions_in",        "Heliostat position table",                   "",       "",         "SolarPILOT",   "",                "",                "" },
 
 
@@ -49,7 +49,10 @@
 
 #include "core.h"
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 
   
@@ -61,6 +64,8 @@ static var_info vtab_utility_rate5[] = {
 	{ SSC_INPUT, SSC_NUMBER, "system_use_lifetime_output", "Lifetime hourly system outputs", "0/1", "0=hourly first year,1=hourly lifetime", "", "*", "INTEGER,MIN=0,MAX=1", "" },
 
 	{ SSC_INPUT, SSC_NUMBER, "TOU_demand_single_peak", "Use single monthly peak for TOU demand charge", "0/1", "0=use TOU peak,1=use flat peak", "", "?=0", "INTEGER,MIN=0,MAX=1", "" },
+
+	{ SSC_INPUT, SSC_NUMBER, "ur_threads", "Number of bill calculation threads", "", "1=serial,0=all cores", "", "?=1", "MIN=0,INTEGER", "" },
 	
 	// First year or lifetime hourly or subhourly
 	// load and gen expected to be > 0
@@ -401,6 +406,36 @@ public:
 
 };
 
+// working arrays for the bill calculations of one year - each thread calculating years in parallel has its own
+class ur_year
+{
+public:
+	ur_year(size_t nrec)
+		: e_sys_cy(nrec), p_sys_cy(nrec), e_grid_cy(nrec), p_grid_cy(nrec), e_load_cy(nrec), p_load_cy(nrec),
+		revenue_w_sys(nrec), revenue_wo_sys(nrec), payment(nrec), income(nrec),
+		demand_charge_w_sys(nrec), energy_charge_w_sys(nrec), energy_charge_gross_w_sys(nrec),
+		demand_charge_wo_sys(nrec), energy_charge_wo_sys(nrec), dc_hourly_peak(nrec),
+		monthly_fixed_charges(12), monthly_minimum_charges(12), monthly_dc_fixed(12), monthly_dc_tou(12),
+		monthly_ec_charges(12), monthly_ec_charges_gross(12),
+		monthly_excess_dollars_applied(12), monthly_excess_dollars_earned(12),
+		monthly_excess_kwhs_applied(12), monthly_excess_kwhs_earned(12),
+		monthly_cumulative_excess_energy(12), monthly_cumulative_excess_dollars(12), monthly_bill(12)
+	{
+	}
+	// current year system, grid and load (accounts for degradation and escalation)
+	std::vector<ssc_number_t> e_sys_cy, p_sys_cy, e_grid_cy, p_grid_cy, e_load_cy, p_load_cy;
+	// time step results
+	std::vector<ssc_number_t> revenue_w_sys, revenue_wo_sys, payment, income,
+		demand_charge_w_sys, energy_charge_w_sys, energy_charge_gross_w_sys,
+		demand_charge_wo_sys, energy_charge_wo_sys, dc_hourly_peak;
+	// monthly results
+	std::vector<ssc_number_t> monthly_fixed_charges, monthly_minimum_charges, monthly_dc_fixed, monthly_dc_tou,
+		monthly_ec_charges, monthly_ec_charges_gross,
+		monthly_excess_dollars_applied, monthly_excess_dollars_earned,
+		monthly_excess_kwhs_applied, monthly_excess_kwhs_earned,
+		monthly_cumulative_excess_energy, monthly_cumulative_excess_dollars, monthly_bill;
+};
+
 class cm_utilityrate5 : public compute_module
 {
 private:
@@ -419,6 +454,18 @@ private:
 	std::vector<std::vector<int> >  m_dc_flat_tiers; // tier numbers for each month of flat demand charge
 	size_t m_num_rec_yearly;
 
+	// compiled tariff - built once in setup() and shared by every year and every bill calculation
+	std::vector<size_t> m_month_first_step; // first time step of each month, and m_num_rec_yearly at [12]
+	std::vector<int> m_ec_sched_row; // row of the time step energy period in m_month[m].ec_periods
+	std::vector<int> m_dc_sched_row; // row of the time step demand period in m_month[m].dc_periods
+	int m_metering_option;
+	bool m_dc_enabled;
+	bool m_tou_demand_single_peak;
+	ssc_number_t m_monthly_fixed_charge;
+	ssc_number_t m_monthly_min_charge;
+	ssc_number_t m_annual_min_charge;
+	ssc_number_t m_nm_yearend_sell_rate;
+
 public:
 	cm_utilityrate5()
 	{
@@ -428,7 +475,7 @@ public:
 	void exec( ) throw( general_error )
 	{
 		ssc_number_t *parr = 0;
-		size_t count, i, j; 
+		size_t count, i; 
 
 		size_t nyears = (size_t)as_integer("analysis_period");
 		double inflation_rate = as_double("inflation_rate")*0.01;
@@ -524,12 +571,9 @@ public:
 		}
 //		ssc_number_t ts_hour_load = 1.0f / step_per_hour_load;
 
-		// prepare timestep arrays for load and grid values
+		// prepare timestep arrays for load values
 		std::vector<ssc_number_t> 
-			e_sys_cy(m_num_rec_yearly), p_sys_cy(m_num_rec_yearly),
-			p_load(m_num_rec_yearly), // to handle no load, or num load != num gen
-			e_grid_cy(m_num_rec_yearly), p_grid_cy(m_num_rec_yearly),
-			e_load_cy(m_num_rec_yearly), p_load_cy(m_num_rec_yearly); // current year load (accounts for escal)
+			p_load(m_num_rec_yearly); // to handle no load, or num load != num gen
 
 
 
@@ -563,27 +607,16 @@ public:
 		assign("year1_electric_load", year1_elec_load* ts_hour_gen);
 
 		
-		/* allocate intermediate data arrays */
-		std::vector<ssc_number_t> revenue_w_sys(m_num_rec_yearly), revenue_wo_sys(m_num_rec_yearly),
-			payment(m_num_rec_yearly), income(m_num_rec_yearly), 
-			demand_charge_w_sys(m_num_rec_yearly), energy_charge_w_sys(m_num_rec_yearly), energy_charge_gross_w_sys(m_num_rec_yearly),
-			demand_charge_wo_sys(m_num_rec_yearly), energy_charge_wo_sys(m_num_rec_yearly),
-			ec_tou_sched(m_num_rec_yearly), dc_tou_sched(m_num_rec_yearly), load(m_num_rec_yearly), dc_hourly_peak(m_num_rec_yearly),
+		/* allocate first year output arrays - the arrays for each year's bill calculations are in ur_year */
+		std::vector<ssc_number_t> 
+			ec_tou_sched(m_num_rec_yearly), dc_tou_sched(m_num_rec_yearly), load(m_num_rec_yearly),
 			e_tofromgrid(m_num_rec_yearly), p_tofromgrid(m_num_rec_yearly), salespurchases(m_num_rec_yearly);
 		std::vector<ssc_number_t> monthly_revenue_w_sys(12), monthly_revenue_wo_sys(12),
-			monthly_fixed_charges(12), monthly_minimum_charges(12),
-			monthly_dc_fixed(12), monthly_dc_tou(12),
-			monthly_ec_charges(12),
-			monthly_ec_charges_gross(12),
-			monthly_excess_dollars_applied(12),
-			monthly_excess_dollars_earned(12),
-			monthly_excess_kwhs_applied(12),
-			monthly_excess_kwhs_earned(12),
 			monthly_ec_rates(12),
 			monthly_salespurchases(12),
 			monthly_load(12), monthly_system_generation(12), monthly_elec_to_grid(12),
 			monthly_elec_needed_from_grid(12),
-			monthly_cumulative_excess_energy(12), monthly_cumulative_excess_dollars(12), monthly_bill(12), monthly_peak(12), monthly_test(12);
+			monthly_peak(12), monthly_test(12);
 
 		/* allocate outputs */		
 		ssc_number_t *annual_net_revenue = allocate("annual_energy_value", nyears+1);
@@ -753,9 +786,28 @@ public:
 		bool timestep_reconciliation = (metering_option == 2 || metering_option == 3 || metering_option == 4);
 
 
-		idx = 0;
-		for (i=0;i<nyears;i++)
+		bool lifetime_output = (as_integer("system_use_lifetime_output") == 1);
+
+		// bill calculations for year i, using the month tables in months.  the first year outputs
+		// are taken from m_month, so year 0 is always calculated with months = m_month
+		auto calc_year = [&](size_t i, ur_year &y, std::vector<ur_month> &months)
 		{
+			std::vector<ssc_number_t> &e_sys_cy = y.e_sys_cy, &p_sys_cy = y.p_sys_cy, &e_grid_cy = y.e_grid_cy, &p_grid_cy = y.p_grid_cy,
+				&e_load_cy = y.e_load_cy, &p_load_cy = y.p_load_cy, &revenue_w_sys = y.revenue_w_sys, &revenue_wo_sys = y.revenue_wo_sys,
+				&payment = y.payment, &income = y.income, &demand_charge_w_sys = y.demand_charge_w_sys,
+				&energy_charge_w_sys = y.energy_charge_w_sys, &energy_charge_gross_w_sys = y.energy_charge_gross_w_sys,
+				&demand_charge_wo_sys = y.demand_charge_wo_sys, &energy_charge_wo_sys = y.energy_charge_wo_sys,
+				&dc_hourly_peak = y.dc_hourly_peak, &monthly_fixed_charges = y.monthly_fixed_charges,
+				&monthly_minimum_charges = y.monthly_minimum_charges, &monthly_dc_fixed = y.monthly_dc_fixed,
+				&monthly_dc_tou = y.monthly_dc_tou, &monthly_ec_charges = y.monthly_ec_charges,
+				&monthly_ec_charges_gross = y.monthly_ec_charges_gross, &monthly_excess_dollars_applied = y.monthly_excess_dollars_applied,
+				&monthly_excess_dollars_earned = y.monthly_excess_dollars_earned,
+				&monthly_excess_kwhs_applied = y.monthly_excess_kwhs_applied, &monthly_excess_kwhs_earned = y.monthly_excess_kwhs_earned,
+				&monthly_cumulative_excess_energy = y.monthly_cumulative_excess_energy,
+				&monthly_cumulative_excess_dollars = y.monthly_cumulative_excess_dollars, &monthly_bill = y.monthly_bill;
+			size_t j;
+			size_t idx = i * m_num_rec_yearly; // first lifetime record of the year
+
 			for (j = 0; j<m_num_rec_yearly; j++)
 			{
 				/* for future implementation for lifetime loads
@@ -785,7 +837,7 @@ public:
 
 
 				// update e_sys per year if lifetime output
-				if ((as_integer("system_use_lifetime_output") == 1) && ( idx < nrec_gen ))
+				if (lifetime_output && ( idx < nrec_gen ))
 				{
 //					e_sys[j] = p_sys[j] = 0.0;
 //					ts_power = (idx < nrec_gen) ? pgen[idx] : 0;
@@ -816,7 +868,7 @@ public:
 			// now calculate revenue without solar system (using load only)
 			if (timestep_reconciliation)
 			{
-				ur_calc_timestep(&e_load_cy[0], &p_load_cy[0],
+				ur_calc_timestep(months, &e_load_cy[0], &p_load_cy[0],
 					&revenue_wo_sys[0], &payment[0], &income[0], &demand_charge_wo_sys[0], &energy_charge_wo_sys[0],
 					&monthly_fixed_charges[0], &monthly_minimum_charges[0],
 					&monthly_dc_fixed[0], &monthly_dc_tou[0],
@@ -830,7 +882,7 @@ public:
 			}
 			else
 			{
-				ur_calc(&e_load_cy[0], &p_load_cy[0],
+				ur_calc(months, &e_load_cy[0], &p_load_cy[0],
 					&revenue_wo_sys[0], &payment[0], &income[0], &demand_charge_wo_sys[0], &energy_charge_wo_sys[0],
 					&monthly_fixed_charges[0], &monthly_minimum_charges[0],
 					&monthly_dc_fixed[0], &monthly_dc_tou[0],
@@ -964,7 +1016,7 @@ public:
 			{
 				if (two_meter)
 				{
-					ur_calc_timestep(&e_sys_cy[0], &p_sys_cy[0],
+					ur_calc_timestep(months, &e_sys_cy[0], &p_sys_cy[0],
 						&revenue_w_sys[0], &payment[0], &income[0],
 						&demand_charge_w_sys[0], &energy_charge_w_sys[0],
 						&monthly_fixed_charges[0], &monthly_minimum_charges[0],
@@ -979,7 +1031,7 @@ public:
 				}
 				else
 				{
-					ur_calc_timestep(&e_grid_cy[0], &p_grid_cy[0],
+					ur_calc_timestep(months, &e_grid_cy[0], &p_grid_cy[0],
 						&revenue_w_sys[0], &payment[0], &income[0], 
 						&demand_charge_w_sys[0], &energy_charge_w_sys[0],
 						&monthly_fixed_charges[0], &monthly_minimum_charges[0],
@@ -998,7 +1050,7 @@ public:
 				if (two_meter)
 				{
 					// calculate revenue with solar system (using system energy & maxpower)
-					ur_calc(&e_sys_cy[0], &p_sys_cy[0],
+					ur_calc(months, &e_sys_cy[0], &p_sys_cy[0],
 						&revenue_w_sys[0], &payment[0], &income[0],
 						&demand_charge_w_sys[0], &energy_charge_w_sys[0],
 						&monthly_fixed_charges[0], &monthly_minimum_charges[0],
@@ -1014,7 +1066,7 @@ public:
 				else
 				{
 					// calculate revenue with solar system (using net grid energy & maxpower)
-					ur_calc(&e_grid_cy[0], &p_grid_cy[0],
+					ur_calc(months, &e_grid_cy[0], &p_grid_cy[0],
 						&revenue_w_sys[0], &payment[0], &income[0], 
 						&demand_charge_w_sys[0], &energy_charge_w_sys[0],
 						&monthly_fixed_charges[0], &monthly_minimum_charges[0],
@@ -1309,8 +1361,64 @@ public:
 				ch_w_sys_fixed[i + 1] += monthly_fixed_charges[j];
 				ch_w_sys_minimum[i + 1] += monthly_minimum_charges[j];
 			}
+		};
+
+		/* with no rollover of credits between months (net billing and two meters), the years are
+		   independent and can be calculated in parallel, each thread with its own month tables and
+		   working arrays.  year 0 is calculated first on this thread for the first year outputs.
+		   serial by default, since callers often already run many rate cases concurrently */
+		int nthreads = as_integer("ur_threads");
+		if (nthreads < 1)
+			nthreads = (int)std::thread::hardware_concurrency();
+		if (nthreads < 1 || !timestep_reconciliation)
+			nthreads = 1;
+		if ((size_t)nthreads > nyears)
+			nthreads = (int)nyears;
+
+		ur_year year0(m_num_rec_yearly);
+		if (nthreads == 1)
+		{
+			for (i = 0; i < nyears; i++)
+				calc_year(i, year0, m_month);
+		}
+		else
+		{
+			std::vector<ur_month> month_init(m_month); // before year 0 changes m_month
+			std::atomic<size_t> next_year(1);
+			std::mutex error_mutex;
+			std::exception_ptr error;
+
+			auto calc_years = [&](bool first_year)
+			{
+				try
+				{
+					if (first_year)
+						calc_year(0, year0, m_month);
+
+					std::vector<ur_month> months(month_init);
+					ur_year y(m_num_rec_yearly);
+					size_t iy;
+					while ((iy = next_year++) < nyears)
+						calc_year(iy, y, months);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(error_mutex);
+					if (!error)
+						error = std::current_exception();
+					next_year = nyears;
+				}
+			};
 
+			std::vector<std::thread> threads;
+			for (int t = 1; t < nthreads; t++)
+				threads.push_back(std::thread(calc_years, false));
+			calc_years(true);
+			for (size_t t = 0; t < threads.size(); t++)
+				threads[t].join();
 
+			if (error)
+				std::rethrow_exception(error);
 		}
 
 		assign("elec_cost_with_system_year1", annual_elec_cost_w_sys[1]);
@@ -1394,6 +1502,14 @@ public:
 		bool dc_enabled = as_boolean("ur_dc_enable");
 		bool en_ts_sell_rate = as_boolean("ur_en_ts_sell_rate");
 
+		m_metering_option = as_integer("ur_metering_option");
+		m_dc_enabled = dc_enabled;
+		m_tou_demand_single_peak = (as_integer("TOU_demand_single_peak") == 1);
+		m_monthly_fixed_charge = as_number("ur_monthly_fixed_charge");
+		m_monthly_min_charge = as_number("ur_monthly_min_charge");
+		m_annual_min_charge = as_number("ur_annual_min_charge");
+		m_nm_yearend_sell_rate = as_number("ur_nm_yearend_sell_rate");
+
 		if (en_ts_sell_rate)
 		{
 			if (!is_assigned("ur_ts_sell_rate"))
@@ -1864,12 +1980,48 @@ public:
 
 		}
 
+		// month boundaries and the monthly period row for every time step, so that the bill
+		// calculations index the month matrices directly instead of searching the period lists
+		m_month_first_step.assign(13, 0);
+		for (m = 0; m < 12; m++)
+			m_month_first_step[m + 1] = m_month_first_step[m] + util::nday[m] * 24 * steps_per_hour;
+
+		m_ec_sched_row.assign(m_num_rec_yearly, 0);
+		m_dc_sched_row.assign(m_num_rec_yearly, 0);
+		for (m = 0; m < 12; m++)
+		{
+			for (c = m_month_first_step[m]; c < m_month_first_step[m + 1] && c < m_num_rec_yearly; c++)
+			{
+				if (ec_enabled)
+				{
+					std::vector<int>::iterator per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), m_ec_tou_sched[c]);
+					if (per_num == m_month[m].ec_periods.end())
+					{
+						std::ostringstream ss;
+						ss << "Energy rate TOU Period " << m_ec_tou_sched[c] << " not found for Month " << util::schedule_int_to_month((int)m) << ".";
+						throw exec_error("utilityrate5", ss.str());
+					}
+					m_ec_sched_row[c] = (int)(per_num - m_month[m].ec_periods.begin());
+				}
+				if (dc_enabled)
+				{
+					std::vector<int>::iterator per_num = std::find(m_month[m].dc_periods.begin(), m_month[m].dc_periods.end(), m_dc_tou_sched[c]);
+					if (per_num == m_month[m].dc_periods.end())
+					{
+						std::ostringstream ss;
+						ss << "Demand rate Period " << m_dc_tou_sched[c] << " not found for Month " << m << ".";
+						throw exec_error("utilityrate5", ss.str());
+					}
+					m_dc_sched_row[c] = (int)(per_num - m_month[m].dc_periods.begin());
+				}
+			}
+		}
 	}
 
 
 
 
-	void ur_calc( ssc_number_t *e_in, ssc_number_t *p_in,
+	void ur_calc( std::vector<ur_month> &months, ssc_number_t *e_in, ssc_number_t *p_in,
 		ssc_number_t *revenue, ssc_number_t *payment, ssc_number_t *income, 
 		ssc_number_t *demand_charge, ssc_number_t *energy_charge,
 		ssc_number_t monthly_fixed_charges[12], ssc_number_t monthly_minimum_charges[12],
@@ -1914,45 +2066,36 @@ public:
 		3=Two meters with all generation sold and all load purchaseded
 		4=Single meter with monthly rollover credits in $ (Net Billing $)
 		*/
-		int metering_option = as_integer("ur_metering_option");
+		int metering_option = m_metering_option;
 		bool enable_nm = (metering_option == 0 || metering_option == 1);
 
 		bool ec_enabled = true; // per 2/25/16 meeting
-		bool dc_enabled = as_boolean("ur_dc_enable");
+		bool dc_enabled = m_dc_enabled;
 
-		bool excess_monthly_dollars = (as_integer("ur_metering_option") == 1);
+		bool excess_monthly_dollars = (metering_option == 1);
 
-		bool tou_demand_single_peak = (as_integer("TOU_demand_single_peak") == 1);
+		bool tou_demand_single_peak = m_tou_demand_single_peak;
 
 
-		size_t steps_per_hour = m_num_rec_yearly / 8760;
 		// calculate the monthly net energy and monthly hours
-		int m, d, h, s, period, tier;
+		int m, period, tier;
 		int c = 0;
-		for (m = 0; m < (int)m_month.size(); m++)
+		for (m = 0; m < (int)months.size(); m++)
 		{
-			m_month[m].energy_net = 0;
-			m_month[m].hours_per_month = 0;
-			m_month[m].dc_flat_peak = 0;
-			m_month[m].dc_flat_peak_hour = 0;
-			for (d = 0; d < util::nday[m]; d++)
+			int c_end = (int)m_month_first_step[m + 1];
+			months[m].energy_net = 0;
+			months[m].hours_per_month = c_end - (int)m_month_first_step[m];
+			months[m].dc_flat_peak = 0;
+			months[m].dc_flat_peak_hour = 0;
+			for (c = (int)m_month_first_step[m]; c < c_end; c++)
 			{
-				for (h = 0; h < 24; h++)
+				// net energy use per month
+				months[m].energy_net += e_in[c]; // -load and +gen
+				// peak
+				if (p_in[c] < 0 && p_in[c] < -months[m].dc_flat_peak)
 				{
-					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
-					{
-						// net energy use per month
-						m_month[m].energy_net += e_in[c]; // -load and +gen
-						// hours per period per month
-						m_month[m].hours_per_month++;
-						// peak
-						if (p_in[c] < 0 && p_in[c] < -m_month[m].dc_flat_peak)
-						{
-							m_month[m].dc_flat_peak = -p_in[c];
-							m_month[m].dc_flat_peak_hour = c;
-						}
-						c++;
-					}
+					months[m].dc_flat_peak = -p_in[c];
+					months[m].dc_flat_peak_hour = c;
 				}
 			}
 		}
@@ -1964,26 +2107,26 @@ public:
 			for (m = 0; m < 12; m++)
 			{
 				prev_value = (m > 0) ? monthly_cumulative_excess_energy[m - 1] : 0;
-				monthly_cumulative_excess_energy[m] = ((prev_value + m_month[m].energy_net) > 0) ? (prev_value + m_month[m].energy_net) : 0;
+				monthly_cumulative_excess_energy[m] = ((prev_value + months[m].energy_net) > 0) ? (prev_value + months[m].energy_net) : 0;
 			}
 		}
 
 		// excess earned
 		for (m = 0; m < 12; m++)
 		{
-			if (m_month[m].energy_net > 0)
-				excess_kwhs_earned[m] = m_month[m].energy_net;
+			if (months[m].energy_net > 0)
+				excess_kwhs_earned[m] = months[m].energy_net;
 		}
 
 	
 		// adjust net energy if net metering with monthly rollover
 		if (enable_nm && !excess_monthly_dollars)
 		{
-			for (m = 1; m < (int)m_month.size(); m++)
+			for (m = 1; m < (int)months.size(); m++)
 			{
-				if (m_month[m].energy_net < 0)
+				if (months[m].energy_net < 0)
 				{
-					m_month[m].energy_net += monthly_cumulative_excess_energy[m - 1];
+					months[m].energy_net += monthly_cumulative_excess_energy[m - 1];
 					excess_kwhs_applied[m] = monthly_cumulative_excess_energy[m - 1];
 				}
 			}
@@ -1993,19 +2136,18 @@ public:
 		if (ec_enabled)
 		{
 			// calculate the monthly net energy per tier and period based on units
-			c = 0;
-			for (m = 0; m < (int)m_month.size(); m++)
+			for (m = 0; m < (int)months.size(); m++)
 			{
 				int start_tier = 0;
-				int end_tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
-				int num_periods = (int)m_month[m].ec_tou_ub_init.nrows();
+				int end_tier = (int)months[m].ec_tou_ub.ncols() - 1;
+				int num_periods = (int)months[m].ec_tou_ub_init.nrows();
 				int num_tiers = end_tier - start_tier + 1;
 
 				if (!gen_only) // added for two meter no load scenarios to use load tier sizing
 				{
 					//start_tier = 0;
-					end_tier = (int)m_month[m].ec_tou_ub_init.ncols() - 1;
-					//int num_periods = (int)m_month[m].ec_tou_ub_init.nrows();
+					end_tier = (int)months[m].ec_tou_ub_init.ncols() - 1;
+					//int num_periods = (int)months[m].ec_tou_ub_init.nrows();
 					num_tiers = end_tier - start_tier + 1;
 
 					// kWh/kW (kWh/kW daily handled in Setup)
@@ -2015,19 +2157,19 @@ public:
 					// 4. assumption is that all periods in same month have same tier breakdown
 					// 5. assumption is that tier numbering is correct for the kWh/kW breakdown
 					// That is, first tier must be kWh/kW
-					if ((m_month[m].ec_tou_units.ncols()>0 && m_month[m].ec_tou_units.nrows() > 0)
-						&& ((m_month[m].ec_tou_units.at(0, 0) == 1) || (m_month[m].ec_tou_units.at(0, 0) == 3)))
+					if ((months[m].ec_tou_units.ncols()>0 && months[m].ec_tou_units.nrows() > 0)
+						&& ((months[m].ec_tou_units.at(0, 0) == 1) || (months[m].ec_tou_units.at(0, 0) == 3)))
 					{
 						// monthly total energy / monthly peak to determine which kWh/kW tier
-						double mon_kWhperkW = -m_month[m].energy_net; // load negative
-						if (m_month[m].dc_flat_peak != 0)
-							mon_kWhperkW /= m_month[m].dc_flat_peak;
+						double mon_kWhperkW = -months[m].energy_net; // load negative
+						if (months[m].dc_flat_peak != 0)
+							mon_kWhperkW /= months[m].dc_flat_peak;
 						// find correct start and end tier based on kWhperkW band
 						start_tier = 1;
 						bool found = false;
-						for (size_t i_tier = 0; i_tier < m_month[m].ec_tou_units.ncols(); i_tier++)
+						for (size_t i_tier = 0; i_tier < months[m].ec_tou_units.ncols(); i_tier++)
 						{
-							int units = (int)m_month[m].ec_tou_units.at(0, i_tier);
+							int units = (int)months[m].ec_tou_units.at(0, i_tier);
 							if ((units == 1) || (units == 3))
 							{
 								if (found)
@@ -2035,7 +2177,7 @@ public:
 									end_tier = (int)i_tier - 1;
 									break;
 								}
-								else if (mon_kWhperkW < m_month[m].ec_tou_ub_init.at(0, i_tier))
+								else if (mon_kWhperkW < months[m].ec_tou_ub_init.at(0, i_tier))
 								{
 									start_tier = (int)i_tier + 1;
 									found = true;
@@ -2044,8 +2186,8 @@ public:
 						}
 						// last tier since no max specified in rate
 						if (!found) start_tier = end_tier;
-						if (start_tier >= (int)m_month[m].ec_tou_ub_init.ncols())
-							start_tier = (int)m_month[m].ec_tou_ub_init.ncols() - 1;
+						if (start_tier >= (int)months[m].ec_tou_ub_init.ncols())
+							start_tier = (int)months[m].ec_tou_ub_init.ncols() - 1;
 						if (end_tier < start_tier)
 							end_tier = start_tier;
 						num_tiers = end_tier - start_tier + 1;
@@ -2059,27 +2201,27 @@ public:
 						{
 							for (tier = 0; tier < num_tiers; tier++)
 							{
-								br.at(period, tier) = m_month[m].ec_tou_br_init.at(period, start_tier + tier);
-								sr.at(period, tier) = m_month[m].ec_tou_sr_init.at(period, start_tier + tier);
-								ub.at(period, tier) = m_month[m].ec_tou_ub_init.at(period, start_tier + tier);
+								br.at(period, tier) = months[m].ec_tou_br_init.at(period, start_tier + tier);
+								sr.at(period, tier) = months[m].ec_tou_sr_init.at(period, start_tier + tier);
+								ub.at(period, tier) = months[m].ec_tou_ub_init.at(period, start_tier + tier);
 								// update for correct tier number column headings
-								m_month[m].ec_periods_tiers[period][tier] = start_tier + m_ec_periods_tiers_init[period][tier];
+								months[m].ec_periods_tiers[period][tier] = start_tier + m_ec_periods_tiers_init[period][tier];
 							}
 						}
 
-						m_month[m].ec_tou_br = br;
-						m_month[m].ec_tou_sr = sr;
-						m_month[m].ec_tou_ub = ub;
+						months[m].ec_tou_br = br;
+						months[m].ec_tou_sr = sr;
+						months[m].ec_tou_ub = ub;
 					}
 
 					// reset now resized - if necessary
 				}
 				start_tier = 0;
-				end_tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
+				end_tier = (int)months[m].ec_tou_ub.ncols() - 1;
 
-				m_month[m].ec_energy_use.resize_fill(num_periods, num_tiers, 0);
-				m_month[m].ec_energy_surplus.resize_fill(num_periods, num_tiers, 0);
-				m_month[m].ec_charge.resize_fill(num_periods, num_tiers, 0);
+				months[m].ec_energy_use.resize_fill(num_periods, num_tiers, 0);
+				months[m].ec_energy_surplus.resize_fill(num_periods, num_tiers, 0);
+				months[m].ec_charge.resize_fill(num_periods, num_tiers, 0);
 
 
 
@@ -2094,28 +2236,12 @@ public:
 					mon_e_net = monthly_cumulative_excess_energy[m - 1]; // rollover
 				}
 
-				for (d = 0; d < util::nday[m]; d++)
+				for (c = (int)m_month_first_step[m]; c < (int)m_month_first_step[m + 1]; c++)
 				{
-					for (h = 0; h < 24; h++)
-					{
-						for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
-						{
-							mon_e_net += e_in[c];
-							int toup = m_ec_tou_sched[c];
-							std::vector<int>::iterator per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), toup);
-							if (per_num == m_month[m].ec_periods.end())
-							{
-								std::ostringstream ss;
-								ss << "Energy rate TOU Period " << toup << " not found for Month " << util::schedule_int_to_month(m) << ".";
-								throw exec_error("utilityrate5", ss.str());
-							}
-							int row = (int)(per_num - m_month[m].ec_periods.begin());
-							// place all in tier 0 initially and then update appropriately
-							// net energy per period per month
-							m_month[m].ec_energy_use(row, 0) += e_in[c];
-							c++;
-						}
-					}
+					mon_e_net += e_in[c];
+					// place all in tier 0 initially and then update appropriately
+					// net energy per period per month
+					months[m].ec_energy_use(m_ec_sched_row[c], 0) += e_in[c];
 				}
 
 				/*
@@ -2123,13 +2249,13 @@ public:
 				if (m > 0 && enable_nm && !excess_monthly_kwhs)
 				{
 					// check for surplus in previous month for same period
-					for (size_t ir = 0; ir < m_month[m - 1].ec_energy_surplus.nrows(); ir++)
+					for (size_t ir = 0; ir < months[m - 1].ec_energy_surplus.nrows(); ir++)
 					{
-						if (m_month[m - 1].ec_energy_surplus.at(ir, 0) > 0) // surplus - check period
+						if (months[m - 1].ec_energy_surplus.at(ir, 0) > 0) // surplus - check period
 						{
-							int toup = m_month[m - 1].ec_periods[ir]; // number of rows of previous month
-							std::vector<int>::iterator per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), toup);
-							if (per_num == m_month[m].ec_periods.end())
+							int toup = months[m - 1].ec_periods[ir]; // number of rows of previous month
+							std::vector<int>::iterator per_num = std::find(months[m].ec_periods.begin(), months[m].ec_periods.end(), toup);
+							if (per_num == months[m].ec_periods.end())
 							{
 								std::ostringstream ss;
 								ss << "utilityrate5: energy charge rollover for period " << toup << " not found for month " << m;
@@ -2138,11 +2264,11 @@ public:
 							else
 							{
 								ssc_number_t extra = 0;
-								int row = (int)(per_num - m_month[m].ec_periods.begin());
-								for (size_t ic = 0; ic < m_month[m - 1].ec_energy_surplus.ncols(); ic++)
-									extra += m_month[m - 1].ec_energy_surplus.at(ir, ic);
+								int row = (int)(per_num - months[m].ec_periods.begin());
+								for (size_t ic = 0; ic < months[m - 1].ec_energy_surplus.ncols(); ic++)
+									extra += months[m - 1].ec_energy_surplus.at(ir, ic);
 
-								m_month[m].ec_energy_use(row, 0) += extra;
+								months[m].ec_energy_use(row, 0) += extra;
 							}
 						}
 					}
@@ -2153,14 +2279,14 @@ public:
 				if (m > 0 && enable_nm && !excess_monthly_dollars)
 				{
 					// check for surplus in previous month for same period
-					for (size_t ir = 0; ir < m_month[m - 1].ec_energy_surplus.nrows(); ir++)
+					for (size_t ir = 0; ir < months[m - 1].ec_energy_surplus.nrows(); ir++)
 					{
-						if (m_month[m - 1].ec_energy_surplus.at(ir, 0) > 0) // surplus - check period
+						if (months[m - 1].ec_energy_surplus.at(ir, 0) > 0) // surplus - check period
 						{
-							int toup_source = m_month[m - 1].ec_periods[ir]; // number of rows of previous month - and period with surplus
+							int toup_source = months[m - 1].ec_periods[ir]; // number of rows of previous month - and period with surplus
 							// find source period in rollover map for previous month
-							std::vector<int>::iterator source_per_num = std::find(m_month[m-1].ec_rollover_periods.begin(), m_month[m-1].ec_rollover_periods.end(), toup_source);
-							if (source_per_num == m_month[m-1].ec_rollover_periods.end())
+							std::vector<int>::iterator source_per_num = std::find(months[m-1].ec_rollover_periods.begin(), months[m-1].ec_rollover_periods.end(), toup_source);
+							if (source_per_num == months[m-1].ec_rollover_periods.end())
 							{
 								std::ostringstream ss;
 								ss << "year:" << year << " utilityrate5: Unable to determine period for energy charge rollover: Period " << toup_source << " does not exist for 12 am, 6 am, 12 pm or 6 pm in the previous month, which is Month " << util::schedule_int_to_month(m-1) << ".";
@@ -2170,22 +2296,22 @@ public:
 							{
 								// find corresponding target period for same time of day
 								ssc_number_t extra = 0;
-								int rollover_index = (int)(source_per_num - m_month[m-1].ec_rollover_periods.begin());
-								if (rollover_index < (int)m_month[m].ec_rollover_periods.size())
+								int rollover_index = (int)(source_per_num - months[m-1].ec_rollover_periods.begin());
+								if (rollover_index < (int)months[m].ec_rollover_periods.size())
 								{
-									int toup_target = m_month[m].ec_rollover_periods[rollover_index];
-									std::vector<int>::iterator target_per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), toup_target);
-									if (target_per_num == m_month[m].ec_periods.end())
+									int toup_target = months[m].ec_rollover_periods[rollover_index];
+									std::vector<int>::iterator target_per_num = std::find(months[m].ec_periods.begin(), months[m].ec_periods.end(), toup_target);
+									if (target_per_num == months[m].ec_periods.end())
 									{
 										std::ostringstream ss;
 										ss << "year:" << year << "utilityrate5: Unable to determine period for energy charge rollover: Period " << toup_target << " does not exist for 12 am, 6 am, 12 pm or 6 pm in the current month, which is " << util::schedule_int_to_month(m) << ".";
 										log(ss.str(), SSC_NOTICE);
 									}
-									int target_row = (int)(target_per_num - m_month[m].ec_periods.begin());
-									for (size_t ic = 0; ic < m_month[m - 1].ec_energy_surplus.ncols(); ic++)
-										extra += m_month[m - 1].ec_energy_surplus.at(ir, ic);
+									int target_row = (int)(target_per_num - months[m].ec_periods.begin());
+									for (size_t ic = 0; ic < months[m - 1].ec_energy_surplus.ncols(); ic++)
+										extra += months[m - 1].ec_energy_surplus.at(ir, ic);
 
-									m_month[m].ec_energy_use(target_row, 0) += extra;
+									months[m].ec_energy_use(target_row, 0) += extra;
 								}
 							}
 						}
@@ -2193,47 +2319,47 @@ public:
 				}
 
 				// set surplus or use
-				for (size_t ir = 0; ir < m_month[m].ec_energy_use.nrows(); ir++)
+				for (size_t ir = 0; ir < months[m].ec_energy_use.nrows(); ir++)
 				{
-					if (m_month[m].ec_energy_use.at(ir, 0) > 0)
+					if (months[m].ec_energy_use.at(ir, 0) > 0)
 					{
-						m_month[m].ec_energy_surplus.at(ir, 0) = m_month[m].ec_energy_use.at(ir, 0);
-						m_month[m].ec_energy_use.at(ir, 0) = 0;
+						months[m].ec_energy_surplus.at(ir, 0) = months[m].ec_energy_use.at(ir, 0);
+						months[m].ec_energy_use.at(ir, 0) = 0;
 					}
 					else
-						m_month[m].ec_energy_use.at(ir, 0) = -m_month[m].ec_energy_use.at(ir, 0);
+						months[m].ec_energy_use.at(ir, 0) = -months[m].ec_energy_use.at(ir, 0);
 				}
 
 				// now ditribute across tier boundaries - upper bounds equally across periods
 				// 3/5/16 prorate based on total net per period / total net
 				// look at total net distributed among tiers
 
-				ssc_number_t num_per = (ssc_number_t)m_month[m].ec_energy_use.nrows();
+				ssc_number_t num_per = (ssc_number_t)months[m].ec_energy_use.nrows();
 				ssc_number_t tot_energy = 0;
 				for (size_t ir = 0; ir < num_per; ir++)
-					tot_energy += m_month[m].ec_energy_use.at(ir, 0);
+					tot_energy += months[m].ec_energy_use.at(ir, 0);
 				if (tot_energy > 0)
 				{
 					for (size_t ir = 0; ir < num_per; ir++)
 					{
 						bool done = false;
-						ssc_number_t per_energy = m_month[m].ec_energy_use.at(ir, 0);
-						for (size_t ic = 0; ic < m_month[m].ec_tou_ub.ncols() && !done; ic++)
+						ssc_number_t per_energy = months[m].ec_energy_use.at(ir, 0);
+						for (size_t ic = 0; ic < months[m].ec_tou_ub.ncols() && !done; ic++)
 						{
-							ssc_number_t ub_tier = m_month[m].ec_tou_ub.at(ir, ic);
+							ssc_number_t ub_tier = months[m].ec_tou_ub.at(ir, ic);
 							if (per_energy > 0)
 							{
 								if (tot_energy > ub_tier)
 								{
-									m_month[m].ec_energy_use.at(ir, ic) = (per_energy/tot_energy) * ub_tier;
+									months[m].ec_energy_use.at(ir, ic) = (per_energy/tot_energy) * ub_tier;
 									if (ic > 0)
-										m_month[m].ec_energy_use.at(ir, ic) -= (per_energy / tot_energy) * m_month[m].ec_tou_ub.at(ir, ic - 1);
+										months[m].ec_energy_use.at(ir, ic) -= (per_energy / tot_energy) * months[m].ec_tou_ub.at(ir, ic - 1);
 								}
 								else
 								{
-									m_month[m].ec_energy_use.at(ir, ic) = (per_energy / tot_energy) * tot_energy;
+									months[m].ec_energy_use.at(ir, ic) = (per_energy / tot_energy) * tot_energy;
 									if (ic > 0)
-										m_month[m].ec_energy_use.at(ir, ic) -= (per_energy / tot_energy)* m_month[m].ec_tou_ub.at(ir, ic - 1);
+										months[m].ec_energy_use.at(ir, ic) -= (per_energy / tot_energy)* months[m].ec_tou_ub.at(ir, ic - 1);
 									done=true;
 								}
 							}
@@ -2244,29 +2370,29 @@ public:
 				// repeat for surplus
 				tot_energy = 0;
 				for (size_t ir = 0; ir < num_per; ir++)
-					tot_energy += m_month[m].ec_energy_surplus.at(ir, 0);
+					tot_energy += months[m].ec_energy_surplus.at(ir, 0);
 				if (tot_energy > 0)
 				{
 					for (size_t ir = 0; ir < num_per; ir++)
 					{
 						bool done = false;
-						ssc_number_t per_energy = m_month[m].ec_energy_surplus.at(ir, 0);
-						for (size_t ic = 0; ic < m_month[m].ec_tou_ub.ncols() && !done; ic++)
+						ssc_number_t per_energy = months[m].ec_energy_surplus.at(ir, 0);
+						for (size_t ic = 0; ic < months[m].ec_tou_ub.ncols() && !done; ic++)
 						{
-							ssc_number_t ub_tier = m_month[m].ec_tou_ub.at(0, ic);
+							ssc_number_t ub_tier = months[m].ec_tou_ub.at(0, ic);
 							if (per_energy > 0)
 							{
 								if (tot_energy > ub_tier)
 								{
-									m_month[m].ec_energy_surplus.at(ir, ic) = (per_energy / tot_energy) * ub_tier;
+									months[m].ec_energy_surplus.at(ir, ic) = (per_energy / tot_energy) * ub_tier;
 									if (ic > 0)
-										m_month[m].ec_energy_surplus.at(ir, ic) -= (per_energy / tot_energy) * m_month[m].ec_tou_ub.at(ir, ic - 1);
+										months[m].ec_energy_surplus.at(ir, ic) -= (per_energy / tot_energy) * months[m].ec_tou_ub.at(ir, ic - 1);
 								}
 								else
 								{
-									m_month[m].ec_energy_surplus.at(ir, ic) = (per_energy / tot_energy) * tot_energy;
+									months[m].ec_energy_surplus.at(ir, ic) = (per_energy / tot_energy) * tot_energy;
 									if (ic > 0)
-										m_month[m].ec_energy_surplus.at(ir, ic) -= (per_energy / tot_energy)* m_month[m].ec_tou_ub.at(ir, ic - 1);
+										months[m].ec_energy_surplus.at(ir, ic) -= (per_energy / tot_energy)* months[m].ec_tou_ub.at(ir, ic - 1);
 									done = true;
 								}
 							}
@@ -2280,38 +2406,22 @@ public:
 		// set peak per period - no tier accumulation
 		if (dc_enabled)
 		{
-			c = 0;
-			for (m = 0; m < (int)m_month.size(); m++)
+			for (m = 0; m < (int)months.size(); m++)
 			{
-				m_month[m].dc_tou_peak.clear();
-				m_month[m].dc_tou_peak_hour.clear();
-				for (i = 0; i < (int)m_month[m].dc_periods.size(); i++)
+				months[m].dc_tou_peak.clear();
+				months[m].dc_tou_peak_hour.clear();
+				for (i = 0; i < (int)months[m].dc_periods.size(); i++)
 				{
-					m_month[m].dc_tou_peak.push_back(0);
-					m_month[m].dc_tou_peak_hour.push_back(0);
+					months[m].dc_tou_peak.push_back(0);
+					months[m].dc_tou_peak_hour.push_back(0);
 				}
-				for (d = 0; d < util::nday[m]; d++)
+				for (c = (int)m_month_first_step[m]; c < (int)m_month_first_step[m + 1]; c++)
 				{
-					for (h = 0; h < 24; h++)
+					int row = m_dc_sched_row[c];
+					if (p_in[c] < 0 && p_in[c] < -months[m].dc_tou_peak[row])
 					{
-						for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
-						{
-							int todp = m_dc_tou_sched[c];
-							std::vector<int>::iterator per_num = std::find(m_month[m].dc_periods.begin(), m_month[m].dc_periods.end(), todp);
-							if (per_num == m_month[m].dc_periods.end())
-							{
-								std::ostringstream ss;
-								ss << "Demand rate Period " << todp << " not found for Month " << m << ".";
-								throw exec_error("utilityrate5", ss.str());
-							}
-							int row = (int)(per_num - m_month[m].dc_periods.begin());
-							if (p_in[c] < 0 && p_in[c] < -m_month[m].dc_tou_peak[row])
-							{
-								m_month[m].dc_tou_peak[row] = -p_in[c];
-								m_month[m].dc_tou_peak_hour[row] = c;
-							}
-							c++;
-						}
+						months[m].dc_tou_peak[row] = -p_in[c];
+						months[m].dc_tou_peak_hour[row] = c;
 					}
 				}
 			}
@@ -2321,176 +2431,163 @@ public:
 		
 		
 // main loop
-		c = 0;
 		// process one month at a time
-		for (m = 0; m < (int)m_month.size(); m++)
+		for (m = 0; m < (int)months.size(); m++)
 		{
-			if (m_month[m].hours_per_month <= 0) break;
-			for (d = 0; d<util::nday[m]; d++)
+			if (months[m].hours_per_month <= 0) break;
+			// charges are applied at the last time step of the month
+			c = (int)m_month_first_step[m + 1] - 1;
+			if (ec_enabled)
 			{
-				for (h = 0; h<24; h++)
+				// energy use and surplus distributed correctly above.
+				// so calculate for all and not based on monthly net
+				// addresses issue if net > 0 but one period net < 0
+				ssc_number_t credit_amt = 0;
+				for (period = 0; period < (int)months[m].ec_tou_sr.nrows(); period++)
 				{
-					// energy charge
-					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
+					for (tier = 0; tier < (int)months[m].ec_tou_sr.ncols(); tier++)
 					{
-						if (d == util::nday[m] - 1 && h == 23 && s == (int)(steps_per_hour-1) )
-						{
-							if (ec_enabled)
-							{
-								// energy use and surplus distributed correctly above.
-								// so calculate for all and not based on monthly net
-								// addresses issue if net > 0 but one period net < 0
-								ssc_number_t credit_amt = 0;
-								for (period = 0; period < (int)m_month[m].ec_tou_sr.nrows(); period++)
-								{
-									for (tier = 0; tier < (int)m_month[m].ec_tou_sr.ncols(); tier++)
-									{
-										ssc_number_t cr = m_month[m].ec_energy_surplus.at(period, tier) * m_month[m].ec_tou_sr.at(period, tier) * rate_esc;
+						ssc_number_t cr = months[m].ec_energy_surplus.at(period, tier) * months[m].ec_tou_sr.at(period, tier) * rate_esc;
 
-//										excess_kwhs_earned[m] += m_month[m].ec_energy_surplus.at(period, tier);
+//						excess_kwhs_earned[m] += months[m].ec_energy_surplus.at(period, tier);
 
-										if (!enable_nm)
-										{
-											credit_amt += cr;
-											m_month[m].ec_charge.at(period, tier) = -cr;
-										}
-										else if (excess_monthly_dollars)
-											monthly_cumulative_excess_dollars[m] += cr;
-
-										/*
-										if (!enable_nm || excess_monthly_kwhs)
-										{
-										credit_amt += cr;
-										if (!excess_monthly_kwhs)
-										m_month[m].ec_charge.at(period, tier) = -cr;
-										}
-										*/
-									}
-								}
-								monthly_ec_charges[m] -= credit_amt;
+						if (!enable_nm)
+						{
+							credit_amt += cr;
+							months[m].ec_charge.at(period, tier) = -cr;
+						}
+						else if (excess_monthly_dollars)
+							monthly_cumulative_excess_dollars[m] += cr;
 
-								ssc_number_t charge_amt = 0;
-								for (period = 0; period < (int)m_month[m].ec_tou_br.nrows(); period++)
-								{
-									for (tier = 0; tier < (int)m_month[m].ec_tou_br.ncols(); tier++)
-									{
-										ssc_number_t ch = m_month[m].ec_energy_use.at(period, tier) * m_month[m].ec_tou_br.at(period, tier) * rate_esc;
-										m_month[m].ec_charge.at(period, tier) = ch;
-										charge_amt += ch;
-									}
-								}
-								monthly_ec_charges[m] += charge_amt;
+						/*
+						if (!enable_nm || excess_monthly_kwhs)
+						{
+						credit_amt += cr;
+						if (!excess_monthly_kwhs)
+						months[m].ec_charge.at(period, tier) = -cr;
+						}
+						*/
+					}
+				}
+				monthly_ec_charges[m] -= credit_amt;
 
+				ssc_number_t charge_amt = 0;
+				for (period = 0; period < (int)months[m].ec_tou_br.nrows(); period++)
+				{
+					for (tier = 0; tier < (int)months[m].ec_tou_br.ncols(); tier++)
+					{
+						ssc_number_t ch = months[m].ec_energy_use.at(period, tier) * months[m].ec_tou_br.at(period, tier) * rate_esc;
+						months[m].ec_charge.at(period, tier) = ch;
+						charge_amt += ch;
+					}
+				}
+				monthly_ec_charges[m] += charge_amt;
 
-								// monthly rollover with year end sell at reduced rate
-								if (enable_nm)
-								{
-									payment[c] += monthly_ec_charges[m];
-									/*
-									if (monthly_ec_charges[m] < 0)
-									{
-									monthly_cumulative_excess_kwhs[m] = -monthly_ec_charges[m];
-									payment[c] += monthly_ec_charges[m];
-									}
-									*/
-								}
-								else // non-net metering - no rollover 
-								{
-									if (m_month[m].energy_net < 0) // must buy from grid
-										payment[c] += monthly_ec_charges[m];
-									else // surplus - sell to grid
-										income[c] -= monthly_ec_charges[m]; // charge is negative for income!
-								}
 
-								energy_charge[c] += monthly_ec_charges[m];
+				// monthly rollover with year end sell at reduced rate
+				if (enable_nm)
+				{
+					payment[c] += monthly_ec_charges[m];
+					/*
+					if (monthly_ec_charges[m] < 0)
+					{
+					monthly_cumulative_excess_kwhs[m] = -monthly_ec_charges[m];
+					payment[c] += monthly_ec_charges[m];
+					}
+					*/
+				}
+				else // non-net metering - no rollover 
+				{
+					if (months[m].energy_net < 0) // must buy from grid
+						payment[c] += monthly_ec_charges[m];
+					else // surplus - sell to grid
+						income[c] -= monthly_ec_charges[m]; // charge is negative for income!
+				}
 
-								// end of energy charge
+				energy_charge[c] += monthly_ec_charges[m];
 
-							}
+				// end of energy charge
 
+			}
 
-							if (dc_enabled)
-							{
-								// fixed demand charge
-								// compute charge based on tier structure for the month
-								ssc_number_t charge = 0;
-								ssc_number_t d_lower = 0;
-								ssc_number_t demand = m_month[m].dc_flat_peak;
-								bool found = false;
-								for (tier = 0; tier < (int)m_month[m].dc_flat_ub.size() && !found; tier++)
-								{
-									if (demand < m_month[m].dc_flat_ub[tier])
-									{
-										found = true;
-										charge += (demand - d_lower) *
-											m_month[m].dc_flat_ch[tier] * rate_esc;
-										m_month[m].dc_flat_charge = charge;
-									}
-									else
-									{
-										charge += (m_month[m].dc_flat_ub[tier] - d_lower) *
-											m_month[m].dc_flat_ch[tier] * rate_esc;
-										d_lower = m_month[m].dc_flat_ub[tier];
-									}
-								}
 
-								monthly_dc_fixed[m] = charge; // redundant...
-								payment[c] += monthly_dc_fixed[m];
-								demand_charge[c] = charge;
-								dc_hourly_peak[m_month[m].dc_flat_peak_hour] = demand;
+			if (dc_enabled)
+			{
+				// fixed demand charge
+				// compute charge based on tier structure for the month
+				ssc_number_t charge = 0;
+				ssc_number_t d_lower = 0;
+				ssc_number_t demand = months[m].dc_flat_peak;
+				bool found = false;
+				for (tier = 0; tier < (int)months[m].dc_flat_ub.size() && !found; tier++)
+				{
+					if (demand < months[m].dc_flat_ub[tier])
+					{
+						found = true;
+						charge += (demand - d_lower) *
+							months[m].dc_flat_ch[tier] * rate_esc;
+						months[m].dc_flat_charge = charge;
+					}
+					else
+					{
+						charge += (months[m].dc_flat_ub[tier] - d_lower) *
+							months[m].dc_flat_ch[tier] * rate_esc;
+						d_lower = months[m].dc_flat_ub[tier];
+					}
+				}
 
+				monthly_dc_fixed[m] = charge; // redundant...
+				payment[c] += monthly_dc_fixed[m];
+				demand_charge[c] = charge;
+				dc_hourly_peak[months[m].dc_flat_peak_hour] = demand;
 
-								// end of fixed demand charge
 
+				// end of fixed demand charge
 
-								// TOU demand charge for each period find correct tier
-								demand = 0;
-								d_lower = 0;
-								int peak_hour = 0;
-								m_month[m].dc_tou_charge.clear();
-								for (period = 0; period < (int)m_month[m].dc_tou_ub.nrows(); period++)
-								{
-									charge = 0;
-									d_lower = 0;
-									if (tou_demand_single_peak)
-									{
-										demand = m_month[m].dc_flat_peak;
-										if (m_month[m].dc_flat_peak_hour != m_month[m].dc_tou_peak_hour[period]) continue; // only one peak per month.
-									}
-									else
-										demand = m_month[m].dc_tou_peak[period];
-									// find tier corresponding to peak demand
-									found = false;
-									for (tier = 0; tier < (int)m_month[m].dc_tou_ub.ncols() && !found; tier++)
-									{
-										if (demand < m_month[m].dc_tou_ub.at(period, tier))
-										{
-											found = true;
-											charge += (demand - d_lower) *
-												m_month[m].dc_tou_ch.at(period, tier)* rate_esc;
-											m_month[m].dc_tou_charge.push_back(charge);
-										}
-										else
-										{
-											charge += (m_month[m].dc_tou_ub.at(period, tier) - d_lower) * m_month[m].dc_tou_ch.at(period, tier)* rate_esc;
-											d_lower = m_month[m].dc_tou_ub.at(period, tier);
-										}
-									}
 
-									dc_hourly_peak[peak_hour] = demand;
-									// add to payments
-									monthly_dc_tou[m] += charge;
-									payment[c] += charge; // apply to last hour of the month
-									demand_charge[c] += charge; // add TOU charge to hourly demand charge
-								}
-								// end of TOU demand charge
-							}
+				// TOU demand charge for each period find correct tier
+				demand = 0;
+				d_lower = 0;
+				int peak_hour = 0;
+				months[m].dc_tou_charge.clear();
+				for (period = 0; period < (int)months[m].dc_tou_ub.nrows(); period++)
+				{
+					charge = 0;
+					d_lower = 0;
+					if (tou_demand_single_peak)
+					{
+						demand = months[m].dc_flat_peak;
+						if (months[m].dc_flat_peak_hour != months[m].dc_tou_peak_hour[period]) continue; // only one peak per month.
+					}
+					else
+						demand = months[m].dc_tou_peak[period];
+					// find tier corresponding to peak demand
+					found = false;
+					for (tier = 0; tier < (int)months[m].dc_tou_ub.ncols() && !found; tier++)
+					{
+						if (demand < months[m].dc_tou_ub.at(period, tier))
+						{
+							found = true;
+							charge += (demand - d_lower) *
+								months[m].dc_tou_ch.at(period, tier)* rate_esc;
+							months[m].dc_tou_charge.push_back(charge);
+						}
+						else
+						{
+							charge += (months[m].dc_tou_ub.at(period, tier) - d_lower) * months[m].dc_tou_ch.at(period, tier)* rate_esc;
+							d_lower = months[m].dc_tou_ub.at(period, tier);
+						}
+					}
 
-						} // end of if end of month
-						c++;
-					} // end of steps per hour loop
-				}  // h loop
-			} // d loop
+					dc_hourly_peak[peak_hour] = demand;
+					// add to payments
+					monthly_dc_tou[m] += charge;
+					payment[c] += charge; // apply to last hour of the month
+					demand_charge[c] += charge; // add TOU charge to hourly demand charge
+				}
+				// end of TOU demand charge
+			}
+			c++;
 
 			// Calculate monthly bill (before minimums and fixed charges) and excess kwhs and rollover
 //			monthly_bill[m] = payment[c - 1] - income[c - 1];
@@ -2558,84 +2655,71 @@ public:
 		// Assumption that fixed and minimum charges independent of rollovers kWh or $
 		// process monthly fixed charges
 		// compute revenue ( = income - payment ) and monthly bill ( = payment - income) and apply fixed and minimum charges
-		c = 0;
 		ssc_number_t mon_bill = 0, ann_bill = 0;
-		ssc_number_t ann_min_charge = as_number("ur_annual_min_charge")*rate_esc;
-		ssc_number_t mon_min_charge = as_number("ur_monthly_min_charge")*rate_esc;
-		ssc_number_t mon_fixed = as_number("ur_monthly_fixed_charge")*rate_esc;
+		ssc_number_t ann_min_charge = m_annual_min_charge*rate_esc;
+		ssc_number_t mon_min_charge = m_monthly_min_charge*rate_esc;
+		ssc_number_t mon_fixed = m_monthly_fixed_charge*rate_esc;
 
 		// process one month at a time
 		for (m = 0; m < 12; m++)
 		{
-			for (d = 0; d < util::nday[m]; d++)
+			c = (int)m_month_first_step[m + 1] - 1;
+			// apply fixed first
+			if (include_fixed)
 			{
-				for (h = 0; h < 24; h++)
+				payment[c] += mon_fixed;
+				monthly_fixed_charges[m] += mon_fixed;
+			}
+			mon_bill = payment[c] - income[c];
+			if (mon_bill < 0) mon_bill = 0; // for calculating min charge when monthly surplus.
+			// apply monthly minimum
+			if (include_min)
+			{
+				if (mon_bill < mon_min_charge)
 				{
-					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
+					monthly_minimum_charges[m] += mon_min_charge - mon_bill;
+					payment[c] += mon_min_charge - mon_bill;
+				}
+			}
+			ann_bill += mon_bill;
+			if (m == 11)
+			{
+				// apply annual minimum
+				if (include_min)
+				{
+					if (ann_bill < ann_min_charge)
 					{
-						if (d == util::nday[m] - 1 && h == 23 && s == (int)(steps_per_hour - 1))
-						{
-							// apply fixed first
-							if (include_fixed)
-							{
-								payment[c] += mon_fixed;
-								monthly_fixed_charges[m] += mon_fixed;
-							}
-							mon_bill = payment[c] - income[c];
-							if (mon_bill < 0) mon_bill = 0; // for calculating min charge when monthly surplus.
-							// apply monthly minimum
-							if (include_min)
-							{
-								if (mon_bill < mon_min_charge)
-								{
-									monthly_minimum_charges[m] += mon_min_charge - mon_bill;
-									payment[c] += mon_min_charge - mon_bill;
-								}
-							}
-							ann_bill += mon_bill;
-							if (m == 11)
-							{
-								// apply annual minimum
-								if (include_min)
-								{
-									if (ann_bill < ann_min_charge)
-									{
-										monthly_minimum_charges[m] += ann_min_charge - ann_bill;
-										payment[c] += ann_min_charge - ann_bill;
-									}
-								}
-								// apply annual rollovers AFTER minimum calculations
-								if (enable_nm)
-								{
-									// monthly rollover with year end sell at reduced rate
-									if (!excess_monthly_dollars && (monthly_cumulative_excess_energy[11] > 0))
-									{
-										ssc_number_t year_end_dollars = monthly_cumulative_excess_energy[11] * as_number("ur_nm_yearend_sell_rate")*rate_esc;
-										income[8759] += year_end_dollars;
-										monthly_cumulative_excess_dollars[11] = year_end_dollars;
-										excess_dollars_earned[11] += year_end_dollars;
-										excess_dollars_applied[11] += year_end_dollars;
-									}
-									else if (excess_monthly_dollars && (monthly_cumulative_excess_dollars[11] > 0))
-									{
-										income[8759] += monthly_cumulative_excess_dollars[11];
-										// ? net metering energy?
-									}
-								}
-							}
-							revenue[c] = income[c] - payment[c];
-							monthly_bill[m] = -revenue[c];
-						}
-						c++;
+						monthly_minimum_charges[m] += ann_min_charge - ann_bill;
+						payment[c] += ann_min_charge - ann_bill;
+					}
+				}
+				// apply annual rollovers AFTER minimum calculations
+				if (enable_nm)
+				{
+					// monthly rollover with year end sell at reduced rate
+					if (!excess_monthly_dollars && (monthly_cumulative_excess_energy[11] > 0))
+					{
+						ssc_number_t year_end_dollars = monthly_cumulative_excess_energy[11] * m_nm_yearend_sell_rate*rate_esc;
+						income[8759] += year_end_dollars;
+						monthly_cumulative_excess_dollars[11] = year_end_dollars;
+						excess_dollars_earned[11] += year_end_dollars;
+						excess_dollars_applied[11] += year_end_dollars;
+					}
+					else if (excess_monthly_dollars && (monthly_cumulative_excess_dollars[11] > 0))
+					{
+						income[8759] += monthly_cumulative_excess_dollars[11];
+						// ? net metering energy?
 					}
 				}
 			}
+			revenue[c] = income[c] - payment[c];
+			monthly_bill[m] = -revenue[c];
 		}
 
 	}
 
 	// updated to timestep for net billing
-	void ur_calc_timestep(ssc_number_t *e_in, ssc_number_t *p_in,
+	void ur_calc_timestep(std::vector<ur_month> &months, ssc_number_t *e_in, ssc_number_t *p_in,
 		ssc_number_t *revenue, ssc_number_t *payment, ssc_number_t *income,
 		ssc_number_t *demand_charge, ssc_number_t *energy_charge,
 		ssc_number_t monthly_fixed_charges[12], ssc_number_t monthly_minimum_charges[12],
@@ -2681,7 +2765,7 @@ public:
 		ssc_number_t monthly_deficit_energy;
 
 		bool ec_enabled = true; // per 2/25/16 meeting
-		bool dc_enabled = as_boolean("ur_dc_enable");
+		bool dc_enabled = m_dc_enabled;
 
 		/*
 		0=Single meter with monthly rollover credits in kWh
@@ -2691,9 +2775,9 @@ public:
 		4=Two meters with all generation sold and all load purchaseded
 		*/
 		//int metering_option = as_integer("ur_metering_option");
-		bool excess_monthly_dollars = (as_integer("ur_metering_option") == 3);
+		bool excess_monthly_dollars = (m_metering_option == 3);
 
-		bool tou_demand_single_peak = (as_integer("TOU_demand_single_peak") == 1);
+		bool tou_demand_single_peak = m_tou_demand_single_peak;
 
 
 		size_t steps_per_hour = m_num_rec_yearly / 8760;
@@ -2702,30 +2786,21 @@ public:
 		// calculate the monthly net energy and monthly hours
 		int m, d, h, s, period, tier;
 		size_t c = 0;
-		for (m = 0; m < (int)m_month.size(); m++)
+		for (m = 0; m < (int)months.size(); m++)
 		{
-			m_month[m].energy_net = 0;
-			m_month[m].hours_per_month = 0;
-			m_month[m].dc_flat_peak = 0;
-			m_month[m].dc_flat_peak_hour = 0;
-			for (d = 0; d < util::nday[m]; d++)
+			months[m].energy_net = 0;
+			months[m].hours_per_month = (int)(m_month_first_step[m + 1] - m_month_first_step[m]);
+			months[m].dc_flat_peak = 0;
+			months[m].dc_flat_peak_hour = 0;
+			for (c = m_month_first_step[m]; c < m_month_first_step[m + 1]; c++)
 			{
-				for (h = 0; h < 24; h++)
+				// net energy use per month
+				months[m].energy_net += e_in[c]; // -load and +gen
+				// peak
+				if (p_in[c] < 0 && p_in[c] < -months[m].dc_flat_peak)
 				{
-					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
-					{
-						// net energy use per month
-						m_month[m].energy_net += e_in[c]; // -load and +gen
-						// hours per period per month
-						m_month[m].hours_per_month++;
-						// peak
-						if (p_in[c] < 0 && p_in[c] < -m_month[m].dc_flat_peak)
-						{
-							m_month[m].dc_flat_peak = -p_in[c];
-							m_month[m].dc_flat_peak_hour = (int)c;
-						}
-						c++;
-					}
+					months[m].dc_flat_peak = -p_in[c];
+					months[m].dc_flat_peak_hour = (int)c;
 				}
 			}
 		}
@@ -2733,8 +2808,8 @@ public:
 		// excess earned
 		for (m = 0; m < 12; m++)
 		{
-			if (m_month[m].energy_net > 0)
-				excess_kwhs_earned[m] = m_month[m].energy_net;
+			if (months[m].energy_net > 0)
+				excess_kwhs_earned[m] = months[m].energy_net;
 		}
 
 
@@ -2744,19 +2819,19 @@ public:
 		{
 			// calculate the monthly net energy per tier and period based on units
 			c = 0;
-			for (m = 0; m < (int)m_month.size(); m++)
+			for (m = 0; m < (int)months.size(); m++)
 			{
 				// check for kWh/kW
 				int start_tier = 0;
-				int end_tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
-				int num_periods = (int)m_month[m].ec_tou_ub.nrows();
+				int end_tier = (int)months[m].ec_tou_ub.ncols() - 1;
+				int num_periods = (int)months[m].ec_tou_ub.nrows();
 				int num_tiers = end_tier - start_tier + 1;
 
 				if (!gen_only) // added for two meter no load scenarios to use load tier sizing
 				{
 					//start_tier = 0;
-					end_tier = (int)m_month[m].ec_tou_ub_init.ncols() - 1;
-					//int num_periods = (int)m_month[m].ec_tou_ub_init.nrows();
+					end_tier = (int)months[m].ec_tou_ub_init.ncols() - 1;
+					//int num_periods = (int)months[m].ec_tou_ub_init.nrows();
 					num_tiers = end_tier - start_tier + 1;
 
 
@@ -2767,19 +2842,19 @@ public:
 					// 4. assumption is that all periods in same month have same tier breakdown
 					// 5. assumption is that tier numbering is correct for the kWh/kW breakdown
 					// That is, first tier must be kWh/kW
-					if ((m_month[m].ec_tou_units.ncols() > 0 && m_month[m].ec_tou_units.nrows() > 0)
-						&& ((m_month[m].ec_tou_units.at(0, 0) == 1) || (m_month[m].ec_tou_units.at(0, 0) == 3)))
+					if ((months[m].ec_tou_units.ncols() > 0 && months[m].ec_tou_units.nrows() > 0)
+						&& ((months[m].ec_tou_units.at(0, 0) == 1) || (months[m].ec_tou_units.at(0, 0) == 3)))
 					{
 						// monthly total energy / monthly peak to determine which kWh/kW tier
-						double mon_kWhperkW = -m_month[m].energy_net; // load negative
-						if (m_month[m].dc_flat_peak != 0)
-							mon_kWhperkW /= m_month[m].dc_flat_peak;
+						double mon_kWhperkW = -months[m].energy_net; // load negative
+						if (months[m].dc_flat_peak != 0)
+							mon_kWhperkW /= months[m].dc_flat_peak;
 						// find correct start and end tier based on kWhperkW band
 						start_tier = 1;
 						bool found = false;
-						for (size_t i_tier = 0; i_tier < m_month[m].ec_tou_units.ncols(); i_tier++)
+						for (size_t i_tier = 0; i_tier < months[m].ec_tou_units.ncols(); i_tier++)
 						{
-							int units = (int)m_month[m].ec_tou_units.at(0, i_tier);
+							int units = (int)months[m].ec_tou_units.at(0, i_tier);
 							if ((units == 1) || (units == 3))
 							{
 								if (found)
@@ -2787,7 +2862,7 @@ public:
 									end_tier = (int)i_tier - 1;
 									break;
 								}
-								else if (mon_kWhperkW < m_month[m].ec_tou_ub_init.at(0, i_tier))
+								else if (mon_kWhperkW < months[m].ec_tou_ub_init.at(0, i_tier))
 								{
 									start_tier = (int)i_tier + 1;
 									found = true;
@@ -2796,8 +2871,8 @@ public:
 						}
 						// last tier since no max specified in rate
 						if (!found) start_tier = end_tier;
-						if (start_tier >= (int)m_month[m].ec_tou_ub_init.ncols())
-							start_tier = (int)m_month[m].ec_tou_ub_init.ncols() - 1;
+						if (start_tier >= (int)months[m].ec_tou_ub_init.ncols())
+							start_tier = (int)months[m].ec_tou_ub_init.ncols() - 1;
 						if (end_tier < start_tier)
 							end_tier = start_tier;
 						num_tiers = end_tier - start_tier + 1;
@@ -2811,26 +2886,26 @@ public:
 						{
 							for (tier = 0; tier < num_tiers; tier++)
 							{
-								br.at(period, tier) = m_month[m].ec_tou_br_init.at(period, start_tier + tier);
-								sr.at(period, tier) = m_month[m].ec_tou_sr_init.at(period, start_tier + tier);
-								ub.at(period, tier) = m_month[m].ec_tou_ub_init.at(period, start_tier + tier);
+								br.at(period, tier) = months[m].ec_tou_br_init.at(period, start_tier + tier);
+								sr.at(period, tier) = months[m].ec_tou_sr_init.at(period, start_tier + tier);
+								ub.at(period, tier) = months[m].ec_tou_ub_init.at(period, start_tier + tier);
 								// update for correct tier number column headings
-								m_month[m].ec_periods_tiers[period][tier] = start_tier + m_ec_periods_tiers_init[period][tier];
+								months[m].ec_periods_tiers[period][tier] = start_tier + m_ec_periods_tiers_init[period][tier];
 							}
 						}
 
-						m_month[m].ec_tou_br = br;
-						m_month[m].ec_tou_sr = sr;
-						m_month[m].ec_tou_ub = ub;
+						months[m].ec_tou_br = br;
+						months[m].ec_tou_sr = sr;
+						months[m].ec_tou_ub = ub;
 					}
 				}
 				// reset now resized
 				start_tier = 0;
-				end_tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
+				end_tier = (int)months[m].ec_tou_ub.ncols() - 1;
 
-				m_month[m].ec_energy_surplus.resize_fill(num_periods, num_tiers, 0);
-				m_month[m].ec_energy_use.resize_fill(num_periods, num_tiers, 0);
-				m_month[m].ec_charge.resize_fill(num_periods, num_tiers, 0);
+				months[m].ec_energy_surplus.resize_fill(num_periods, num_tiers, 0);
+				months[m].ec_energy_use.resize_fill(num_periods, num_tiers, 0);
+				months[m].ec_charge.resize_fill(num_periods, num_tiers, 0);
 
 			}
 		}
@@ -2839,38 +2914,22 @@ public:
 		// set peak per period - no tier accumulation
 		if (dc_enabled)
 		{
-			c = 0;
-			for (m = 0; m < (int)m_month.size(); m++)
+			for (m = 0; m < (int)months.size(); m++)
 			{
-				m_month[m].dc_tou_peak.clear();
-				m_month[m].dc_tou_peak_hour.clear();
-				for (i = 0; i < (int)m_month[m].dc_periods.size(); i++)
+				months[m].dc_tou_peak.clear();
+				months[m].dc_tou_peak_hour.clear();
+				for (i = 0; i < (int)months[m].dc_periods.size(); i++)
 				{
-					m_month[m].dc_tou_peak.push_back(0);
-					m_month[m].dc_tou_peak_hour.push_back(0);
+					months[m].dc_tou_peak.push_back(0);
+					months[m].dc_tou_peak_hour.push_back(0);
 				}
-				for (d = 0; d < util::nday[m]; d++)
+				for (c = m_month_first_step[m]; c < m_month_first_step[m + 1]; c++)
 				{
-					for (h = 0; h < 24; h++)
+					int row = m_dc_sched_row[c];
+					if (p_in[c] < 0 && p_in[c] < -months[m].dc_tou_peak[row])
 					{
-						for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
-						{
-							int todp = m_dc_tou_sched[c];
-							std::vector<int>::iterator per_num = std::find(m_month[m].dc_periods.begin(), m_month[m].dc_periods.end(), todp);
-							if (per_num == m_month[m].dc_periods.end())
-							{
-								std::ostringstream ss;
-								ss << "Demand charge Period " << todp << " not found for Month " << m << ".";
-								throw exec_error("utilityrate5", ss.str());
-							}
-							int row = (int)(per_num - m_month[m].dc_periods.begin());
-							if (p_in[c] < 0 && p_in[c] < -m_month[m].dc_tou_peak[row])
-							{
-								m_month[m].dc_tou_peak[row] = -p_in[c];
-								m_month[m].dc_tou_peak_hour[row] = (int)c;
-							}
-							c++;
-						}
+						months[m].dc_tou_peak[row] = -p_in[c];
+						months[m].dc_tou_peak_hour[row] = (int)c;
 					}
 				}
 			}
@@ -2895,17 +2954,8 @@ public:
 						// energy charge
 						if (ec_enabled)
 						{
-							period = m_ec_tou_sched[c];
-							// find corresponding monthly period
-							// check for valid period
-							std::vector<int>::iterator per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), period);
-							if (per_num == m_month[m].ec_periods.end())
-							{
-								std::ostringstream ss;
-								ss << "Energy rate Period " << period << " not found for Month " << m << ".";
-								throw exec_error("utilityrate5", ss.str());
-							}
-							int row = (int)(per_num - m_month[m].ec_periods.begin());
+							// corresponding monthly period
+							int row = m_ec_sched_row[c];
 
 							if (e_in[c] >= 0.0)
 							{ // calculate income or credit
@@ -2923,16 +2973,16 @@ public:
 
 								// cumulative energy used to determine tier for credit of entire surplus amount
 								ssc_number_t credit_amt = 0;
-								for (tier = 0; tier < (int)m_month[m].ec_tou_ub.ncols(); tier++)
+								for (tier = 0; tier < (int)months[m].ec_tou_ub.ncols(); tier++)
 								{
-									ssc_number_t e_upper = m_month[m].ec_tou_ub.at(row, tier);
+									ssc_number_t e_upper = months[m].ec_tou_ub.at(row, tier);
 									if (cumulative_energy < e_upper)
 										break;
 								}
-								if (tier >= (int)m_month[m].ec_tou_ub.ncols())
-									tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
+								if (tier >= (int)months[m].ec_tou_ub.ncols())
+									tier = (int)months[m].ec_tou_ub.ncols() - 1;
 								ssc_number_t tier_energy = energy_surplus;
-								ssc_number_t sr = m_month[m].ec_tou_sr.at(row, tier);
+								ssc_number_t sr = months[m].ec_tou_sr.at(row, tier);
 								// time step sell rates
 								if (c< m_ec_ts_sell_rate.size())
 									sr = m_ec_ts_sell_rate[c];
@@ -2947,13 +2997,13 @@ public:
 								}
 								else
 								{
-									m_month[m].ec_charge.at(row, tier) -= (ssc_number_t)tier_credit;
+									months[m].ec_charge.at(row, tier) -= (ssc_number_t)tier_credit;
 									//								price[c] += (ssc_number_t)credit_amt;
 									monthly_ec_charges[m] -= (ssc_number_t)credit_amt;
 									income[c] = (ssc_number_t)credit_amt;
 									energy_charge[c] = -(ssc_number_t)credit_amt;
 								}
-								m_month[m].ec_energy_surplus.at(row, tier) += (ssc_number_t)tier_energy;
+								months[m].ec_energy_surplus.at(row, tier) += (ssc_number_t)tier_energy;
 								excess_kwhs_earned[m] += tier_energy;
 							}
 							else
@@ -2971,19 +3021,19 @@ public:
 
 
 								// cumulative energy used to determine tier for credit of entire surplus amount
-								for (tier = 0; tier < (int)m_month[m].ec_tou_ub.ncols(); tier++)
+								for (tier = 0; tier < (int)months[m].ec_tou_ub.ncols(); tier++)
 								{
-									double e_upper = m_month[m].ec_tou_ub.at(row, tier);
+									double e_upper = months[m].ec_tou_ub.at(row, tier);
 									if (cumulative_deficit < e_upper)
 										break;
 								}
-								if (tier >= (int)m_month[m].ec_tou_ub.ncols())
-									tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
+								if (tier >= (int)months[m].ec_tou_ub.ncols())
+									tier = (int)months[m].ec_tou_ub.ncols() - 1;
 								double tier_energy = energy_deficit;
-								double tier_charge = tier_energy * m_month[m].ec_tou_br.at(row, tier) * rate_esc;
+								double tier_charge = tier_energy * months[m].ec_tou_br.at(row, tier) * rate_esc;
 								charge_amt = tier_charge;
-								m_month[m].ec_energy_use.at(row, tier) += (ssc_number_t)tier_energy;
-								m_month[m].ec_charge.at(row, tier) += (ssc_number_t)tier_charge;
+								months[m].ec_energy_use.at(row, tier) += (ssc_number_t)tier_energy;
+								months[m].ec_charge.at(row, tier) += (ssc_number_t)tier_charge;
 
 								payment[c] = (ssc_number_t)charge_amt;
 								monthly_ec_charges[m] += (ssc_number_t)charge_amt;
@@ -3004,29 +3054,29 @@ public:
 								// compute charge based on tier structure for the month
 								ssc_number_t charge = 0;
 								ssc_number_t d_lower = 0;
-								ssc_number_t demand = m_month[m].dc_flat_peak;
+								ssc_number_t demand = months[m].dc_flat_peak;
 								bool found = false;
-								for (tier = 0; tier < (int)m_month[m].dc_flat_ub.size() && !found; tier++)
+								for (tier = 0; tier < (int)months[m].dc_flat_ub.size() && !found; tier++)
 								{
-									if (demand < m_month[m].dc_flat_ub[tier])
+									if (demand < months[m].dc_flat_ub[tier])
 									{
 										found = true;
 										charge += (demand - d_lower) *
-											m_month[m].dc_flat_ch[tier] * rate_esc;
-										m_month[m].dc_flat_charge = charge;
+											months[m].dc_flat_ch[tier] * rate_esc;
+										months[m].dc_flat_charge = charge;
 									}
 									else
 									{
-										charge += (m_month[m].dc_flat_ub[tier] - d_lower) *
-											m_month[m].dc_flat_ch[tier] * rate_esc;
-										d_lower = m_month[m].dc_flat_ub[tier];
+										charge += (months[m].dc_flat_ub[tier] - d_lower) *
+											months[m].dc_flat_ch[tier] * rate_esc;
+										d_lower = months[m].dc_flat_ub[tier];
 									}
 								}
 
 								monthly_dc_fixed[m] = charge; // redundant...
 								payment[c] += monthly_dc_fixed[m];
 								demand_charge[c] = charge;
-								dc_hourly_peak[m_month[m].dc_flat_peak_hour] = demand;
+								dc_hourly_peak[months[m].dc_flat_peak_hour] = demand;
 
 
 								// end of fixed demand charge
@@ -3036,33 +3086,33 @@ public:
 								demand = 0;
 								d_lower = 0;
 								int peak_hour = 0;
-								m_month[m].dc_tou_charge.clear();
-								for (period = 0; period < (int)m_month[m].dc_tou_ub.nrows(); period++)
+								months[m].dc_tou_charge.clear();
+								for (period = 0; period < (int)months[m].dc_tou_ub.nrows(); period++)
 								{
 									charge = 0;
 									d_lower = 0;
 									if (tou_demand_single_peak)
 									{
-										demand = m_month[m].dc_flat_peak;
-										if (m_month[m].dc_flat_peak_hour != m_month[m].dc_tou_peak_hour[period]) continue; // only one peak per month.
+										demand = months[m].dc_flat_peak;
+										if (months[m].dc_flat_peak_hour != months[m].dc_tou_peak_hour[period]) continue; // only one peak per month.
 									}
 									else
-										demand = m_month[m].dc_tou_peak[period];
+										demand = months[m].dc_tou_peak[period];
 
 									found = false;
-									for (tier = 0; tier < (int)m_month[m].dc_tou_ub.ncols() && !found; tier++)
+									for (tier = 0; tier < (int)months[m].dc_tou_ub.ncols() && !found; tier++)
 									{
-										if (demand < m_month[m].dc_tou_ub.at(period, tier))
+										if (demand < months[m].dc_tou_ub.at(period, tier))
 										{
 											found = true;
 											charge += (demand - d_lower) *
-												m_month[m].dc_tou_ch.at(period, tier)* rate_esc;
-											m_month[m].dc_tou_charge.push_back(charge);
+												months[m].dc_tou_ch.at(period, tier)* rate_esc;
+											months[m].dc_tou_charge.push_back(charge);
 										}
 										else
 										{
-											charge += (m_month[m].dc_tou_ub.at(period, tier) - d_lower) * m_month[m].dc_tou_ch.at(period, tier)* rate_esc;
-											d_lower = m_month[m].dc_tou_ub.at(period, tier);
+											charge += (months[m].dc_tou_ub.at(period, tier) - d_lower) * months[m].dc_tou_ch.at(period, tier)* rate_esc;
+											d_lower = months[m].dc_tou_ub.at(period, tier);
 										}
 									}
 
@@ -3163,9 +3213,9 @@ public:
 		// compute revenue ( = income - payment ) and monthly bill ( = payment - income) and apply fixed and minimum charges
 		c = 0;
 		ssc_number_t mon_bill = 0, ann_bill = 0;
-		ssc_number_t ann_min_charge = as_number("ur_annual_min_charge")*rate_esc;
-		ssc_number_t mon_min_charge = as_number("ur_monthly_min_charge")*rate_esc;
-		ssc_number_t mon_fixed = as_number("ur_monthly_fixed_charge")*rate_esc;
+		ssc_number_t ann_min_charge = m_annual_min_charge*rate_esc;
+		ssc_number_t mon_min_charge = m_monthly_min_charge*rate_esc;
+		ssc_number_t mon_fixed = m_monthly_fixed_charge*rate_esc;
 
 		// process one month at a time
 		for (m = 0; m < 12; m++)
@@ -152,3 +152,46 @@ public:
 };
 
 DEFINE_MODULE_ENTRY( wfcsvconv, "Converter for TMY2, TMY3, INTL, EPW, SMW weather files to standard CSV format", 1 )
+
+
+static var_info _cm_vtab_wfbinconv[] = 
+{	
+/*   VARTYPE           DATATYPE         NAME                         LABEL                              UNITS     META                      GROUP                     REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT,        SSC_STRING,      "input_file",               "Input weather file name",         "",       "tmy2,tmy3,intl,epw,smw,csv",  "Weather File Converter", "*",                       "",                     "" },
+	{ SSC_INOUT,        SSC_STRING,      "output_file",              "Output file name",                "",       "default is input file name with .wfbin extension", "Weather File Converter", "?", "",             "" },
+
+var_info_invalid };
+
+class cm_wfbinconv : public compute_module
+{
+public:
+	cm_wfbinconv()
+	{
+		add_var_info( _cm_vtab_wfbinconv );
+	}
+
+	void exec( ) throw( general_error )
+	{
+		std::string input = as_string("input_file");
+
+		std::string output;
+		if ( is_assigned("output_file") )
+			output = as_string("output_file");
+		else
+		{
+			output = input;
+			std::string::size_type dot = output.find_last_of( '.' );
+			std::string::size_type sep = output.find_last_of( "/\\" );
+			if ( dot != std::string::npos && ( sep == std::string::npos || dot > sep ) )
+				output.erase( dot );
+			output += ".wfbin";
+		}
+
+		if (!weatherfile::convert_to_binary( input, output ))
+			throw exec_error( "wfbinconv", "could not convert " + input + " to " + output );
+
+		assign( "output_file", var_data( output ) );
+	}
+};
+
+DEFINE_MODULE_ENTRY( wfbinconv, "Converter for TMY2, TMY3, INTL, EPW, SMW, CSV weather files to the memory-mapped binary weather format", 1 )
@@ -54,6 +54,11 @@
 #include "lib_util.h"
 #include "cmod_windpower.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 static var_info _cm_vtab_windpower[] = {
 	// VARTYPE   DATATYPE		NAME								LABEL										UNITS		META	GROUP			REQUIRED_IF						CONSTRAINTS                                        UI_HINTS
 	{ SSC_INPUT, SSC_STRING,  "wind_resource_filename",				"local wind data file path",				"",			"",		"WindPower",	"?",							"LOCAL_FILE",										"" },
@@ -78,6 +83,12 @@ static var_info _cm_vtab_windpower[] = {
 	{ SSC_INPUT, SSC_ARRAY,   "wind_farm_yCoordinates",				"Turbine Y coordinates",					"m",		"",		"WindPower",	"*",							"LENGTH_EQUAL=wind_farm_xCoordinates",				"" },
 	{ SSC_INPUT, SSC_NUMBER,  "wind_farm_losses_percent",			"Percentage losses",						"%",		"",		"WindPower",	"*",							"",													"" },
 	{ SSC_INPUT, SSC_NUMBER,  "wind_farm_wake_model",				"Wake Model",								"0/1/2",	"",		"WindPower",	"*",							"INTEGER",											"" },
+	{ SSC_INPUT, SSC_NUMBER,  "wind_farm_wake_cache",				"Enable wake result cache",					"0/1",		"",		"WindPower",	"?=0",							"INTEGER",											"" },
+	{ SSC_INPUT, SSC_NUMBER,  "wind_farm_wake_cache_dir_step",		"Wake cache wind direction step",			"deg",		"",		"WindPower",	"?=5",							"POSITIVE",											"" },
+	{ SSC_INPUT, SSC_NUMBER,  "wind_farm_wake_cache_speed_step",	"Wake cache wind speed step",				"m/s",		"",		"WindPower",	"?=0.5",						"POSITIVE",											"" },
+	{ SSC_INPUT, SSC_NUMBER,  "wind_farm_wake_cache_density_step",	"Wake cache air density step",				"kg/m3",	"",		"WindPower",	"?=0.025",						"POSITIVE",											"" },
+	{ SSC_INPUT, SSC_NUMBER,  "wind_farm_wake_cache_tolerance",		"Wake cache tolerance (fraction of rated)",	"",			"",		"WindPower",	"?=0.001",						"MIN=0",											"" },
+	{ SSC_INPUT, SSC_NUMBER,  "wind_farm_threads",					"Number of wake calculation threads",		"",			"1=serial,0=all cores",	"WindPower",	"?=1",					"MIN=0,INTEGER",									"" },
 	{ SSC_INPUT, SSC_NUMBER,  "en_low_temp_cutoff",					"Enable Low Temperature Cutoff",			"0/1",		"",		"WindPower",	"?=0",							"INTEGER",											"" },
 	{ SSC_INPUT, SSC_NUMBER,  "low_temp_cutoff",					"Low Temperature Cutoff",					"C",		"",		"WindPower",	"en_low_temp_cutoff=1",			"",													"" },
 	{ SSC_INPUT, SSC_NUMBER,  "en_icing_cutoff",					"Enable Icing Cutoff",						"0/1",		"",		"WindPower",	"?=0",							"INTEGER",											"" },
@@ -198,6 +209,18 @@ bool winddata::read_line(std::vector<double> &values)
 }
 
 
+/// Returns a new wake model for the turbine, or null if the choice is not 0 (simple), 1 (Park) or 2 (eddy viscosity)
+static std::shared_ptr<wakeModelBase> create_wake_model(int wakeModelChoice, size_t nTurbines, windTurbine *wt, double turbulenceCoeff)
+{
+	if (wakeModelChoice == 0)
+		return std::make_shared<simpleWakeModel>(simpleWakeModel(nTurbines, wt));
+	else if (wakeModelChoice == 1)
+		return std::make_shared<parkWakeModel>(parkWakeModel(nTurbines, wt));
+	else if (wakeModelChoice == 2)
+		return std::make_shared<eddyViscosityWakeModel>(eddyViscosityWakeModel(nTurbines, wt, turbulenceCoeff));
+	return std::shared_ptr<wakeModelBase>();
+}
+
 cm_windpower::cm_windpower(){
 	add_var_info(_cm_vtab_windpower);
 	// performance adjustment factors
@@ -241,8 +264,6 @@ void cm_windpower::exec() throw(general_error)
 		throw exec_error("windpower", util::format("wind turbine class not properly initialized"));
 	if (wpc.nTurbines < 1)
 		throw exec_error("windpower", util::format("the number of wind turbines was zero."));
-	if (wpc.nTurbines > wpc.GetMaxTurbines())
-		throw exec_error("windpower", util::format("the wind model is only configured to handle up to %d turbines.", wpc.GetMaxTurbines()));
 
 	// create adjustment factors and losses
 	adjustment_factors haf(this, "adjust");
@@ -278,7 +299,7 @@ void cm_windpower::exec() throw(general_error)
 			farmpwr[i] *= haf(i); //apply adjustment factor/availability and curtailment losses
 		}
 		
-		for (size_t i = 0; i < wpc.nTurbines; i++)
+		for (size_t i = 0; i < wt.powerCurveArrayLength; i++)
 			turbine_output[i] = (ssc_number_t)turbine_outkW[i];
 
 		accumulate_monthly("gen", "monthly_energy");
@@ -345,20 +366,19 @@ void cm_windpower::exec() throw(general_error)
 		throw exec_error("windpower", util::format("invalid number of data records (%d): must be an integer multiple of 8760", (int)nstep));
 
 	// create wakeModel
-	std::shared_ptr<wakeModelBase> wakeModel(nullptr);
 	int wakeModelChoice = as_integer("wind_farm_wake_model");
-	if (wakeModelChoice == 0)
-		wakeModel = std::make_shared<simpleWakeModel>(simpleWakeModel(wpc.nTurbines, &wt));
-	else if (wakeModelChoice == 1)
-		wakeModel = std::make_shared<parkWakeModel>(parkWakeModel(wpc.nTurbines, &wt));
-	else if (wakeModelChoice == 2)
-	{
-		wpc.turbulenceIntensity *= 100;	
-		wakeModel = std::make_shared<eddyViscosityWakeModel>(eddyViscosityWakeModel(wpc.nTurbines, &wt, as_double("wind_resource_turbulence_coeff")));
-	}
-	if (!wpc.InitializeModel(wakeModel))
+	double evTurbulenceCoeff = as_double("wind_resource_turbulence_coeff");
+	if (wakeModelChoice == 2)
+		wpc.turbulenceIntensity *= 100;
+	if (!wpc.InitializeModel(create_wake_model(wakeModelChoice, wpc.nTurbines, &wt, evTurbulenceCoeff)))
 		throw exec_error("windpower", util::format("Wake model choice must be 0, 1 or 2"));
 
+	// optionally interpolate farm power from wake results on a direction, speed and air density grid
+	std::unique_ptr<wakeResultCache> wakeCache;
+	if (as_boolean("wind_farm_wake_cache"))
+		wakeCache.reset(new wakeResultCache(&wpc, as_double("wind_farm_wake_cache_dir_step"), as_double("wind_farm_wake_cache_speed_step"),
+			as_double("wind_farm_wake_cache_density_step"), as_double("wind_farm_wake_cache_tolerance")));
+
 	// allocate output data
 	ssc_number_t *farmpwr = allocate("gen", nstep);
 	ssc_number_t *wspd = allocate("wind_speed", nstep);
@@ -366,27 +386,19 @@ void cm_windpower::exec() throw(general_error)
 	ssc_number_t *air_temp = allocate("temp", nstep);
 	ssc_number_t *air_pres = allocate("pressure", nstep);
 
-	std::vector<double> Power(wpc.nTurbines, 0.), Thrust(wpc.nTurbines, 0.),
-		Eff(wpc.nTurbines, 0.), Wind(wpc.nTurbines, 0.), Turb(wpc.nTurbines, 0.),
-		DistDown(wpc.nTurbines, 0.), DistCross(wpc.nTurbines, 0.);
-
 	ssc_number_t *monthly = allocate("monthly_energy", 12);
 	for (int i = 0; i < 12; i++)
 		monthly[i] = 0.0f;
 	double annual = 0.0;
 	double withoutLosses = 0.0;
 
-	// compute power output at i-th timestep
+	// read the resource at hub height for every timestep
+	std::vector<double> windSeries(nstep), dirSeries(nstep), tempSeries(nstep), presSeries(nstep);
 	int i = 0;
 	for (size_t hr = 0; hr < 8760; hr++)
 	{
-		int imonth = util::month_of((double)hr) - 1;
-
 		for (size_t istep = 0; istep < steps_per_hour; istep++)
 		{
-			if (i % (nstep / 20) == 0)
-				update("", 100.0f * ((float)i) / ((float)nstep), (float)i); //update percentage complete in UI
-
 			double wind, dir, temp, pres, closest_dir_meas_ht;
 
 			//skip leap day if applicable
@@ -431,25 +443,115 @@ void cm_windpower::exec() throw(general_error)
 				wt.measurementHeight = wt.hubHeight;
 			}
 
-			double farmp = 0;
-
-			if ((int)wpc.nTurbines != wpc.windPowerUsingResource(
-				/* inputs */
-				wind,	/* m/s */
-				dir,	/* degrees */
-				pres,	/* Atm */
-				temp,	/* deg C */
-
-				/* outputs */
-				&farmp,
-				&Power[0],
-				&Thrust[0],
-				&Eff[0],
-				&Wind[0],
-				&Turb[0],
-				&DistDown[0],
-				&DistCross[0]))
-				throw exec_error("windpower", util::format("error in wind calculation at time %d, details: %s", i, wpc.GetErrorDetails().c_str()));
+			windSeries[i] = wind;
+			dirSeries[i] = dir;
+			tempSeries[i] = temp;
+			presSeries[i] = pres;
+			wspd[i] = (ssc_number_t)wind;
+			wdir[i] = (ssc_number_t)dir;
+			air_temp[i] = (ssc_number_t)temp;
+			air_pres[i] = (ssc_number_t)pres;
+			i++;
+		}
+	}
+
+	// Timesteps are independent, so they are handed out in chunks from a shared counter to threads that each have their own
+	// copy of the turbine, wake model and calculator. The wake cache is filled as it goes, so it is only used on one thread.
+	int nthreads = as_integer("wind_farm_threads");
+	if (nthreads < 1) nthreads = (int)std::thread::hardware_concurrency();
+	if (nthreads < 1 || wakeCache) nthreads = 1;
+
+	std::vector<double> farmPower(nstep, 0.0);
+	const size_t chunkSize = 256;
+	std::atomic<size_t> nextStep(0);
+	std::mutex errorMutex;
+	size_t errorStep = nstep;
+	std::string errorDetails;
+
+	auto worker = [&](bool reportProgress)
+	{
+		windTurbine turbine(wt);
+		windPowerCalculator calc;
+		calc.windTurb = &turbine;
+		calc.nTurbines = wpc.nTurbines;
+		calc.turbulenceIntensity = wpc.turbulenceIntensity;
+		calc.XCoords = wpc.XCoords;
+		calc.YCoords = wpc.YCoords;
+		calc.InitializeModel(create_wake_model(wakeModelChoice, calc.nTurbines, &turbine, evTurbulenceCoeff));
+
+		std::vector<double> Power(calc.nTurbines, 0.), Thrust(calc.nTurbines, 0.),
+			Eff(calc.nTurbines, 0.), Wind(calc.nTurbines, 0.), Turb(calc.nTurbines, 0.),
+			DistDown(calc.nTurbines, 0.), DistCross(calc.nTurbines, 0.);
+
+		size_t start, nextUpdate = 0;
+		while ((start = nextStep.fetch_add(chunkSize)) < nstep)
+		{
+			if (reportProgress && start >= nextUpdate)
+			{
+				update("", 100.0f * ((float)start) / ((float)nstep), (float)start); //update percentage complete in UI
+				nextUpdate = start + nstep / 20;
+			}
+
+			size_t end = std::min(start + chunkSize, nstep);
+			for (size_t j = start; j < end; j++)
+			{
+				int nCalculated;
+				if (wakeCache)
+					nCalculated = wakeCache->farmPower(windSeries[j], dirSeries[j], presSeries[j], tempSeries[j], &farmPower[j]);
+				else
+					nCalculated = calc.windPowerUsingResource(
+						/* inputs */
+						windSeries[j],	/* m/s */
+						dirSeries[j],	/* degrees */
+						presSeries[j],	/* Atm */
+						tempSeries[j],	/* deg C */
+
+						/* outputs */
+						&farmPower[j],
+						&Power[0],
+						&Thrust[0],
+						&Eff[0],
+						&Wind[0],
+						&Turb[0],
+						&DistDown[0],
+						&DistCross[0]);
+
+				if ((int)calc.nTurbines != nCalculated)
+				{
+					// report the earliest failure, as the serial calculation would
+					std::lock_guard<std::mutex> lock(errorMutex);
+					if (j < errorStep)
+					{
+						errorStep = j;
+						errorDetails = wakeCache ? wakeCache->GetErrorDetails() : calc.GetErrorDetails();
+					}
+					nextStep = nstep;
+					return;
+				}
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int t = 1; t < nthreads; t++)
+		pool.push_back(std::thread(worker, false));
+	worker(true); // the calling thread participates as well
+	for (size_t t = 0; t < pool.size(); t++)
+		pool[t].join();
+
+	if (errorStep < nstep)
+		throw exec_error("windpower", util::format("error in wind calculation at time %d, details: %s", (int)errorStep, errorDetails.c_str()));
+
+	// apply losses and accumulate energy in timestep order
+	i = 0;
+	for (size_t hr = 0; hr < 8760; hr++)
+	{
+		int imonth = util::month_of((double)hr) - 1;
+
+		for (size_t istep = 0; istep < steps_per_hour; istep++)
+		{
+			double farmp = farmPower[i];
+			double temp = tempSeries[i];
 
 			// apply losses
 			withoutLosses += farmp * haf(hr);
@@ -462,10 +564,6 @@ void cm_windpower::exec() throw(general_error)
 			}
 
 			farmpwr[i] = (ssc_number_t)farmp*haf(hr); //adjustment factors are constrained to be hourly, not sub-hourly, so it's correct for this to be indexed on the hour
-			wspd[i] = (ssc_number_t)wind;
-			wdir[i] = (ssc_number_t)dir;
-			air_temp[i] = (ssc_number_t)temp;
-			air_pres[i] = (ssc_number_t)pres;
 
 			// accumulate monthly and annual energy
 			monthly[imonth] += farmpwr[i] / steps_per_hour;
@@ -475,6 +573,10 @@ void cm_windpower::exec() throw(general_error)
 		} // end steps_per_hour loop
 	} // end 1->8760 loop
 
+	if (wakeCache)
+		log(util::format("Wake cache: %d grid points in %d cells, %d timesteps calculated in full",
+			(int)wakeCache->gridPointCount(), (int)wakeCache->cellCount(), (int)wakeCache->fullCalculationCount()), SSC_NOTICE);
+
 	// assign outputs
 	assign("annual_energy", var_data((ssc_number_t)annual));
 	double kWhperkW = 0.0;
@@ -708,7 +708,7 @@ double shading_factor_calculator::dc_shade_factor()
 	return (m_dc_shade_factor);
 }
 
-weatherdata::weatherdata( var_data *data_table )
+weatherdata::weatherdata( var_data *data_table, bool borrow_arrays )
 {
 	m_startSec = m_stepSec = m_nRecords = 0;
 	m_index = 0;
@@ -813,77 +813,69 @@ weatherdata::weatherdata( var_data *data_table )
 
 	if ( nrec > 0 && nmult >= 1 )
 	{
-		m_data.resize( nrec );
-		for( int i=0;i<nrec;i++ )
-		{
-			weather_record *r = new weather_record;
-
-			if ( i < year.len ) r->year = (int)year.p[i]; 
-			else r->year = 2000;
-
-			if ( i < month.len ) r->month = (int)month.p[i];
-			else if ( m_stepSec == 3600 && m_nRecords == 8760 ) {
-				r->month = util::month_of((double)i);
-			}
+		m_store.reset( nrec );
+		m_store.set_default( YEAR, 2000 );
+		m_store.set_default( MINUTE, (float)((m_stepSec / 2) / 60) );
 
-			if ( i < day.len ) r->day = (int)day.p[i];
-			else if ( m_stepSec == 3600 && m_nRecords == 8760 ) {
-				int month = util::month_of( (double)i );
-				r->day = util::day_of_month( month, (double)i );
-			}
-
-			if ( i < hour.len ) r->hour = (int)hour.p[i];
-			else if ( m_stepSec == 3600 && m_nRecords == 8760 ) {
-				size_t day = i / 24;
-				size_t start_of_day = day * 24;
-				r->hour = (int)(i - start_of_day);
-			}
+		vec *cols[_MAXCOL_] = { &year, &month, &day, &hour, &minute,
+			&gh, &dn, &df, &poa, &tdry, &twet, &tdew, &wspd, &wdir, &rhum, &pres, &snow, &alb, &aod };
+		for ( size_t k = 0; k < _MAXCOL_; k++ )
+			set_column( k, *cols[k], borrow_arrays );
 
-			if ( i < minute.len ) r->minute = minute.p[i];
-			else r->minute = (double)((m_stepSec / 2) / 60);
-
-			r->gh = r->dn = r->df = r->poa = r->wspd = r->wdir = r->tdry = r->twet = r->tdew 
-				= r->rhum = r->pres = r->snow = r->alb = r->aod = std::numeric_limits<double>::quiet_NaN();
-			if ( i < gh.len ) r->gh = gh.p[i];
-			if ( i < dn.len ) r->dn = dn.p[i];
-			if ( i < df.len ) r->df = df.p[i];
-			if (i < poa.len ) r->poa = poa.p[i];
-
-			if ( i < wspd.len ) r->wspd = wspd.p[i];
-			if ( i < wdir.len ) r->wdir = wdir.p[i];
-
-			if ( i < tdry.len ) r->tdry = tdry.p[i];
-			if ( i < twet.len ) r->twet = twet.p[i];
-			else{
-				// calculate twet using calc_twet if tdry & rh & pres are available
-				if ((i < tdry.len) && (i < rhum.len) && (i < pres.len)){
-					r->twet = (float)calc_twet(tdry.p[i], rhum.p[i], pres.p[i]);
-				}
-			}
-			if ( i < tdew.len ) r->tdew = tdew.p[i];
-			else{
-				// calculate tdew using wiki_dew_calc if tdry & rh are available
-				if ((i < tdry.len) && (i < rhum.len)){
-					r->tdew = (float)wiki_dew_calc(tdry.p[i], rhum.p[i]);
-				}
+		// the time of day columns may be shorter than the data; fill in the rest for hourly data
+		if ( m_stepSec == 3600 && m_nRecords == 8760 )
+		{
+			float *p_month = month.len < nrec ? ( m_store.has( MONTH ) ? m_store.data( MONTH ) : m_store.alloc( MONTH, 0 ) ) : 0;
+			float *p_day = day.len < nrec ? ( m_store.has( DAY ) ? m_store.data( DAY ) : m_store.alloc( DAY, 0 ) ) : 0;
+			float *p_hour = hour.len < nrec ? ( m_store.has( HOUR ) ? m_store.data( HOUR ) : m_store.alloc( HOUR, 0 ) ) : 0;
+			for ( size_t i = 0; i < nrec; i++ )
+			{
+				int month_i = util::month_of( (double)i );
+				if ( p_month && i >= month.len ) p_month[i] = (float)month_i;
+				if ( p_day && i >= day.len ) p_day[i] = (float)util::day_of_month( month_i, (double)i );
+				if ( p_hour && i >= hour.len ) p_hour[i] = (float)(i - (i / 24) * 24);
 			}
+		}
 
-			if ( i < rhum.len ) r->rhum = rhum.p[i];
-			if ( i < pres.len ) r->pres = pres.p[i];
-
-			if ( i < snow.len ) r->snow = snow.p[i];
-			if ( i < alb.len ) r->alb = alb.p[i];
-			if ( i < aod.len ) r->aod = aod.p[i];
+		// calculate twet using calc_twet if tdry & rh & pres are available
+		if ( twet.len == 0 && tdry.len > 0 && rhum.len > 0 && pres.len > 0 )
+		{
+			float *p = m_store.alloc( TWET, 0 );
+			for ( size_t i = 0; i < nrec; i++ )
+				p[i] = (float)calc_twet( tdry.p[i], rhum.p[i], pres.p[i] );
+		}
 
-			m_data[i] = r;
+		// calculate tdew using wiki_dew_calc if tdry & rh are available
+		if ( tdew.len == 0 && tdry.len > 0 && rhum.len > 0 )
+		{
+			float *p = m_store.alloc( TDEW, 0 );
+			for ( size_t i = 0; i < nrec; i++ )
+				p[i] = (float)wiki_dew_calc( tdry.p[i], rhum.p[i] );
 		}
 	}
 }
 
 weatherdata::~weatherdata()
 {
-	for( size_t i=0;i<m_data.size();i++ )
-		delete m_data[i];
+	// nothing to do, columns are released with m_store
+}
+
+void weatherdata::set_column( size_t id, const vec &v, bool borrow_arrays )
+{
+	if ( v.len == 0 )
+		return;
+
+	size_t nrec = m_store.size();
+	if ( borrow_arrays && v.len >= nrec )
+		m_store.borrow( id, v.p ); // ssc_number_t is float, the column type
+	else
+	{
+		// short columns keep the default constant past their end, as if missing
+		float *p = m_store.alloc( id, m_store.value( id, 0 ) );
+		size_t n = std::min( v.len, nrec );
+		for ( size_t i = 0; i < n; i++ )
+			p[i] = (float)v.p[i];
+	}
 }
 
 
@@ -953,16 +945,16 @@ ssc_number_t weatherdata::get_number( var_data *v, const char *name )
 }
 
 void weatherdata::set_counter_to(size_t cur_index){
-	if (cur_index < m_data.size()) {
+	if (cur_index < m_store.size()) {
 		m_index = cur_index;
 	}
 }
 
 bool weatherdata::read( weather_record *r )
 {
-	if (m_index < m_data.size())
+	if (m_index < m_store.size())
 	{
-		*r = *m_data[m_index++];
+		m_store.get( m_index++, r );
 		return true;
 	}
 	else
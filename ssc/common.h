@@ -138,7 +138,7 @@ public:
 
 class weatherdata : public weather_data_provider
 {
-	std::vector< weather_record* > m_data;
+	weather_columns m_store;
 	std::vector<size_t> m_columns;
 
 	struct vec {
@@ -148,6 +148,7 @@ class weatherdata : public weather_data_provider
 
 	vec get_vector(var_data *v, const char *name, size_t *len = nullptr);
 	ssc_number_t get_number(var_data *v, const char *name);
+	void set_column(size_t id, const vec &v, bool borrow_arrays);
 
 	size_t name_to_id(const char *name);
 
@@ -155,8 +156,10 @@ public:
 	/* Detects file format, read header information, detects which data columns are available and at what index
 	and read weather record information.
 	If wet-bulb temperature or dew point are missing, calculate using tdry, pres & rhum or tdry & rhum, respectively.
-	Interpolates meteorological data if requested.*/
-	weatherdata(var_data *data_table);
+	Interpolates meteorological data if requested.
+	With borrow_arrays, full length arrays in data_table are read in place instead of copied, so the table
+	must not be changed or freed while this object is in use.*/
+	weatherdata(var_data *data_table, bool borrow_arrays = false);
 	virtual ~weatherdata();
 
 	void set_counter_to(size_t cur_index);
@@ -50,6 +50,7 @@
 #include <sstream>
 #include <fstream>
 #include <cstring>
+#include <cctype>
 
 #include "core.h"
 
@@ -91,18 +92,79 @@ bool compute_module::compute( handler_interface *handler, var_table *data )
 		return false;
 	}
 	
+	m_output_filter.clear();
+	var_data *filter = m_vartab->lookup( SSC_OUTPUT_FILTER );
+	if (filter && filter->type == SSC_STRING)
+		set_output_filter( filter->str );
+
+	bool ok = false;
 	try { // catch any 'general_error' that can be thrown during precheck, exec, and postcheck
 
-		if (!verify("precheck input", SSC_INPUT)) return false;
-		exec();
-		if (!verify("postcheck output", SSC_OUTPUT)) return false;
+		if (verify("precheck input", SSC_INPUT))
+		{
+			exec();
+			if (verify("postcheck output", SSC_OUTPUT))
+			{
+				drop_unrequested_outputs();
+				ok = true;
+			}
+		}
 
 	} catch ( general_error &e )	{
 		log( e.err_text, SSC_ERROR, e.time );
-		return false;
 	}
-	
-	return true;
+
+	m_discard.clear();
+	return ok;
+}
+
+static bool glob_match( const char *pat, const char *str )
+{
+	// '*' matches any run of characters, '?' any single character.  names are not case sensitive, as in var_table
+	const char *star = NULL, *resume = NULL;
+	while (*str)
+	{
+		if (*pat == '?' || tolower((unsigned char)*pat) == tolower((unsigned char)*str)) { pat++; str++; }
+		else if (*pat == '*') { star = pat++; resume = str; }
+		else if (star) { pat = star + 1; str = ++resume; }
+		else return false;
+	}
+	while (*pat == '*') pat++;
+	return *pat == 0;
+}
+
+void compute_module::set_output_filter( const std::string &filter )
+{
+	std::vector< std::string > list = util::split( filter, ",; \t\r\n" );
+	for (size_t i = 0; i < list.size(); i++)
+		if (!list[i].empty())
+			m_output_filter.push_back( list[i] );
+}
+
+bool compute_module::output_requested( const std::string &name )
+{
+	if (m_output_filter.empty()) return true;
+
+	for (size_t i = 0; i < m_output_filter.size(); i++)
+		if (glob_match( m_output_filter[i].c_str(), name.c_str() ))
+			return true;
+
+	return false;
+}
+
+void compute_module::drop_unrequested_outputs()
+{
+	if (m_output_filter.empty()) return;
+
+	// scalars are cheap and often used by downstream modules, only the time series are removed
+	for (size_t i = 0; i < m_varlist.size(); i++)
+	{
+		var_info *vi = m_varlist[i];
+		if (vi->var_type == SSC_OUTPUT
+			&& (vi->data_type == SSC_ARRAY || vi->data_type == SSC_MATRIX)
+			&& !output_requested( vi->name ))
+			m_vartab->unassign( vi->name );
+	}
 }
 
 bool compute_module::verify(const std::string &phase, int check_var_type) throw( general_error )
@@ -114,6 +176,9 @@ bool compute_module::verify(const std::string &phase, int check_var_type) throw(
 		if ( vi->var_type == check_var_type
 			|| vi->var_type == SSC_INOUT )
 		{
+			if ( check_var_type == SSC_OUTPUT && vi->var_type == SSC_OUTPUT && !output_requested( vi->name ) )
+				continue;
+
 			if ( check_required( vi->name ) )
 			{
 				// if the variable is required, make sure it exists
@@ -270,6 +335,12 @@ var_data *compute_module::assign( const std::string &name, const var_data &value
 	return m_vartab->assign( name, value );
 }
 
+var_data *compute_module::assign( const std::string &name, var_data &&value ) throw( general_error )
+{
+	if (!m_vartab) throw general_error("invalid data container object reference");
+	return m_vartab->assign( name, std::move(value) );
+}
+
 ssc_number_t *compute_module::allocate( const std::string &name, size_t length ) throw( general_error )
 {
 	var_data *v = assign(name, var_data());
@@ -278,6 +349,19 @@ ssc_number_t *compute_module::allocate( const std::string &name, size_t length )
 	return v->num.data();
 }
 
+ssc_number_t *compute_module::allocate_output( const std::string &name, size_t length ) throw( general_error )
+{
+	if (output_requested( name ))
+		return allocate( name, length );
+
+	// unrequested outputs of the same length share one buffer, so nothing is stored per variable
+	std::vector<ssc_number_t> &buf = m_discard[length];
+	if (buf.size() != length)
+		buf.resize( length );
+	std::fill( buf.begin(), buf.end(), (ssc_number_t)0.0 );
+	return length > 0 ? &buf[0] : NULL;
+}
+
 ssc_number_t *compute_module::allocate( const std::string &name, size_t nrows, size_t ncols ) throw( general_error )
 {
 	var_data *v = assign(name, var_data());
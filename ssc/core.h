@@ -54,6 +54,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <map>
 #include <algorithm>
 #include <exception>
 #include <cstdarg>
@@ -253,9 +254,17 @@ public:
 	bool is_ssc_array_output( const std::string &name ) throw( general_error );
 	var_data *lookup( const std::string &name ) throw( general_error );
 	var_data *assign( const std::string &name, const var_data &value ) throw( general_error );
+	var_data *assign( const std::string &name, var_data &&value ) throw( general_error );
 	ssc_number_t *allocate( const std::string &name, size_t length ) throw( general_error );
 	ssc_number_t *allocate( const std::string &name, size_t nrows, size_t ncols ) throw( general_error );
 	util::matrix_t<ssc_number_t>& allocate_matrix( const std::string &name, size_t nrows, size_t ncols ) throw( general_error );
+
+	/* output subsets: if the caller assigned SSC_OUTPUT_FILTER, only the outputs matching it are
+	   returned.  output_requested() is true for every name when no filter is given.  allocate_output()
+	   is for arrays the module only writes and never reads back: when the output is not requested the
+	   values go to a scratch buffer that is reused and discarded instead of the data container */
+	bool output_requested( const std::string &name );
+	ssc_number_t *allocate_output( const std::string &name, size_t length ) throw( general_error );
 	var_data &value( const std::string &name ) throw( general_error );
 	bool is_assigned( const std::string &name ) throw( general_error );
 	size_t as_unsigned_long(const std::string &name) throw(general_error);
@@ -293,6 +302,9 @@ private:
 	bool check_required( const std::string &name ) throw( general_error );
 	bool check_constraints( const std::string &name, std::string &fail_text ) throw( general_error );
 
+	void set_output_filter( const std::string &filter );
+	void drop_unrequested_outputs();
+
 	// helper functions for check_required
 	ssc_number_t get_operand_value( const std::string &input, const std::string &cur_var_name ) throw( general_error );
 
@@ -303,6 +315,9 @@ private:
 	
 	unordered_map< std::string, var_info* > *m_infomap;
 
+	std::vector< std::string > m_output_filter; // glob patterns, empty for all outputs
+	std::map< size_t, std::vector<ssc_number_t> > m_discard; // scratch buffers for unrequested outputs, by length
+
 	/* these members are take values only during a call to 'compute(..)'
 	  and are NULL otherwise */
 	handler_interface   *m_handler;
@@ -83,7 +83,7 @@ solarpilot_invoke::~solarpilot_invoke()
         delete m_sapi;
 }
 
-AutoPilot_S *solarpilot_invoke::GetSAPI()
+AutoPilot *solarpilot_invoke::GetSAPI()
 {
     return m_sapi;
 }
@@ -96,7 +96,19 @@ bool solarpilot_invoke::run(std::shared_ptr<weather_data_provider> wdata)
     if(m_sapi != 0)
         delete m_sapi;
 
-    m_sapi = new AutoPilot_S();
+    //solarpilot_threads: number of threads for the layout and field simulations, 1 (the default)
+    //runs serially and 0 uses all cores. Modules that don't declare the input run serially.
+    int nthreads = m_cmod->is_assigned("solarpilot_threads") ? m_cmod->as_integer("solarpilot_threads") : 1;
+#ifdef SP_USE_THREADS
+    if(nthreads != 1)
+    {
+        AutoPilot_MT *sapi_mt = new AutoPilot_MT();
+        sapi_mt->SetMaxThreadCount(nthreads < 1 ? 999999 : nthreads);
+        m_sapi = sapi_mt;
+    }
+    else
+#endif
+        m_sapi = new AutoPilot_S();
 
 	// read inputs from SSC module
 		
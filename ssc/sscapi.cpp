@@ -49,6 +49,9 @@
 
 #include <stdio.h>
 #include <cstring>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "core.h"
 #include "sscapi.h"
@@ -86,6 +89,7 @@ extern module_entry_info
 	cm_entry_pv6parmod,
 	cm_entry_pvsandiainv,
 	cm_entry_wfreader,
+	cm_entry_wfbinconv,
 	cm_entry_irradproc,
 	cm_entry_utilityrate,
 	cm_entry_utilityrate2,
@@ -168,6 +172,7 @@ static module_entry_info *module_table[] = {
 	&cm_entry_pvwattsv5_1ts,
 	&cm_entry_pvsandiainv,
 	&cm_entry_wfreader,
+	&cm_entry_wfbinconv,
 	&cm_entry_irradproc,
 	&cm_entry_utilityrate,
 	&cm_entry_utilityrate2,
@@ -352,6 +357,26 @@ SSCEXPORT void ssc_data_set_table( ssc_data_t p_data, const char *name, ssc_data
 	dat->table = *value;  // invokes operator= for deep copy
 }
 
+SSCEXPORT ssc_number_t *ssc_data_alloc_array( int length )
+{
+	if ( length < 1 ) return 0;
+	return new ssc_number_t[ length ];
+}
+
+SSCEXPORT void ssc_data_set_array_owned( ssc_data_t p_data, const char *name, ssc_number_t *pvalues, int length )
+{
+	var_table *vt = static_cast<var_table*>(p_data);
+	if (!pvalues) return;
+	if (!vt || length < 1)
+	{
+		delete [] pvalues; // ownership was handed over, so release it as the data set would
+		return;
+	}
+	var_data *dat = vt->assign( name, var_data() );
+	dat->type = SSC_ARRAY;
+	dat->num.assign_owned( pvalues, 1, (size_t)length );
+}
+
 SSCEXPORT const char *ssc_data_get_string( ssc_data_t p_data, const char *name )
 {
 	var_table *vt = static_cast<var_table*>(p_data);
@@ -402,6 +427,16 @@ SSCEXPORT ssc_data_t ssc_data_get_table( ssc_data_t p_data, const char *name )
 	return static_cast<ssc_data_t>( &(dat->table) );
 }
 
+SSCEXPORT const ssc_number_t *ssc_data_get_array_view( ssc_data_t p_data, const char *name, int *length )
+{
+	var_table *vt = static_cast<var_table*>(p_data);
+	if (!vt) return 0;
+	var_data *dat = vt->lookup(name);
+	if (!dat || (dat->type != SSC_ARRAY && dat->type != SSC_MATRIX)) return 0;
+	if (length) *length = (int) dat->num.ncells();
+	return dat->num.data();
+}
+
 SSCEXPORT ssc_entry_t ssc_module_entry( int index )
 {
 	int max=0;
@@ -593,7 +628,8 @@ static char p_internal_buf[256];
 	return result ? 0 : p_internal_buf;
 }
 
-static int sg_defaultPrint = 1;
+// atomic so that the print setting can be changed while other threads are running modules
+static std::atomic<int> sg_defaultPrint( 1 );
 
 SSCEXPORT void ssc_module_exec_set_print( int print )
 {
@@ -662,6 +698,66 @@ SSCEXPORT ssc_bool_t ssc_module_exec_with_handler(
 }
 
 
+SSCEXPORT int ssc_module_exec_batch( const char *name, ssc_data_t *p_data, int count, int nthreads, ssc_bool_t *results, ssc_module_t *p_mods )
+{
+	if ( count < 0 || (count > 0 && !p_data) ) return 0;
+
+	// validate the module name up front so an invalid name is reported once, not per case
+	ssc_module_t p_test = ssc_module_create( name );
+	if ( !p_test ) return -1;
+	ssc_module_free( p_test );
+
+	if ( nthreads < 1 ) nthreads = (int)std::thread::hardware_concurrency();
+	if ( nthreads < 1 ) nthreads = 1;
+	if ( nthreads > count ) nthreads = count;
+
+	std::vector<ssc_bool_t> status( count, 0 );
+	std::vector<ssc_module_t> mods( count, (ssc_module_t)0 );
+
+	// cases are handed out one at a time from a shared counter, so an idle worker
+	// always picks up the next unstarted case regardless of how long the others take
+	std::atomic<int> next_case( 0 );
+	auto worker = [&]()
+	{
+		int i;
+		while ( (i = next_case++) < count )
+		{
+			compute_module *cm = static_cast<compute_module*>( ssc_module_create( name ) );
+			var_table *vt = static_cast<var_table*>( p_data[i] );
+			if ( !vt )
+				cm->log( "invalid data object provided", SSC_ERROR );
+			else
+			{
+				try {
+					default_exec_handler h( cm, default_internal_handler_no_print, 0 );
+					status[i] = cm->compute( &h, vt ) ? 1 : 0;
+				} catch( std::exception &e ) {
+					cm->log( std::string("unhandled exception: ") + e.what(), SSC_ERROR );
+				}
+			}
+			mods[i] = static_cast<ssc_module_t>( cm );
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for( int t=1;t<nthreads;t++ )
+		pool.push_back( std::thread( worker ) );
+	worker(); // the calling thread participates as well
+	for( size_t t=0;t<pool.size();t++ )
+		pool[t].join();
+
+	int nsuccess = 0;
+	for( int i=0;i<count;i++ )
+	{
+		if ( status[i] ) nsuccess++;
+		if ( results ) results[i] = status[i];
+		if ( p_mods ) p_mods[i] = mods[i];
+		else ssc_module_free( mods[i] );
+	}
+
+	return nsuccess;
+}
+
 SSCEXPORT void ssc_module_extproc_output( ssc_handler_t p_handler, const char *output_line )
 {
 	handler_interface *hi = static_cast<handler_interface*>( p_handler );
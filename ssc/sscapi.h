@@ -164,6 +164,12 @@ SSCEXPORT void ssc_data_set_matrix( ssc_data_t p_data, const char *name, ssc_num
 
 /** Assigns value of type @a SSC_TABLE. */
 SSCEXPORT void ssc_data_set_table( ssc_data_t p_data, const char *name, ssc_data_t table );
+
+/** Allocates an uninitialized array of 'length' numbers to be filled in by the caller and then handed to ssc_data_set_array_owned. Returns 0 (NULL) if 'length' is less than 1. */
+SSCEXPORT ssc_number_t *ssc_data_alloc_array( int length );
+
+/** Assigns value of type @a SSC_ARRAY without copying the values. The data set takes ownership of 'pvalues', which must have been returned by ssc_data_alloc_array, and releases it when the variable is unassigned or reassigned, or the data set is freed. The caller must not use or free 'pvalues' afterwards, even if 'length' is less than 1 and nothing is assigned. */
+SSCEXPORT void ssc_data_set_array_owned( ssc_data_t p_data, const char *name, ssc_number_t *pvalues, int length );
 /**@}*/ 
 
 /** @name Retrieving variable values.
@@ -184,6 +190,9 @@ SSCEXPORT ssc_number_t *ssc_data_get_matrix( ssc_data_t p_data, const char *name
 
 /** Returns the value of a @a SSC_TABLE variable with the given name. */
 SSCEXPORT ssc_data_t ssc_data_get_table( ssc_data_t p_data, const char *name );
+
+/** Returns a read-only view of the values of a @a SSC_ARRAY or @a SSC_MATRIX variable with the given name, without copying them. Matrices are viewed as a continuous array in row-major order, and 'length' receives the total number of values. The view remains valid until the variable is unassigned or reassigned, or the data set is freed. */
+SSCEXPORT const ssc_number_t *ssc_data_get_array_view( ssc_data_t p_data, const char *name, int *length );
 /**@}*/ 
 
 /** The opaque data structure that stores information about a compute module. */
@@ -301,6 +310,9 @@ SSCEXPORT const char *ssc_module_exec_simple_nothread( const char *name, ssc_dat
 #define SSC_UPDATE 1
 /**@}*/
 
+/** Name of an optional string variable in the data set that selects the outputs a computation module returns: a list of names separated by commas, semicolons or spaces, where '*' matches any run of characters and '?' any single character (e.g. "gen,annual_*,monthly_energy").  Array and matrix outputs that do not match are not returned, and modules skip storing them during the run where possible.  Number and string outputs are always returned.  If the variable is not assigned, all outputs are returned. */
+#define SSC_OUTPUT_FILTER "ssc_output_filter"
+
 /** Runs an instantiated computation module over the specified data set. Returns Boolean: 1 or 0. Detailed notices, warnings, and errors can be retrieved using the ssc_module_log function. */
 SSCEXPORT ssc_bool_t ssc_module_exec( ssc_module_t p_mod, ssc_data_t p_data ); /* uses default internal built-in handler */
 
@@ -324,6 +336,23 @@ SSCEXPORT ssc_bool_t ssc_module_exec_with_handler(
 /** Retrive notices, warnings, and error messages from the simulation. Returns a NULL-terminated ASCII C string with the message text, or NULL if the index passed in was invalid. */
 SSCEXPORT const char *ssc_module_log( ssc_module_t p_mod, int index, int *item_type, float *time );
 
+/** Runs the named computation module over an array of 'count' data sets using a pool of 'nthreads' worker threads. If 'nthreads' is less than 1, the number of hardware threads is used. Each case is run by its own module instance, so no simulation state is shared between cases, and no progress or log messages are printed to the console regardless of ssc_module_exec_set_print. If 'results' is not NULL, it must point to 'count' entries that receive 1 or 0 for each case. If 'p_mods' is not NULL, it must point to 'count' entries that receive the module instance used for each case, so that its notices, warnings, and errors can be retrieved with ssc_module_log; in that case the caller must release each one with ssc_module_free. Returns the number of cases that succeeded, or -1 if the module name is invalid. Each data set must be distinct, but the data sets may otherwise be used from the calling thread once the function returns. Example:
+
+	\verbatim
+	ssc_data_t cases[100];
+	ssc_bool_t ok[100];
+	ssc_module_t mods[100];
+	// ... create and assign inputs to each case ...
+	int nsuccess = ssc_module_exec_batch( "pvwattsv5", cases, 100, 0, ok, mods );
+	for( int i=0;i<100;i++ )
+	{
+		if ( !ok[i] ) printf( "case %d: %s\n", i, ssc_module_log( mods[i], 0, 0, 0 ) );
+		ssc_module_free( mods[i] );
+	}
+	\endverbatim
+*/
+SSCEXPORT int ssc_module_exec_batch( const char *name, ssc_data_t *p_data, int count, int nthreads, ssc_bool_t *results, ssc_module_t *p_mods );
+
 /** DO NOT CALL THIS FUNCTION: immediately causes a segmentation fault within the library. This is only useful for testing crash handling from an external application that is dynamically linked to the SSC library */
 SSCEXPORT void __ssc_segfault();
 
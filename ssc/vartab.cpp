@@ -191,6 +191,13 @@ var_table::var_table() : m_iterator(m_hash.begin())
 	/* nothing to do here */
 }
 
+var_table::var_table( var_table &&rhs ) : m_iterator(m_hash.begin())
+{
+	m_hash.swap( rhs.m_hash );
+	m_iterator = m_hash.begin();
+	rhs.m_iterator = rhs.m_hash.begin();
+}
+
 var_table::~var_table()
 {
 	clear();
@@ -208,6 +215,19 @@ var_table &var_table::operator=( const var_table &rhs )
 	return *this;
 }
 
+var_table &var_table::operator=( var_table &&rhs )
+{
+	if ( this != &rhs )
+	{
+		clear();
+		m_hash.swap( rhs.m_hash );
+		m_iterator = m_hash.begin();
+		rhs.m_iterator = rhs.m_hash.begin();
+	}
+
+	return *this;
+}
+
 void var_table::clear()
 {
 	for ( var_hash::iterator it = m_hash.begin(); it !=m_hash.end(); ++it )
@@ -228,6 +248,19 @@ var_data *var_table::assign( const std::string &name, const var_data &val )
 	return v;
 }
 
+var_data *var_table::assign( const std::string &name, var_data &&val )
+{
+	var_data *v = lookup(name);
+	if (!v)
+	{
+		v = new var_data;
+		m_hash[ util::lower_case(name) ] = v;
+	}
+
+	*v = std::move(val);
+	return v;
+}
+
 void var_table::unassign( const std::string &name )
 {
 	var_hash::iterator it = m_hash.find( util::lower_case(name) );
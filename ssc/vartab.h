@@ -70,10 +70,12 @@ class var_table
 {
 public:
 	explicit var_table();
+	var_table( var_table &&rhs ); // takes the variables of 'rhs', leaving it empty
 	virtual ~var_table();
 
 	void clear();
 	var_data *assign( const std::string &name, const var_data &value );
+	var_data *assign( const std::string &name, var_data &&value ); // moves 'value' into the table without copying its data
 	void unassign( const std::string &name );
 	bool rename( const std::string &oldname, const std::string &newname );
 	var_data *lookup( const std::string &name );
@@ -81,6 +83,7 @@ public:
 	const char *next();
 	unsigned int size() { return (unsigned int)m_hash.size(); }
 	var_table &operator=( const var_table &rhs );
+	var_table &operator=( var_table &&rhs );
 
 private:
 	var_hash m_hash;
@@ -94,6 +97,7 @@ public:
 	
 	var_data() : type(SSC_INVALID) { num=0.0; }
 	var_data( const var_data &cp ) : type(cp.type), num(cp.num), str(cp.str) {  }
+	var_data( var_data &&cp ) : type(cp.type), num(std::move(cp.num)), str(std::move(cp.str)), table(std::move(cp.table)) {  }
 	var_data( const std::string &s ) : type(SSC_STRING), str(s) {  }
 	var_data( ssc_number_t n ) : type(SSC_NUMBER) { num = n; }
 	var_data(const ssc_number_t *pvalues, int length) : type(SSC_ARRAY) { num.assign(pvalues, (size_t)length); }
@@ -108,6 +112,7 @@ public:
 	static bool parse( unsigned char type, const std::string &buf, var_data &value );
 
 	var_data &operator=(const var_data &rhs) { copy(rhs); return *this; }
+	var_data &operator=(var_data &&rhs) { type=rhs.type; num=std::move(rhs.num); str=std::move(rhs.str); table=std::move(rhs.table); return *this; }
 	void copy( const var_data &rhs ) { type=rhs.type; num=rhs.num; str=rhs.str; table = rhs.table; }
 	
 	unsigned char type;
@@ -131,6 +131,10 @@ int CO2_TQ( double T, double Q, CO2_state * state );
 double CO2_visc( double D, double T);	//(uPa-s)
 double CO2_cond( double D, double T);	//(W/m-K)
 
+// Saturated vapor and liquid density fits (kg/m3) for T_sat_min <= T < T_crit (K)
+double CO2_sat_vap_dens( const double T );
+double CO2_sat_liq_dens( const double T );
+
 namespace N_co2_props
 {
 	const double T_crit = 304.1282;
@@ -0,0 +1,393 @@
+/*******************************************************************************************************
+*  Copyright 2017 Alliance for Sustainable Energy, LLC
+*
+*  NOTICE: This software was developed at least in part by Alliance for Sustainable Energy, LLC
+*  (Alliance) under Contract No. DE-AC36-08GO28308 with the U.S. Department of Energy and the U.S.
+*  The Government retains for itself and others acting on its behalf a nonexclusive, paid-up,
+*  irrevocable worldwide license in the software to reproduce, prepare derivative works, distribute
+*  copies to the public, perform publicly and display publicly, and to permit others to do so.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted
+*  provided that the following conditions are met:
+*
+*  1. Redistributions of source code must retain the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer.
+*
+*  2. Redistributions in binary form must reproduce the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer in the documentation and/or
+*  other materials provided with the distribution.
+*
+*  3. The entire corresponding source code of any redistribution, with or without modification, by a
+*  research entity, including but not limited to any contracting manager/operator of a United States
+*  National Laboratory, any institution of higher learning, and any non-profit organization, must be
+*  made publicly available under this license for as long as the redistribution is made available by
+*  the research entity.
+*
+*  4. Redistribution of this software, without modification, must refer to the software by the same
+*  designation. Redistribution of a modified version of this software (i) may not refer to the modified
+*  version by the same designation, or by any confusingly similar designation, and (ii) must refer to
+*  the underlying software originally provided by Alliance as System Advisor Model or SAM. Except
+*  to comply with the foregoing, the terms System Advisor Model, SAM, or any confusingly similar
+*  designation may not be used to refer to any modified version of this software or any modified
+*  version of the underlying software originally provided by Alliance without the prior written consent
+*  of Alliance.
+*
+*  5. The name of the copyright holder, contributors, the United States Government, the United States
+*  Department of Energy, or any of their employees may not be used to endorse or promote products
+*  derived from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+*  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER,
+*  CONTRIBUTORS, UNITED STATES GOVERNMENT OR UNITED STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR
+*  EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+*  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+*  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+*  THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************************************/
+
+#include "co2_props_table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <atomic>
+
+using namespace N_co2_props;
+
+namespace
+{
+	enum
+	{
+		E_PH,
+		E_PS
+	};
+
+	// Phase of a table node
+	enum
+	{
+		E_NODE_INVALID,		// property error or two-phase
+		E_NODE_LIQUID,
+		E_NODE_VAPOR,
+		E_NODE_SUPERCRIT
+	};
+
+	const int N_SOLVE_MAX_ITER = 6;
+
+	C_co2_props_table g_co2_props_table;
+	std::mutex g_co2_props_table_mutex;
+	std::atomic<bool> g_is_co2_props_table_built(false);
+
+	// Per thread so concurrent runs in one process don't share a setting
+#ifdef _MSC_VER
+	__declspec(thread) double g_co2_props_table_tol = 0.0;
+#else
+	__thread double g_co2_props_table_tol = 0.0;
+#endif
+
+	int call_exact(int prop_pair, double P, double y, CO2_state *state)
+	{
+		if( prop_pair == E_PH )
+			return CO2_PH(P, y, state);
+		return CO2_PS(P, y, state);
+	}
+
+	// Catmull-Rom weights of the four nodes around a point at fraction t of the middle interval
+	void catmull_rom_weights(double t, double w[4])
+	{
+		w[0] = 0.5*((-t + 2.0)*t - 1.0)*t;
+		w[1] = 0.5*((3.0*t - 5.0)*t*t + 2.0);
+		w[2] = 0.5*((-3.0*t + 4.0)*t + 1.0)*t;
+		w[3] = 0.5*(t - 1.0)*t*t;
+	}
+
+	// Newton iteration on the Helmholtz fit from an interpolated (T,D), as in CO2_PH and CO2_PS but
+	// without their saturation checks and initial guess fits.  Returns false if the iteration does
+	// not converge or the solution is out of range or two-phase
+	bool solve(int prop_pair, double P, double y, double rel_tol, double T, double D, CO2_state *state)
+	{
+		const double P_tol = fmax(rel_tol, P*rel_tol);
+		const double y_tol = fmax(rel_tol, fabs(y)*rel_tol);
+
+		Element e;
+		find_element(T, D, &e);
+		double f, dfdD, dfdD2, dfdT, dfdDdT, dfdT2;
+		int iter;
+		for( iter = 0; iter < N_SOLVE_MAX_ITER; iter++ )
+		{
+			double x = (D - e.x_low) * e.inv_dx;
+			double t = (T - e.y_low) * e.inv_dy;
+			if( t < -0.01 || t > 1.01 || x < -0.01 || x > 1.01 )	// outside element
+			{
+				find_element(T, D, &e);
+				x = (D - e.x_low) * e.inv_dx;
+				t = (T - e.y_low) * e.inv_dy;
+			}
+			get_derivatives(x, t, D, &e, &f, &dfdD, &dfdD2, &dfdT, &dfdDdT, &dfdT2);
+
+			const double P_res = D*D*dfdD - P;
+			double y_res, J_21, J_22;
+			if( prop_pair == E_PH )
+			{
+				y_res = f - T*dfdT + D*dfdD - y;
+				J_21 = 2.0*dfdD - T*dfdDdT + D*dfdD2;	// dH_res / dD
+				J_22 = -T*dfdT2 + D*dfdDdT;				// dH_res / dT
+			}
+			else
+			{
+				y_res = -dfdT - y;
+				J_21 = -dfdDdT;		// dS_res / dD
+				J_22 = -dfdT2;		// dS_res / dT
+			}
+			if( fabs(P_res) < P_tol && fabs(y_res) < y_tol )
+				break;
+
+			const double J_11 = 2.0*D*dfdD + D*D*dfdD2;		// dP_res / dD
+			const double J_12 = D*D*dfdDdT;					// dP_res / dT
+			const double alpha = J_21 / J_11;
+			const double delta_T = (y_res - P_res*alpha) / (J_22 - J_12*alpha);
+			D -= (P_res - J_12*delta_T) / J_11;
+			T -= delta_T;
+		}
+
+		if( iter >= N_SOLVE_MAX_ITER || !(T >= T_lower_limit && T <= T_upper_limit) )
+			return false;
+
+		double D_vap = 0.0;
+		double D_liq = 0.0;
+		double Q = 999.0;
+		if( T < T_crit )
+		{
+			D_vap = CO2_sat_vap_dens(T);
+			D_liq = CO2_sat_liq_dens(T);
+			Q = (D_vap * (D_liq - D)) / (D * (D_liq - D_vap));
+			if( Q >= 0.0 && Q <= 1.0 )
+				return false;	// two-phase: the exact routines handle it
+		}
+		else if( P < P_crit )
+		{
+			Q = 998.0;
+		}
+		const double inte = f - T*dfdT;
+
+		// Same state as the exact routines calculate from the converged T and D
+		state->temp = T;
+		state->pres = D*D*dfdD;
+		state->dens = D;
+		state->qual = Q;
+		state->inte = inte;
+		state->enth = inte + D*dfdD;
+		state->entr = -dfdT;
+		state->cv = -T*dfdT2;
+		state->cp = T*(D*dfdDdT*dfdDdT / (2.0*dfdD + D*dfdD2) - dfdT2);
+		state->ssnd = sqrt(1000.0*D*D*(dfdD2 - dfdDdT*dfdDdT / dfdT2 + 2.0*dfdD / D));
+		state->sat_vap_dens = D_vap;
+		state->sat_liq_dens = D_liq;
+		return true;
+	}
+}
+
+bool C_co2_props_table::S_grid::interpolate(double u_P, double y, double & T, double & D) const
+{
+	double u_y = (y - m_y_min)*m_inv_dy;
+	if( !(u_P >= 1.0 && u_y >= 1.0) )	// also rejects NaN
+		return false;
+
+	int i_P = (int)u_P;
+	int i_y = (int)u_y;
+	int n_P = (int)(mv_T.size() / m_n_y);
+	if( i_P > n_P - 3 || i_y > m_n_y - 3 )
+		return false;
+
+	int i_cell = i_P*m_n_y + i_y;
+	if( !mv_is_cell[i_cell] )
+		return false;
+
+	double w_P[4], w_y[4];
+	catmull_rom_weights(u_P - i_P, w_P);
+	catmull_rom_weights(u_y - i_y, w_y);
+
+	T = D = 0.0;
+	for( int a = 0; a < 4; a++ )
+	{
+		int i_row = i_cell + (a - 1)*m_n_y - 1;
+		double T_row = 0.0, D_row = 0.0;
+		for( int b = 0; b < 4; b++ )
+		{
+			T_row += w_y[b] * mv_T[i_row + b];
+			D_row += w_y[b] * mv_D[i_row + b];
+		}
+		T += w_P[a] * T_row;
+		D += w_P[a] * D_row;
+	}
+
+	return true;
+}
+
+C_co2_props_table::C_co2_props_table()
+{
+	m_inv_dP = std::numeric_limits<double>::quiet_NaN();
+	m_is_built = false;
+}
+
+void C_co2_props_table::build_grid(int prop_pair, double y_min, double y_max, S_grid & grid)
+{
+	int n_P = ms_par.m_n_P;
+	int n_y = ms_par.m_n_y;
+	double dP = (ms_par.m_P_max - ms_par.m_P_min) / (n_P - 1);
+	double dy = (y_max - y_min) / (n_y - 1);
+
+	grid.m_y_min = y_min;
+	grid.m_inv_dy = 1.0 / dy;
+	grid.m_n_y = n_y;
+	grid.mv_T.assign(n_P*n_y, 0.0);
+	grid.mv_D.assign(n_P*n_y, 0.0);
+	grid.mv_is_cell.assign(n_P*n_y, false);
+
+	std::vector<char> phase(n_P*n_y, E_NODE_INVALID);
+	CO2_state co2_props;
+	for( int i = 0; i < n_P; i++ )
+	{
+		for( int j = 0; j < n_y; j++ )
+		{
+			int k = i*n_y + j;
+			if( call_exact(prop_pair, ms_par.m_P_min + i*dP, y_min + j*dy, &co2_props) != 0 )
+				continue;
+
+			grid.mv_T[k] = co2_props.temp;
+			grid.mv_D[k] = co2_props.dens;
+			if( co2_props.qual < 0.0 )
+				phase[k] = E_NODE_LIQUID;
+			else if( co2_props.qual > 1.0 && co2_props.qual < 998.0 )
+				phase[k] = E_NODE_VAPOR;
+			else if( co2_props.qual >= 998.0 )
+				phase[k] = E_NODE_SUPERCRIT;
+		}
+	}
+
+	// A cell is tabulated if its whole 4x4 stencil is single-phase and on one side of the saturation line
+	for( int i = 1; i < n_P - 2; i++ )
+	{
+		for( int j = 1; j < n_y - 2; j++ )
+		{
+			bool is_ok = true, is_liquid = false, is_vapor = false;
+			for( int a = i - 1; a <= i + 2 && is_ok; a++ )
+			{
+				for( int b = j - 1; b <= j + 2; b++ )
+				{
+					char node = phase[a*n_y + b];
+					is_ok = is_ok && node != E_NODE_INVALID;
+					is_liquid = is_liquid || node == E_NODE_LIQUID;
+					is_vapor = is_vapor || node == E_NODE_VAPOR;
+				}
+			}
+			grid.mv_is_cell[i*n_y + j] = is_ok && !(is_liquid && is_vapor);
+		}
+	}
+}
+
+void C_co2_props_table::build(const S_table_par & par)
+{
+	ms_par = par;
+	ms_par.m_n_P = std::max(ms_par.m_n_P, 4);
+	ms_par.m_n_y = std::max(ms_par.m_n_y, 4);
+	m_inv_dP = (ms_par.m_n_P - 1) / (ms_par.m_P_max - ms_par.m_P_min);
+
+	// Enthalpy and entropy ranges span the temperature range at every tabulated pressure
+	double H_min = std::numeric_limits<double>::max(), H_max = -H_min;
+	double S_min = H_min, S_max = H_max;
+	CO2_state co2_props;
+	for( int i = 0; i < ms_par.m_n_P; i++ )
+	{
+		double P = ms_par.m_P_min + i / m_inv_dP;
+		if( CO2_TP(ms_par.m_T_min, P, &co2_props) == 0 )
+		{
+			H_min = std::min(H_min, co2_props.enth);
+			S_min = std::min(S_min, co2_props.entr);
+		}
+		if( CO2_TP(ms_par.m_T_max, P, &co2_props) == 0 )
+		{
+			H_max = std::max(H_max, co2_props.enth);
+			S_max = std::max(S_max, co2_props.entr);
+		}
+	}
+	build_grid(E_PH, H_min, H_max, ms_ph);
+	build_grid(E_PS, S_min, S_max, ms_ps);
+
+	m_is_built = true;
+}
+
+int C_co2_props_table::PH(double P, double H, CO2_state *state, double rel_tol) const
+{
+	double T, D;
+	if( m_is_built && ms_ph.interpolate((P - ms_par.m_P_min)*m_inv_dP, H, T, D)
+		&& solve(E_PH, P, H, rel_tol, T, D, state) )
+	{
+		return 0;
+	}
+	return CO2_PH(P, H, state);
+}
+
+int C_co2_props_table::PS(double P, double S, CO2_state *state, double rel_tol) const
+{
+	double T, D;
+	if( m_is_built && ms_ps.interpolate((P - ms_par.m_P_min)*m_inv_dP, S, T, D)
+		&& solve(E_PS, P, S, rel_tol, T, D, state) )
+	{
+		return 0;
+	}
+	return CO2_PS(P, S, state);
+}
+
+const C_co2_props_table & C_co2_props_table::instance()
+{
+	if( !g_is_co2_props_table_built.load() )
+	{
+		std::lock_guard<std::mutex> lock(g_co2_props_table_mutex);
+		if( !g_is_co2_props_table_built.load() )
+		{
+			g_co2_props_table.build(S_table_par());
+			g_is_co2_props_table_built.store(true);
+		}
+	}
+	return g_co2_props_table;
+}
+
+void CO2_props_table_set_tol(double rel_tol /*-*/)
+{
+	g_co2_props_table_tol = std::max(rel_tol, 0.0);
+}
+
+double CO2_props_table_get_tol()
+{
+	return g_co2_props_table_tol;
+}
+
+C_co2_props_table_tol_scope::C_co2_props_table_tol_scope(double rel_tol /*-*/)
+{
+	m_rel_tol_prev = CO2_props_table_get_tol();
+	CO2_props_table_set_tol(rel_tol);
+}
+
+C_co2_props_table_tol_scope::~C_co2_props_table_tol_scope()
+{
+	CO2_props_table_set_tol(m_rel_tol_prev);
+}
+
+int CO2_PH_tab(double P, double H, CO2_state *state)
+{
+	double rel_tol = g_co2_props_table_tol;
+	if( rel_tol <= 0.0 )
+		return CO2_PH(P, H, state);
+	return C_co2_props_table::instance().PH(P, H, state, rel_tol);
+}
+
+int CO2_PS_tab(double P, double S, CO2_state *state)
+{
+	double rel_tol = g_co2_props_table_tol;
+	if( rel_tol <= 0.0 )
+		return CO2_PS(P, S, state);
+	return C_co2_props_table::instance().PS(P, S, state, rel_tol);
+}
@@ -0,0 +1,158 @@
+/*******************************************************************************************************
+*  Copyright 2017 Alliance for Sustainable Energy, LLC
+*
+*  NOTICE: This software was developed at least in part by Alliance for Sustainable Energy, LLC
+*  (Alliance) under Contract No. DE-AC36-08GO28308 with the U.S. Department of Energy and the U.S.
+*  The Government retains for itself and others acting on its behalf a nonexclusive, paid-up,
+*  irrevocable worldwide license in the software to reproduce, prepare derivative works, distribute
+*  copies to the public, perform publicly and display publicly, and to permit others to do so.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted
+*  provided that the following conditions are met:
+*
+*  1. Redistributions of source code must retain the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer.
+*
+*  2. Redistributions in binary form must reproduce the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer in the documentation and/or
+*  other materials provided with the distribution.
+*
+*  3. The entire corresponding source code of any redistribution, with or without modification, by a
+*  research entity, including but not limited to any contracting manager/operator of a United States
+*  National Laboratory, any institution of higher learning, and any non-profit organization, must be
+*  made publicly available under this license for as long as the redistribution is made available by
+*  the research entity.
+*
+*  4. Redistribution of this software, without modification, must refer to the software by the same
+*  designation. Redistribution of a modified version of this software (i) may not refer to the modified
+*  version by the same designation, or by any confusingly similar designation, and (ii) must refer to
+*  the underlying software originally provided by Alliance as System Advisor Model or SAM. Except
+*  to comply with the foregoing, the terms System Advisor Model, SAM, or any confusingly similar
+*  designation may not be used to refer to any modified version of this software or any modified
+*  version of the underlying software originally provided by Alliance without the prior written consent
+*  of Alliance.
+*
+*  5. The name of the copyright holder, contributors, the United States Government, the United States
+*  Department of Energy, or any of their employees may not be used to endorse or promote products
+*  derived from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+*  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER,
+*  CONTRIBUTORS, UNITED STATES GOVERNMENT OR UNITED STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR
+*  EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+*  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+*  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+*  THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************************************/
+
+#ifndef __CO2_PROPS_TABLE_
+#define __CO2_PROPS_TABLE_
+
+#include <vector>
+
+#include "CO2_properties.h"
+
+/*
+	Tabulated fast path for CO2_PH and CO2_PS.
+
+	Temperature and density are stored on uniform grids over (P,H) and (P,S), computed once
+	with the exact property routines.  A lookup interpolates T and D with a bicubic (Catmull-Rom)
+	stencil and refines them with a few Newton steps on the Helmholtz fit until the specified properties
+	are within the relative tolerance.  The saturation checks and initial guess fits of the exact
+	routines are skipped, and every returned state is evaluated at a single (T,D), so it is
+	thermodynamically consistent.  Grid cells whose stencil touches an invalid or two-phase node, or
+	mixes liquid and vapor nodes, are not tabulated.  Lookups in those cells, out of range lookups, and
+	lookups that do not converge or land in the two-phase region fall back to the exact routines.
+*/
+
+class C_co2_props_table
+{
+public:
+	struct S_table_par
+	{
+		double m_P_min;		//[kPa] Pressure range of both tables
+		double m_P_max;		//[kPa]
+		double m_T_min;		//[K] Temperature range, sets the enthalpy and entropy ranges
+		double m_T_max;		//[K]
+		int m_n_P;			//[-] Number of pressure nodes
+		int m_n_y;			//[-] Number of enthalpy or entropy nodes
+
+		S_table_par()
+		{
+			// Covers sCO2 cycle design and off-design conditions
+			m_P_min = 1000.0;
+			m_P_max = 35000.0;
+			m_T_min = 280.0;
+			m_T_max = 1100.0;
+			m_n_P = 120;
+			m_n_y = 200;
+		}
+	};
+
+private:
+	struct S_grid
+	{
+		double m_y_min;		// Enthalpy or entropy of the first node
+		double m_inv_dy;
+		int m_n_y;
+		std::vector<double> mv_T;	//[K] Node values, index i_P*m_n_y + i_y
+		std::vector<double> mv_D;	//[kg/m3]
+		std::vector<char> mv_is_cell;	// true if the cell with lower-left node i_P*m_n_y + i_y can be interpolated
+
+		// Bicubic estimate of T and D; false if (P,y) is not in a tabulated cell
+		bool interpolate(double u_P, double y, double & T, double & D) const;
+	};
+
+	S_table_par ms_par;
+	double m_inv_dP;
+	bool m_is_built;
+
+	S_grid ms_ph;
+	S_grid ms_ps;
+
+	void build_grid(int prop_pair, double y_min, double y_max, S_grid & grid);
+
+public:
+	C_co2_props_table();
+
+	void build(const S_table_par & par);
+
+	bool is_built() const
+	{
+		return m_is_built;
+	}
+
+	// Same arguments and return codes as CO2_PH and CO2_PS.  'rel_tol' applies to the specified properties
+	int PH(double P, double H, CO2_state *state, double rel_tol) const;
+	int PS(double P, double S, CO2_state *state, double rel_tol) const;
+
+	// Process-wide table with the default S_table_par, built on first use
+	static const C_co2_props_table & instance();
+};
+
+// Relative accuracy target for CO2_PH_tab and CO2_PS_tab.  0 (default) disables the tables and
+// these functions call the exact property routines.  The setting applies to the calling thread only
+void CO2_props_table_set_tol(double rel_tol /*-*/);
+double CO2_props_table_get_tol();
+
+// Sets the calling thread's accuracy target for the lifetime of the object and restores the previous
+// value on destruction, so a compute module's setting doesn't carry over to later runs on the thread
+class C_co2_props_table_tol_scope
+{
+	double m_rel_tol_prev;
+
+	C_co2_props_table_tol_scope(const C_co2_props_table_tol_scope &);
+	C_co2_props_table_tol_scope & operator=(const C_co2_props_table_tol_scope &);
+
+public:
+	explicit C_co2_props_table_tol_scope(double rel_tol /*-*/);
+	~C_co2_props_table_tol_scope();
+};
+
+// Drop-in replacements for CO2_PH and CO2_PS that use the process-wide tables when enabled on this thread
+int CO2_PH_tab(double P, double H, CO2_state *state);
+int CO2_PS_tab(double P, double S, CO2_state *state);
+
+#endif
@@ -118,6 +118,8 @@ csp_dispatch_opt::csp_dispatch_opt()
     price_signal.clear();
     clear_output_arrays();
     m_is_weather_setup = false;
+    m_lp = NULL;
+    m_lp_nstep = 0;
 
     //parameters
     params.is_pb_operating0 = false;
@@ -159,6 +161,16 @@ csp_dispatch_opt::csp_dispatch_opt()
     outputs.solve_time = 0.;
     outputs.presolve_nvar = 0;
 
+    forecast_outputs.step_start = 0;
+    forecast_outputs.divs_per_int = 0;
+    forecast_outputs.sf_effadj = numeric_limits<double>::quiet_NaN();
+
+}
+
+csp_dispatch_opt::~csp_dispatch_opt()
+{
+    if( m_lp != NULL )
+        delete_lp(m_lp);
 }
 
 void csp_dispatch_opt::clear_output_arrays()
@@ -219,6 +231,47 @@ bool csp_dispatch_opt::predict_performance(int step_start, int ntimeints, int di
     if(! check_setup(m_nstep_opt) )
         throw C_csp_exception("Dispatch optimization precheck failed.");
 
+    //copy the horizon from the precomputed forecast if it covers it
+    int i0 = forecast_index(step_start, m_nstep_opt, divs_per_int);
+    if( i0 >= 0 )
+    {
+        const s_forecast_outputs &F = forecast_outputs;
+        int i1 = i0 + m_nstep_opt;
+
+        outputs.eta_sf_expected.assign( F.eta_sf_expected.begin() + i0, F.eta_sf_expected.begin() + i1 );
+        outputs.q_sfavail_expected.assign( F.q_sfavail_expected.begin() + i0, F.q_sfavail_expected.begin() + i1 );
+        outputs.eta_pb_expected.assign( F.eta_pb_expected.begin() + i0, F.eta_pb_expected.begin() + i1 );
+        outputs.f_pb_op_limit.assign( F.f_pb_op_limit.begin() + i0, F.f_pb_op_limit.begin() + i1 );
+        outputs.w_condf_expected.assign( F.w_condf_expected.begin() + i0, F.w_condf_expected.begin() + i1 );
+
+        /* 
+        The heliostat field keeps the outputs of its last optical efficiency call, and the solver reports them 
+        for time steps in which the field is off. Repeat the last call of the horizon so the field is left as 
+        the step by step forecast leaves it.
+        */
+        C_csp_solver_sim_info simloc;
+        simloc.ms_ts.m_step = params.siminfo->ms_ts.m_step;
+
+        if(! m_weather.read_time_step( step_start + m_nstep_opt*divs_per_int - 1, simloc ) )
+            return false;
+        params.col_rec->calculate_optical_efficiency(m_weather.ms_outputs, simloc);
+        m_weather.converged();
+
+        return true;
+    }
+
+    return forecast_performance(step_start, m_nstep_opt, divs_per_int, outputs.eta_sf_expected, outputs.q_sfavail_expected, 
+        outputs.eta_pb_expected, outputs.f_pb_op_limit, outputs.w_condf_expected);
+}
+
+bool csp_dispatch_opt::forecast_performance(int step_start, int ntimeints, int divs_per_int, vector<double> &eta_sf_expected, 
+    vector<double> &q_sfavail_expected, vector<double> &eta_pb_expected, vector<double> &f_pb_op_limit, vector<double> &w_condf_expected)
+{
+    /* 
+    Walk the weather file from weather time step 'step_start' and append the expected performance for 
+    ntimeints dispatch time steps of divs_per_int weather time steps each. 
+    */
+
     //create the sim info
     C_csp_solver_sim_info simloc;    // = *params.siminfo;
 	simloc.ms_ts.m_step = params.siminfo->ms_ts.m_step;
@@ -228,7 +281,7 @@ bool csp_dispatch_opt::predict_performance(int step_start, int ntimeints, int di
 
     double ave_weight = 1./(double)divs_per_int;
 
-    for(int i=0; i<m_nstep_opt; i++)
+    for(int i=0; i<ntimeints; i++)
     {
         //initialize hourly average values
         double therm_eff_ave = 0.;
@@ -282,15 +335,15 @@ bool csp_dispatch_opt::predict_performance(int step_start, int ntimeints, int di
 
         //-----report hourly averages
         //thermal efficiency
-        outputs.eta_sf_expected.push_back(therm_eff_ave);
+        eta_sf_expected.push_back(therm_eff_ave);
         //predicted field energy output
-        outputs.q_sfavail_expected.push_back( q_inc_ave );
+        q_sfavail_expected.push_back( q_inc_ave );
         //power cycle efficiency
-        outputs.eta_pb_expected.push_back( cycle_eff_ave );
+        eta_pb_expected.push_back( cycle_eff_ave );
 		// Maximum power cycle output (normalized)
-		outputs.f_pb_op_limit.push_back(f_pb_op_lim_ave);		//[-]
+		f_pb_op_limit.push_back(f_pb_op_lim_ave);		//[-]
         //condenser power
-        outputs.w_condf_expected.push_back( wcond_ave );
+        w_condf_expected.push_back( wcond_ave );
     }
 
     //reset the weather data reader
@@ -299,6 +352,54 @@ bool csp_dispatch_opt::predict_performance(int step_start, int ntimeints, int di
     return true;
 }
 
+int csp_dispatch_opt::forecast_index(int step_start, int ntimeints, int divs_per_int)
+{
+    //index of the precomputed forecast entry for weather time step 'step_start', or -1 if the forecast does not cover the horizon
+    const s_forecast_outputs &F = forecast_outputs;
+
+    if( F.divs_per_int != divs_per_int || F.sf_effadj != params.sf_effadj )
+        return -1;
+    if( step_start < F.step_start || (step_start - F.step_start) % divs_per_int != 0 )
+        return -1;
+
+    int i0 = (step_start - F.step_start) / divs_per_int;
+    if( i0 + ntimeints > (int)F.q_sfavail_expected.size() )
+        return -1;
+
+    return i0;
+}
+
+bool csp_dispatch_opt::precompute_forecast(int step_start, int ntimeints, int divs_per_int)
+{
+    /* 
+    Calculate the same values as predict_performance() for ntimeints dispatch time steps starting at weather 
+    time step 'step_start' (0-based). The same serial calculation is used so that the copied horizons match 
+    the step by step forecast exactly.
+    */
+
+    s_forecast_outputs &F = forecast_outputs;
+    F.divs_per_int = 0;     //invalid until complete
+
+    if( !m_is_weather_setup || params.siminfo == 0 || ntimeints < 1 || divs_per_int < 1 )
+        return false;
+
+    F.eta_sf_expected.clear();
+    F.q_sfavail_expected.clear();
+    F.eta_pb_expected.clear();
+    F.f_pb_op_limit.clear();
+    F.w_condf_expected.clear();
+
+    if(! forecast_performance(step_start, ntimeints, divs_per_int, F.eta_sf_expected, F.q_sfavail_expected, 
+        F.eta_pb_expected, F.f_pb_op_limit, F.w_condf_expected) )
+        return false;
+
+    F.step_start = step_start;
+    F.sf_effadj = params.sf_effadj;
+    F.divs_per_int = divs_per_int;
+
+    return true;
+}
+
 static void calculate_parameters(csp_dispatch_opt *optinst, unordered_map<std::string, double> &pars, int nt)
 {
     /* 
@@ -424,876 +525,956 @@ static void calculate_parameters(csp_dispatch_opt *optinst, unordered_map<std::s
         pars["pen_delta_w"] = optinst->params.pen_delta_w; //0.1;
 };
 
-bool csp_dispatch_opt::optimize()
+void csp_dispatch_opt::build_problem(optimization_vars &O, unordered_map<std::string, double> &P)
 {
-
-    //First check to see whether we should call the AMPL engine instead. 
-    if( solver_params.is_ampl_engine )
-    {
-        return optimize_ampl();
-    }
-
     /* 
-    Formulate the optimization problem for dispatch generation. We are trying to maximize revenue subject to inventory
-    constraints.
-    
-    
-    Variables
-    -------------------------------------------------------------
-    Continuous
-    -------------------------------------------------------------
-    xr          kWt     Power delivered by the receiver at time t
-    xrsu        kWt     Power used by the reciever for start up
-    ursu        kWt     Receiver accumulated start-up thermal power at time t
-    x           kWt	    Cycle thermal power consumption at time t 
-    ucsu        kWt     Cycle accumulated start-up thermal power at time t
-    s           kWht    TES reserve quantity at time t (auxiliary variable) 
-    wdot        kWe     Electrical power production at time t
-    delta_w     kWe     Positive change in power production at time t w/r/t t-1
-    -------------------------------------------------------------
-    Binary
-    -------------------------------------------------------------
-    yr              1 if receiver is generating ``usable'' thermal power at time t; 0 otherwise 
-    yrsu            1 if receiver is starting up at time t; 0 otherwise 
-    yrsb            1 if receiver is in standby at time t; 0 otherwise
-    yrsup           1 if reciever startup penalty is enforced at time t; 0 otherwise
-    yrhsp           1 if receiver hot startup penalty is enforced at time t; 0 otherwise
-    y               1 if cycle is generating electric power at time t; 0 otherwise
-    ycsu            1 if cycle is starting up at time t; 0 otherwise
-    ycsb            1 if cycle is in standby mode at time t; 0 otherwise
-    ycsup           1 if cycle startup penalty is enforced at time t; 0 otherwise
-    ychsp           1 if cycle hot startup penalty is enforced at time t; 0 otherwise
-    -------------------------------------------------------------
+    Build the variables and constraints of the dispatch problem for the current horizon length. Entries that depend 
+    on the forecast, price signal or plant state are placeholders here and are set by update_problem.
     */
-    lprec *lp;
-    int ret = 0;
-
-
-    try{
-
-        //Calculate the number of variables
-        int nt = (int)m_nstep_opt;
+    int nt = (int)m_nstep_opt;
 
-        //set up the variable structure
-        optimization_vars O;
-        O.add_var("xr", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
-        O.add_var("xrsu", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
-        O.add_var("ursu", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
-        O.add_var("yr", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-        O.add_var("yrsu", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-        //O.add_var("yrsb", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-        //O.add_var("yrsd", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-        O.add_var("yrsup", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-        //O.add_var("yrhsp", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+    if( m_lp != NULL )
+        delete_lp(m_lp);
+    m_lp = NULL;
 
-        O.add_var("x", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0.);
-        O.add_var("y", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-        O.add_var("s", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
-        O.add_var("ucsu", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
-        O.add_var("ycsu", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-        O.add_var("ycsb", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-#ifdef MOD_CYCLE_SHUTDOWN
-        O.add_var("ycsd", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-#endif
-        O.add_var("ycsup", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-        O.add_var("ychsp", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
-        O.add_var("wdot", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. ); //0 lower bound?
-        O.add_var("delta_w", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. ); 
-        
-        unordered_map<std::string, double> P;
-        calculate_parameters(this, P, nt);
+    lprec *lp = make_lp(0, O.get_total_var_count());  //build the context
 
-        O.construct();  //allocates memory for data array
+    if(lp == NULL)
+        throw C_csp_exception("Failed to create a new CSP dispatch optimization problem context.");
 
-        int nvar = O.get_total_var_count(); //total number of variables in the problem
+    m_lp_rows.power_curve.assign(nt, 0);
+    m_lp_rows.rec_su_solar.assign(nt, 0);
+    m_lp_rows.rec_limit.assign(nt, 0);
+    m_lp_rows.rec_mode.assign(nt, 0);
+    m_lp_rows.rec_solar.assign(nt, 0);
+    m_lp_rows.tes_su.assign(nt, 0);
+    m_lp_rows.wdot_max.assign(nt, 0);
+    m_lp_rows.wnet_max.assign(nt, 0);
 
-        lp = make_lp(0, nvar);  //build the context
+    //set variable names and types for each column
+    for(int i=0; i<O.get_num_varobjs(); i++)
+    {
+        optimization_vars::opt_var *v = O.get_var(i);
 
-        if(lp == NULL)
-            throw C_csp_exception("Failed to create a new CSP dispatch optimization problem context.");
+        string name_base = v->name;
 
-        //set variable names and types for each column
-        for(int i=0; i<O.get_num_varobjs(); i++)
+        if( v->var_dim == optimization_vars::VAR_DIM::DIM_T )
         {
-            optimization_vars::opt_var *v = O.get_var(i);
-
-            string name_base = v->name;
-
-            if( v->var_dim == optimization_vars::VAR_DIM::DIM_T )
+            for(int t=0; t<nt; t++)
             {
-                for(int t=0; t<nt; t++)
-                {
-                    char s[40];
-                    sprintf(s, "%s-%d", name_base.c_str(), t);
-                    set_col_name(lp, O.column(i, t), s);
-                    
-                }
+                char s[40];
+                sprintf(s, "%s-%d", name_base.c_str(), t);
+                set_col_name(lp, O.column(i, t), s);
+                
             }
-            else if( v->var_dim == optimization_vars::VAR_DIM::DIM_NT ) 
+        }
+        else if( v->var_dim == optimization_vars::VAR_DIM::DIM_NT ) 
+        {
+            for(int t1=0; t1<v->var_dim_size; t1++)
             {
-                for(int t1=0; t1<v->var_dim_size; t1++)
+                for(int t2=0; t2<v->var_dim_size2; t2++)
                 {
-                    for(int t2=0; t2<v->var_dim_size2; t2++)
-                    {
-                        char s[40];
-                        sprintf(s, "%s-%d-%d", name_base.c_str(), t1, t2);
-                        set_col_name(lp, O.column(i, t1,t2 ), s);
-                    }
+                    char s[40];
+                    sprintf(s, "%s-%d-%d", name_base.c_str(), t1, t2);
+                    set_col_name(lp, O.column(i, t1,t2 ), s);
                 }
             }
-            else
+        }
+        else
+        {
+            for(int t1=0; t1<nt; t1++)
             {
-                for(int t1=0; t1<nt; t1++)
+                for(int t2=t1; t2<nt; t2++)
                 {
-                    for(int t2=t1; t2<nt; t2++)
-                    {
-                        char s[40];
-                        sprintf(s, "%s-%d-%d", name_base.c_str(), t1, t2);
-                        set_col_name(lp, O.column(i, t1, t2 ), s);
-                    }
+                    char s[40];
+                    sprintf(s, "%s-%d-%d", name_base.c_str(), t1, t2);
+                    set_col_name(lp, O.column(i, t1, t2 ), s);
                 }
             }
         }
+    }
 
-        /* 
-        --------------------------------------------------------------------------------
-        set up the objective function first (per lpsolve guidance)
-        --------------------------------------------------------------------------------
-        */
-		{
-            int *col = new int[12 * nt];
-            REAL *row = new REAL[12 * nt];
-            double tadj = P["disp_time_weighting"];
-            int i = 0;
-
-            //calculate the mean price to appropriately weight the receiver production timing derate
-            double pmean =0;
-            for(int t=0; t<(int)price_signal.size(); t++)
-                pmean += price_signal.at(t);
-            pmean /= (double)price_signal.size();
-            //--
-            
-            for(int t=0; t<nt; t++)
-            {
-                i = 0;
-                col[ t + nt*(i  ) ] = O.column("wdot", t);
-                row[ t + nt*(i++) ] = P["delta"] * price_signal.at(t)*tadj*(1.-outputs.w_condf_expected.at(t));
+    //set the row mode
+    set_add_rowmode(lp, TRUE);
+
+    /* 
+    --------------------------------------------------------------------------------
+    set up the variable properties
+    --------------------------------------------------------------------------------
+    */
+    for(int i=0; i<O.get_num_varobjs(); i++)
+    {
+        optimization_vars::opt_var *v = O.get_var(i);
+        if( v->var_type == optimization_vars::VAR_TYPE::BINARY_T )
+        {
+            for(int i=v->ind_start; i<v->ind_end; i++)
+                set_binary(lp, i+1, TRUE);
+        }
+        //upper and lower variable bounds
+        for(int i=v->ind_start; i<v->ind_end; i++)
+        {
+            set_upbo(lp, i+1, v->upper_bound);
+            set_lowbo(lp, i+1, v->lower_bound);
+        }
+    }
 
-                col[ t + nt*(i  ) ] = O.column("xr", t);
-                row[ t + nt*(i++) ] = -(P["delta"] * price_signal.at(t) * P["Lr"])+tadj*pmean;  // tadj added to prefer receiver production sooner (i.e. delay dumping)
 
-                col[ t + nt*(i  ) ] = O.column("xrsu", t);
-                row[ t + nt*(i++) ] = -P["delta"] * price_signal.at(t) * P["Lr"];
+    /* 
+    --------------------------------------------------------------------------------
+    set up the constraints
+    --------------------------------------------------------------------------------
+    */
+    //cycle production change
+    {
+        REAL row[3];
+        int col[3];
+        
+        for(int t=0; t<nt; t++)
+        {
+            col[0] = O.column("delta_w", t);
+            row[0] = 1.;
 
-                col[ t + nt*(i  ) ] = O.column("yrsu", t);
-                row[ t + nt*(i++) ] = -price_signal.at(t) * (params.w_rec_ht + params.w_stow);
+            col[1] = O.column("wdot", t);
+            row[1] = -1.;
 
-                col[ t + nt*(i  ) ] = O.column("yr", t);
-                row[ t + nt*(i++) ] = -(P["delta"] * price_signal.at(t) * params.w_track) + tadj;	// tadj added to prefer receiver operation in nearer term to longer term
+            if(t>0)
+            {
+                col[2] = O.column("wdot", t-1);
+                row[2] = 1.;
+                
+                add_constraintex(lp, 3, row, col, GE, 0.);
+            }
+            else
+            {
+                add_constraintex(lp, 2, row, col, GE, 0.);
+                m_lp_rows.wdot_change0 = get_Nrows(lp);
+            }
+        }
+    }
 
-                col[ t + nt*(i  ) ] = O.column("x", t);
-                row[ t + nt*(i++) ] = -P["delta"] * price_signal.at(t) * params.w_cycle_pump;
 
-                col[ t + nt*(i  ) ] = O.column("ycsb", t);
-                row[ t + nt*(i++) ] = -P["delta"] * price_signal.at(t) * params.w_cycle_standby;
+    
+    {
+        //Linearization of the implementation of the piecewise efficiency equation 
+        REAL row[3];
+        int col[3];
 
-                //xxcol[ t + nt*(i   ] = O.column("yrsb", t);
-                //xxrow[ t + nt*(i++) ] = -delta * price_signal.at(t) * (Lr * Qrl + (params.w_stow / delta));
+        for(int t=0; t<nt; t++)
+        {
+            int i=0;
+            //power production curve
+            row[i  ] = 1.;
+            col[i++] = O.column("wdot", t);
 
-                //xxcol[ t + nt*(i   ] = O.column("yrsd", t);
-                //xxrow[ t + nt*(i++) ] = -0.5 - (params.w_stow);
+            row[i  ] = -1.;     //efficiency coefficients are set by update_problem
+            col[i++] = O.column("x", t);
 
-                //xxcol[ t + nt*(i   ] = O.column("ycsd", t);
-                //xxrow[ t + nt*(i++) ] = -0.5;
+            row[i  ] = -1.;
+            col[i++] = O.column("y", t);
 
-                col[ t + nt*(i  ) ] = O.column("yrsup", t);
-                row[ t + nt*(i++) ] = -P["rsu_cost"]*tadj;
+            //row[i  ] = -outputs.eta_pb_expected.at(t);
+            //col[i++] = O.column("x", t);
 
-                //xxcol[ t + nt*(i   ] = O.column("yrhsp", t);
-                //xxrow[ t + nt*(i++) ] = -tadj;
+            add_constraintex(lp, i, row, col, EQ, 0.);
+            m_lp_rows.power_curve.at(t) = get_Nrows(lp);
+        }
+    }
 
-                col[ t + nt*(i  ) ] = O.column("ycsup", t);
-                row[ t + nt*(i++) ] = -P["csu_cost"]*tadj;
+    // ******************** Receiver constraints *******************
+    //{ //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+    //    REAL row[5];
+    //    int col[5];
 
-                col[ t + nt*(i  ) ] = O.column("ychsp", t);
-                row[ t + nt*(i++) ] = -P["csu_cost"]*tadj * 0.1;
+    //    for(int t=0; t<nt; t++)
+    //    {
+    //        int i=0; 
+    //        row[i  ] = qrecmaxobs*1.01;
+    //        col[i++] = O.column("yd", t);
 
-                col[ t + nt*(i  ) ] = O.column("delta_w", t);
-                row[ t + nt*(i++) ] = -P["pen_delta_w"]*tadj;
+    //        row[i  ] = 1.;
+    //        col[i++] = O.column("xr", t);
 
-                tadj *= P["disp_time_weighting"];
-            }
+    //        row[i  ] = 1.;
+    //        col[i++] = O.column("xrsu", t);
 
-            set_obj_fnex(lp, i*nt, row, col);
+    //        add_constraintex(lp, i, row, col, GE, outputs.q_sfavail_expected.at(t)*0.999 );
+    //    }
+    //} //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-            delete[] col;
-            delete[] row;
-        }
 
-        //set the row mode
-        set_add_rowmode(lp, TRUE);
+    {
+        REAL row[5];
+        int col[5];
 
-        /* 
-        --------------------------------------------------------------------------------
-        set up the variable properties
-        --------------------------------------------------------------------------------
-        */
-        for(int i=0; i<O.get_num_varobjs(); i++)
+        for(int t=0; t<nt; t++)
         {
-            optimization_vars::opt_var *v = O.get_var(i);
-            if( v->var_type == optimization_vars::VAR_TYPE::BINARY_T )
+
+            //Receiver startup inventory
+            row[0] = 1.;
+            col[0] = O.column("ursu", t);
+
+            row[1] = -P["delta"];
+            col[1] = O.column("xrsu", t);
+
+            if(t>0)
             {
-                for(int i=v->ind_start; i<v->ind_end; i++)
-                    set_binary(lp, i+1, TRUE);
+                row[2] = -1.;
+                col[2] = O.column("ursu", t-1);
+
+                add_constraintex(lp, 3, row, col, LE, 0);
             }
-            //upper and lower variable bounds
-            for(int i=v->ind_start; i<v->ind_end; i++)
+            else
             {
-                set_upbo(lp, i+1, v->upper_bound);
-                set_lowbo(lp, i+1, v->lower_bound);
+                add_constraintex(lp, 2, row, col, LE, 0.);
             }
-        }
 
+            //-----
 
-        /* 
-        --------------------------------------------------------------------------------
-        set up the constraints
-        --------------------------------------------------------------------------------
-        */
-        //cycle production change
-        {
-            REAL row[3];
-            int col[3];
-            
-            for(int t=0; t<nt; t++)
-            {
-                col[0] = O.column("delta_w", t);
-                row[0] = 1.;
-
-                col[1] = O.column("wdot", t);
-                row[1] = -1.;
+            //inventory nonzero
+            row[0] = 1.;
+            col[0] = O.column("ursu", t);
 
-                if(t>0)
-                {
-                    col[2] = O.column("wdot", t-1);
-                    row[2] = 1.;
-                    
-                    add_constraintex(lp, 3, row, col, GE, 0.);
-                }
-                else
-                {
-                    add_constraintex(lp, 2, row, col, GE, -P["Wdot0"]);
-                }
-            }
-        }
+            row[1] = -P["Er"];
+            col[1] = O.column("yrsu", t);
 
+            add_constraintex(lp, 2, row, col, LE, 0.);
 
-        
-        {
-            //Linearization of the implementation of the piecewise efficiency equation 
-            REAL row[3];
-            int col[3];
+            //Receiver operation allowed when:
+            row[0] = 1.;
+            col[0] = O.column("yr", t);
+            
+            row[1] = -1.0/P["Er"]; 
+            col[1] = O.column("ursu", t);
 
-            for(int t=0; t<nt; t++)
+            if(t>0)
             {
-                int i=0;
-                //power production curve
-                row[i  ] = 1.;
-                col[i++] = O.column("wdot", t);
+                row[2] = -1.;
+                col[2] = O.column("yr", t-1);
 
-                row[i  ] = -P["etap"]*outputs.eta_pb_expected.at(t)/params.eta_cycle_ref;
-                col[i++] = O.column("x", t);
-
-                row[i  ] = -(P["Wdotu"] - P["etap"]*P["Qu"])*outputs.eta_pb_expected.at(t)/params.eta_cycle_ref;
-                col[i++] = O.column("y", t);
+                add_constraintex(lp, 3, row, col, LE, 0.); 
+            }
+            else
+            {
+                add_constraintex(lp, 2, row, col, LE, 0.);
+                m_lp_rows.rec_allowed0 = get_Nrows(lp);
+            }
 
-                //row[i  ] = -outputs.eta_pb_expected.at(t);
-                //col[i++] = O.column("x", t);
+            //Receiver startup can't be enabled after a time step where the Receiver was operating
+            if(t>0)
+            {
+                row[0] = 1.;
+                col[0] = O.column("yrsu", t);
 
-                add_constraintex(lp, i, row, col, EQ, 0.);
+                row[1] = 1.;
+                col[1] = O.column("yr", t-1);
 
+                add_constraintex(lp, 2, row, col, LE, 1.);
             }
-        }
 
-        // ******************** Receiver constraints *******************
-        //{ //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-        //    REAL row[5];
-        //    int col[5];
+            //Receiver startup energy consumption
+            row[0] = 1.;
+            col[0] = O.column("xrsu", t);
 
-        //    for(int t=0; t<nt; t++)
-        //    {
-        //        int i=0; 
-        //        row[i  ] = qrecmaxobs*1.01;
-        //        col[i++] = O.column("yd", t);
+            row[1] = -P["Qru"];
+            col[1] = O.column("yrsu", t);
 
-        //        row[i  ] = 1.;
-        //        col[i++] = O.column("xr", t);
+            add_constraintex(lp, 2, row, col, LE, 0.);
 
-        //        row[i  ] = 1.;
-        //        col[i++] = O.column("xrsu", t);
+            //Receiver startup only during solar positive periods
+            row[0] = 1.;
+            col[0] = O.column("yrsu", t);
 
-        //        add_constraintex(lp, i, row, col, GE, outputs.q_sfavail_expected.at(t)*0.999 );
-        //    }
-        //} //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+            add_constraintex(lp, 1, row, col, LE, 0.);
+            m_lp_rows.rec_su_solar.at(t) = get_Nrows(lp);
 
+            //Receiver consumption limit
+            row[0] = 1.;
+            col[0] = O.column("xr", t);
 
-        {
-            REAL row[5];
-            int col[5];
+            row[1] = 1.;
+            col[1] = O.column("xrsu", t);
+            
+            add_constraintex(lp, 2, row, col, LE, 0.);
+            m_lp_rows.rec_limit.at(t) = get_Nrows(lp);
 
-            for(int t=0; t<nt; t++)
-            {
+            //Receiver operation mode requirement
+            row[0] = 1.;
+            col[0] = O.column("xr", t);
 
-                //Receiver startup inventory
-                row[0] = 1.;
-                col[0] = O.column("ursu", t);
+            row[1] = -1.;
+            col[1] = O.column("yr", t);
 
-                row[1] = -P["delta"];
-                col[1] = O.column("xrsu", t);
+            add_constraintex(lp, 2, row, col, LE, 0.);
+            m_lp_rows.rec_mode.at(t) = get_Nrows(lp);
 
-                if(t>0)
-                {
-                    row[2] = -1.;
-                    col[2] = O.column("ursu", t-1);
+            //Receiver minimum operation requirement
+            row[0] = 1.;
+            col[0] = O.column("xr", t);
 
-                    add_constraintex(lp, 3, row, col, LE, 0);
-                }
-                else
-                {
-                    add_constraintex(lp, 2, row, col, LE, 0.);
-                }
+            row[1] = -P["Qrl"];
+            col[1] = O.column("yr", t);
 
-                //-----
+            add_constraintex(lp, 2, row, col, GE, 0.);
 
-                //inventory nonzero
-                row[0] = 1.;
-                col[0] = O.column("ursu", t);
+            //Receiver can't continue operating when no energy is available
+            row[0] = 1.;
+            col[0] = O.column("yr", t);
 
-                row[1] = -P["Er"];
-                col[1] = O.column("yrsu", t);
+            add_constraintex(lp, 1, row, col, LE, 0.);  //if any measurable energy, y^r can be 1
+            m_lp_rows.rec_solar.at(t) = get_Nrows(lp);
 
-                add_constraintex(lp, 2, row, col, LE, 0.);
+            // --- new constraints ---
 
-                //Receiver operation allowed when:
-                row[0] = 1.;
-                col[0] = O.column("yr", t);
-                
-                row[1] = -1.0/P["Er"]; 
-                col[1] = O.column("ursu", t);
+            //receiver startup/standby persist
+            /*row[0] = 1.;
+            col[0] = O.column("yrsu", t);
 
-                if(t>0)
-                {
-                    row[2] = -1.;
-                    col[2] = O.column("yr", t-1);
+            row[1] = 1.;
+            col[1] = O.column("yrsb", t);
 
-                    add_constraintex(lp, 3, row, col, LE, 0.); 
-                }
-                else
-                {
-                    add_constraintex(lp, 2, row, col, LE, (params.is_rec_operating0 ? 1. : 0.) );
-                }
+            add_constraintex(lp, 2, row, col, LE, 1.);*/
 
-                //Receiver startup can't be enabled after a time step where the Receiver was operating
-                if(t>0)
-                {
-                    row[0] = 1.;
-                    col[0] = O.column("yrsu", t);
+            //recever standby partition
+            /*row[0] = 1.;
+            col[0] = O.column("yr", t);
 
-                    row[1] = 1.;
-                    col[1] = O.column("yr", t-1);
+            row[1] = 1.;
+            col[1] = O.column("yrsb", t);
 
-                    add_constraintex(lp, 2, row, col, LE, 1.);
-                }
+            add_constraintex(lp, 2, row, col, LE, 1.);*/
 
-                //Receiver startup energy consumption
-                row[0] = 1.;
-                col[0] = O.column("xrsu", t);
+            if( t > 0 )
+            {
+                //rsb_persist
+                /*row[0] = 1.;
+                col[0] = O.column("yrsb", t);
 
-                row[1] = -P["Qru"];
-                col[1] = O.column("yrsu", t);
+                row[1] = -1.;
+                col[1] = O.column("yr", t-1);
 
-                add_constraintex(lp, 2, row, col, LE, 0.);
+                row[2] = -1.;
+                col[2] = O.column("yrsb", t-1);
 
-                //Receiver startup only during solar positive periods
+                add_constraintex(lp, 3, row, col, LE, 0.);*/
+
+                //receiver startup penalty
                 row[0] = 1.;
-                col[0] = O.column("yrsu", t);
+                col[0] = O.column("yrsup", t);
 
-                add_constraintex(lp, 1, row, col, LE, min(P["M"]*outputs.q_sfavail_expected.at(t), 1.0) );
+                row[1] = -1.;
+                col[1] = O.column("yrsu", t);
 
-                //Receiver consumption limit
-                row[0] = 1.;
-                col[0] = O.column("xr", t);
+                row[2] = 1.;
+                col[2] = O.column("yrsu", t-1);
 
-                row[1] = 1.;
-                col[1] = O.column("xrsu", t);
-                
-                add_constraintex(lp, 2, row, col, LE, outputs.q_sfavail_expected.at(t));
+                add_constraintex(lp, 3, row, col, GE, 0.);
 
-                //Receiver operation mode requirement
-                row[0] = 1.;
-                col[0] = O.column("xr", t);
+                //receiver hot startup penalty
+                /*row[0] = 1.;
+                col[0] = O.column("yrhsp", t);
 
-                row[1] = -outputs.q_sfavail_expected.at(t);
+                row[1] = -1.;
                 col[1] = O.column("yr", t);
 
-                add_constraintex(lp, 2, row, col, LE, 0.);
+                row[2] = -1.;
+                col[2] = O.column("yrsb", t-1);
 
-                //Receiver minimum operation requirement
-                row[0] = 1.;
-                col[0] = O.column("xr", t);
+                add_constraintex(lp, 3, row, col, GE, -1);*/
 
-                row[1] = -P["Qrl"];
-                col[1] = O.column("yr", t);
+                //receiver shutdown energy
+                /*row[0] = 1.;
+                col[0] = O.column("yrsd", t-1);
 
-                add_constraintex(lp, 2, row, col, GE, 0.);
+                row[1] = -1.;
+                col[1] = O.column("yr", t-1);
 
-                //Receiver can't continue operating when no energy is available
-                row[0] = 1.;
-                col[0] = O.column("yr", t);
+                row[2] = 1.;
+                col[2] = O.column("yr", t);
 
-                add_constraintex(lp, 1, row, col, LE, min(P["M"]*outputs.q_sfavail_expected.at(t), 1.0) );  //if any measurable energy, y^r can be 1
+                row[3] = -1.;
+                col[3] = O.column("yrsb", t-1);
 
-                // --- new constraints ---
+                row[4] = 1.;
+                col[4] = O.column("yrsb", t);
 
-                //receiver startup/standby persist
-                /*row[0] = 1.;
-                col[0] = O.column("yrsu", t);
+                add_constraintex(lp, 5, row, col, GE, 0.);*/
 
-                row[1] = 1.;
-                col[1] = O.column("yrsb", t);
+            }
+        }
+    }
 
-                add_constraintex(lp, 2, row, col, LE, 1.);*/
+    
+    // ******************** Power cycle constraints *******************
+    {
+        REAL row[5];
+        int col[5];
 
-                //recever standby partition
-                /*row[0] = 1.;
-                col[0] = O.column("yr", t);
 
-                row[1] = 1.;
-                col[1] = O.column("yrsb", t);
+        for(int t=0; t<nt; t++)
+        {
 
-                add_constraintex(lp, 2, row, col, LE, 1.);*/
+            int i=0;
+            //Startup Inventory balance
+            row[i  ] = 1.;
+            col[i++] = O.column("ucsu", t);
+            
+            row[i  ] = -P["delta"] * P["Qc"];
+            col[i++] = O.column("ycsu", t);
 
-                if( t > 0 )
-                {
-                    //rsb_persist
-                    /*row[0] = 1.;
-                    col[0] = O.column("yrsb", t);
+            if(t>0)
+            {
+                row[i  ] = -1.;
+                col[i++] = O.column("ucsu", t-1);
+            }
 
-                    row[1] = -1.;
-                    col[1] = O.column("yr", t-1);
+            add_constraintex(lp, i, row, col, LE, 0.);
 
-                    row[2] = -1.;
-                    col[2] = O.column("yrsb", t-1);
+            //Inventory nonzero
+            row[0] = 1.;
+            col[0] = O.column("ucsu", t);
 
-                    add_constraintex(lp, 3, row, col, LE, 0.);*/
+            row[1] = -P["M"];
+            col[1] = O.column("ycsu", t);
 
-                    //receiver startup penalty
-                    row[0] = 1.;
-                    col[0] = O.column("yrsup", t);
+            add_constraintex(lp, 2, row, col, LE, 0.);
 
-                    row[1] = -1.;
-                    col[1] = O.column("yrsu", t);
+            //Cycle operation allowed when:
+            i=0;
+            row[i  ] = 1.;
+            col[i++] = O.column("y", t);
+            
+            row[i  ] = -1.0/P["Ec"]; 
+            col[i++] = O.column("ucsu", t);
 
-                    row[2] = 1.;
-                    col[2] = O.column("yrsu", t-1);
+            if(t>0)
+            {
+                row[i  ] = -1.;
+                col[i++] = O.column("y", t-1);
 
-                    add_constraintex(lp, 3, row, col, GE, 0.);
+                row[i  ] = -1.;
+                col[i++] = O.column("ycsb", t-1);
 
-                    //receiver hot startup penalty
-                    /*row[0] = 1.;
-                    col[0] = O.column("yrhsp", t);
+                add_constraintex(lp, i, row, col, LE, 0.); 
+            }
+            else
+            {
+                add_constraintex(lp, i, row, col, LE, 0.);
+                m_lp_rows.pb_allowed0 = get_Nrows(lp);
+            }
 
-                    row[1] = -1.;
-                    col[1] = O.column("yr", t);
+            //Cycle consumption limit
+            i=0;
+            row[i  ] = 1.;
+            col[i++] = O.column("x", t);
 
-                    row[2] = -1.;
-                    col[2] = O.column("yrsb", t-1);
+            //mjw 2016.12.2 --> This constraint seems to be problematic in identifying feasible solutions for subhourly runs. Needs attention.
+            row[i  ] = P["Qc"];
+            col[i++] = O.column("ycsu", t);
+            
+            row[i  ] = -P["Qu"];
+            col[i++] = O.column("y", t);
 
-                    add_constraintex(lp, 3, row, col, GE, -1);*/
+            add_constraintex(lp, i, row, col, LE, 0.);
 
-                    //receiver shutdown energy
-                    /*row[0] = 1.;
-                    col[0] = O.column("yrsd", t-1);
+            //cycle operation mode requirement
+            row[0] = 1.;
+            col[0] = O.column("x", t);
 
-                    row[1] = -1.;
-                    col[1] = O.column("yr", t-1);
+            row[1] = -P["Qu"];
+            col[1] = O.column("y", t);
 
-                    row[2] = 1.;
-                    col[2] = O.column("yr", t);
+            add_constraintex(lp, 2, row, col, LE, 0.);
 
-                    row[3] = -1.;
-                    col[3] = O.column("yrsb", t-1);
+            //Minimum cycle energy contribution
+            i=0;
+            row[i  ] = 1.;
+            col[i++] = O.column("x", t);
 
-                    row[4] = 1.;
-                    col[4] = O.column("yrsb", t);
+            row[i  ] = -P["Ql"];
+            col[i++] = O.column("y", t);
 
-                    add_constraintex(lp, 5, row, col, GE, 0.);*/
+            add_constraintex(lp, i, row, col, GE, 0);
 
-                }
+            //cycle startup can't be enabled after a time step where the cycle was operating
+            if(t>0)
+            {
+                row[0] = 1.;
+                col[0] = O.column("ycsu", t);
+
+                row[1] = 1.;
+                col[1] = O.column("y", t-1);
+
+                add_constraintex(lp, 2, row, col, LE, 1.);
             }
-        }
 
-        
-        // ******************** Power cycle constraints *******************
-        {
-            REAL row[5];
-            int col[5];
 
+            //Standby mode entry
+            i=0;
+            row[i  ] = 1.;
+            col[i++] = O.column("ycsb", t);
 
-            for(int t=0; t<nt; t++)
+            if(t>0)
             {
+                row[i  ] = -1.;
+                col[i++] = O.column("y", t-1);
 
-                int i=0;
-                //Startup Inventory balance
-                row[i  ] = 1.;
-                col[i++] = O.column("ucsu", t);
-                
-                row[i  ] = -P["delta"] * P["Qc"];
-                col[i++] = O.column("ycsu", t);
-
-                if(t>0)
-                {
-                    row[i  ] = -1.;
-                    col[i++] = O.column("ucsu", t-1);
-                }
+                row[i  ] = -1.;
+                col[i++] = O.column("ycsb", t-1);
 
+                add_constraintex(lp, i, row, col, LE, 0);
+            }
+            else
+            {
                 add_constraintex(lp, i, row, col, LE, 0.);
+                m_lp_rows.pb_standby0 = get_Nrows(lp);
+            }
+
+            //some modes can't coincide
+            row[0] = 1.;
+            col[0] = O.column("ycsu", t);
+            row[1] = 1.;
+            col[1] = O.column("ycsb", t);    
+
+            add_constraintex(lp, 2, row, col, LE, 1);   
 
-                //Inventory nonzero
+            row[0] = 1.;
+            col[0] = O.column("y", t);
+            row[1] = 1.;
+            col[1] = O.column("ycsb", t);    
+
+            add_constraintex(lp, 2, row, col, LE, 1);   
+
+            if( t > 0 )
+            {
+                //cycle start penalty
                 row[0] = 1.;
-                col[0] = O.column("ucsu", t);
+                col[0] = O.column("ycsup", t);
 
-                row[1] = -P["M"];
+                row[1] = -1.;
                 col[1] = O.column("ycsu", t);
 
-                add_constraintex(lp, 2, row, col, LE, 0.);
+                row[2] = 1.;
+                col[2] = O.column("ycsu", t-1);
 
-                //Cycle operation allowed when:
-                i=0;
-                row[i  ] = 1.;
-                col[i++] = O.column("y", t);
-                
-                row[i  ] = -1.0/P["Ec"]; 
-                col[i++] = O.column("ucsu", t);
+                add_constraintex(lp, 3, row, col, GE, 0.);
 
-                if(t>0)
-                {
-                    row[i  ] = -1.;
-                    col[i++] = O.column("y", t-1);
+                //cycle standby start penalty
+                row[0] = 1.;
+                col[0] = O.column("ychsp", t);
 
-                    row[i  ] = -1.;
-                    col[i++] = O.column("ycsb", t-1);
+                row[1] = -1.;
+                col[1] = O.column("y", t);
 
-                    add_constraintex(lp, i, row, col, LE, 0.); 
-                }
-                else
-                {
-                    add_constraintex(lp, i, row, col, LE, (params.is_pb_operating0 ? 1. : 0.) + (params.is_pb_standby0 ? 1. : 0.) );
-                }
+                row[2] = -1.;
+                col[2] = O.column("ycsb", t-1);
 
-                //Cycle consumption limit
-                i=0;
-                row[i  ] = 1.;
-                col[i++] = O.column("x", t);
+                add_constraintex(lp, 3, row, col, GE, -1.);
 
-                //mjw 2016.12.2 --> This constraint seems to be problematic in identifying feasible solutions for subhourly runs. Needs attention.
-                row[i  ] = P["Qc"];
-                col[i++] = O.column("ycsu", t);
+#ifdef MOD_CYCLE_SHUTDOWN
+                //cycle shutdown energy penalty
+                row[0] = 1.;
+                col[0] = O.column("ycsd", t-1);
+
+                row[1] = -1.;
+                col[1] = O.column("y", t-1);
+                
+                row[2] = 1.;
+                col[2] = O.column("y", t);
+                
+                row[3] = -1.;
+                col[3] = O.column("ycsb", t-1);
                 
-                row[i  ] = -P["Qu"];
-                col[i++] = O.column("y", t);
+                row[4] = 1.;
+                col[4] = O.column("ycsb", t);
 
-                add_constraintex(lp, i, row, col, LE, 0.);
+                add_constraintex(lp, 5, row, col, GE, 0.);
+#endif
 
-                //cycle operation mode requirement
-                row[0] = 1.;
-                col[0] = O.column("x", t);
+            }
+        }
+    }
 
-                row[1] = -P["Qu"];
-                col[1] = O.column("y", t);
 
-                add_constraintex(lp, 2, row, col, LE, 0.);
+    // ******************** Balance constraints *******************
+    //Energy in, out, and stored in the TES system must balance.
+    {
+        REAL row[7];
+        int col[7];
 
-                //Minimum cycle energy contribution
-                i=0;
+        for(int t=0; t<nt; t++)
+        {
+            int i=0;
+
+            row[i  ] = P["delta"];
+            col[i++] = O.column("xr", t);
+            
+            row[i  ] = -P["delta"]*P["Qc"];
+            col[i++] = O.column("ycsu", t);
+            
+            row[i  ] = -P["delta"]*P["Qb"]; 
+            col[i++] = O.column("ycsb", t);
+            
+            row[i  ] = -P["delta"];
+            col[i++] = O.column("x", t);
+#ifdef MOD_REC_STANDBY                
+            row[i  ] = -delta*Qrsb;
+            col[i++] = O.column("yrsb", t);
+#endif
+            
+            row[i  ] = -1.;
+            col[i++] = O.column("s", t);
+            
+            if(t>0)
+            {
                 row[i  ] = 1.;
-                col[i++] = O.column("x", t);
+                col[i++] = O.column("s", t-1);
 
-                row[i  ] = -P["Ql"];
-                col[i++] = O.column("y", t);
+                add_constraintex(lp, i, row, col, EQ, 0.);
+            }
+            else
+            {
+                add_constraintex(lp, i, row, col, EQ, 0.);  //initial storage state (kWh)
+                m_lp_rows.balance0 = get_Nrows(lp);
+            }
+        }
+    }
+    
+    //Energy in storage must be within limits
+    {
+        REAL row[8];
+        int col[8];
 
-                add_constraintex(lp, i, row, col, GE, 0);
+        for(int t=0; t<nt; t++)
+        {
+            
+            row[0] = 1.;
+            col[0] = O.column("s", t);
 
-                //cycle startup can't be enabled after a time step where the cycle was operating
-                if(t>0)
-                {
-                    row[0] = 1.;
-                    col[0] = O.column("ycsu", t);
+            add_constraintex(lp, 1, row, col, LE, P["Eu"]);
 
-                    row[1] = 1.;
-                    col[1] = O.column("y", t-1);
+			//max cycle thermal input in time periods where cycle operates and receiver is starting up
+            //outputs.delta_rs.resize(nt);
+			if (t < nt - 1)
+			{
+				/*double delta_rec_startup = min(1., max(params.e_rec_startup / max(outputs.q_sfavail_expected.at(t + 1)*P["delta"], 1.), params.dt_rec_startup / P["delta"]));
+                outputs.delta_rs.at(t) = delta_rec_startup;*/
+				double large = 5.0*params.q_pb_max;
+				int i = 0;
 
-                    add_constraintex(lp, 2, row, col, LE, 1.);
-                }
+				row[i] = 1.;
+				col[i++] = O.column("x", t + 1);
 
+				row[i] = params.q_pb_standby + large;
+				col[i++] = O.column("ycsb", t + 1);
 
-                //Standby mode entry
-                i=0;
-                row[i  ] = 1.;
-                col[i++] = O.column("ycsb", t);
+				row[i] = -1.;   //depends on the receiver startup time, set by update_problem
+				col[i++] = O.column("s", t);
 
-                if(t>0)
-                {
-                    row[i  ] = -1.;
-                    col[i++] = O.column("y", t-1);
+				row[i] = large;
+				col[i++] = O.column("yrsu", t + 1);
 
-                    row[i  ] = -1.;
-                    col[i++] = O.column("ycsb", t-1);
+				row[i] = large;
+				col[i++] = O.column("y", t + 1);
 
-                    add_constraintex(lp, i, row, col, LE, 0);
-                }
-                else
-                {
-                    add_constraintex(lp, i, row, col, LE, (params.is_pb_standby0 ? 1 : 0) + (params.is_pb_operating0 ? 1 : 0));
-                }
+				row[i] = large;
+				col[i++] = O.column("y", t);
 
-                //some modes can't coincide
-                row[0] = 1.;
-                col[0] = O.column("ycsu", t);
-                row[1] = 1.;
-                col[1] = O.column("ycsb", t);    
+				row[i] = large;
+				col[i++] = O.column("ycsb", t);
 
-                add_constraintex(lp, 2, row, col, LE, 1);   
+				add_constraintex(lp, i, row, col, LE, 3.0*large);
+				m_lp_rows.tes_su.at(t) = get_Nrows(lp);
+			}
 
-                row[0] = 1.;
-                col[0] = O.column("y", t);
-                row[1] = 1.;
-                col[1] = O.column("ycsb", t);    
+        }
+    }
 
-                add_constraintex(lp, 2, row, col, LE, 1);   
+    // Maximum gross electricity production constraint
+    {
+        REAL row[1];
+        int col[1];
 
-                if( t > 0 )
-                {
-                    //cycle start penalty
-                    row[0] = 1.;
-                    col[0] = O.column("ycsup", t);
+        for( int t = 0; t<nt; t++ )
+        {
+            row[0] = 1.;
+            col[0] = O.column("wdot", t);
 
-                    row[1] = -1.;
-                    col[1] = O.column("ycsu", t);
+			add_constraintex(lp, 1, row, col, LE, 0.);
+            m_lp_rows.wdot_max.at(t) = get_Nrows(lp);
+        }
+    }
 
-                    row[2] = 1.;
-                    col[2] = O.column("ycsu", t-1);
+	// Maximum net electricity production constraint
+	{
+		REAL row[9];
+		int col[9];
 
-                    add_constraintex(lp, 3, row, col, GE, 0.);
+		for (int t = 0; t<nt; t++)
+		{
+			//the production coefficient, the limit, and the production bound when cycle operation is impossible are set by update_problem
+			int i = 0;
 
-                    //cycle standby start penalty
-                    row[0] = 1.;
-                    col[0] = O.column("ychsp", t);
+			row[i] = 1.;
+			col[i++] = O.column("wdot", t);
 
-                    row[1] = -1.;
-                    col[1] = O.column("y", t);
+			row[i] = -params.w_rec_pump;
+			col[i++] = O.column("xr", t);
 
-                    row[2] = -1.;
-                    col[2] = O.column("ycsb", t-1);
+			row[i] = -params.w_rec_pump;
+			col[i++] = O.column("xrsu", t);
 
-                    add_constraintex(lp, 3, row, col, GE, -1.);
+			row[i] = -(params.w_rec_ht / params.dt) - (params.w_stow / params.dt);	//kWe
+			col[i++] = O.column("yrsu", t);
 
-#ifdef MOD_CYCLE_SHUTDOWN
-                    //cycle shutdown energy penalty
-                    row[0] = 1.;
-                    col[0] = O.column("ycsd", t-1);
-
-                    row[1] = -1.;
-                    col[1] = O.column("y", t-1);
-                    
-                    row[2] = 1.;
-                    col[2] = O.column("y", t);
-                    
-                    row[3] = -1.;
-                    col[3] = O.column("ycsb", t-1);
-                    
-                    row[4] = 1.;
-                    col[4] = O.column("ycsb", t);
-
-                    add_constraintex(lp, 5, row, col, GE, 0.);
-#endif
+			row[i] = -params.w_track;
+			col[i++] = O.column("yr", t);
 
-                }
-            }
-        }
+			row[i] = -params.w_cycle_standby;
+			col[i++] = O.column("ycsb", t);
 
+			row[i] = -params.w_cycle_pump;
+			col[i++] = O.column("x", t);
 
-        // ******************** Balance constraints *******************
-        //Energy in, out, and stored in the TES system must balance.
-        {
-            REAL row[7];
-            int col[7];
+			//row[i] = -(params.w_rec_pump*params.q_rec_min) - (params.w_stow / params.dt); //kWe
+			//col[i++] = O.column("yrsb", t);
+			//row[i] - params.w_stow / params.dt;	//kWe
+			//col[i++] = O.column("yrsd", t);
 
-            for(int t=0; t<nt; t++)
-            {
-                int i=0;
+			add_constraintex(lp, 7, row, col, LE, 0.);
+			m_lp_rows.wnet_max.at(t) = get_Nrows(lp);
+		}
+	}
 
-                row[i  ] = P["delta"];
-                col[i++] = O.column("xr", t);
-                
-                row[i  ] = -P["delta"]*P["Qc"];
-                col[i++] = O.column("ycsu", t);
-                
-                row[i  ] = -P["delta"]*P["Qb"]; 
-                col[i++] = O.column("ycsb", t);
-                
-                row[i  ] = -P["delta"];
-                col[i++] = O.column("x", t);
-#ifdef MOD_REC_STANDBY                
-                row[i  ] = -delta*Qrsb;
-                col[i++] = O.column("yrsb", t);
-#endif
-                
-                row[i  ] = -1.;
-                col[i++] = O.column("s", t);
-                
-                if(t>0)
-                {
-                    row[i  ] = 1.;
-                    col[i++] = O.column("s", t-1);
+    
+    //Set problem to maximize
+    set_maxim(lp);
 
-                    add_constraintex(lp, i, row, col, EQ, 0.);
-                }
-                else
-                {
-                    add_constraintex(lp, i, row, col, EQ, -P["s0"]);  //initial storage state (kWh)
-                }
-            }
-        }
+    //reset the row mode
+    set_add_rowmode(lp, FALSE);
+
+    m_lp = lp;
+    m_lp_nstep = nt;
+}
+
+void csp_dispatch_opt::update_problem(optimization_vars &O, unordered_map<std::string, double> &P)
+{
+    /* 
+    Set the objective, coefficients, right hand sides and bounds that change from one horizon to the next
+    */
+    int nt = (int)m_nstep_opt;
+    lprec *lp = m_lp;
+
+    /* 
+    --------------------------------------------------------------------------------
+    set up the objective function
+    --------------------------------------------------------------------------------
+    */
+	{
+        int *col = new int[12 * nt];
+        REAL *row = new REAL[12 * nt];
+        double tadj = P["disp_time_weighting"];
+        int i = 0;
+
+        //calculate the mean price to appropriately weight the receiver production timing derate
+        double pmean =0;
+        for(int t=0; t<(int)price_signal.size(); t++)
+            pmean += price_signal.at(t);
+        pmean /= (double)price_signal.size();
+        //--
         
-        //Energy in storage must be within limits
+        for(int t=0; t<nt; t++)
         {
-            REAL row[8];
-            int col[8];
+            i = 0;
+            col[ t + nt*(i  ) ] = O.column("wdot", t);
+            row[ t + nt*(i++) ] = P["delta"] * price_signal.at(t)*tadj*(1.-outputs.w_condf_expected.at(t));
 
-            for(int t=0; t<nt; t++)
-            {
-                
-                row[0] = 1.;
-                col[0] = O.column("s", t);
+            col[ t + nt*(i  ) ] = O.column("xr", t);
+            row[ t + nt*(i++) ] = -(P["delta"] * price_signal.at(t) * P["Lr"])+tadj*pmean;  // tadj added to prefer receiver production sooner (i.e. delay dumping)
 
-                add_constraintex(lp, 1, row, col, LE, P["Eu"]);
+            col[ t + nt*(i  ) ] = O.column("xrsu", t);
+            row[ t + nt*(i++) ] = -P["delta"] * price_signal.at(t) * P["Lr"];
 
-				//max cycle thermal input in time periods where cycle operates and receiver is starting up
-                //outputs.delta_rs.resize(nt);
-				if (t < nt - 1)
-				{
-					/*double delta_rec_startup = min(1., max(params.e_rec_startup / max(outputs.q_sfavail_expected.at(t + 1)*P["delta"], 1.), params.dt_rec_startup / P["delta"]));
-                    outputs.delta_rs.at(t) = delta_rec_startup;*/
-					double t_rec_startup = outputs.delta_rs.at(t) * P["delta"];
-					double large = 5.0*params.q_pb_max;
-					int i = 0;
+            col[ t + nt*(i  ) ] = O.column("yrsu", t);
+            row[ t + nt*(i++) ] = -price_signal.at(t) * (params.w_rec_ht + params.w_stow);
 
-					row[i] = 1.;
-					col[i++] = O.column("x", t + 1);
+            col[ t + nt*(i  ) ] = O.column("yr", t);
+            row[ t + nt*(i++) ] = -(P["delta"] * price_signal.at(t) * params.w_track) + tadj;	// tadj added to prefer receiver operation in nearer term to longer term
 
-					row[i] = params.q_pb_standby + large;
-					col[i++] = O.column("ycsb", t + 1);
+            col[ t + nt*(i  ) ] = O.column("x", t);
+            row[ t + nt*(i++) ] = -P["delta"] * price_signal.at(t) * params.w_cycle_pump;
 
-					row[i] = -1. / t_rec_startup;
-					col[i++] = O.column("s", t);
+            col[ t + nt*(i  ) ] = O.column("ycsb", t);
+            row[ t + nt*(i++) ] = -P["delta"] * price_signal.at(t) * params.w_cycle_standby;
 
-					row[i] = large;
-					col[i++] = O.column("yrsu", t + 1);
+            //xxcol[ t + nt*(i   ] = O.column("yrsb", t);
+            //xxrow[ t + nt*(i++) ] = -delta * price_signal.at(t) * (Lr * Qrl + (params.w_stow / delta));
 
-					row[i] = large;
-					col[i++] = O.column("y", t + 1);
+            //xxcol[ t + nt*(i   ] = O.column("yrsd", t);
+            //xxrow[ t + nt*(i++) ] = -0.5 - (params.w_stow);
 
-					row[i] = large;
-					col[i++] = O.column("y", t);
+            //xxcol[ t + nt*(i   ] = O.column("ycsd", t);
+            //xxrow[ t + nt*(i++) ] = -0.5;
 
-					row[i] = large;
-					col[i++] = O.column("ycsb", t);
+            col[ t + nt*(i  ) ] = O.column("yrsup", t);
+            row[ t + nt*(i++) ] = -P["rsu_cost"]*tadj;
 
-					add_constraintex(lp, i, row, col, LE, 3.0*large);
-				}
+            //xxcol[ t + nt*(i   ] = O.column("yrhsp", t);
+            //xxrow[ t + nt*(i++) ] = -tadj;
 
-            }
-        }
+            col[ t + nt*(i  ) ] = O.column("ycsup", t);
+            row[ t + nt*(i++) ] = -P["csu_cost"]*tadj;
 
-        // Maximum gross electricity production constraint
-        {
-            REAL row[1];
-            int col[1];
+            col[ t + nt*(i  ) ] = O.column("ychsp", t);
+            row[ t + nt*(i++) ] = -P["csu_cost"]*tadj * 0.1;
 
-            for( int t = 0; t<nt; t++ )
-            {
-                row[0] = 1.;
-                col[0] = O.column("wdot", t);
+            col[ t + nt*(i  ) ] = O.column("delta_w", t);
+            row[ t + nt*(i++) ] = -P["pen_delta_w"]*tadj;
 
-				add_constraintex(lp, 1, row, col, LE, outputs.f_pb_op_limit.at(t) * P["W_dot_cycle"]);
-            }
+            tadj *= P["disp_time_weighting"];
         }
 
-		// Maximum net electricity production constraint
-		{
-			REAL row[9];
-			int col[9];
+        set_obj_fnex(lp, i*nt, row, col);
 
-			for (int t = 0; t<nt; t++)
-			{
-                
-                //check if cycle should be able to operate
-                if( outputs.wnet_lim_min.at(t) > w_lim.at(t) )      // power cycle operation is impossible at t
-                {
-                    if(w_lim.at(t) > 0)
-                        params.messages->add_message(C_csp_messages::NOTICE, "Power cycle operation not possible at time "+ util::to_string(t+1) + ": power limit below minimum operation");                    
-                    w_lim.at(t) = 0.;
-                    
-                }
+        delete[] col;
+        delete[] row;
+    }
 
-				if (w_lim.at(t) > 0.)	// Power cycle operation is possible
-				{
-					int i = 0;
+    //initial plant state
+    set_rh(lp, m_lp_rows.wdot_change0, -P["Wdot0"]);
+    set_rh(lp, m_lp_rows.rec_allowed0, (params.is_rec_operating0 ? 1. : 0.) );
+    set_rh(lp, m_lp_rows.pb_allowed0, (params.is_pb_operating0 ? 1. : 0.) + (params.is_pb_standby0 ? 1. : 0.) );
+    set_rh(lp, m_lp_rows.pb_standby0, (params.is_pb_standby0 ? 1. : 0.) + (params.is_pb_operating0 ? 1. : 0.) );
+    set_rh(lp, m_lp_rows.balance0, -P["s0"]);  //initial storage state (kWh)
 
-					row[i] = 1.0-outputs.w_condf_expected.at(t);
-					col[i++] = O.column("wdot", t);
+    for(int t=0; t<nt; t++)
+    {
+        //power production curve
+        set_mat(lp, m_lp_rows.power_curve.at(t), O.column("x", t), -P["etap"]*outputs.eta_pb_expected.at(t)/params.eta_cycle_ref);
+        set_mat(lp, m_lp_rows.power_curve.at(t), O.column("y", t), -(P["Wdotu"] - P["etap"]*P["Qu"])*outputs.eta_pb_expected.at(t)/params.eta_cycle_ref);
 
-					row[i] = -params.w_rec_pump;
-					col[i++] = O.column("xr", t);
+        //Receiver startup and operation only during solar positive periods
+        set_rh(lp, m_lp_rows.rec_su_solar.at(t), min(P["M"]*outputs.q_sfavail_expected.at(t), 1.0) );
+        set_rh(lp, m_lp_rows.rec_solar.at(t), min(P["M"]*outputs.q_sfavail_expected.at(t), 1.0) );
 
-					row[i] = -params.w_rec_pump;
-					col[i++] = O.column("xrsu", t);
+        //Receiver consumption limit and operation mode requirement
+        set_rh(lp, m_lp_rows.rec_limit.at(t), outputs.q_sfavail_expected.at(t));
+        set_mat(lp, m_lp_rows.rec_mode.at(t), O.column("yr", t), -outputs.q_sfavail_expected.at(t));
 
-					row[i] = -(params.w_rec_ht / params.dt) - (params.w_stow / params.dt);	//kWe
-					col[i++] = O.column("yrsu", t);
+        //max cycle thermal input in time periods where cycle operates and receiver is starting up
+        if( t < nt - 1 )
+            set_mat(lp, m_lp_rows.tes_su.at(t), O.column("s", t), -1. / (outputs.delta_rs.at(t) * P["delta"]));
 
-					row[i] = -params.w_track;
-					col[i++] = O.column("yr", t);
+        //Maximum gross electricity production
+        set_rh(lp, m_lp_rows.wdot_max.at(t), outputs.f_pb_op_limit.at(t) * P["W_dot_cycle"]);
 
-					row[i] = -params.w_cycle_standby;
-					col[i++] = O.column("ycsb", t);
+        //check if cycle should be able to operate
+        if( outputs.wnet_lim_min.at(t) > w_lim.at(t) )      // power cycle operation is impossible at t
+        {
+            if(w_lim.at(t) > 0)
+                params.messages->add_message(C_csp_messages::NOTICE, "Power cycle operation not possible at time "+ util::to_string(t+1) + ": power limit below minimum operation");                    
+            w_lim.at(t) = 0.;
+        }
 
-					row[i] = -params.w_cycle_pump;
-					col[i++] = O.column("x", t);
+        //Maximum net electricity production. Production is fixed at zero when operation is impossible at the current constrained wlim
+        bool is_pb_possible = w_lim.at(t) > 0.;
+        set_mat(lp, m_lp_rows.wnet_max.at(t), O.column("wdot", t), 1.0-outputs.w_condf_expected.at(t));
+        set_rh(lp, m_lp_rows.wnet_max.at(t), is_pb_possible ? w_lim.at(t) : 0.);
+        set_upbo(lp, O.column("wdot", t), is_pb_possible ? get_infinite(lp) : 0.);
+    }
+}
 
-					//row[i] = -(params.w_rec_pump*params.q_rec_min) - (params.w_stow / params.dt); //kWe
-					//col[i++] = O.column("yrsb", t);
-					//row[i] - params.w_stow / params.dt;	//kWe
-					//col[i++] = O.column("yrsd", t);
+bool csp_dispatch_opt::optimize()
+{
 
-					add_constraintex(lp, 7, row, col, LE, w_lim.at(t));
-				}
-				else // Power cycle operation is impossible at current constrained wlim
-				{
-					row[0] = 1.0;
-					col[0] = O.column("wdot", t);
-					add_constraintex(lp, 1, row, col, EQ, 0.);
-				}
-			}
-		}
+    //First check to see whether we should call the AMPL engine instead. 
+    if( solver_params.is_ampl_engine )
+    {
+        return optimize_ampl();
+    }
+
+    /* 
+    Formulate the optimization problem for dispatch generation. We are trying to maximize revenue subject to inventory
+    constraints.
+    
+    
+    Variables
+    -------------------------------------------------------------
+    Continuous
+    -------------------------------------------------------------
+    xr          kWt     Power delivered by the receiver at time t
+    xrsu        kWt     Power used by the reciever for start up
+    ursu        kWt     Receiver accumulated start-up thermal power at time t
+    x           kWt	    Cycle thermal power consumption at time t 
+    ucsu        kWt     Cycle accumulated start-up thermal power at time t
+    s           kWht    TES reserve quantity at time t (auxiliary variable) 
+    wdot        kWe     Electrical power production at time t
+    delta_w     kWe     Positive change in power production at time t w/r/t t-1
+    -------------------------------------------------------------
+    Binary
+    -------------------------------------------------------------
+    yr              1 if receiver is generating ``usable'' thermal power at time t; 0 otherwise 
+    yrsu            1 if receiver is starting up at time t; 0 otherwise 
+    yrsb            1 if receiver is in standby at time t; 0 otherwise
+    yrsup           1 if reciever startup penalty is enforced at time t; 0 otherwise
+    yrhsp           1 if receiver hot startup penalty is enforced at time t; 0 otherwise
+    y               1 if cycle is generating electric power at time t; 0 otherwise
+    ycsu            1 if cycle is starting up at time t; 0 otherwise
+    ycsb            1 if cycle is in standby mode at time t; 0 otherwise
+    ycsup           1 if cycle startup penalty is enforced at time t; 0 otherwise
+    ychsp           1 if cycle hot startup penalty is enforced at time t; 0 otherwise
+    -------------------------------------------------------------
+    */
+    lprec *lp = NULL;
+    int ret = 0;
+
+
+    try{
 
+        //Calculate the number of variables
+        int nt = (int)m_nstep_opt;
+
+        //set up the variable structure
+        optimization_vars O;
+        O.add_var("xr", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
+        O.add_var("xrsu", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
+        O.add_var("ursu", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
+        O.add_var("yr", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+        O.add_var("yrsu", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+        //O.add_var("yrsb", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+        //O.add_var("yrsd", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+        O.add_var("yrsup", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+        //O.add_var("yrhsp", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+
+        O.add_var("x", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0.);
+        O.add_var("y", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+        O.add_var("s", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
+        O.add_var("ucsu", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. );
+        O.add_var("ycsu", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+        O.add_var("ycsb", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+#ifdef MOD_CYCLE_SHUTDOWN
+        O.add_var("ycsd", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+#endif
+        O.add_var("ycsup", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+        O.add_var("ychsp", optimization_vars::VAR_TYPE::BINARY_T, optimization_vars::VAR_DIM::DIM_T, nt);
+        O.add_var("wdot", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. ); //0 lower bound?
+        O.add_var("delta_w", optimization_vars::VAR_TYPE::REAL_T, optimization_vars::VAR_DIM::DIM_T, nt, 0. ); 
         
-        //Set problem to maximize
-        set_maxim(lp);
+        unordered_map<std::string, double> P;
+        calculate_parameters(this, P, nt);
+
+        O.construct();  //allocates memory for data array
+
+        //the problem structure only changes with the horizon length
+        if( m_lp == NULL || m_lp_nstep != nt )
+            build_problem(O, P);
 
-        //reset the row mode
-        set_add_rowmode(lp, FALSE);
+        update_problem(O, P);
+
+        //presolve modifies the problem it is run on, so solve a copy
+        lp = copy_lp(m_lp);
+
+        if(lp == NULL)
+            throw C_csp_exception("Failed to create a new CSP dispatch optimization problem context.");
 
         //set the log function
         solver_params.reset();
@@ -64,12 +64,47 @@ using namespace std;
 #ifndef _CSP_DISPATCH
 #define _CSP_DISPATCH
 
+class optimization_vars;
+
 class csp_dispatch_opt
 {
     int  m_nstep_opt;              //number of time steps in the optimized array
     bool m_is_weather_setup;  //bool indicating whether the weather has been copied
     
+    /* 
+    The structure of the optimization problem only depends on the number of time steps, so it is built once and the 
+    coefficients that depend on the forecast and plant state are updated in place for each horizon. Presolve 
+    modifies the problem it runs on, so each solve works on a copy.
+    */
+    lprec *m_lp;                    //problem structure for m_lp_nstep time steps, NULL until the first optimization
+    int m_lp_nstep;
+
+    struct s_lp_rows                //problem rows holding horizon-specific coefficients or right hand sides
+    {
+        int wdot_change0;           //production change at the first step
+        int rec_allowed0;           //receiver operation at the first step
+        int pb_allowed0;            //cycle operation at the first step
+        int pb_standby0;            //cycle standby entry at the first step
+        int balance0;               //storage balance at the first step
+        vector<int> power_curve;    //cycle efficiency
+        vector<int> rec_su_solar;   //receiver startup only with solar resource
+        vector<int> rec_limit;      //receiver consumption limit
+        vector<int> rec_mode;       //receiver operation mode requirement
+        vector<int> rec_solar;      //receiver operation only with solar resource
+        vector<int> tes_su;         //cycle thermal input during receiver startup
+        vector<int> wdot_max;       //maximum gross production
+        vector<int> wnet_max;       //maximum net production
+    } m_lp_rows;
+
     void clear_output_arrays();
+    bool forecast_performance(int step_start, int ntimeints, int divs_per_int, vector<double> &eta_sf_expected, vector<double> &q_sfavail_expected, 
+        vector<double> &eta_pb_expected, vector<double> &f_pb_op_limit, vector<double> &w_condf_expected);
+    void build_problem(optimization_vars &O, unordered_map<std::string, double> &P);
+    void update_problem(optimization_vars &O, unordered_map<std::string, double> &P);
+
+    //not copyable, owns the problem structure
+    csp_dispatch_opt(const csp_dispatch_opt &);
+    csp_dispatch_opt &operator=(const csp_dispatch_opt &);
 
 public:
     bool m_last_opt_successful;   //last optimization run was successful?
@@ -289,12 +324,26 @@ public:
 
     struct s_forecast_outputs
     {
-
+        /* 
+        Forecast for the whole simulation period, one entry per dispatch time step, calculated once by 
+        precompute_forecast(). Horizons that fall inside the period are copied from these arrays instead of 
+        walking the weather file again.
+        */
+        int step_start;         //first weather time step (0-based) covered by the forecast
+        int divs_per_int;       //weather time steps per dispatch time step
+        double sf_effadj;       //solar field efficiency adjustment that was applied
+        vector<double> q_sfavail_expected;
+        vector<double> eta_sf_expected;
+        vector<double> eta_pb_expected;
+        vector<double> f_pb_op_limit;
+        vector<double> w_condf_expected;
+        vector<double> price_mult;  //price multiplier, set by the caller
     } forecast_outputs;
 
     //----- public member functions ----
 
     csp_dispatch_opt();
+    ~csp_dispatch_opt();
 
     //check parameters and inputs to make sure everything has been set up correctly
     bool check_setup(int nstep);
@@ -308,6 +357,10 @@ public:
     //Predict performance out nstep values. 
     bool predict_performance(int step_start, int ntimeints, int divs_per_int);    
 
+    //Predict performance for the whole simulation period ahead of time, see s_forecast_outputs
+    bool precompute_forecast(int step_start, int ntimeints, int divs_per_int);
+    int forecast_index(int step_start, int ntimeints, int divs_per_int);
+
     //declare dispatch function in csp_dispatch.cpp
     bool optimize();
 
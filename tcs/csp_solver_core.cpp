@@ -625,6 +625,25 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
     dispatch.solver_params.ampl_exec_call = mc_tou.mc_dispatch_params.m_ampl_exec_call;
     //-------------------------------
 
+	if( mc_tou.mc_dispatch_params.m_dispatch_optimize )
+	{
+		// Forecast solar field, cycle and price for the whole simulation once; each horizon copies its part
+		int disp_divs = (int)((3600. / baseline_step) / mc_tou.mc_dispatch_params.m_disp_steps_per_hour);
+		double disp_step = baseline_step * disp_divs;		//[s]
+		int fc_step_start = (int)(mc_kernel.get_sim_setup()->m_sim_time_start / disp_step) * disp_divs;
+		int fc_nstep = (int)((mc_kernel.get_sim_setup()->m_sim_time_end - fc_step_start * baseline_step) / disp_step + 1.e-6);
+
+		if( disp_divs > 0 && fc_nstep > 0 && dispatch.precompute_forecast(fc_step_start, fc_nstep, disp_divs) )
+		{
+			dispatch.forecast_outputs.price_mult.resize(fc_nstep);
+			for( int t = 0; t < fc_nstep; t++ )
+			{
+				mc_tou.call((fc_step_start + 1) * baseline_step + t * disp_step, mc_tou_outputs);
+				dispatch.forecast_outputs.price_mult.at(t) = mc_tou_outputs.m_price_mult;
+			}
+		}
+	}
+
         
 	int cr_operating_state = C_csp_collector_receiver::OFF;
 	int pc_operating_state = C_csp_power_cycle::OFF;
@@ -886,8 +905,17 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
                 dispatch.price_signal.clear();
                 dispatch.price_signal.resize(opt_horizon*mc_tou.mc_dispatch_params.m_disp_steps_per_hour, 1.);
 
+                int fc_index = dispatch.forecast_index((int)(mc_kernel.mc_sim_info.ms_ts.m_time / baseline_step - 1),
+                    opt_horizon*mc_tou.mc_dispatch_params.m_disp_steps_per_hour,
+                    (int)((3600. / baseline_step) / mc_tou.mc_dispatch_params.m_disp_steps_per_hour));
+
                 for(int t=0; t<opt_horizon*mc_tou.mc_dispatch_params.m_disp_steps_per_hour; t++)
                 {
+                    if( fc_index >= 0 )
+                    {
+                        dispatch.price_signal.at(t) = dispatch.forecast_outputs.price_mult.at(fc_index + t);
+                        continue;
+                    }
 					mc_tou.call(mc_kernel.mc_sim_info.ms_ts.m_time + t * 3600./(double)mc_tou.mc_dispatch_params.m_disp_steps_per_hour, mc_tou_outputs);
 		            dispatch.price_signal.at(t) = mc_tou_outputs.m_price_mult;
                 }
@@ -59,6 +59,8 @@
 
 #include "numeric_solvers.h"
 
+struct solarpos_table;
+
 class C_csp_solver_steam_state
 {
 public:
@@ -168,6 +170,10 @@ private:
 
 	bool m_is_wf_init;
 
+	std::shared_ptr<const solarpos_table> m_solarpos;	// sun position for each weather record
+
+	void get_sun_position(double sunn[9]);
+
 public:
 	std::shared_ptr<weather_data_provider> m_weather_data_provider;
 	weather_header* m_hdr;
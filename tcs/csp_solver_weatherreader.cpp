@@ -97,6 +97,27 @@ void C_csp_weatherreader::init()
     m_weather_data_provider->read( &m_rec );
     m_weather_data_provider->rewind();
 
+	// Sun position for every record, calculated once and shared with other runs at the same site
+	size_t nrec = m_weather_data_provider->nrecords();
+	std::vector<int> year(nrec), month(nrec), day(nrec), hour(nrec);
+	std::vector<double> minute(nrec);
+	size_t nread = 0;
+	weather_record rec;
+	while( nread < nrec && m_weather_data_provider->read( &rec ) )
+	{
+		year[nread] = rec.year;
+		month[nread] = rec.month;
+		day[nread] = rec.day;
+		hour[nread] = rec.hour;
+		minute[nread] = rec.minute;
+		nread++;
+	}
+	m_weather_data_provider->rewind();
+
+	m_solarpos.reset();
+	if( nread == nrec )
+		m_solarpos = solarpos_cache::instance().get(m_hdr->lat, m_hdr->lon, m_hdr->tz, year, month, day, hour, minute);
+
 	ms_solved_params.m_leapyear = (m_rec.year % 4 == 0) && ((m_rec.year % 100 != 0) || (m_rec.year % 400 == 0));
     //do a special check to see if it's a leap year but the weather file supplies 8760 values nonetheless
     if( ms_solved_params.m_leapyear && (m_weather_data_provider->nrecords() % 8760 == 0) )
@@ -153,8 +174,7 @@ void C_csp_weatherreader::timestep_call(const C_csp_solver_sim_info &p_sim_info)
 	angle[0] = angle[1] = angle[2] = angle[3] = angle[4] = 0;
 	diffc[0] = diffc[1] = diffc[2] = 0;
 
-	solarpos(m_rec.year, m_rec.month, m_rec.day, m_rec.hour, m_rec.minute,
-		m_hdr->lat, m_hdr->lon, m_hdr->tz, sunn);
+	get_sun_position(sunn);
 
 	if( sunn[2] > 0.0087 )
 	{
@@ -220,6 +240,22 @@ void C_csp_weatherreader::timestep_call(const C_csp_solver_sim_info &p_sim_info)
 	
 }
 
+void C_csp_weatherreader::get_sun_position(double sunn[9])
+{
+	// use the precalculated sun position if the current record is the last one read from the provider
+	int irec = m_weather_data_provider->get_counter_value() - 1;
+	if( m_solarpos && irec >= 0 && (size_t)irec < m_solarpos->size()
+		&& m_solarpos->year[irec] == m_rec.year && m_solarpos->month[irec] == m_rec.month && m_solarpos->day[irec] == m_rec.day
+		&& m_solarpos->hour[irec] == m_rec.hour && m_solarpos->minute[irec] == m_rec.minute )
+	{
+		for( int k = 0; k < 9; k++ )
+			sunn[k] = m_solarpos->sun[k][irec];
+	}
+	else
+		solarpos(m_rec.year, m_rec.month, m_rec.day, m_rec.hour, m_rec.minute,
+			m_hdr->lat, m_hdr->lon, m_hdr->tz, sunn);
+}
+
 bool C_csp_weatherreader::read_time_step(int time_step, C_csp_solver_sim_info &p_sim_info)
 {
     /* 
@@ -48,6 +48,7 @@
 *******************************************************************************************************/
 
 #include "heat_exchangers.h"
+#include "co2_props_table.h"
 #include "csp_solver_util.h"
 #include "sam_csp_util.h"
 #include <algorithm>
@@ -65,7 +66,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_PH(P_h_in, h_h_in, &ms_co2_props);
+		prop_error_code = CO2_PH_tab(P_h_in, h_h_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -93,7 +94,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_PH(P_c_in, h_c_in, &ms_co2_props);
+		prop_error_code = CO2_PH_tab(P_c_in, h_c_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -465,7 +466,7 @@ void NS_HX_counterflow_eqs::calc_req_UA_enth(int hot_fl_code /*-*/, HTFPropertie
 		double T_h = std::numeric_limits<double>::quiet_NaN();
 		if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 		{
-			prop_error_code = CO2_PH(P_h, h_h, &ms_co2_props);
+			prop_error_code = CO2_PH_tab(P_h, h_h, &ms_co2_props);
 			if (prop_error_code != 0)
 			{
 				throw(C_csp_exception("C_HX_counterflow::design",
@@ -491,7 +492,7 @@ void NS_HX_counterflow_eqs::calc_req_UA_enth(int hot_fl_code /*-*/, HTFPropertie
 		double T_c = std::numeric_limits<double>::quiet_NaN();
 		if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 		{
-			prop_error_code = CO2_PH(P_c, h_c, &ms_co2_props);
+			prop_error_code = CO2_PH_tab(P_c, h_c, &ms_co2_props);
 			if (prop_error_code != 0)
 			{
 				throw(C_csp_exception("C_HX_counterflow::design",
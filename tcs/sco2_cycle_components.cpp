@@ -1,5 +1,6 @@
 #include "sco2_cycle_components.h"
 #include "CO2_properties.h"
+#include "co2_props_table.h"
 #include <limits>
 #include <algorithm>
 
@@ -40,7 +41,7 @@ void calculate_turbomachinery_outlet_1(double T_in /*K*/, double P_in /*kPa*/, d
 	double s_in = co2_props.entr;
 	dens_in = co2_props.dens;
 
-	prop_error_code = CO2_PS(P_out, s_in, &co2_props);			// outlet enthalpy if compression/expansion is isentropic
+	prop_error_code = CO2_PS_tab(P_out, s_in, &co2_props);			// outlet enthalpy if compression/expansion is isentropic
 	if (prop_error_code != 0)
 	{
 		error_code = prop_error_code;
@@ -58,7 +59,7 @@ void calculate_turbomachinery_outlet_1(double T_in /*K*/, double P_in /*kPa*/, d
 
 	double h_out = h_in - w;
 
-	prop_error_code = CO2_PH(P_out, h_out, &co2_props);
+	prop_error_code = CO2_PH_tab(P_out, h_out, &co2_props);
 	if (prop_error_code != 0)
 	{
 		error_code = prop_error_code;
@@ -110,7 +111,7 @@ void isen_eta_from_poly_eta(double T_in /*K*/, double P_in /*kPa*/, double P_out
 	double s_in = co2_props.entr;
 
 	// Outlet enthalpy if compression/expansion is isentropic
-	prop_error_code = CO2_PS(P_out, s_in, &co2_props);
+	prop_error_code = CO2_PS_tab(P_out, s_in, &co2_props);
 	if (prop_error_code != 0)
 	{
 		error_code = prop_error_code;
@@ -134,7 +135,7 @@ void isen_eta_from_poly_eta(double T_in /*K*/, double P_in /*kPa*/, double P_out
 		stage_P_out = stage_P_in + stage_DP;
 
 		// Outlet enthalpy if compression/expansion is isentropic
-		prop_error_code = CO2_PS(stage_P_out, stage_s_in, &co2_props);
+		prop_error_code = CO2_PS_tab(stage_P_out, stage_s_in, &co2_props);
 		if (prop_error_code != 0)
 		{
 			error_code = prop_error_code;
@@ -154,7 +155,7 @@ void isen_eta_from_poly_eta(double T_in /*K*/, double P_in /*kPa*/, double P_out
 		stage_P_in = stage_P_out;
 		stage_h_in = stage_h_out;
 
-		prop_error_code = CO2_PH(stage_P_in, stage_h_in, &co2_props);
+		prop_error_code = CO2_PH_tab(stage_P_in, stage_h_in, &co2_props);
 		if (prop_error_code != 0)
 		{
 			error_code = prop_error_code;
@@ -234,7 +235,7 @@ void C_turbine::turbine_sizing(const S_design_parameters & des_par_in, int & err
 	double ssnd_in = co2_props.ssnd;
 
 	// Outlet specific enthalpy after isentropic expansion
-	prop_error_code = CO2_PS(ms_des_par.m_P_out, ms_des_par.m_s_in, &co2_props);
+	prop_error_code = CO2_PS_tab(ms_des_par.m_P_out, ms_des_par.m_s_in, &co2_props);
 	if (prop_error_code != 0)
 	{
 		error_code = prop_error_code;
@@ -289,7 +290,7 @@ void C_turbine::off_design_turbine(double T_in, double P_in, double P_out, doubl
 	double s_in = co2_props.entr;
 	double ssnd_in = co2_props.ssnd;
 
-	prop_error_code = CO2_PS(P_out, s_in, &co2_props);
+	prop_error_code = CO2_PS_tab(P_out, s_in, &co2_props);
 	if (prop_error_code != 0)
 	{
 		error_code = prop_error_code;
@@ -309,7 +310,7 @@ void C_turbine::off_design_turbine(double T_in, double P_in, double P_out, doubl
 
 	// Calculate the outlet state and allowable mass flow rate
 	double h_out = h_in - ms_od_solved.m_eta*(h_in - h_s_out);		//[kJ/kg] Enthalpy at turbine outlet
-	prop_error_code = CO2_PH(P_out, h_out, &co2_props);
+	prop_error_code = CO2_PH_tab(P_out, h_out, &co2_props);
 	if (prop_error_code != 0)
 	{
 		error_code = prop_error_code;
@@ -374,7 +375,7 @@ int C_comp_single_stage::design_given_shaft_speed(double T_in /*K*/, double P_in
 
 	// Get actual outlet state
 	double h_out = h_in + w_i / eta_isen;	//[kJ/kg]
-	prop_error_code = CO2_PH(P_out, h_out, &co2_props);
+	prop_error_code = CO2_PH_tab(P_out, h_out, &co2_props);
 	if (prop_error_code != 0)
 	{
 		return prop_error_code;
@@ -424,7 +425,7 @@ int C_comp_single_stage::design_single_stage_comp(double T_in /*K*/, double P_in
 	double rho_in = in_props.dens;	//[kg/m^3]
 
 	CO2_state isen_out_props;
-	prop_err_code = CO2_PS(P_out, s_in, &isen_out_props);
+	prop_err_code = CO2_PS_tab(P_out, s_in, &isen_out_props);
 	if (prop_err_code != 0)
 	{
 		return -1;
@@ -535,7 +536,7 @@ int C_comp_single_stage::off_design_given_N(double T_in /*K*/, double P_in /*kPa
 	P_out = co2_props.pres;
 
 	// Determine compressor outlet temperature and speed of sound
-	prop_error_code = CO2_PH(P_out, h_out, &co2_props);
+	prop_error_code = CO2_PH_tab(P_out, h_out, &co2_props);
 	if (prop_error_code != 0)
 	{
 		return 2;
@@ -666,7 +667,7 @@ int C_comp_multi_stage::design_given_outlet_state(double T_in /*K*/, double P_in
 		double h_in = mv_stages[0].ms_des_solved.m_h_in;
 		double s_in = mv_stages[0].ms_des_solved.m_s_in;
 
-		int prop_err_code = CO2_PS(P_out, s_in, &co2_props);
+		int prop_err_code = CO2_PS_tab(P_out, s_in, &co2_props);
 		if (prop_err_code != 0)
 		{
 			return -1;
@@ -829,7 +830,7 @@ void C_comp_multi_stage::off_design_given_N(double T_in /*K*/, double P_in /*kPa
 	double s_in = mv_stages[0].ms_od_solved.m_s_in;					//[kJ/kg-K]
 
 	CO2_state co2_props;
-	int prop_err_code = CO2_PS(P_out, s_in, &co2_props);
+	int prop_err_code = CO2_PS_tab(P_out, s_in, &co2_props);
 	if (prop_err_code != 0)
 	{
 		error_code = prop_err_code;
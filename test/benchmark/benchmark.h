@@ -0,0 +1,57 @@
+#ifndef _SSC_BENCHMARK_H_
+#define _SSC_BENCHMARK_H_
+
+#include <string>
+#include <vector>
+
+#include "sscapi.h"
+
+/**
+*   Performance regression harness for the compute modules.  Each benchmark prepares a data container
+*   (untimed), then times ssc_module_exec for one compute module on that container.  Throughput is
+*   reported in simulated timesteps per second, where the number of timesteps is the length of an
+*   output array of the timed module (e.g. "gen" for the performance models).
+*
+*   Benchmarks are registered at static initialization time with BENCHMARK_CMOD, so adding a case only
+*   requires adding a setup function to one of the benchmark sources:
+*
+*	BENCHMARK_CMOD(pvwattsv5, hourly, "gen")
+*	{
+*		return pvwattsv5_nofinancial_testfile(data);
+*	}
+*
+*   The setup body receives 'ssc_data_t &data' and returns 0 on success.
+*/
+
+typedef int(*benchmark_setup_fn)(ssc_data_t &data);
+
+struct benchmark_case
+{
+	std::string name;		///< "<cmod>/<configuration>", used for filtering and reporting
+	std::string cmod;		///< compute module that is timed
+	std::string steps_var;	///< output array whose length is the number of simulated timesteps
+	benchmark_setup_fn setup;
+};
+
+std::vector<benchmark_case> &benchmark_registry();
+
+class benchmark_registrar
+{
+public:
+	benchmark_registrar(const char *cmod, const char *config, const char *steps_var, benchmark_setup_fn setup)
+	{
+		benchmark_case bc;
+		bc.name = std::string(cmod) + "/" + config;
+		bc.cmod = cmod;
+		bc.steps_var = steps_var;
+		bc.setup = setup;
+		benchmark_registry().push_back(bc);
+	}
+};
+
+#define BENCHMARK_CMOD(cmod, config, steps_var) \
+	static int bm_setup_##cmod##_##config(ssc_data_t &data); \
+	static benchmark_registrar bm_registrar_##cmod##_##config(#cmod, #config, steps_var, bm_setup_##cmod##_##config); \
+	static int bm_setup_##cmod##_##config(ssc_data_t &data)
+
+#endif
@@ -0,0 +1,268 @@
+#include <math.h>
+#include <string>
+#include <sstream>
+#include <vector>
+
+#include "benchmark.h"
+#include "../input_cases/pvwattsv5_cases.h"
+#include "../input_cases/windpower_cases.h"
+#include "../input_cases/pvsamv1_common_data.h"
+#include "../input_cases/tcstrough_physical_cases.h"
+
+/**
+*   Benchmark configurations for the performance, storage, rate and financial compute modules.
+*
+*	hourly:		the standard 8760 weather or generation profile from the test input cases
+*	minute:		the same year at 60 steps per hour (525,600 steps), passed in memory as
+*				solar_resource_data / wind_resource_data
+*	lifetime:	system_use_lifetime_output=1 over a 25 year analysis period
+*
+*   Anything the timed module depends on (weather expansion, upstream performance model runs) is done in
+*   the setup function so that it is excluded from the measurement.
+*
+*   tcsmolten_salt has no case yet: test/input_cases has no input set for it (about 200 required inputs),
+*   so add one there before adding its benchmark.
+*/
+
+static const int MINUTES_PER_HOUR = 60;
+
+/// Runs an upstream module during setup; unlike run_module the data container is left to the caller on failure
+static int run_prerequisite(ssc_data_t data, const char *name)
+{
+	ssc_module_t mod = ssc_module_create(name);
+	if (!mod)
+		return -1;
+	ssc_bool_t ok = ssc_module_exec(mod, data);
+	ssc_module_free(mod);
+	return ok ? 0 : -1;
+}
+
+/// Passes a SimulationTestTable style input list to the data container (same conventions as computeModuleTest)
+static int set_test_info(ssc_data_t data, const TestInfo *info, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		const TestInfo &ti = info[i];
+		if (ti.dataType == STR)
+			ssc_data_set_string(data, ti.sscVarName.c_str(), ti.values.c_str());
+		else if (ti.dataType == NUM)
+			ssc_data_set_number(data, ti.sscVarName.c_str(), (ssc_number_t)atof(ti.values.c_str()));
+		else if (ti.dataType == ARR || ti.dataType == MAT)
+		{
+			size_t len = ti.length * (ti.dataType == MAT ? ti.width : 1);
+			std::vector<ssc_number_t> val(len, 0);
+			std::stringstream ss(ti.values);
+			for (size_t j = 0; j < len; j++)
+			{
+				std::string substr;
+				getline(ss, substr, ',');
+				val[j] = (ssc_number_t)atof(substr.c_str());
+			}
+			if (ti.dataType == ARR)
+				ssc_data_set_array(data, ti.sscVarName.c_str(), &val[0], (int)len);
+			else
+				ssc_data_set_matrix(data, ti.sscVarName.c_str(), &val[0], (int)ti.length, (int)ti.width);
+		}
+		else
+			return -1;
+	}
+	return 0;
+}
+
+/// Reads an hourly weather file with wfreader and stores it as a 1-minute solar_resource_data table,
+/// holding each hourly value constant over its 60 minutes
+static int set_minute_solar_resource(ssc_data_t data, const char *file)
+{
+	ssc_data_t wf = ssc_data_create();
+	ssc_data_set_string(wf, "file_name", file);
+	if (run_prerequisite(wf, "wfreader") != 0)
+	{
+		ssc_data_free(wf);
+		return -1;
+	}
+
+	ssc_data_t table = ssc_data_create();
+	const char *hdr[] = { "lat", "lon", "tz", "elev" };
+	for (size_t i = 0; i < sizeof(hdr) / sizeof(hdr[0]); i++)
+	{
+		ssc_number_t val = 0;
+		ssc_data_get_number(wf, hdr[i], &val);
+		ssc_data_set_number(table, hdr[i], val);
+	}
+
+	// wfreader name -> solar_resource_data name
+	const char *fields[][2] = {
+		{ "year", "year" }, { "month", "month" }, { "day", "day" }, { "hour", "hour" },
+		{ "global", "gh" }, { "beam", "dn" }, { "diffuse", "df" },
+		{ "wspd", "wspd" }, { "wdir", "wdir" }, { "tdry", "tdry" }, { "tdew", "tdew" },
+		{ "rhum", "rhum" }, { "pres", "pres" }, { "albedo", "alb" } };
+
+	int nrec = 0;
+	for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+	{
+		int len = 0;
+		ssc_number_t *hourly = ssc_data_get_array(wf, fields[i][0], &len);
+		if (!hourly || len < 8760)
+			continue;
+
+		nrec = len * MINUTES_PER_HOUR;
+		ssc_number_t *p = ssc_data_alloc_array(nrec);
+		for (int h = 0; h < len; h++)
+			for (int m = 0; m < MINUTES_PER_HOUR; m++)
+				p[h*MINUTES_PER_HOUR + m] = hourly[h];
+		ssc_data_set_array_owned(table, fields[i][1], p, nrec);
+	}
+
+	ssc_number_t *minute = ssc_data_alloc_array(nrec);
+	for (int i = 0; i < nrec; i++)
+		minute[i] = (ssc_number_t)(i % MINUTES_PER_HOUR);
+	ssc_data_set_array_owned(table, "minute", minute, nrec);
+
+	ssc_data_unassign(data, "solar_resource_file");
+	ssc_data_set_table(data, "solar_resource_data", table);
+	ssc_data_free(table);
+	ssc_data_free(wf);
+	return nrec > 0 ? 0 : -1;
+}
+
+/// Stores a synthetic year of 1-minute wind data at hub height as wind_resource_data; the speed follows a
+/// diurnal and a slower seasonal cycle so that the whole power curve is exercised
+static int set_minute_wind_resource(ssc_data_t data)
+{
+	const int nstep = 8760 * MINUTES_PER_HOUR;
+	const double pi = 3.14159265358979;
+
+	ssc_data_t table = ssc_data_create();
+	ssc_data_set_number(table, "lat", 35.0f);
+	ssc_data_set_number(table, "lon", -93.0f);
+	ssc_data_set_number(table, "elev", 758.0f);
+	ssc_data_set_number(table, "year", 2012.0f);
+
+	ssc_number_t heights[4] = { 80, 80, 80, 80 };
+	ssc_number_t fields[4] = { 1, 2, 3, 4 }; // temp, pres, speed, dir
+	ssc_data_set_array(table, "heights", heights, 4);
+	ssc_data_set_array(table, "fields", fields, 4);
+
+	ssc_number_t *p = ssc_data_alloc_array(nstep * 4);
+	for (int i = 0; i < nstep; i++)
+	{
+		double hour = (double)i / MINUTES_PER_HOUR;
+		p[i * 4] = (ssc_number_t)(15 + 10 * sin(2 * pi * hour / 8760.0));
+		p[i * 4 + 1] = (ssc_number_t)0.95;
+		p[i * 4 + 2] = (ssc_number_t)(8 + 4 * sin(2 * pi * hour / 24.0) + 3 * sin(2 * pi * hour / 8760.0));
+		p[i * 4 + 3] = (ssc_number_t)fmod(180 + 0.5 * i, 360.0);
+	}
+	ssc_data_set_matrix(table, "data", p, nstep, 4);
+	delete[] p;
+
+	ssc_data_unassign(data, "wind_resource_filename");
+	ssc_data_set_table(data, "wind_resource_data", table);
+	ssc_data_free(table);
+	return 0;
+}
+
+/// Residential PV system (belpe load, pvsamv1 inputs) with lifetime output optionally enabled
+static void pvsamv1_residential(ssc_data_t &data, bool lifetime)
+{
+	belpe_default(data);
+	pvsamv1_with_residential_default(data);
+	ssc_data_set_number(data, "system_use_lifetime_output", lifetime ? 1 : 0);
+	ssc_data_set_number(data, "analysis_period", 25);
+}
+
+BENCHMARK_CMOD(pvwattsv5, hourly, "gen")
+{
+	return pvwattsv5_nofinancial_testfile(data);
+}
+
+BENCHMARK_CMOD(pvwattsv5, minute, "gen")
+{
+	int status = pvwattsv5_nofinancial_testfile(data);
+	status += set_minute_solar_resource(data, solar_resource_path);
+	return status;
+}
+
+BENCHMARK_CMOD(pvsamv1, hourly, "gen")
+{
+	pvsamv1_residential(data, false);
+	return 0;
+}
+
+BENCHMARK_CMOD(pvsamv1, minute, "gen")
+{
+	pvsamv1_residential(data, false);
+	return set_minute_solar_resource(data, solar_resource_path);
+}
+
+BENCHMARK_CMOD(pvsamv1, lifetime, "gen")
+{
+	pvsamv1_residential(data, true);
+	return 0;
+}
+
+BENCHMARK_CMOD(battery, hourly, "gen")
+{
+	pvsamv1_residential(data, false);
+	int status = run_prerequisite(data, "pvsamv1");
+	ssc_data_set_number(data, "en_batt", 1);
+	return status;
+}
+
+BENCHMARK_CMOD(battery, lifetime, "gen")
+{
+	pvsamv1_residential(data, true);
+	int status = run_prerequisite(data, "pvsamv1");
+	ssc_data_set_number(data, "en_batt", 1);
+	return status;
+}
+
+BENCHMARK_CMOD(utilityrate5, hourly, "gen")
+{
+	pvsamv1_residential(data, false);
+	int status = run_prerequisite(data, "pvsamv1");
+	utility_rate5_default(data);
+	return status;
+}
+
+BENCHMARK_CMOD(utilityrate5, minute, "gen")
+{
+	pvsamv1_residential(data, false);
+	int status = set_minute_solar_resource(data, solar_resource_path);
+	status += run_prerequisite(data, "pvsamv1");
+	utility_rate5_default(data);
+	return status;
+}
+
+BENCHMARK_CMOD(utilityrate5, lifetime, "gen")
+{
+	pvsamv1_residential(data, true);
+	int status = run_prerequisite(data, "pvsamv1");
+	utility_rate5_default(data);
+	ssc_data_set_number(data, "system_use_lifetime_output", 1);
+	return status;
+}
+
+BENCHMARK_CMOD(windpower, hourly, "gen")
+{
+	return windpower_nofinancial_testfile(data);
+}
+
+BENCHMARK_CMOD(windpower, minute, "gen")
+{
+	int status = windpower_nofinancial_testfile(data);
+	status += set_minute_wind_resource(data);
+	return status;
+}
+
+BENCHMARK_CMOD(tcstrough_physical, hourly, "gen")
+{
+	ssc_module_exec_set_print(0);
+	return set_test_info(data, physTroughPPASingleDefaultInfo, sizeof(physTroughPPASingleDefaultInfo) / sizeof(physTroughPPASingleDefaultInfo[0]));
+}
+
+BENCHMARK_CMOD(singleowner, hourly, "cf_energy_net")
+{
+	int status = set_test_info(data, physTroughPPASingleDefaultInfo, sizeof(physTroughPPASingleDefaultInfo) / sizeof(physTroughPPASingleDefaultInfo[0]));
+	status += run_prerequisite(data, "tcstrough_physical");
+	return status;
+}
@@ -0,0 +1,383 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+#include "benchmark.h"
+
+/**
+*   Command line driver for the compute module benchmarks.
+*
+*	Benchmark [--filter=<substring>] [--repetitions=<n>] [--format=console|json] [--out=<file>] [--list]
+*
+*   On POSIX systems each benchmark runs in a forked child process so that the reported peak resident
+*   set size belongs to that benchmark alone (setup included).  On Windows the benchmarks run in-process
+*   and the peak working set is the high-water mark of the whole run up to that benchmark.
+*/
+
+std::vector<benchmark_case> &benchmark_registry()
+{
+	static std::vector<benchmark_case> s_registry;
+	return s_registry;
+}
+
+struct benchmark_result
+{
+	benchmark_result() : ok(false), steps(0), peak_rss_kb(0) { }
+
+	bool ok;
+	std::string error;
+	size_t steps;
+	std::vector<double> seconds;
+	long peak_rss_kb;
+
+	double min_time() const { return seconds.empty() ? 0.0 : *std::min_element(seconds.begin(), seconds.end()); }
+	double max_time() const { return seconds.empty() ? 0.0 : *std::max_element(seconds.begin(), seconds.end()); }
+	double mean_time() const
+	{
+		double sum = 0;
+		for (size_t i = 0; i < seconds.size(); i++)
+			sum += seconds[i];
+		return seconds.empty() ? 0.0 : sum / seconds.size();
+	}
+	double steps_per_second() const
+	{
+		double t = mean_time();
+		return t > 0 ? steps / t : 0.0;
+	}
+};
+
+static void run_case(const benchmark_case &bc, int repetitions, benchmark_result &r)
+{
+	r.ok = true;
+	for (int rep = 0; rep < repetitions; rep++)
+	{
+		ssc_data_t data = ssc_data_create();
+		if (bc.setup(data) != 0)
+		{
+			r.ok = false;
+			r.error = "setup failed";
+			ssc_data_free(data);
+			return;
+		}
+
+		ssc_module_t mod = ssc_module_create(bc.cmod.c_str());
+		if (!mod)
+		{
+			r.ok = false;
+			r.error = "could not create module " + bc.cmod;
+			ssc_data_free(data);
+			return;
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ssc_bool_t ok = ssc_module_exec(mod, data);
+		std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+
+		if (!ok)
+		{
+			r.ok = false;
+			r.error = "simulation failed";
+			int type = 0;
+			float t = 0;
+			const char *msg = ssc_module_log(mod, 0, &type, &t);
+			if (msg)
+				r.error += std::string(": ") + msg;
+			ssc_module_free(mod);
+			ssc_data_free(data);
+			return;
+		}
+
+		int len = 0;
+		if (ssc_data_get_array(data, bc.steps_var.c_str(), &len) == 0)
+		{
+			int nr = 0, nc = 0;
+			if (ssc_data_get_matrix(data, bc.steps_var.c_str(), &nr, &nc) != 0)
+				len = nr;
+		}
+		r.steps = (size_t)len;
+		r.seconds.push_back(std::chrono::duration<double>(stop - start).count());
+
+		ssc_module_free(mod);
+		ssc_data_free(data);
+	}
+}
+
+#ifdef _WIN32
+
+static void run_isolated(const benchmark_case &bc, int repetitions, benchmark_result &r)
+{
+	run_case(bc, repetitions, r);
+
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		r.peak_rss_kb = (long)(pmc.PeakWorkingSetSize / 1024);
+}
+
+#else
+
+static void run_isolated(const benchmark_case &bc, int repetitions, benchmark_result &r)
+{
+	int fds[2];
+	if (pipe(fds) != 0)
+	{
+		r.error = "could not create pipe";
+		return;
+	}
+
+	fflush(stdout);
+	fflush(stderr);
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		r.error = "could not fork";
+		close(fds[0]);
+		close(fds[1]);
+		return;
+	}
+
+	if (pid == 0)
+	{
+		// child: run the benchmark and report "ok steps t1 t2 ..." or "error <message>"
+		close(fds[0]);
+		benchmark_result cr;
+		run_case(bc, repetitions, cr);
+		std::string msg;
+		char buf[64];
+		if (cr.ok)
+		{
+			sprintf(buf, "ok %lu", (unsigned long)cr.steps);
+			msg = buf;
+			for (size_t i = 0; i < cr.seconds.size(); i++)
+			{
+				sprintf(buf, " %.9g", cr.seconds[i]);
+				msg += buf;
+			}
+		}
+		else
+			msg = "error " + cr.error;
+
+		size_t off = 0;
+		while (off < msg.size())
+		{
+			ssize_t n = write(fds[1], msg.c_str() + off, msg.size() - off);
+			if (n <= 0) break;
+			off += (size_t)n;
+		}
+		close(fds[1]);
+		_exit(0);
+	}
+
+	close(fds[1]);
+	std::string msg;
+	char buf[4096];
+	ssize_t n;
+	while ((n = read(fds[0], buf, sizeof(buf))) > 0)
+		msg.append(buf, (size_t)n);
+	close(fds[0]);
+
+	int status = 0;
+	struct rusage ru;
+	memset(&ru, 0, sizeof(ru));
+	wait4(pid, &status, 0, &ru);
+
+#ifdef __APPLE__
+	r.peak_rss_kb = (long)(ru.ru_maxrss / 1024); // bytes on macOS
+#else
+	r.peak_rss_kb = (long)ru.ru_maxrss; // kilobytes on Linux
+#endif
+
+	if (msg.compare(0, 3, "ok ") == 0)
+	{
+		r.ok = true;
+		const char *p = msg.c_str() + 3;
+		char *end = 0;
+		r.steps = (size_t)strtoul(p, &end, 10);
+		p = end;
+		for (;;)
+		{
+			double t = strtod(p, &end);
+			if (end == p) break;
+			r.seconds.push_back(t);
+			p = end;
+		}
+	}
+	else if (msg.compare(0, 6, "error ") == 0)
+		r.error = msg.substr(6);
+	else
+		r.error = "benchmark process terminated abnormally";
+}
+
+#endif
+
+static std::string json_escape(const std::string &s)
+{
+	std::string out;
+	for (size_t i = 0; i < s.size(); i++)
+	{
+		char c = s[i];
+		if (c == '"' || c == '\\') { out += '\\'; out += c; }
+		else if (c == '\n') out += "\\n";
+		else if ((unsigned char)c < 0x20) out += ' ';
+		else out += c;
+	}
+	return out;
+}
+
+static void write_console(FILE *fp, const std::vector<benchmark_case> &cases, const std::vector<benchmark_result> &results)
+{
+	fprintf(fp, "%-32s %12s %12s %12s %14s %12s\n", "Benchmark", "Mean (ms)", "Min (ms)", "Steps", "Steps/s", "Peak RSS (MB)");
+	fprintf(fp, "%s\n", std::string(100, '-').c_str());
+	for (size_t i = 0; i < cases.size(); i++)
+	{
+		const benchmark_result &r = results[i];
+		if (r.ok)
+			fprintf(fp, "%-32s %12.1f %12.1f %12lu %14.0f %12.1f\n", cases[i].name.c_str(),
+				r.mean_time()*1000.0, r.min_time()*1000.0, (unsigned long)r.steps, r.steps_per_second(), r.peak_rss_kb / 1024.0);
+		else
+			fprintf(fp, "%-32s ERROR: %s\n", cases[i].name.c_str(), r.error.c_str());
+	}
+}
+
+static void write_json(FILE *fp, const std::vector<benchmark_case> &cases, const std::vector<benchmark_result> &results, int repetitions)
+{
+	char date[64];
+	time_t now = time(0);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"context\": {\n");
+	fprintf(fp, "    \"date\": \"%s\",\n", date);
+	fprintf(fp, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+	fprintf(fp, "    \"ssc_version\": %d,\n", ssc_version());
+	fprintf(fp, "    \"ssc_build_info\": \"%s\",\n", json_escape(ssc_build_info()).c_str());
+	fprintf(fp, "    \"repetitions\": %d\n", repetitions);
+	fprintf(fp, "  },\n");
+	fprintf(fp, "  \"benchmarks\": [");
+	for (size_t i = 0; i < cases.size(); i++)
+	{
+		const benchmark_result &r = results[i];
+		fprintf(fp, "%s\n    {\n", i > 0 ? "," : "");
+		fprintf(fp, "      \"name\": \"%s\",\n", json_escape(cases[i].name).c_str());
+		fprintf(fp, "      \"cmod\": \"%s\",\n", json_escape(cases[i].cmod).c_str());
+		if (!r.ok)
+		{
+			fprintf(fp, "      \"error_occurred\": true,\n");
+			fprintf(fp, "      \"error_message\": \"%s\"\n", json_escape(r.error).c_str());
+		}
+		else
+		{
+			fprintf(fp, "      \"repetitions\": %d,\n", (int)r.seconds.size());
+			fprintf(fp, "      \"steps\": %lu,\n", (unsigned long)r.steps);
+			fprintf(fp, "      \"real_time_mean\": %.6f,\n", r.mean_time());
+			fprintf(fp, "      \"real_time_min\": %.6f,\n", r.min_time());
+			fprintf(fp, "      \"real_time_max\": %.6f,\n", r.max_time());
+			fprintf(fp, "      \"time_unit\": \"s\",\n");
+			fprintf(fp, "      \"steps_per_second\": %.1f,\n", r.steps_per_second());
+			fprintf(fp, "      \"peak_rss_kb\": %ld\n", r.peak_rss_kb);
+		}
+		fprintf(fp, "    }");
+	}
+	fprintf(fp, "\n  ]\n}\n");
+}
+
+static void usage()
+{
+	printf("usage: Benchmark [--filter=<substring>] [--repetitions=<n>] [--format=console|json] [--out=<file>] [--list]\n");
+}
+
+int main(int argc, char **argv)
+{
+	std::string filter, format("console"), out;
+	int repetitions = 3;
+	bool list = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg.compare(0, 9, "--filter=") == 0) filter = arg.substr(9);
+		else if (arg.compare(0, 14, "--repetitions=") == 0) repetitions = atoi(arg.substr(14).c_str());
+		else if (arg.compare(0, 9, "--format=") == 0) format = arg.substr(9);
+		else if (arg.compare(0, 6, "--out=") == 0) out = arg.substr(6);
+		else if (arg == "--list") list = true;
+		else
+		{
+			usage();
+			return 1;
+		}
+	}
+
+	if (repetitions < 1 || (format != "console" && format != "json"))
+	{
+		usage();
+		return 1;
+	}
+
+	std::vector<benchmark_case> cases;
+	std::vector<benchmark_case> &all = benchmark_registry();
+	for (size_t i = 0; i < all.size(); i++)
+		if (filter.empty() || all[i].name.find(filter) != std::string::npos)
+			cases.push_back(all[i]);
+
+	if (list)
+	{
+		for (size_t i = 0; i < cases.size(); i++)
+			printf("%s\n", cases[i].name.c_str());
+		return 0;
+	}
+
+	if (!getenv("SSCDIR"))
+	{
+		fprintf(stderr, "error: the SSCDIR environment variable must point to the ssc source tree (input files are read from $SSCDIR/test)\n");
+		return 1;
+	}
+
+	ssc_module_exec_set_print(0);
+
+	std::vector<benchmark_result> results(cases.size());
+	int nfail = 0;
+	for (size_t i = 0; i < cases.size(); i++)
+	{
+		fprintf(stderr, "running %s...\n", cases[i].name.c_str());
+		run_isolated(cases[i], repetitions, results[i]);
+		if (!results[i].ok)
+			nfail++;
+	}
+
+	FILE *fp = stdout;
+	if (!out.empty())
+	{
+		fp = fopen(out.c_str(), "w");
+		if (!fp)
+		{
+			fprintf(stderr, "error: could not open %s for writing\n", out.c_str());
+			return 1;
+		}
+	}
+
+	if (format == "json")
+		write_json(fp, cases, results, repetitions);
+	else
+		write_console(fp, cases, results);
+
+	if (fp != stdout)
+		fclose(fp);
+
+	return nfail > 0 ? 1 : 0;
+}
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include "sscapi.h"
 #include <string>
+#include <map>
 #include <type_traits>
 
 static ssc_bool_t my_handler(ssc_module_t p_mod, ssc_handler_t p_handler, int action,
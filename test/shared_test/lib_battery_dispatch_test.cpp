@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "lib_battery_dispatch_test.h"
+
+/// Optimized front of meter dispatch charges from the grid at the low price, discharges at the high price, and stays within the state of charge limits
+TEST_F(BatteryDispatchTest, FOMOptimizedPriceSignal_lib_battery_dispatch)
+{
+	double tolerance = 0.01;
+	double energyCharged = 0, energyDischarged = 0;
+	for (size_t hour = 0; hour != 48; hour++)
+	{
+		dispatch->dispatch(0, hour, 0, 0, 0, 0, 0);
+		double powerBattery = dispatch->getBatteryPower()->powerBattery;
+		double SOC = batteryModel->battery_soc();
+		bool isPeak = hour % 24 >= 16 && hour % 24 < 20;
+
+		if (isPeak)
+			EXPECT_GE(powerBattery, -tolerance) << "Charging at the high price, hour " << hour;
+		else
+			EXPECT_LE(powerBattery, tolerance) << "Discharging at the low price, hour " << hour;
+		EXPECT_GE(SOC, SOC_min - tolerance) << "hour " << hour;
+		EXPECT_LE(SOC, SOC_max + tolerance) << "hour " << hour;
+
+		if (hour >= 24)
+		{
+			if (isPeak)
+				energyDischarged += powerBattery * dtHour;
+			else
+				energyCharged -= powerBattery * dtHour;
+		}
+
+		// full before the high price period, empty after it
+		if (hour == 39)
+			EXPECT_GT(SOC, SOC_max - 2) << "hour " << hour;
+		if (hour == 43)
+			EXPECT_LT(SOC, SOC_min + 2) << "hour " << hour;
+	}
+	EXPECT_GT(energyCharged, 5.);
+	EXPECT_GT(energyDischarged, 5.);
+}
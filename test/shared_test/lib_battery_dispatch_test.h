@@ -0,0 +1,92 @@
+#ifndef __LIB_BATTERY_DISPATCH_TEST_H__
+#define __LIB_BATTERY_DISPATCH_TEST_H__
+
+#include <gtest/gtest.h>
+#include <lib_battery.h>
+#include <lib_battery_dispatch.h>
+
+/**
+*   BatteryDispatchTest sets up a 10 kWh, 5 kW lithium ion battery with no lifetime or thermal capacity fade,
+*   and a front of meter dispatch that may only charge from the grid, for a PPA price that is four times
+*   higher from 4 pm to 8 pm than the rest of the day
+*/
+class BatteryDispatchTest : public ::testing::Test
+{
+protected:
+	capacity_lithium_ion_t * capacityModel;
+	voltage_dynamic_t * voltageModel;
+	lifetime_cycle_t * lifetimeCycleModel;
+	lifetime_calendar_t * lifetimeCalendarModel;
+	lifetime_t * lifetimeModel;
+	thermal_t * thermalModel;
+	losses_t * lossModel;
+	battery_t * batteryModel;
+	dispatch_automatic_front_of_meter_t * dispatch;
+
+	double dtHour;
+	double SOC_min;
+	double SOC_max;
+	double powerMax;
+	std::vector<double> ppaFactors;
+
+public:
+
+	void SetUp()
+	{
+		dtHour = 1;
+		SOC_min = 10;
+		SOC_max = 95;
+		powerMax = 5;
+
+		util::matrix_t<double> cycleTable(2, 3);
+		cycleTable.at(0, 0) = 100; cycleTable.at(0, 1) = 0; cycleTable.at(0, 2) = 100;
+		cycleTable.at(1, 0) = 100; cycleTable.at(1, 1) = 1e6; cycleTable.at(1, 2) = 100;
+		util::matrix_t<double> calendarTable;
+		util::matrix_t<double> capacityVsTemperature(2, 2);
+		capacityVsTemperature.at(0, 0) = -20; capacityVsTemperature.at(0, 1) = 100;
+		capacityVsTemperature.at(1, 0) = 60; capacityVsTemperature.at(1, 1) = 100;
+
+		capacityModel = new capacity_lithium_ion_t(2.25 * 9, 50, SOC_max, SOC_min);
+		voltageModel = new voltage_dynamic_t(139, 9, 3.6, 4.1, 4.05, 3.4, 2.25, 0.04, 2.0, 0.2, 0.1);
+		lifetimeCycleModel = new lifetime_cycle_t(cycleTable);
+		lifetimeCalendarModel = new lifetime_calendar_t(lifetime_calendar_t::NONE, calendarTable, dtHour);
+		lifetimeModel = new lifetime_t(lifetimeCycleModel, lifetimeCalendarModel, battery_t::NO_REPLACEMENTS, 0);
+		thermalModel = new thermal_t(50, 0.5, 0.5, 0.5, 1000, 20, 298.15, capacityVsTemperature);
+		double_vec noLoss(8760, 0);
+		lossModel = new losses_t(lifetimeModel, thermalModel, capacityModel, losses_t::MONTHLY, noLoss, noLoss, noLoss, noLoss);
+		batteryModel = new battery_t(dtHour, battery_t::LITHIUM_ION);
+		batteryModel->initialize(capacityModel, voltageModel, lifetimeModel, thermalModel, lossModel);
+
+		ppaFactors.push_back(0.5);
+		ppaFactors.push_back(2.0);
+		util::matrix_t<size_t> ppaSchedule(12, 24, 1);
+		for (size_t m = 0; m != 12; m++) {
+			for (size_t h = 16; h != 20; h++)
+				ppaSchedule.at(m, h) = 2;
+		}
+
+		dispatch = new dispatch_automatic_front_of_meter_t(batteryModel, dtHour, SOC_min, SOC_max, dispatch_t::RESTRICT_POWER, 1e3, 1e3, powerMax, powerMax, 0,
+			dispatch_t::FOM_OPTIMIZED, dispatch_t::FRONT, 1, 24, 1, false, false, true, 1e3, 0, dispatch_t::INPUT_CYCLE_COST, 0.,
+			ppaFactors, ppaSchedule, ppaSchedule, NULL, 98, 95, 95);
+		dispatch->update_pv_data(double_vec(8760 + 24, 0));
+		dispatch->update_cliploss_data(double_vec(8760 + 24, 0));
+		dispatch->getBatteryPower()->connectionMode = dispatch_t::AC_CONNECTED;
+	}
+	void TearDown()
+	{
+		// the dispatch deletes its own copies of the battery, not the battery or its models
+		if (dispatch)
+			delete dispatch;
+		if (batteryModel)
+			delete batteryModel;
+		delete capacityModel;
+		delete voltageModel;
+		delete lifetimeModel;
+		delete lifetimeCycleModel;
+		delete lifetimeCalendarModel;
+		delete thermalModel;
+		delete lossModel;
+	}
+};
+
+#endif
@@ -165,4 +165,142 @@ TEST_F(LeadAcidBattery, LeadAcidCapacityUnitTest_lib_battery)
 	*/
 	
 
-}
\ No newline at end of file
+}
+TEST(LifetimeCycle, RainflowAndInterpolation_lib_battery)
+{
+	// capacity (%) vs cycles at 20, 80 and 100 % DOD
+	double table[9][3] = { { 20, 0, 100 }, { 20, 5000, 90 }, { 20, 10000, 50 },
+		{ 80, 0, 100 }, { 80, 1000, 80 }, { 80, 2000, 50 },
+		{ 100, 0, 100 }, { 100, 400, 80 }, { 100, 1000, 40 } };
+	util::matrix_t<double> lifetime_matrix(9, 3);
+	for (size_t i = 0; i < 9; i++)
+		for (size_t j = 0; j < 3; j++)
+			lifetime_matrix(i, j) = table[i][j];
+
+	lifetime_cycle_t cycle_model(lifetime_matrix);
+
+	// full cycles between 0 and 80 % DOD, one is counted at each return to 0
+	double q = 100;
+	for (int i = 0; i < 1000; i++)
+		q = cycle_model.runCycleLifetime(i % 2 ? 80 : 0);
+	EXPECT_EQ(cycle_model.cycles_elapsed(), 499);
+	EXPECT_DOUBLE_EQ(cycle_model.cycle_range(), 80);
+	EXPECT_NEAR(q, 90.02, 1e-10);
+
+	// damage for a cycle between DOD levels interpolates the 20 and 80 % curves
+	EXPECT_NEAR(cycle_model.computeCycleDamageAtDOD(50), q - (99 + 90) / 2., 1e-10);
+
+	// above the highest level uses the highest level
+	EXPECT_NEAR(cycle_model.computeCycleDamageAtDOD(100), q - (80 - 40 * 100 / 600.), 1e-10);
+
+	cycle_model.replaceBattery();
+	EXPECT_EQ(cycle_model.cycles_elapsed(), 0);
+	EXPECT_DOUBLE_EQ(cycle_model.runCycleLifetime(0), 100);
+}
+
+/**
+*   BatteryStack builds a battery with cycle and calendar fade, a thermal model and a dynamic voltage model,
+*   using a KiBaM capacity model for lead acid and the lithium ion capacity model otherwise
+*/
+class BatteryStack
+{
+public:
+	capacity_t * capacityModel;
+	voltage_dynamic_t * voltageModel;
+	lifetime_cycle_t * lifetimeCycleModel;
+	lifetime_calendar_t * lifetimeCalendarModel;
+	lifetime_t * lifetimeModel;
+	thermal_t * thermalModel;
+	losses_t * lossModel;
+	battery_t * batteryModel;
+
+	BatteryStack(int chemistry)
+	{
+		double table[6][3] = { { 20, 0, 100 }, { 20, 5000, 90 }, { 20, 10000, 50 },
+			{ 80, 0, 100 }, { 80, 1000, 80 }, { 80, 2000, 50 } };
+		util::matrix_t<double> cycleTable(6, 3);
+		for (size_t i = 0; i < 6; i++)
+			for (size_t j = 0; j < 3; j++)
+				cycleTable(i, j) = table[i][j];
+		util::matrix_t<double> capacityVsTemperature(3, 2);
+		capacityVsTemperature.at(0, 0) = -10; capacityVsTemperature.at(0, 1) = 60;
+		capacityVsTemperature.at(1, 0) = 0; capacityVsTemperature.at(1, 1) = 80;
+		capacityVsTemperature.at(2, 0) = 25; capacityVsTemperature.at(2, 1) = 100;
+
+		if (chemistry == battery_t::LEAD_ACID)
+			capacityModel = new capacity_kibam_t(415, 5, 340, 374, 100, 100, 20);
+		else
+			capacityModel = new capacity_lithium_ion_t(2.25 * 9, 50, 95, 10);
+		voltageModel = new voltage_dynamic_t(139, 9, 3.6, 4.1, 4.05, 3.4, 2.25, 0.04, 2.0, 0.2, 0.1);
+		lifetimeCycleModel = new lifetime_cycle_t(cycleTable);
+		lifetimeCalendarModel = new lifetime_calendar_t(lifetime_calendar_t::LITHIUM_ION_CALENDAR_MODEL, util::matrix_t<double>(), 1);
+		lifetimeModel = new lifetime_t(lifetimeCycleModel, lifetimeCalendarModel, battery_t::NO_REPLACEMENTS, 0);
+		thermalModel = new thermal_t(50, 0.5, 0.5, 0.5, 1000, 20, 283.15, capacityVsTemperature);
+		double_vec noLoss(8760, 0);
+		lossModel = new losses_t(lifetimeModel, thermalModel, capacityModel, losses_t::MONTHLY, noLoss, noLoss, noLoss, noLoss);
+		batteryModel = new battery_t(1, chemistry);
+		batteryModel->initialize(capacityModel, voltageModel, lifetimeModel, thermalModel, lossModel);
+	}
+	~BatteryStack()
+	{
+		delete batteryModel;
+		delete capacityModel;
+		delete voltageModel;
+		delete lifetimeModel;
+		delete lifetimeCycleModel;
+		delete lifetimeCalendarModel;
+		delete thermalModel;
+		delete lossModel;
+	}
+
+	// values that depend on the state of every model
+	std::vector<double> outputs()
+	{
+		std::vector<double> values;
+		values.push_back(batteryModel->battery_soc());
+		values.push_back(batteryModel->battery_charge_total());
+		values.push_back(batteryModel->battery_charge_maximum());
+		values.push_back(batteryModel->battery_charge_maximum_thermal());
+		values.push_back(batteryModel->capacity_model()->I());
+		values.push_back(batteryModel->capacity_model()->I_loss());
+		values.push_back(batteryModel->capacity_model()->q1());
+		values.push_back(batteryModel->capacity_model()->prev_DOD());
+		values.push_back(batteryModel->battery_voltage());
+		values.push_back(batteryModel->thermal_model()->T_battery());
+		values.push_back(batteryModel->lifetime_model()->capacity_percent());
+		values.push_back(batteryModel->lifetime_model()->cycleModel()->cycles_elapsed());
+		values.push_back(batteryModel->lifetime_model()->cycleModel()->cycle_range());
+		return values;
+	}
+};
+
+/// A battery restored from a saved state after running a step behaves bit for bit like one that never ran it
+TEST(BatteryState, SaveStepRestore_lib_battery)
+{
+	int chemistries[2] = { battery_t::LITHIUM_ION, battery_t::LEAD_ACID };
+	for (int c = 0; c < 2; c++)
+	{
+		BatteryStack reference(chemistries[c]), restored(chemistries[c]);
+		battery_state state;
+
+		// daily cycles of different depth, with the current limited by the capacity model near the SOC limits
+		for (size_t hour = 0; hour < 24 * 20; hour++)
+		{
+			double I = (hour % 24 < 10 ? -1. : 1.) * (4. + (hour / 24) % 5);
+			double I_trial = -2 * I;
+
+			restored.batteryModel->save_state(state);
+			restored.batteryModel->run(hour, I_trial);
+			restored.batteryModel->restore_state(state);
+
+			reference.batteryModel->run(hour, I);
+			restored.batteryModel->run(hour, I);
+
+			std::vector<double> expected = reference.outputs(), actual = restored.outputs();
+			for (size_t i = 0; i < expected.size(); i++)
+				ASSERT_EQ(expected[i], actual[i]) << "chemistry " << chemistries[c] << " hour " << hour << " output " << i;
+		}
+		EXPECT_GT(reference.outputs()[11], 5) << "cycles counted, chemistry " << chemistries[c];
+		EXPECT_LT(reference.outputs()[10], 100) << "capacity faded, chemistry " << chemistries[c];
+	}
+}
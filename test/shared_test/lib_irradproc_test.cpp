@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <math.h>
 #include <gtest/gtest.h>
 
 #include "lib_irradproc.h"
@@ -577,4 +578,153 @@ TEST_F(SunsetCaseIrradProc, CalcTestRadMode0_lib_irradproc){
 	printf("poa: %f, %f, %f, %f, %f, %f \n", poa_p[0], poa_p[1], poa_p[2], poa_p[3], poa_p[4], poa_p[5]);
 	printf("irrad: %f, %f, %f \n", &rad_p[0], &rad_p[1], &rad_p[2]);
 	*/
-}
\ No newline at end of file
+}
+
+/// Runs irrad::calc at each step of the series and compares against irrad_batch, returning the number of steps that differ
+static int compare_batch_to_scalar(irrad_batch &batch, const irrad_timeseries &ts, int radmode, int skymodel, int tracking, double tilt, double azim, double rotlim, bool backtrack_on, double gcr, double lat, double lon, double tz, double delt, double e)
+{
+	int nfail = 0;
+	for (size_t i = 0; i < ts.size(); i++){
+		irrad irr;
+		irr.set_time(ts.year[i], ts.month[i], ts.day[i], ts.hour[i], ts.minute[i], delt);
+		irr.set_location(lat, lon, tz);
+		irr.set_sky_model(skymodel, ts.alb[i]);
+		if (radmode == DN_DF) irr.set_beam_diffuse(ts.dn[i], ts.df[i]);
+		else if (radmode == DN_GH) irr.set_global_beam(ts.gh[i], ts.dn[i]);
+		else irr.set_global_diffuse(ts.gh[i], ts.df[i]);
+		irr.set_surface(tracking, ts.tilt.empty() ? tilt : ts.tilt[i], azim, rotlim, backtrack_on, gcr);
+		int code = irr.calc();
+
+		double solazi, solzen, solalt, aoi, stilt, sazi, rot, btd, ibeam, iskydiff, ignddiff;
+		int sunup;
+		irr.get_sun(&solazi, &solzen, &solalt, 0, 0, 0, &sunup, 0, 0, 0);
+		irr.get_angles(&aoi, &stilt, &sazi, &rot, &btd);
+		irr.get_poa(&ibeam, &iskydiff, &ignddiff, 0, 0, 0);
+
+		bool same = code == batch.status[i] && sunup == batch.sunup[i]
+			&& fabs(solazi - batch.solazi[i]) < e && fabs(solzen - batch.solzen[i]) < e && fabs(solalt - batch.solalt[i]) < e
+			&& fabs(irr.get_sunpos_calc_hour() - batch.sunpos_hour[i]) < e
+			&& fabs(aoi - batch.aoi[i]) < e && fabs(stilt - batch.stilt[i]) < e && fabs(sazi - batch.sazi[i]) < e
+			&& fabs(rot - batch.rot[i]) < e && fabs(btd - batch.btd[i]) < e
+			&& fabs(ibeam - batch.poa_beam[i]) < e && fabs(iskydiff - batch.poa_skydiff[i]) < e && fabs(ignddiff - batch.poa_gnddiff[i]) < e;
+		if (!same) nfail++;
+	}
+	return nfail;
+}
+
+TEST_F(IrradTest, batchMatchesScalar_lib_irradproc){
+	// one year of synthetic irradiance at 30 minute steps
+	size_t step_per_hour = 2;
+	irrad_timeseries ts;
+	ts.resize(8760 * step_per_hour);
+	int nday[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	size_t idx = 0;
+	for (int m = 1; m <= 12; m++){
+		for (int d = 1; d <= nday[m - 1]; d++){
+			for (int h = 0; h < 24; h++){
+				for (size_t jj = 0; jj < step_per_hour; jj++){
+					double t = h + jj / (double)step_per_hour;
+					double clear = sin(M_PI * (t - 5) / 15);
+					ts.year[idx] = year;
+					ts.month[idx] = m;
+					ts.day[idx] = d;
+					ts.hour[idx] = h;
+					ts.minute[idx] = 60.0 * jj / step_per_hour;
+					ts.dn[idx] = clear > 0 ? 850 * clear * (0.6 + 0.4 * cos(d)) : 0;
+					ts.df[idx] = clear > 0 ? 120 * clear : 0;
+					ts.gh[idx] = clear > 0 ? ts.df[idx] + 0.9 * ts.dn[idx] * clear : 0;
+					ts.alb[idx] = (m < 3 || m > 11) ? 0.6 : alb;
+					idx++;
+				}
+			}
+		}
+	}
+	ASSERT_EQ(idx, ts.size());
+
+	int radmodes[3] = { DN_DF, DN_GH, GH_DF };
+	int trackmodes[4] = { 0, 1, 2, 3 };
+	for (int r = 0; r < 3; r++){
+		for (int s = 0; s <= 2; s++){
+			for (int t = 0; t < 4; t++){
+				bool bt = (trackmodes[t] == 1);
+				double rl = (trackmodes[t] == 1) ? 45 : rotlim;
+				double g = (trackmodes[t] == 1) ? 0.4 : gcr;
+				irrad_batch batch;
+				batch.set_location(lat, lon, tz);
+				batch.set_sky_model(s);
+				batch.set_radmode(radmodes[r]);
+				batch.set_surface(trackmodes[t], tilt, azim, rl, bt, g);
+				batch.set_time_step(1.0 / step_per_hour);
+				ASSERT_EQ(batch.calc(ts), 0);
+				EXPECT_EQ(compare_batch_to_scalar(batch, ts, radmodes[r], s, trackmodes[t], tilt, azim, rl, bt, g, lat, lon, tz, 1.0 / step_per_hour, e), 0)
+					<< "radmode " << radmodes[r] << ", sky model " << s << ", tracking " << trackmodes[t];
+			}
+		}
+	}
+
+	// instantaneous values with a timeseries tilt
+	ts.tilt.resize(ts.size());
+	for (size_t i = 0; i < ts.size(); i++)
+		ts.tilt[i] = 10 + 5 * ts.month[i];
+	irrad_batch batch;
+	batch.set_location(lat, lon, tz);
+	batch.set_sky_model(skymodel);
+	batch.set_radmode(DN_DF);
+	batch.set_surface(4, tilt, azim, rotlim, backtrack_on, gcr);
+	batch.set_time_step(IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET);
+	ASSERT_EQ(batch.calc(ts), 0);
+	EXPECT_EQ(compare_batch_to_scalar(batch, ts, DN_DF, skymodel, 4, tilt, azim, rotlim, backtrack_on, gcr, lat, lon, tz, IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET, e), 0);
+
+	// out of range input is reported per step with the irrad::calc code
+	ts.dn[100] = 2000;
+	ASSERT_EQ(batch.calc(ts), 0);
+	EXPECT_EQ(batch.status[100], -105);
+}
+
+TEST_F(IrradTest, solarposCache_lib_irradproc){
+	// one day at 10 minute steps
+	vector<int> yr, mn, dy, hr;
+	vector<double> min;
+	for (int h = 0; h < 24; h++){
+		for (int m = 0; m < 60; m += 10){
+			yr.push_back(year);
+			mn.push_back(month);
+			dy.push_back(day);
+			hr.push_back(h);
+			min.push_back(m);
+		}
+	}
+
+	solarpos_cache cache(1024 * 1024);
+	shared_ptr<const solarpos_table> t = cache.get(lat, lon, tz, yr, mn, dy, hr, min);
+	ASSERT_EQ(t->size(), yr.size());
+	double sunn[9];
+	for (size_t i = 0; i < yr.size(); i++){
+		solarpos(yr[i], mn[i], dy[i], hr[i], min[i], lat, lon, tz, sunn);
+		for (int k = 0; k < 9; k++)
+			EXPECT_EQ(t->sun[k][i], sunn[k]) << "step " << i << ", sun parameter " << k;
+	}
+
+	// same site and time grid is shared, a different site is not
+	EXPECT_EQ(cache.get(lat, lon, tz, yr, mn, dy, hr, min), t);
+	shared_ptr<const solarpos_table> t2 = cache.get(lat + 1, lon, tz, yr, mn, dy, hr, min);
+	EXPECT_NE(t2, t);
+	EXPECT_EQ(cache.count(), 2u);
+	EXPECT_EQ(cache.bytes(), t->bytes() + t2->bytes());
+
+	// least recently used table is released first
+	cache.get(lat, lon, tz, yr, mn, dy, hr, min);
+	cache.set_capacity(t->bytes());
+	EXPECT_EQ(cache.count(), 1u);
+	EXPECT_EQ(cache.get(lat, lon, tz, yr, mn, dy, hr, min), t);
+
+	// tables still in use stay valid after being released from the cache
+	cache.clear();
+	EXPECT_EQ(cache.count(), 0u);
+	EXPECT_EQ(t2->size(), yr.size());
+
+	// caching disabled
+	cache.set_capacity(0);
+	EXPECT_NE(cache.get(lat, lon, tz, yr, mn, dy, hr, min), t);
+	EXPECT_EQ(cache.count(), 0u);
+}
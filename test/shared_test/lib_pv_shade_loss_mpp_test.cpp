@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+
+#include "lib_pv_shade_loss_mpp.h"
+#include "lib_util.h"
+
+/**
+ * The decoded shading database is shared by all ShadeDB8_mpp instances, and a pre-decoded file
+ * written from it maps to the same tables.
+ */
+
+static std::vector<double> sample_vectors(ShadeDB8_mpp &db)
+{
+	std::vector<double> v;
+	for (size_t N = 1; N <= 8; N++)
+	{
+		std::vector<double> vmpp = db.get_vector(N, 5, 7, 1, ShadeDB8_mpp::VMPP);
+		std::vector<double> impp = db.get_vector(N, 3, 10, 1, ShadeDB8_mpp::IMPP);
+		v.insert(v.end(), vmpp.begin(), vmpp.end());
+		v.insert(v.end(), impp.begin(), impp.end());
+	}
+	return v;
+}
+
+TEST(libPvShadeLossMppTests, SharedDatabase)
+{
+	ShadeDB8_mpp db1, db2;
+	db1.init();
+	db2.init();
+	ASSERT_TRUE(db1.get_error().empty());
+	std::vector<double> v1 = sample_vectors(db1);
+	ASSERT_EQ(v1.size(), 8 * 16);
+	EXPECT_EQ(v1, sample_vectors(db2));
+
+	// instances keep the tables alive after the process-wide reference is dropped
+	ShadeDB8_mpp::release_shared_data();
+	EXPECT_EQ(v1, sample_vectors(db1));
+}
+
+TEST(libPvShadeLossMppTests, DecodedFile)
+{
+	std::string file = "shade_db8_test.bin";
+	remove(file.c_str());
+
+	ShadeDB8_mpp::release_shared_data();
+	ShadeDB8_mpp inflated;
+	inflated.init(file);
+	ASSERT_TRUE(inflated.get_error().empty());
+	ASSERT_TRUE(util::file_exists(file.c_str()));
+
+	ShadeDB8_mpp::release_shared_data();
+	ShadeDB8_mpp mapped;
+	mapped.init(file);
+	ASSERT_TRUE(mapped.get_error().empty());
+	EXPECT_TRUE(mapped.get_warning().empty());
+	EXPECT_EQ(sample_vectors(inflated), sample_vectors(mapped));
+
+	ShadeDB8_mpp::release_shared_data();
+	remove(file.c_str());
+}
+
+TEST(libPvShadeLossMppTests, DecodedFileAfterBuiltIn)
+{
+	// a decoded file given after the built-in database is already shared is still written and mapped
+	std::string file = "shade_db8_test2.bin";
+	remove(file.c_str());
+
+	ShadeDB8_mpp::release_shared_data();
+	ShadeDB8_mpp builtin;
+	builtin.init();
+	ASSERT_TRUE(builtin.get_error().empty());
+
+	ShadeDB8_mpp written;
+	written.init(file);
+	ASSERT_TRUE(written.get_error().empty());
+	ASSERT_TRUE(util::file_exists(file.c_str()));
+
+	ShadeDB8_mpp::release_shared_data();
+	ShadeDB8_mpp mapped;
+	mapped.init(file);
+	ASSERT_TRUE(mapped.get_error().empty());
+	EXPECT_TRUE(mapped.get_warning().empty());
+	EXPECT_EQ(sample_vectors(builtin), sample_vectors(mapped));
+
+	ShadeDB8_mpp::release_shared_data();
+	remove(file.c_str());
+}
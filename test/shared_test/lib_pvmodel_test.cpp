@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+#include "lib_pvmodel.h"
+#include "lib_cec6par.h"
+
+/**
+ * Checks the Lambert W single diode solutions against the iterative reference solutions for a
+ * typical 60 cell module over a range of irradiance and cell temperature.
+ */
+
+struct sd_params { double a, Il, Io, Rs, Rsh; };
+
+// CEC model operating parameters for a typical 60 cell module
+static std::vector<sd_params> operating_conditions()
+{
+	std::vector<sd_params> v;
+	for (double G = 2; G <= 1200; G *= 1.15)
+	{
+		for (double T = -20; T <= 80; T += 10)
+		{
+			double Tc = T + 273.15, Tref = 298.15;
+			sd_params p;
+			p.a = 1.6 * Tc / Tref;
+			p.Il = G / 1000 * (9.0 + 0.0045*(Tc - Tref));
+			p.Io = 1e-10 * pow(Tc / Tref, 3) * exp(1 / 8.618e-5 * (1.121 / Tref - 1.121*(1 - 0.0002677*(Tc - Tref)) / Tc));
+			p.Rs = 0.3;
+			p.Rsh = 300 * 1000 / G;
+			v.push_back(p);
+		}
+	}
+	return v;
+}
+
+TEST(libPvmodelTests, LambertWMatchesIterative)
+{
+	std::vector<sd_params> cond = operating_conditions();
+	for (size_t i = 0; i < cond.size(); i++)
+	{
+		const sd_params &p = cond[i];
+		double Voc = openvoltage_5par_lambertw(p.a, p.Il, p.Io, p.Rsh);
+		EXPECT_NEAR(Voc, openvoltage_5par(40, p.a, p.Il, p.Io, p.Rsh), 1e-3);
+
+		// the current at Voc is zero, and the explicit current satisfies the single diode equation
+		EXPECT_NEAR(current_5par_lambertw(Voc, p.a, p.Il, p.Io, p.Rs, p.Rsh), 0, 1e-9);
+		double V = 0.8*Voc;
+		double I = current_5par_lambertw(V, p.a, p.Il, p.Io, p.Rs, p.Rsh);
+		double Vd = V + I*p.Rs;
+		EXPECT_NEAR(p.Il - p.Io*(exp(Vd / p.a) - 1) - Vd / p.Rsh, I, 1e-9);
+		EXPECT_NEAR(I, current_5par(V, 0.9*p.Il, p.a, p.Il, p.Io, p.Rs, p.Rsh), 1e-4);
+
+		double Vmp_it, Imp_it, Vmp, Imp;
+		double Pmp_it = maxpower_5par(Voc, p.a, p.Il, p.Io, p.Rs, p.Rsh, &Vmp_it, &Imp_it);
+		double Pmp = maxpower_5par_lambertw(p.a, p.Il, p.Io, p.Rs, p.Rsh, &Vmp, &Imp);
+		EXPECT_NEAR(Pmp, Pmp_it, 1e-6*Pmp);
+		EXPECT_NEAR(Pmp, Vmp*Imp, 1e-9*Pmp);
+		EXPECT_NEAR(Vmp, Vmp_it, 1e-2);
+	}
+}
+
+TEST(libPvmodelTests, LambertWBatch)
+{
+	std::vector<sd_params> cond = operating_conditions();
+	size_t n = cond.size();
+	std::vector<double> a(n), Il(n), Io(n), Rs(n), Rsh(n), Pmp(n), Vmp(n), Imp(n), Voc(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		a[i] = cond[i].a; Il[i] = cond[i].Il; Io[i] = cond[i].Io; Rs[i] = cond[i].Rs; Rsh[i] = cond[i].Rsh;
+	}
+	maxpower_5par_lambertw(n, &a[0], &Il[0], &Io[0], &Rs[0], &Rsh[0], &Pmp[0], &Vmp[0], &Imp[0], &Voc[0]);
+	for (size_t i = 0; i < n; i++)
+	{
+		double V, I, V_oc;
+		ASSERT_EQ(Pmp[i], maxpower_5par_lambertw(a[i], Il[i], Io[i], Rs[i], Rsh[i], &V, &I, &V_oc));
+		ASSERT_EQ(Vmp[i], V);
+		ASSERT_EQ(Imp[i], I);
+		ASSERT_EQ(Voc[i], V_oc);
+	}
+}
+
+TEST(libPvmodelTests, LambertWLimits)
+{
+	// no light
+	double V, I;
+	EXPECT_EQ(openvoltage_5par_lambertw(1.6, 0, 1e-10, 300), 0);
+	EXPECT_EQ(maxpower_5par_lambertw(1.6, 0, 1e-10, 0.3, 300, &V, &I), 0);
+
+	// no series resistance: the current is explicit
+	double Id = 1e-10*(exp(30 / 1.6) - 1);
+	EXPECT_NEAR(current_5par_lambertw(30, 1.6, 9, 1e-10, 0, 300), 9 - Id - 30.0 / 300, 1e-12);
+}
+
+TEST(libPvmodelTests, Cec6parSolverModes)
+{
+	cec6par_module_t mod;
+	mod.Area = 1.6; mod.Vmp = 31; mod.Imp = 8.5; mod.Voc = 38; mod.Isc = 9;
+	mod.alpha_isc = 0.0045; mod.beta_voc = -0.12; mod.a = 1.6; mod.Il = 9.0; mod.Io = 1e-10;
+	mod.Rs = 0.3; mod.Rsh = 300; mod.Adj = 5;
+
+	pvinput_t in(800, 150, 50, 1000, 20, 10, 2, 180, 1013, 30, 20, 100, 30, 180, 12, 3, true);
+	pvoutput_t out_lw, out_it;
+	ASSERT_TRUE(mod(in, 45, -1, out_lw));
+	mod.SolverMode = SINGLEDIODE_ITERATIVE;
+	ASSERT_TRUE(mod(in, 45, -1, out_it));
+	EXPECT_NEAR(out_lw.Power, out_it.Power, 1e-6*out_it.Power);
+	EXPECT_NEAR(out_lw.Voc_oper, out_it.Voc_oper, 1e-3);
+
+	mod.SolverMode = SINGLEDIODE_LAMBERTW;
+	ASSERT_TRUE(mod(in, 45, 25, out_lw));
+	mod.SolverMode = SINGLEDIODE_ITERATIVE;
+	ASSERT_TRUE(mod(in, 45, 25, out_it));
+	EXPECT_NEAR(out_lw.Current, out_it.Current, 1e-4);
+}
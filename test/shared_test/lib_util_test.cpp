@@ -13,4 +13,34 @@ TEST(libUtilTests, testFormat)
 	str = "query point (301.3, 10.4) is too far out of convex hull of data (dist=4.3)... estimating value from 5 parameter modele at (2.2, 2.1)=2.4";
 	ASSERT_EQ(util::format("query point (%lg, %lg) is too far out of convex hull of data (dist=%lg)... estimating value from 5 parameter modele at (%lg, %lg)=%lg",
 		301.3, 10.4, 4.3, 2.2, 2.1, 2.4), str);
-}
\ No newline at end of file
+}
+TEST(libUtilTests, testMatrixMove)
+{
+	util::matrix_t<double> a(3, 4, 2.5);
+	double *buf = a.data();
+
+	// moving hands over the buffer without copying it
+	util::matrix_t<double> b(std::move(a));
+	ASSERT_EQ(b.data(), buf);
+	ASSERT_EQ(b.nrows(), 3);
+	ASSERT_EQ(b.ncols(), 4);
+	ASSERT_EQ(a.ncells(), 0);
+
+	util::matrix_t<double> c;
+	c = std::move(b);
+	ASSERT_EQ(c.data(), buf);
+	ASSERT_EQ(c.at(2, 3), 2.5);
+
+	// copying a moved-from matrix leaves the target empty rather than reading freed storage
+	util::matrix_t<double> d(2, 2, 1.0);
+	d = b;
+	ASSERT_EQ(d.ncells(), 0);
+
+	// a buffer handed over with assign_owned is used in place
+	double *owned = new double[5];
+	for (size_t i = 0; i < 5; i++) owned[i] = (double)i;
+	d.assign_owned(owned, 1, 5);
+	ASSERT_EQ(d.data(), owned);
+	ASSERT_EQ(d.length(), 5);
+	ASSERT_EQ(d[4], 4.0);
+}
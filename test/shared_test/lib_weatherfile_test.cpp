@@ -129,6 +129,39 @@ TEST_F(CSVCase_WeatherfileTest, readTest){
 	EXPECT_EQ(wf.get_counter_value(), 1);
 }
 
+/// Test that a binary weather file reproduces the header and every record of its source
+TEST_F(CSVCase_WeatherfileTest, binaryRoundTrip_lib_weatherfile){
+	std::string binfile = "weather-noRHum.wfbin";
+	ASSERT_TRUE(weatherfile::convert_to_binary(file, binfile));
+
+	weatherfile bin;
+	ASSERT_TRUE(bin.open(binfile)) << bin.message();
+	EXPECT_EQ(bin.type(), wf.type());
+	EXPECT_EQ(bin.header().city, wf.header().city);
+	EXPECT_EQ(bin.header().location, wf.header().location);
+	EXPECT_NEAR(bin.header().lat, wf.header().lat, e);
+	EXPECT_NEAR(bin.header().tz, wf.header().tz, e);
+	EXPECT_EQ(bin.start_sec(), wf.start_sec());
+	EXPECT_EQ(bin.step_sec(), wf.step_sec());
+	ASSERT_EQ(bin.nrecords(), wf.nrecords());
+	for (size_t k = 0; k < weatherfile::_MAXCOL_; k++)
+		EXPECT_EQ(bin.has_data_column(k), wf.has_data_column(k)) << "column " << k;
+
+	weather_record r, rb;
+	for (size_t i = 0; i < wf.nrecords(); i++){
+		ASSERT_TRUE(wf.read(&r));
+		ASSERT_TRUE(bin.read(&rb));
+		EXPECT_EQ(rb.hour, r.hour) << "record " << i;
+		EXPECT_EQ(rb.day, r.day) << "record " << i;
+		EXPECT_NEAR(rb.dn, r.dn, e) << "record " << i;
+		EXPECT_NEAR(rb.tdry, r.tdry, e) << "record " << i;
+		EXPECT_EQ(std::isnan(rb.gh), std::isnan(r.gh)) << "record " << i;
+	}
+	EXPECT_FALSE(bin.read(&rb));
+
+	remove(binfile.c_str());
+}
+
 /**
 * \class weatherdataTest
 *
@@ -250,6 +283,45 @@ TEST_F(Data8760CaseWeatherData, readTest_lib_weatherfile){
 	// are not assigned but are NULL
 }
 
+static bool same_value(double a, double b){
+	return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+TEST_F(Data8760CaseWeatherData, borrowArraysTest_lib_weatherfile){
+	weatherdata copied(input);
+	weatherdata borrowed(input, true);
+	EXPECT_FALSE(borrowed.has_message()) << "Error message was found:" << borrowed.message();
+
+	weather_record a, b;
+	for (size_t i = 0; i < 8760; i++){
+		ASSERT_TRUE(copied.read(&a));
+		ASSERT_TRUE(borrowed.read(&b));
+		EXPECT_EQ(a.year, b.year);
+		EXPECT_EQ(a.month, b.month);
+		EXPECT_EQ(a.day, b.day);
+		EXPECT_EQ(a.hour, b.hour);
+		EXPECT_TRUE(same_value(a.minute, b.minute) && same_value(a.gh, b.gh) && same_value(a.dn, b.dn)
+			&& same_value(a.df, b.df) && same_value(a.poa, b.poa) && same_value(a.wspd, b.wspd)
+			&& same_value(a.wdir, b.wdir) && same_value(a.tdry, b.tdry) && same_value(a.twet, b.twet)
+			&& same_value(a.tdew, b.tdew) && same_value(a.rhum, b.rhum) && same_value(a.pres, b.pres)
+			&& same_value(a.snow, b.snow) && same_value(a.alb, b.alb) && same_value(a.aod, b.aod)) << "record " << i;
+	}
+	EXPECT_FALSE(borrowed.read(&b));
+
+	// full length arrays are read in place, short ones are copied
+	input->table.lookup("dn")->num.data()[5] = 100;
+	input->table.lookup("month")->num.data()[0] = 7;
+	borrowed.set_counter_to(0);
+	EXPECT_TRUE(borrowed.read(&b));
+	EXPECT_EQ(b.month, 1);
+	borrowed.set_counter_to(5);
+	EXPECT_TRUE(borrowed.read(&b));
+	EXPECT_NEAR(b.dn, 100, e);
+	copied.set_counter_to(5);
+	EXPECT_TRUE(copied.read(&a));
+	EXPECT_NEAR(a.dn, 0, e);
+}
+
 /// Error Case
 class Data9999CaseWeatherData : public weatherdataTest{
 protected:
@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <algorithm>
 
 #include <lib_windwatts.h>
 #include <lib_windwakemodel.h>
@@ -87,4 +89,134 @@ TEST_F(windPowerCalculatorTest, windPowerUsingWeibull_lib_windwatts){
 
 	double energyTotal = wpc.windPowerUsingWeibull(weibullK, avgSpeed, refHeight, &energy[0]); // runs method we want to test
 	EXPECT_NEAR(energyTotal, 5639180, e);
-}
\ No newline at end of file
+}
+TEST_F(windPowerCalculatorTest, windPowerUsingResourceLargeFarm_lib_windwatts){
+	// a farm larger than the old 300 turbine limit
+	nTurbines = 400;
+	distX.clear();
+	distY.clear();
+	for (int i = 0; i < nTurbines; i++){
+		distX.push_back(500. * (i % 20));
+		distY.push_back(500. * (i / 20));
+	}
+	power.resize(nTurbines);
+	thrust.resize(nTurbines);
+	eff.resize(nTurbines);
+	windSpeed.resize(nTurbines);
+	turbulenceCoeff.resize(nTurbines);
+	distDownwind.resize(nTurbines);
+	distCrosswind.resize(nTurbines);
+	wpc.nTurbines = nTurbines;
+	wpc.XCoords = distX;
+	wpc.YCoords = distY;
+
+	std::shared_ptr<fakeWakeModel> fakeWM(new fakeWakeModel());
+	wpc.InitializeModel(fakeWM);
+	int run = wpc.windPowerUsingResource(10., 180, 1.0, 25, &farmPower, &power[0], &thrust[0],
+		&eff[0], &windSpeed[0], &turbulenceCoeff[0], &distDownwind[0], &distCrosswind[0]);
+	EXPECT_EQ(run, nTurbines);
+}
+
+TEST_F(windPowerCalculatorTest, largeFarmCullingMatchesAllPairs_lib_windwatts){
+	// skipping upwind turbines out of reach of a wake must give the same results as visiting every pair, for each wake model
+	nTurbines = 330;
+	distX.clear();
+	distY.clear();
+	for (int i = 0; i < nTurbines; i++){
+		// staggered rows with irregular offsets so that many turbines sit near the crosswind edge of a wake
+		distX.push_back(400. * (i % 22) + 37. * ((i * 7) % 5) + 200. * ((i / 22) % 2));
+		distY.push_back(450. * (i / 22) + 23. * ((i * 3) % 7));
+	}
+	wpc.nTurbines = nTurbines;
+	wpc.XCoords = distX;
+	wpc.YCoords = distY;
+
+	windPowerCalculator reference;
+	reference.nTurbines = nTurbines;
+	reference.turbulenceIntensity = wpc.turbulenceIntensity;
+	reference.windTurb = &wt;
+	reference.XCoords = distX;
+	reference.YCoords = distY;
+
+	std::vector<double> refPower(nTurbines), refThrust(nTurbines), refEff(nTurbines), refWindSpeed(nTurbines), refTurbulence(nTurbines);
+	power.resize(nTurbines);
+	thrust.resize(nTurbines);
+	eff.resize(nTurbines);
+	windSpeed.resize(nTurbines);
+	turbulenceCoeff.resize(nTurbines);
+	distDownwind.resize(nTurbines);
+	distCrosswind.resize(nTurbines);
+
+	double directions[] = { 0., 37.5, 90., 181., 263.25, 315. };
+	for (int model = 0; model < 3; model++){
+		std::shared_ptr<wakeModelBase> culled, allPairs;
+		if (model == 0){
+			culled = std::make_shared<simpleWakeModel>(nTurbines, &wt);
+			allPairs = std::make_shared<simpleWakeModel>(nTurbines, &wt);
+		}
+		else if (model == 1){
+			culled = std::make_shared<parkWakeModel>(nTurbines, &wt);
+			allPairs = std::make_shared<parkWakeModel>(nTurbines, &wt);
+		}
+		else{
+			culled = std::make_shared<eddyViscosityWakeModel>(nTurbines, &wt, 0.1);
+			allPairs = std::make_shared<eddyViscosityWakeModel>(nTurbines, &wt, 0.1);
+		}
+		allPairs->setCulling(false);
+		wpc.InitializeModel(culled);
+		reference.InitializeModel(allPairs);
+
+		for (size_t d = 0; d < sizeof(directions) / sizeof(directions[0]); d++){
+			double refFarmPower = 0;
+			int refRun = reference.windPowerUsingResource(9., directions[d], 1.0, 25, &refFarmPower, &refPower[0], &refThrust[0],
+				&refEff[0], &refWindSpeed[0], &refTurbulence[0], &distDownwind[0], &distCrosswind[0]);
+			int run = wpc.windPowerUsingResource(9., directions[d], 1.0, 25, &farmPower, &power[0], &thrust[0],
+				&eff[0], &windSpeed[0], &turbulenceCoeff[0], &distDownwind[0], &distCrosswind[0]);
+			ASSERT_EQ(refRun, nTurbines) << wpc.GetWakeModelName() << " at " << directions[d] << " deg";
+			ASSERT_EQ(run, nTurbines) << wpc.GetWakeModelName() << " at " << directions[d] << " deg";
+
+			EXPECT_EQ(farmPower, refFarmPower) << wpc.GetWakeModelName() << " at " << directions[d] << " deg";
+			EXPECT_LT(*std::min_element(eff.begin(), eff.end()), 100.) << "no wake losses, " << wpc.GetWakeModelName() << " at " << directions[d] << " deg";
+			for (int i = 0; i < nTurbines; i++){
+				EXPECT_EQ(power[i], refPower[i]) << wpc.GetWakeModelName() << " turbine " << i << " at " << directions[d] << " deg";
+				EXPECT_EQ(thrust[i], refThrust[i]) << wpc.GetWakeModelName() << " turbine " << i << " at " << directions[d] << " deg";
+				EXPECT_EQ(eff[i], refEff[i]) << wpc.GetWakeModelName() << " turbine " << i << " at " << directions[d] << " deg";
+				EXPECT_EQ(windSpeed[i], refWindSpeed[i]) << wpc.GetWakeModelName() << " turbine " << i << " at " << directions[d] << " deg";
+				EXPECT_EQ(turbulenceCoeff[i], refTurbulence[i]) << wpc.GetWakeModelName() << " turbine " << i << " at " << directions[d] << " deg";
+			}
+		}
+	}
+}
+
+TEST_F(windPowerCalculatorTest, wakeResultCache_lib_windwatts){
+	// with zero tolerance the cache only interpolates where that is exact, elsewhere it falls back to the full calculation
+	nTurbines = 5;
+	wpc.nTurbines = nTurbines;
+	wpc.XCoords = { 0, 400, 800, 1200, 1600 };
+	wpc.YCoords = { 0, 100, 0, 100, 0 };
+	power.resize(nTurbines);
+	thrust.resize(nTurbines);
+	eff.resize(nTurbines);
+	windSpeed.resize(nTurbines);
+	turbulenceCoeff.resize(nTurbines);
+	distDownwind.resize(nTurbines);
+	distCrosswind.resize(nTurbines);
+
+	std::shared_ptr<simpleWakeModel> wakeModel(new simpleWakeModel(nTurbines, &wt));
+	wpc.InitializeModel(wakeModel);
+	wakeResultCache cache(&wpc, 5, 0.5, 0.025, 0);
+
+	size_t nLookups = 0;
+	for (double dir = 0; dir < 360; dir += 7.5){
+		for (double speed = 0; speed < 30; speed += 0.4){
+			double exact = 0, cached = 0;
+			ASSERT_EQ(wpc.windPowerUsingResource(speed, dir, 1.0, 25, &exact, &power[0], &thrust[0],
+				&eff[0], &windSpeed[0], &turbulenceCoeff[0], &distDownwind[0], &distCrosswind[0]), nTurbines);
+			ASSERT_EQ(cache.farmPower(speed, dir, 1.0, 25, &cached), nTurbines);
+			EXPECT_NEAR(cached, exact, 1e-6) << "direction " << dir << ", speed " << speed;
+			nLookups++;
+		}
+	}
+	EXPECT_GT(cache.gridPointCount(), (size_t)0);
+	EXPECT_LT(cache.fullCalculationCount(), nLookups);
+}
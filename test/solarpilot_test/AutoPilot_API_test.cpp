@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "AutoPilot_API.h"
+#include "definitions.h"
+
+/**
+*   AutoPilotOptTableTest sets up a small user-defined field of 66 heliostats north of an 80 m tower
+*   and a synthetic clear-sky weather file, and calculates the default optical efficiency table
+*   (12 azimuths x 8 zeniths, in degrees)
+*/
+class AutoPilotOptTableTest : public ::testing::Test{
+protected:
+	var_map V;
+	AutoPilot_S sapi;
+	sp_optical_table opttab;
+
+	void SetUp(){
+		V.amb.latitude.val = 34.87;
+		V.amb.longitude.val = -116.78;
+		V.amb.time_zone.val = -8;
+		V.sf.temp_which.combo_clear();
+		std::string name = "Template 1", val = "0";
+		V.sf.temp_which.combo_add_choice(name, val);
+		V.sf.temp_which.combo_select_by_choice_index(0);
+		V.sf.q_des.val = 50;
+		V.sf.tht.val = 80;
+		V.recs.front().rec_height.val = 8;
+		V.recs.front().rec_diameter.val = 7;
+
+		// staggered rows of heliostats from 60 m to 135 m north of the tower
+		char row[200];
+		for (int r = 0; r < 6; r++){
+			for (int c = -5; c <= 5; c++){
+				sprintf(row, "0,%f,%f,%f,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL;", c * 15. + (r % 2) * 7.5, 60. + r * 15., 0.);
+				V.sf.layout_data.val.append(row);
+			}
+		}
+
+		std::vector<std::string> wfdata;
+		char line[200];
+		for (int i = 0; i < 8760; i++){
+			int doy = i / 24, hr = i % 24;
+			int month = doy / 31 + 1 > 12 ? 12 : doy / 31 + 1;
+			double dni = (hr > 6 && hr < 18) ? 900 * sin(3.14159 * (hr - 6) / 12.) : 0.;
+			sprintf(line, "%d,%d,%d,%.2lf,%.1lf,%.1lf,%.1lf", doy % 28 + 1, hr, month, dni, 20., 1., 3.);
+			wfdata.push_back(line);
+		}
+		sapi.GenerateDesignPointSimulations(V, wfdata);
+		sapi.Setup(V);
+	}
+};
+
+/// Table positions are given in degrees: efficiency is nearly independent of azimuth with the sun overhead, and falls off toward the horizon
+TEST_F(AutoPilotOptTableTest, EfficiencyTable_AutoPilot_API){
+	ASSERT_TRUE(sapi.CalculateOpticalEfficiencyTable(opttab));
+	ASSERT_EQ(opttab.zeniths.size(), 8);
+	ASSERT_EQ(opttab.azimuths.size(), 12);
+	ASSERT_EQ(opttab.eff_data.size(), 8);
+
+	double overhead_min = 1., overhead_max = 0.;
+	for (size_t i = 0; i < opttab.azimuths.size(); i++){
+		ASSERT_EQ(opttab.eff_data.at(0).size(), opttab.azimuths.size());
+		overhead_min = fmin(overhead_min, opttab.eff_data.at(0).at(i));
+		overhead_max = fmax(overhead_max, opttab.eff_data.at(0).at(i));
+		// zeniths 30, 45, 60, 75, 85 deg
+		for (size_t j = 3; j < opttab.zeniths.size() - 1; j++)
+			EXPECT_LT(opttab.eff_data.at(j + 1).at(i), opttab.eff_data.at(j).at(i)) << "zenith " << opttab.zeniths.at(j + 1) << " azimuth " << opttab.azimuths.at(i);
+		EXPECT_LT(opttab.eff_data.at(7).at(i), 0.35) << "azimuth " << opttab.azimuths.at(i);
+	}
+	EXPECT_LT(overhead_max - overhead_min, 0.01) << "Sun at 0.5 deg zenith";
+
+	EXPECT_NEAR(opttab.eff_data.at(0).at(6), 0.7215, 0.005) << "Zenith 0.5 deg, azimuth 180 deg";
+	EXPECT_NEAR(opttab.eff_data.at(3).at(6), 0.6408, 0.005) << "Zenith 30 deg, azimuth 180 deg";
+	EXPECT_NEAR(opttab.eff_data.at(5).at(0), 0.5710, 0.005) << "Zenith 60 deg, azimuth 0 deg";
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "AutoPilot_API.h"
+#include "SolarField.h"
+#include "definitions.h"
+
+/**
+*   FluxMapTest sets up a user-defined field of 252 heliostats north of an 80 m tower, enough for the flux
+*   density calculation to be split between 4 threads, and calculates 6x5 flux maps on the receiver (in kW/m2)
+*   for three sun positions
+*/
+class FluxMapTest : public ::testing::Test{
+protected:
+	var_map V;
+	AutoPilot_S sapi;
+	SolarField *SF;	// deleted by sapi
+
+	void SetUp(){
+		V.amb.latitude.val = 34.87;
+		V.amb.longitude.val = -116.78;
+		V.amb.time_zone.val = -8;
+		V.sf.temp_which.combo_clear();
+		std::string name = "Template 1", val = "0";
+		V.sf.temp_which.combo_add_choice(name, val);
+		V.sf.temp_which.combo_select_by_choice_index(0);
+		V.sf.q_des.val = 50;
+		V.sf.tht.val = 80;
+		V.recs.front().rec_height.val = 8;
+		V.recs.front().rec_diameter.val = 7;
+
+		// staggered rows of heliostats from 60 m to 225 m north of the tower
+		char row[200];
+		for (int r = 0; r < 12; r++){
+			for (int c = -10; c <= 10; c++){
+				sprintf(row, "0,%f,%f,%f,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL;", c * 15. + (r % 2) * 7.5, 60. + r * 15., 0.);
+				V.sf.layout_data.val.append(row);
+			}
+		}
+
+		std::vector<std::string> wfdata;
+		char line[200];
+		for (int i = 0; i < 8760; i++){
+			int doy = i / 24, hr = i % 24;
+			int month = doy / 31 + 1 > 12 ? 12 : doy / 31 + 1;
+			double dni = (hr > 6 && hr < 18) ? 900 * sin(3.14159 * (hr - 6) / 12.) : 0.;
+			sprintf(line, "%d,%d,%d,%.2lf,%.1lf,%.1lf,%.1lf", doy % 28 + 1, hr, month, dni, 20., 1., 3.);
+			wfdata.push_back(line);
+		}
+		SF = new SolarField();
+		sapi.SetExternalSFObject(SF);
+		sapi.GenerateDesignPointSimulations(V, wfdata);
+		sapi.Setup(V);
+	}
+
+	// flux maps at azimuths 180, 100 and 250 deg and zeniths 30, 60 and 45 deg
+	bool calculate(int nthreads, sp_flux_table &fluxtab){
+		SF->setThreadCount(nthreads);
+		double azimuths[3] = { 180., 100., 250. }, zeniths[3] = { 30., 60., 45. };
+		for (int i = 0; i < 3; i++){
+			fluxtab.azimuths.push_back(azimuths[i] * D2R);
+			fluxtab.zeniths.push_back(zeniths[i] * D2R);
+		}
+		return sapi.CalculateFluxMaps(fluxtab, 6, 5, false);
+	}
+};
+
+/// Flux maps match those recorded with the per flux point evaluation of the Hermite series used before the flux kernel
+TEST_F(FluxMapTest, PerPointReference_Flux){
+	// rows from the top of the receiver, for each sun position
+	double expected[3][5][6] = {
+		{
+			{ 0.0322046861566, 4.7151933232, 72.9297317223, 74.273051895, 4.43891002276, 0.0274010046051 },
+			{ 0.0122702489525, 31.9785704453, 634.198838294, 685.26287712, 31.4893606229, 0.00758628386987 },
+			{ 0.0458916086429, 8.91438210569, 147.049325564, 147.456737418, 7.48589910168, 0.0259539493318 },
+			{ 0.0086065009551, 26.1258046644, 652.538601705, 672.192414869, 19.9710518171, 0.00401738063196 },
+			{ 1.90267239057e-05, 4.26495644128, 74.0893241611, 73.0878136278, 3.06415600735, 3.41033251198e-06 }
+		},
+		{
+			{ 0.318872836108, 4.49279659476, 32.7733417082, 3.00052414201, 3.06061595706, 0.0140746407694 },
+			{ 0.421060145618, 16.38918982, 203.462950938, 162.795607374, 40.6677837699, 0.0017391197437 },
+			{ 0.292407246831, 16.0488984952, 308.184313809, 1089.59239041, 5.944465025, 0.0103948569323 },
+			{ 0.118147013282, 7.26512773019, 203.699348126, 163.428682017, 25.8499361784, 0.00112000142586 },
+			{ 0.0175422101321, 3.47034277429, 32.8485767575, 3.63052881616, 2.16485282919, 2.02524263042e-06 }
+		},
+		{
+			{ 0.0132928645422, 3.59901714914, 1.38794321809, 11.4023336918, 1.9902227384, 0.298308714478 },
+			{ 0.00284716102761, 46.0048292074, 152.981134121, 247.398157714, 13.2699099417, 0.396698640328 },
+			{ 0.0263629268596, 7.75565198277, 1328.55793328, 664.878155933, 12.540728898, 0.242386440459 },
+			{ 0.00410406313614, 36.2794746244, 153.079561121, 247.190695892, 9.24959111457, 0.0473953748021 },
+			{ 7.32739495699e-06, 3.54225743402, 1.74560011074, 11.3948520738, 1.3864882328, 8.39565868597e-06 }
+		}
+	};
+
+	sp_flux_table fluxtab;
+	ASSERT_TRUE(calculate(1, fluxtab));
+	ASSERT_EQ(fluxtab.flux_surfaces.size(), 1);
+	block_t<double> &flux = fluxtab.flux_surfaces.front().flux_data;
+	ASSERT_EQ(flux.nrows(), 5);
+	ASSERT_EQ(flux.ncols(), 6);
+	ASSERT_EQ(flux.nlayers(), 3);
+
+	for (int k = 0; k < 3; k++){
+		double peak = 0.;
+		for (int i = 0; i < 5; i++)
+			for (int j = 0; j < 6; j++)
+				peak = fmax(peak, expected[k][i][j]);
+		for (int i = 0; i < 5; i++)
+			for (int j = 0; j < 6; j++)
+				EXPECT_NEAR(flux.at(i, j, k), expected[k][i][j], 1e-9 * peak) << "sun position " << k << " row " << i << " column " << j;
+	}
+}
+
+/// Splitting the heliostats between threads only changes the order in which their flux is summed
+TEST_F(FluxMapTest, ThreadCount_Flux){
+	sp_flux_table serial, threaded;
+	ASSERT_TRUE(calculate(1, serial));
+	ASSERT_TRUE(calculate(4, threaded));
+	EXPECT_EQ(SF->getThreadCount(), 4);
+
+	block_t<double> &a = serial.flux_surfaces.front().flux_data, &b = threaded.flux_surfaces.front().flux_data;
+	ASSERT_EQ(a.nrows(), b.nrows());
+	ASSERT_EQ(a.ncols(), b.ncols());
+	ASSERT_EQ(a.nlayers(), b.nlayers());
+	for (size_t k = 0; k < a.nlayers(); k++){
+		double peak = 0.;
+		for (size_t i = 0; i < a.nrows(); i++)
+			for (size_t j = 0; j < a.ncols(); j++)
+				peak = fmax(peak, a.at(i, j, k));
+		EXPECT_GT(peak, 100.) << "sun position " << k;
+		for (size_t i = 0; i < a.nrows(); i++)
+			for (size_t j = 0; j < a.ncols(); j++)
+				EXPECT_NEAR(b.at(i, j, k), a.at(i, j, k), 1e-10 * peak) << "sun position " << k << " row " << i << " column " << j;
+	}
+}
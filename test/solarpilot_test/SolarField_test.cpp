@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "AutoPilot_API.h"
+#include "SolarField.h"
+#include "definitions.h"
+
+/**
+*   ShadowBlockTest sets up a user-defined field of 30 rows of 51 heliostats north of an 80 m tower, enough for
+*   the shadowing and blocking calculation to be split between threads, and simulates it at low sun positions
+*   where most heliostats are shaded or blocked
+*/
+class ShadowBlockTest : public ::testing::Test{
+protected:
+	var_map V;
+	std::vector<std::string> wfdata;
+
+	void SetUp(){
+		V.amb.latitude.val = 34.87;
+		V.amb.longitude.val = -116.78;
+		V.amb.time_zone.val = -8;
+		V.sf.temp_which.combo_clear();
+		std::string name = "Template 1", val = "0";
+		V.sf.temp_which.combo_add_choice(name, val);
+		V.sf.temp_which.combo_select_by_choice_index(0);
+		V.sf.q_des.val = 50;
+		V.sf.tht.val = 80;
+		V.recs.front().rec_height.val = 8;
+		V.recs.front().rec_diameter.val = 7;
+		V.sf.layout_data.val = layout(0.);
+
+		char line[200];
+		for (int i = 0; i < 8760; i++){
+			int doy = i / 24, hr = i % 24;
+			int month = doy / 31 + 1 > 12 ? 12 : doy / 31 + 1;
+			double dni = (hr > 6 && hr < 18) ? 900 * sin(3.14159 * (hr - 6) / 12.) : 0.;
+			sprintf(line, "%d,%d,%d,%.2lf,%.1lf,%.1lf,%.1lf", doy % 28 + 1, hr, month, dni, 20., 1., 3.);
+			wfdata.push_back(line);
+		}
+	}
+
+	// rows from 60 m to 466 m north of the tower. The inner rows move north by 'shift' (m), which leaves the field extents unchanged
+	std::string layout(double shift){
+		std::string data;
+		char row[200];
+		for (int r = 0; r < 30; r++){
+			for (int c = -25; c <= 25; c++){
+				sprintf(row, "0,%f,%f,%f,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL;", c * 14., 60. + r * 14. + (r > 0 && r < 29 ? shift : 0.), 0.);
+				data.append(row);
+			}
+		}
+		return data;
+	}
+
+	// shading and blocking efficiency of each heliostat at azimuth 200 deg, zenith 70 deg and at azimuth 95 deg, zenith 65 deg
+	void simulate(SolarField &SF, std::vector<double> &shading, std::vector<double> &blocking){
+		sim_params P;
+		P.dni = 950.;
+		P.Tamb = 25.;
+		double azimuths[2] = { 200., 95. }, zeniths[2] = { 70., 65. };
+		shading.clear();
+		blocking.clear();
+		for (int k = 0; k < 2; k++){
+			SF.Simulate(azimuths[k] * D2R, zeniths[k] * D2R, P);
+			Hvector *helios = SF.getHeliostats();
+			for (size_t i = 0; i < helios->size(); i++){
+				shading.push_back(helios->at(i)->getEfficiencyShading());
+				blocking.push_back(helios->at(i)->getEfficiencyBlock());
+			}
+		}
+	}
+};
+
+/// Each thread calculates a separate range of heliostats, so the efficiencies don't depend on the thread count
+TEST_F(ShadowBlockTest, ThreadCount_SolarField){
+	AutoPilot_S sapi;
+	SolarField *SF = new SolarField();	// deleted by sapi
+	sapi.SetExternalSFObject(SF);
+	sapi.GenerateDesignPointSimulations(V, wfdata);
+	ASSERT_TRUE(sapi.Setup(V));
+	ASSERT_EQ(SF->getHeliostats()->size(), 1530);
+
+	std::vector<double> shading, blocking, shading_mt, blocking_mt;
+	SF->setThreadCount(1);
+	simulate(*SF, shading, blocking);
+	SF->setThreadCount(4);	// 3 threads are used for 1530 heliostats
+	simulate(*SF, shading_mt, blocking_mt);
+
+	ASSERT_EQ(shading.size(), shading_mt.size());
+	int n_shaded = 0, n_blocked = 0;
+	for (size_t i = 0; i < shading.size(); i++){
+		EXPECT_EQ(shading_mt[i], shading[i]) << "heliostat " << i % 1530 << " sun position " << i / 1530;
+		EXPECT_EQ(blocking_mt[i], blocking[i]) << "heliostat " << i % 1530 << " sun position " << i / 1530;
+		if (shading[i] < 1.) n_shaded++;
+		if (blocking[i] < 1.) n_blocked++;
+	}
+	EXPECT_GT(n_shaded, 1000);
+	EXPECT_GT(n_blocked, 1000);
+}
+
+/// Moving heliostats in a field that was already simulated gives the same efficiencies as a field built at the new positions
+TEST_F(ShadowBlockTest, MovedHeliostats_SolarField){
+	AutoPilot_S sapi;
+	SolarField *SF = new SolarField();	// deleted by sapi
+	sapi.SetExternalSFObject(SF);
+	sapi.GenerateDesignPointSimulations(V, wfdata);
+	ASSERT_TRUE(sapi.Setup(V));
+	SF->setThreadCount(4);
+
+	std::vector<double> shading, blocking;
+	simulate(*SF, shading, blocking);
+
+	// move the heliostats of the simulated field in place, as a layout refresh does
+	std::string moved = layout(6.);
+	SF->getVarMap()->sf.layout_data.val = moved;
+	ASSERT_TRUE(SolarField::parseHeliostatXYZFile(moved, *SF->getLayoutShellObject()));
+	SolarField::PrepareFieldLayout(*SF, 0, true);	// returns false when no further design simulation is needed
+	std::vector<double> shading_reused, blocking_reused;
+	simulate(*SF, shading_reused, blocking_reused);
+
+	// build a new field at the moved positions
+	AutoPilot_S sapi_moved;
+	SolarField *SF_moved = new SolarField();	// deleted by sapi_moved
+	sapi_moved.SetExternalSFObject(SF_moved);
+	V.sf.layout_data.val = moved;
+	sapi_moved.GenerateDesignPointSimulations(V, wfdata);
+	ASSERT_TRUE(sapi_moved.Setup(V));
+	SF_moved->setThreadCount(4);
+	std::vector<double> shading_rebuilt, blocking_rebuilt;
+	simulate(*SF_moved, shading_rebuilt, blocking_rebuilt);
+
+	ASSERT_EQ(shading_reused.size(), shading_rebuilt.size());
+	ASSERT_EQ(shading.size(), shading_rebuilt.size());
+	int n_changed = 0;
+	for (size_t i = 0; i < shading_rebuilt.size(); i++){
+		EXPECT_EQ(shading_reused[i], shading_rebuilt[i]) << "heliostat " << i % 1530 << " sun position " << i / 1530;
+		EXPECT_EQ(blocking_reused[i], blocking_rebuilt[i]) << "heliostat " << i % 1530 << " sun position " << i / 1530;
+		if (shading[i] != shading_rebuilt[i] || blocking[i] != blocking_rebuilt[i]) n_changed++;
+	}
+	EXPECT_GT(n_changed, 1000) << "Moving the heliostats should change their efficiencies";
+}
@@ -430,4 +430,70 @@ TEST_F(CMPvsamv1PowerIntegration, NoFinancialModelLosses)
 		SetCalculated("annual_energy");
 		EXPECT_NEAR(calculated_value, annual_energy_expected[2], m_error_tolerance_hi);
 	}
-}
\ No newline at end of file
+}
+/// Lifetime simulation replaying the first year DC calculation must match the full recalculation
+TEST_F(CMPvsamv1PowerIntegration, NoFinancialModelLifetimeReplay)
+{
+	std::map<std::string, double> pairs;
+	pairs["system_use_lifetime_output"] = 1;
+	pairs["analysis_period"] = 5;
+	pairs["lifetime_replay"] = 0;
+	ssc_number_t p_dc_degradation[1] = { 0.5 };
+	ssc_data_set_array(data, "dc_degradation", p_dc_degradation, 1);
+
+	int pvsam_errors = modify_ssc_data_and_run_module(data, "pvsamv1", pairs);
+	EXPECT_FALSE(pvsam_errors);
+	if (!pvsam_errors) {
+		int n = 0;
+		ssc_number_t *p_gen = ssc_data_get_array(data, "gen", &n);
+		std::vector<ssc_number_t> gen_recalculated(p_gen, p_gen + n);
+		EXPECT_EQ(n, 5 * 8760);
+
+		pairs["lifetime_replay"] = 1;
+		pvsam_errors = modify_ssc_data_and_run_module(data, "pvsamv1", pairs);
+		EXPECT_FALSE(pvsam_errors);
+		if (!pvsam_errors) {
+			p_gen = ssc_data_get_array(data, "gen", &n);
+			ASSERT_EQ(n, (int)gen_recalculated.size());
+			for (int i = 0; i < n; i++)
+				EXPECT_EQ(p_gen[i], gen_recalculated[i]) << "gen at step " << i;
+		}
+	}
+}
+
+/// Results are unchanged when only a subset of the outputs is requested, and unrequested time series are not returned
+TEST_F(CMPvsamv1PowerIntegration, NoFinancialModelOutputFilter)
+{
+	std::map<std::string, double> pairs;
+	int pvsam_errors = modify_ssc_data_and_run_module(data, "pvsamv1", pairs);
+	EXPECT_FALSE(pvsam_errors);
+	if (!pvsam_errors) {
+		int n = 0;
+		ssc_number_t *p_gen = ssc_data_get_array(data, "gen", &n);
+		std::vector<ssc_number_t> gen_all(p_gen, p_gen + n);
+		ssc_number_t annual_energy_all;
+		ssc_data_get_number(data, "annual_energy", &annual_energy_all);
+
+		const char *dropped[] = { "gen", "monthly_energy", "sol_zen", "subarray1_celltemp", "poa_nom" };
+		for (size_t i = 0; i < sizeof(dropped) / sizeof(dropped[0]); i++)
+			ssc_data_unassign(data, dropped[i]);
+
+		ssc_data_set_string(data, SSC_OUTPUT_FILTER, "gen, monthly_*");
+		pvsam_errors = modify_ssc_data_and_run_module(data, "pvsamv1", pairs);
+		EXPECT_FALSE(pvsam_errors);
+		if (!pvsam_errors) {
+			p_gen = ssc_data_get_array(data, "gen", &n);
+			ASSERT_EQ(n, (int)gen_all.size());
+			for (int i = 0; i < n; i++)
+				EXPECT_EQ(p_gen[i], gen_all[i]) << "gen at step " << i;
+
+			ssc_number_t annual_energy;
+			ssc_data_get_number(data, "annual_energy", &annual_energy);
+			EXPECT_EQ(annual_energy, annual_energy_all);
+			EXPECT_TRUE(ssc_data_get_array(data, "monthly_energy", &n) != 0);
+			EXPECT_TRUE(ssc_data_get_array(data, "sol_zen", &n) == 0);
+			EXPECT_TRUE(ssc_data_get_array(data, "subarray1_celltemp", &n) == 0);
+			EXPECT_TRUE(ssc_data_get_array(data, "poa_nom", &n) == 0);
+		}
+	}
+}
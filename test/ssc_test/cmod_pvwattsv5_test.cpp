@@ -37,4 +37,50 @@ TEST_F(CMPvwattsV5Integration, DefaultNoFinancialModel){
 	ssc_data_get_number(data, "capacity_factor", &capacity_factor);
 	EXPECT_NEAR(capacity_factor, 19.7197, error_tolerance) << "Capacity factor";
 
-}
\ No newline at end of file
+}
+/// Batch execution should give the same results as running each case serially
+TEST_F(CMPvwattsV5Integration, BatchExecMatchesSerial){
+	const int ncases = 4;
+	ssc_data_t cases[ncases];
+	ssc_bool_t results[ncases];
+	ssc_module_t mods[ncases];
+	for (int i = 0; i < ncases; i++)
+	{
+		cases[i] = ssc_data_create();
+		pvwattsv5_nofinancial_testfile(cases[i]);
+		ssc_data_set_number(cases[i], "tilt", (ssc_number_t)(10 * i));
+	}
+
+	int nsuccess = ssc_module_exec_batch("pvwattsv5", cases, ncases, 2, results, mods);
+	EXPECT_EQ(nsuccess, ncases);
+
+	// an unknown module fails the whole batch before any case runs
+	EXPECT_EQ(ssc_module_exec_batch("not_a_module", cases, ncases, 2, results, 0), -1);
+
+	for (int i = 0; i < ncases; i++)
+	{
+		EXPECT_TRUE(results[i]) << "case " << i << ": " << (ssc_module_log(mods[i], 0, 0, 0) ? ssc_module_log(mods[i], 0, 0, 0) : "");
+		ssc_module_free(mods[i]);
+
+		ssc_data_set_number(data, "tilt", (ssc_number_t)(10 * i));
+		compute();
+		ssc_number_t batch_energy = 0, serial_energy = 0;
+		ssc_data_get_number(cases[i], "annual_energy", &batch_energy);
+		ssc_data_get_number(data, "annual_energy", &serial_energy);
+		EXPECT_EQ(batch_energy, serial_energy) << "Annual energy of case " << i;
+		ssc_data_free(cases[i]);
+	}
+}
+
+/// Output filter patterns match variable names without regard to case, like the data container does
+TEST_F(CMPvwattsV5Integration, OutputFilterIgnoresCase){
+	ssc_data_set_string(data, SSC_OUTPUT_FILTER, "GH, Monthly_*, A?");
+	compute();
+
+	int n = 0;
+	EXPECT_NE(ssc_data_get_array(data, "gh", &n), (ssc_number_t*)0);
+	EXPECT_NE(ssc_data_get_array(data, "monthly_energy", &n), (ssc_number_t*)0);
+	EXPECT_NE(ssc_data_get_array(data, "ac", &n), (ssc_number_t*)0);
+	EXPECT_EQ(ssc_data_get_array(data, "dn", &n), (ssc_number_t*)0);
+	EXPECT_EQ(ssc_data_get_array(data, "dc", &n), (ssc_number_t*)0);
+}
@@ -0,0 +1,307 @@
+#include <gtest/gtest.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "sscapi.h"
+
+/**
+*   CMUtilityRate5 runs utilityrate5 over a 25 year lifetime on a synthetic hourly load and generation profile,
+*   with a two period, three tier time of use energy rate and two tier flat and TOU demand charges
+*/
+/// Bills of a three year run, with the first element of the annual arrays for year 0
+struct golden_bills{
+	ssc_number_t bill[4], ec[4], dc_fixed[4], dc_tou[4];
+	ssc_number_t year1_monthly[12], year3_monthly[12];
+};
+
+class CMUtilityRate5 : public ::testing::Test{
+protected:
+	ssc_data_t data;
+	int nyears = 25;
+
+	void SetUp(){
+		data = ssc_data_create();
+		ssc_data_set_number(data, "system_use_lifetime_output", 1);
+		ssc_data_set_number(data, "inflation_rate", 2.5);
+		ssc_number_t degradation[1] = { 0.5 };
+		ssc_data_set_array(data, "degradation", degradation, 1);
+		ssc_number_t load_escalation[1] = { 1.5 };
+		ssc_data_set_array(data, "load_escalation", load_escalation, 1);
+		ssc_number_t rate_escalation[1] = { 1 };
+		ssc_data_set_array(data, "rate_escalation", rate_escalation, 1);
+		ssc_data_set_number(data, "ur_monthly_fixed_charge", 16.68f);
+		ssc_data_set_number(data, "ur_monthly_min_charge", 20);
+		ssc_data_set_number(data, "ur_nm_yearend_sell_rate", 0.02789f);
+
+		// period 2 on summer weekday afternoons, period 1 otherwise
+		ssc_number_t ec_weekday[288], ec_weekend[288], dc_weekday[288], dc_weekend[288];
+		for (int m = 0; m < 12; m++){
+			for (int h = 0; h < 24; h++){
+				ec_weekday[m * 24 + h] = (m >= 5 && m < 9 && h >= 12 && h < 19) ? 2.f : 1.f;
+				ec_weekend[m * 24 + h] = 1;
+				dc_weekday[m * 24 + h] = (h >= 12 && h < 19) ? 2.f : 1.f;
+				dc_weekend[m * 24 + h] = 1;
+			}
+		}
+		ssc_data_set_matrix(data, "ur_ec_sched_weekday", ec_weekday, 12, 24);
+		ssc_data_set_matrix(data, "ur_ec_sched_weekend", ec_weekend, 12, 24);
+		ssc_number_t ec_tou_mat[36] = { 1, 1, 200, 0, 0.08f, 0.04f,
+			1, 2, 600, 0, 0.10f, 0.04f,
+			1, 3, 1e38f, 0, 0.12f, 0.04f,
+			2, 1, 200, 0, 0.22f, 0.06f,
+			2, 2, 600, 0, 0.26f, 0.06f,
+			2, 3, 1e38f, 0, 0.30f, 0.06f };
+		ssc_data_set_matrix(data, "ur_ec_tou_mat", ec_tou_mat, 6, 6);
+
+		ssc_data_set_number(data, "ur_dc_enable", 1);
+		ssc_data_set_matrix(data, "ur_dc_sched_weekday", dc_weekday, 12, 24);
+		ssc_data_set_matrix(data, "ur_dc_sched_weekend", dc_weekend, 12, 24);
+		ssc_number_t dc_tou_mat[16] = { 1, 1, 2, 4,
+			1, 2, 1e38f, 6,
+			2, 1, 2, 11,
+			2, 2, 1e38f, 14 };
+		ssc_data_set_matrix(data, "ur_dc_tou_mat", dc_tou_mat, 4, 4);
+		ssc_number_t dc_flat_mat[96];
+		for (int m = 0; m < 12; m++){
+			ssc_number_t tiers[8] = { (ssc_number_t)m, 1, 2.5f, 3, (ssc_number_t)m, 2, 1e38f, 5 };
+			for (int k = 0; k < 8; k++)
+				dc_flat_mat[m * 8 + k] = tiers[k];
+		}
+		ssc_data_set_matrix(data, "ur_dc_flat_mat", dc_flat_mat, 24, 4);
+
+		set_profiles(nyears, 1);
+	}
+	void TearDown(){
+		ssc_data_free(data);
+	}
+
+	// one year of load and 'years' of degrading generation, with 'steps_per_hour' records per hour
+	void set_profiles(int years, int steps_per_hour){
+		nyears = years;
+		ssc_data_set_number(data, "analysis_period", nyears);
+		int nrec = 8760 * steps_per_hour;
+		std::vector<ssc_number_t> load(nrec), gen(nrec * nyears);
+		for (int i = 0; i < nrec; i++){
+			double t = (double)i / steps_per_hour;
+			double hod = fmod(t, 24);
+			load[i] = (ssc_number_t)(1.5 + 0.8 * sin(hod / 24 * 6.283) + 0.4 * sin(t / 8760. * 6.283) + 0.3 * sin(t * 0.37));
+		}
+		for (int y = 0; y < nyears; y++){
+			for (int i = 0; i < nrec; i++){
+				double t = (double)i / steps_per_hour;
+				double hod = fmod(t, 24);
+				double sun = (hod > 6 && hod < 18) ? sin((hod - 6) / 12 * 3.14159) : 0;
+				gen[y * nrec + i] = (ssc_number_t)(4.0 * sun * (1 - 0.005 * y) * (0.7 + 0.3 * cos(t * 0.011)));
+			}
+		}
+		ssc_data_set_array(data, "load", &load[0], nrec);
+		ssc_data_set_array(data, "gen", &gen[0], nrec * nyears);
+	}
+
+	bool compute(){
+		ssc_module_t module = ssc_module_create("utilityrate5");
+		if (NULL == module)
+			return false;
+		bool ok = ssc_module_exec(module, data) != 0;
+		ssc_module_free(module);
+		return ok;
+	}
+
+	// annual, monthly by year and first year outputs
+	std::vector<std::vector<ssc_number_t>> outputs(){
+		const char *names[] = { "annual_energy_value", "elec_cost_with_system", "elec_cost_without_system",
+			"utility_bill_w_sys", "utility_bill_wo_sys", "charge_w_sys_ec", "charge_w_sys_dc_tou",
+			"utility_bill_w_sys_ym", "charge_w_sys_ec_ym", "lifetime_load",
+			"year1_monthly_utility_bill_w_sys", "year1_monthly_ec_charge_with_system", "year1_monthly_dc_tou_with_system",
+			"year1_hourly_ec_with_system", "year1_hourly_dc_with_system", "monthly_tou_demand_charge_w_sys" };
+		std::vector<std::vector<ssc_number_t>> values;
+		for (size_t k = 0; k < sizeof(names) / sizeof(names[0]); k++){
+			int nrows = 0, ncols = 1;
+			ssc_number_t *p = ssc_data_get_array(data, names[k], &nrows);
+			if (!p)
+				p = ssc_data_get_matrix(data, names[k], &nrows, &ncols);
+			EXPECT_TRUE(p != 0) << names[k];
+			values.push_back(p ? std::vector<ssc_number_t>(p, p + nrows * ncols) : std::vector<ssc_number_t>());
+		}
+		ssc_number_t year1 = 0;
+		ssc_data_get_number(data, "elec_cost_with_system_year1", &year1);
+		values.push_back(std::vector<ssc_number_t>(1, year1));
+		ssc_data_get_number(data, "savings_year1", &year1);
+		values.push_back(std::vector<ssc_number_t>(1, year1));
+		return values;
+	}
+
+	// compares a few lifetime and monthly bills to the cent
+	void check_bills(const golden_bills &expected, const std::string &label){
+		const char *names[] = { "utility_bill_w_sys", "charge_w_sys_ec", "charge_w_sys_dc_fixed", "charge_w_sys_dc_tou" };
+		const ssc_number_t *annual[] = { expected.bill, expected.ec, expected.dc_fixed, expected.dc_tou };
+		for (size_t k = 0; k < 4; k++){
+			int n = 0;
+			ssc_number_t *p = ssc_data_get_array(data, names[k], &n);
+			ASSERT_TRUE(p != 0) << label << " " << names[k];
+			ASSERT_EQ(n, 4) << label << " " << names[k];
+			for (int y = 0; y < n; y++)
+				EXPECT_NEAR(p[y], annual[k][y], 0.01) << label << " " << names[k] << " year " << y;
+		}
+		int n = 0, nrows = 0, ncols = 0;
+		ssc_number_t *year1 = ssc_data_get_array(data, "year1_monthly_utility_bill_w_sys", &n);
+		ssc_number_t *ym = ssc_data_get_matrix(data, "utility_bill_w_sys_ym", &nrows, &ncols);
+		ASSERT_TRUE(year1 != 0 && ym != 0) << label;
+		ASSERT_EQ(n, 12) << label;
+		ASSERT_EQ(nrows, 4) << label;
+		ASSERT_EQ(ncols, 12) << label;
+		for (int m = 0; m < 12; m++){
+			EXPECT_NEAR(year1[m], expected.year1_monthly[m], 0.01) << label << " year 1 month " << m;
+			EXPECT_NEAR(ym[3 * 12 + m], expected.year3_monthly[m], 0.01) << label << " year 3 month " << m;
+		}
+	}
+};
+
+/// Years billed on several threads give the same lifetime and first year results as one thread, for net billing and two meters
+TEST_F(CMUtilityRate5, LifetimeThreads_cmod_utilityrate5) {
+	int metering_options[2] = { 2, 4 };
+	for (int k = 0; k < 2; k++){
+		ssc_data_set_number(data, "ur_metering_option", metering_options[k]);
+
+		ssc_data_set_number(data, "ur_threads", 1);
+		ASSERT_TRUE(compute()) << "metering option " << metering_options[k];
+		std::vector<std::vector<ssc_number_t>> serial = outputs();
+
+		ssc_data_set_number(data, "ur_threads", 4);
+		ASSERT_TRUE(compute()) << "metering option " << metering_options[k];
+		std::vector<std::vector<ssc_number_t>> threaded = outputs();
+
+		ASSERT_EQ(serial.size(), threaded.size());
+		for (size_t i = 0; i < serial.size(); i++){
+			ASSERT_EQ(serial[i].size(), threaded[i].size()) << "metering option " << metering_options[k] << " output " << i;
+			for (size_t j = 0; j < serial[i].size(); j++)
+				EXPECT_EQ(serial[i][j], threaded[i][j]) << "metering option " << metering_options[k] << " output " << i << " index " << j;
+		}
+		EXPECT_GT(serial[0].size(), (size_t)nyears) << "lifetime annual values";
+	}
+}
+
+/// Hourly bills over three years for each metering option, recorded before the per year bill calculation was split out for threading
+TEST_F(CMUtilityRate5, GoldenBillsHourly_cmod_utilityrate5) {
+	golden_bills expected[5] = {
+		{ // metering option 0
+			{ 0, 1085.5968f, 1156.06433f, 1230.57812f },
+			{ 0, 506.013702f, 548.939209f, 594.579895f },
+			{ 0, 99.8166199f, 105.48085f, 111.453026f },
+			{ 0, 279.606445f, 294.47876f, 310.128632f },
+			{ 97.2035675f, 113.577698f, 132.943909f, 121.25473f, 116.256485f, 115.163704f,
+			99.1346588f, 82.5207748f, 76.1746445f, 39.7654266f, 42.3917427f, 49.2094421f },
+			{ 110.137032f, 128.547546f, 150.196747f, 137.607788f, 132.081177f, 128.685211f,
+			110.520973f, 92.1219254f, 84.9305115f, 43.4746895f, 46.3730965f, 65.9013138f }
+		},
+		{ // metering option 1
+			{ 0, 1103.60718f, 1175.30884f, 1251.21155f },
+			{ 0, 524.024048f, 568.183716f, 615.21344f },
+			{ 0, 99.8166199f, 105.48085f, 111.453026f },
+			{ 0, 279.606445f, 294.47876f, 310.128632f },
+			{ 97.2035675f, 113.577698f, 132.943909f, 121.25473f, 116.256485f, 109.391724f,
+			88.4976654f, 67.844986f, 63.459877f, 57.1130295f, 58.0895958f, 77.973877f },
+			{ 110.137032f, 128.547546f, 150.196747f, 137.607788f, 132.081177f, 123.175385f,
+			99.751442f, 76.9664001f, 71.790802f, 65.4150848f, 66.6716614f, 88.8705368f }
+		},
+		{ // metering option 2
+			{ 0, 1264.64319f, 1338.67627f, 1417.00806f },
+			{ 0, 685.060059f, 731.551208f, 781.010132f },
+			{ 0, 99.8166199f, 105.48085f, 111.453026f },
+			{ 0, 279.606445f, 294.47876f, 310.128632f },
+			{ 114.548851f, 125.209404f, 143.978546f, 136.427444f, 131.798767f, 120.20163f,
+			97.507103f, 76.2058868f, 69.9488754f, 75.1567917f, 78.0505676f, 95.6093674f },
+			{ 128.381424f, 140.017548f, 161.041107f, 152.601807f, 147.480804f, 135.066315f,
+			109.788033f, 85.6415634f, 78.5149536f, 83.9337158f, 87.2219772f, 107.318924f }
+		},
+		{ // metering option 3
+			{ 0, 1264.64343f, 1338.67651f, 1417.00806f },
+			{ 0, 696.282104f, 742.866333f, 792.414551f },
+			{ 0, 99.8166199f, 105.48085f, 111.453026f },
+			{ 0, 279.606445f, 294.47876f, 310.128632f },
+			{ 124.189812f, 121.374489f, 143.676788f, 138.472595f, 131.994812f, 121.927513f,
+			102.523506f, 81.0100632f, 66.9957809f, 70.8338394f, 79.3799896f, 82.2642593f },
+			{ 138.089386f, 136.042114f, 160.704651f, 154.699982f, 147.676605f, 136.849487f,
+			115.044594f, 90.7818604f, 75.4766922f, 79.4446259f, 88.5776672f, 93.6205368f }
+		},
+		{ // metering option 4
+			{ 0, 1849.96301f, 1952.3324f, 2060.44507f },
+			{ 0, 1163.30029f, 1232.30322f, 1305.34326f },
+			{ 0, 99.8611755f, 105.527657f, 111.502205f },
+			{ 0, 386.641754f, 407.33606f, 429.183258f },
+			{ 159.513733f, 168.365616f, 192.251678f, 184.995361f, 180.003906f, 191.767593f,
+			163.540466f, 133.707489f, 119.101234f, 107.577896f, 112.901291f, 136.236923f },
+			{ 177.658356f, 187.221756f, 213.682739f, 205.795578f, 200.334229f, 213.424805f,
+			182.362656f, 149.398254f, 133.025116f, 119.894829f, 125.87088f, 151.775909f }
+		}
+	};
+	set_profiles(3, 1);
+	for (int k = 0; k < 5; k++){
+		ssc_data_set_number(data, "ur_metering_option", k);
+		ASSERT_TRUE(compute()) << "metering option " << k;
+		check_bills(expected[k], "hourly, metering option " + std::to_string(k));
+	}
+}
+
+/// 15 minute bills over three years for each metering option, recorded as for the hourly bills
+TEST_F(CMUtilityRate5, GoldenBillsSubhourly_cmod_utilityrate5) {
+	golden_bills expected[5] = {
+		{ // metering option 0
+			{ 0, 1081.18347f, 1151.5791f, 1226.99219f },
+			{ 0, 499.670074f, 542.425964f, 588.863708f },
+			{ 0, 99.9225159f, 105.592087f, 111.569901f },
+			{ 0, 281.430969f, 296.395477f, 312.142151f },
+			{ 97.1107483f, 113.556953f, 132.903275f, 120.875954f, 115.898239f, 112.586723f,
+			96.6421051f, 80.1117401f, 74.1581268f, 39.8550034f, 42.4576683f, 55.0270119f },
+			{ 110.05069f, 128.540283f, 150.169464f, 137.20871f, 131.704712f, 125.999573f,
+			107.918449f, 89.6229935f, 82.8422012f, 43.5735512f, 46.4458542f, 72.915741f }
+		},
+		{ // metering option 1
+			{ 0, 1097.41272f, 1168.93274f, 1244.72412f },
+			{ 0, 515.899292f, 559.779724f, 606.595642f },
+			{ 0, 99.9225159f, 105.592087f, 111.569901f },
+			{ 0, 281.430969f, 296.395477f, 312.142151f },
+			{ 97.1107483f, 113.556953f, 132.903275f, 120.875954f, 115.898239f, 107.897728f,
+			87.284256f, 66.8499298f, 62.5898247f, 56.8728333f, 57.8747635f, 77.6982651f },
+			{ 110.05069f, 128.540283f, 150.169464f, 137.20871f, 131.704712f, 121.613945f,
+			98.4807892f, 75.9420242f, 70.8939896f, 65.1644211f, 66.3728943f, 88.5821533f }
+		},
+		{ // metering option 2
+			{ 0, 1265.66125f, 1339.91772f, 1418.39734f },
+			{ 0, 684.147766f, 730.764526f, 780.268921f },
+			{ 0, 99.9225159f, 105.592087f, 111.569901f },
+			{ 0, 281.430969f, 296.395477f, 312.142151f },
+			{ 114.370796f, 125.170143f, 143.938202f, 135.990448f, 131.419983f, 121.152489f,
+			98.2238235f, 76.9940567f, 70.5033188f, 74.9244766f, 77.7476044f, 95.2259979f },
+			{ 128.198532f, 140.005768f, 160.978668f, 152.212341f, 147.127441f, 136.092957f,
+			110.609741f, 86.5076828f, 79.1016998f, 83.7031174f, 86.9200211f, 106.93943f }
+		},
+		{ // metering option 3
+			{ 0, 1265.66125f, 1339.91785f, 1418.39734f },
+			{ 0, 695.374756f, 742.084229f, 791.675293f },
+			{ 0, 99.9225159f, 105.592087f, 111.569901f },
+			{ 0, 281.430969f, 296.395477f, 312.142151f },
+			{ 124.012596f, 121.327034f, 143.652283f, 138.031235f, 131.61998f, 122.654739f,
+			103.149879f, 81.6875687f, 67.6372833f, 70.9463348f, 79.0580978f, 81.8842773f },
+			{ 137.89888f, 136.032532f, 160.654816f, 154.305695f, 147.337799f, 137.647217f,
+			115.771538f, 91.5274353f, 76.14608f, 79.5748138f, 88.2585907f, 93.2419357f }
+		},
+		{ // metering option 4
+			{ 0, 1844.71106f, 1946.73474f, 2054.58838f },
+			{ 0, 1157.49915f, 1226.12891f, 1298.88086f },
+			{ 0, 100.093941f, 105.772186f, 111.759079f },
+			{ 0, 386.957855f, 407.668091f, 429.532104f },
+			{ 159.379761f, 168.240128f, 192.102325f, 184.803589f, 179.934875f, 190.657089f,
+			162.440918f, 132.690247f, 118.039619f, 107.453346f, 112.805733f, 136.163437f },
+			{ 177.510147f, 187.125137f, 213.547806f, 205.598602f, 200.206848f, 212.202591f,
+			181.122772f, 148.225754f, 131.805191f, 119.758636f, 125.778564f, 151.70639f }
+		}
+	};
+	set_profiles(3, 4);
+	for (int k = 0; k < 5; k++){
+		ssc_data_set_number(data, "ur_metering_option", k);
+		ASSERT_TRUE(compute()) << "metering option " << k;
+		check_bills(expected[k], "15 minute, metering option " + std::to_string(k));
+	}
+}
@@ -201,3 +201,37 @@ TEST_F(CMWindPowerIntegration, DISABLED_IcingAndLowTempCutoff_cmod_windpower) {
 	free_winddata_array(windresourcedata);
 }
 
+
+/// Timesteps calculated on several threads give the same results as one thread, using Wind Resource Data
+TEST_F(CMWindPowerIntegration, Threads_cmod_windpower) {
+	ssc_data_unassign(data, "wind_resource_filename");
+	var_data* windresourcedata = create_winddata_array(1, 1);
+	// vary speed and direction so that the time steps and their wakes differ
+	util::matrix_t<ssc_number_t> &resource = windresourcedata->table.lookup("data")->num;
+	for (size_t i = 0; i < resource.nrows(); i++) {
+		resource.at(i, 2) = (ssc_number_t)(8 + 5 * sin(i * 0.05) + 2 * sin(i * 0.7));
+		resource.at(i, 3) = (ssc_number_t)fmod(i * 7.0, 360.0);
+	}
+	var_table *vt = static_cast<var_table*>(data);
+	vt->assign("wind_resource_data", *windresourcedata);
+	vt->assign("wind_farm_wake_model", 2);
+
+	vt->assign("wind_farm_threads", 1);
+	compute();
+
+	int nSerial = 0;
+	ssc_number_t *gen = ssc_data_get_array(data, "gen", &nSerial);
+	ASSERT_EQ(nSerial, 8760);
+	std::vector<ssc_number_t> genSerial(gen, gen + nSerial);
+
+	vt->assign("wind_farm_threads", 4);
+	compute();
+
+	int nThreaded = 0;
+	gen = ssc_data_get_array(data, "gen", &nThreaded);
+	ASSERT_EQ(nThreaded, nSerial);
+	for (int i = 0; i < nSerial; i++)
+		EXPECT_EQ(gen[i], genSerial[i]) << "time step " << i;
+
+	free_winddata_array(windresourcedata);
+}
@@ -0,0 +1,111 @@
+#include <cmath>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "CO2_properties.h"
+#include "co2_props_table.h"
+
+/**
+ * Compares the tabulated CO2_PH and CO2_PS fast path against the exact property routines over the
+ * sCO2 cycle range, including states near the critical point and in the two-phase region, where the
+ * tables fall back to the exact routines.
+ */
+
+class CO2PropsTableTest : public ::testing::Test{
+protected:
+	double rel_tol;
+
+	virtual void SetUp(){
+		rel_tol = 1.E-8;
+	}
+
+	// Exact state at each (T,P) of a grid spanning liquid, vapor and supercritical states
+	template<class F>
+	void for_each_state(F f){
+		CO2_state co2_props;
+		for (double P = 1500.0; P < 30000.0; P += 737.0)
+		{
+			for (double T = 285.0; T < 1000.0; T += 7.3)
+			{
+				if (CO2_TP(T, P, &co2_props) == 0)
+					f(P, co2_props);
+			}
+		}
+	}
+};
+
+TEST_F(CO2PropsTableTest, PH_matches_exact){
+	const C_co2_props_table &table = C_co2_props_table::instance();
+	ASSERT_TRUE(table.is_built());
+	for_each_state([&](double P, const CO2_state &exact){
+		CO2_state tab;
+		ASSERT_EQ(table.PH(P, exact.enth, &tab, rel_tol), 0);
+		EXPECT_NEAR(tab.pres, P, P*1.E-7);
+		EXPECT_NEAR(tab.enth, exact.enth, fabs(exact.enth)*1.E-7 + 1.E-7);
+		EXPECT_NEAR(tab.temp, exact.temp, 1.E-3) << "P = " << P << " T = " << exact.temp;
+		EXPECT_NEAR(tab.dens, exact.dens, exact.dens*1.E-5);
+	});
+}
+
+TEST_F(CO2PropsTableTest, PS_matches_exact){
+	const C_co2_props_table &table = C_co2_props_table::instance();
+	for_each_state([&](double P, const CO2_state &exact){
+		CO2_state tab;
+		ASSERT_EQ(table.PS(P, exact.entr, &tab, rel_tol), 0);
+		EXPECT_NEAR(tab.pres, P, P*1.E-7);
+		EXPECT_NEAR(tab.entr, exact.entr, fabs(exact.entr)*1.E-7 + 1.E-7);
+		EXPECT_NEAR(tab.temp, exact.temp, 1.E-3) << "P = " << P << " T = " << exact.temp;
+		EXPECT_NEAR(tab.dens, exact.dens, exact.dens*1.E-5);
+	});
+}
+
+TEST_F(CO2PropsTableTest, two_phase_uses_exact){
+	const C_co2_props_table &table = C_co2_props_table::instance();
+	CO2_state sat, exact, tab;
+	ASSERT_EQ(CO2_TQ(290.0, 0.4, &sat), 0);
+
+	ASSERT_EQ(CO2_PH(sat.pres, sat.enth, &exact), 0);
+	ASSERT_EQ(table.PH(sat.pres, sat.enth, &tab, rel_tol), 0);
+	EXPECT_EQ(tab.qual, exact.qual);
+	EXPECT_EQ(tab.temp, exact.temp);
+
+	ASSERT_EQ(CO2_PS(sat.pres, sat.entr, &exact), 0);
+	ASSERT_EQ(table.PS(sat.pres, sat.entr, &tab, rel_tol), 0);
+	EXPECT_EQ(tab.qual, exact.qual);
+	EXPECT_EQ(tab.temp, exact.temp);
+}
+
+TEST_F(CO2PropsTableTest, disabled_by_default){
+	EXPECT_EQ(CO2_props_table_get_tol(), 0.0);
+
+	CO2_state exact, tab;
+	ASSERT_EQ(CO2_PH(8000.0, 400.0, &exact), 0);
+	ASSERT_EQ(CO2_PH_tab(8000.0, 400.0, &tab), 0);
+	EXPECT_EQ(tab.temp, exact.temp);
+	EXPECT_EQ(tab.dens, exact.dens);
+}
+
+TEST_F(CO2PropsTableTest, tol_scope_restores_default){
+	{
+		C_co2_props_table_tol_scope tol(rel_tol);
+		EXPECT_EQ(CO2_props_table_get_tol(), rel_tol);
+		{
+			C_co2_props_table_tol_scope tol_nested(0.0);
+			EXPECT_EQ(CO2_props_table_get_tol(), 0.0);
+		}
+		EXPECT_EQ(CO2_props_table_get_tol(), rel_tol);
+	}
+	EXPECT_EQ(CO2_props_table_get_tol(), 0.0);
+}
+
+TEST_F(CO2PropsTableTest, tol_is_per_thread){
+	C_co2_props_table_tol_scope tol(rel_tol);
+	double tol_other_thread = -1.0;
+	std::thread other([&tol_other_thread](){
+		tol_other_thread = CO2_props_table_get_tol();
+	});
+	other.join();
+	EXPECT_EQ(tol_other_thread, 0.0);
+	EXPECT_EQ(CO2_props_table_get_tol(), rel_tol);
+}
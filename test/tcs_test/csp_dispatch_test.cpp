@@ -0,0 +1,305 @@
+#include <string>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "csp_solver_core.h"
+#include "csp_solver_util.h"
+#include "csp_dispatch.h"
+#include "sam_csp_util.h"
+#include "lib_weatherfile.h"
+
+/**
+ * Collector-receiver with a simple analytical optical efficiency. Like the heliostat field models it keeps the
+ * result of its last optical efficiency call, which the solver reports for time steps in which the field is off.
+ */
+class C_csp_test_collector_receiver : public C_csp_collector_receiver
+{
+public:
+	double m_eta_last;		//[-] optical efficiency of the last call
+	double m_time_last;		//[s] simulation time of the last call
+
+	C_csp_test_collector_receiver()
+	{
+		m_eta_last = m_time_last = std::numeric_limits<double>::quiet_NaN();
+	}
+
+	virtual void init(const C_csp_collector_receiver::S_csp_cr_init_inputs init_inputs,
+		C_csp_collector_receiver::S_csp_cr_solved_params & solved_params){}
+	virtual int get_operating_state(){ return C_csp_collector_receiver::OFF; }
+	virtual double get_startup_time(){ return 0.2 * 3600.; }
+	virtual double get_startup_energy(){ return 0.25 * 600.; }
+	virtual double get_pumping_parasitic_coef(){ return 0.015; }
+	virtual double get_min_power_delivery(){ return 0.25 * 600.; }
+	virtual double get_tracking_power(){ return 0.5; }
+	virtual double get_col_startup_power(){ return 5.; }
+	virtual void off(const C_csp_weatherreader::S_outputs &weather, const C_csp_solver_htf_1state &htf_state_in,
+		C_csp_collector_receiver::S_csp_cr_out_solver &cr_out_solver, const C_csp_solver_sim_info &sim_info){}
+	virtual void startup(const C_csp_weatherreader::S_outputs &weather, const C_csp_solver_htf_1state &htf_state_in,
+		C_csp_collector_receiver::S_csp_cr_out_solver &cr_out_solver, const C_csp_solver_sim_info &sim_info){}
+	virtual void on(const C_csp_weatherreader::S_outputs &weather, const C_csp_solver_htf_1state &htf_state_in, double field_control,
+		C_csp_collector_receiver::S_csp_cr_out_solver &cr_out_solver, const C_csp_solver_sim_info &sim_info){}
+	virtual void estimates(const C_csp_weatherreader::S_outputs &weather, const C_csp_solver_htf_1state &htf_state_in,
+		C_csp_collector_receiver::S_csp_cr_est_out &est_out, const C_csp_solver_sim_info &sim_info){}
+	virtual void converged(){}
+	virtual void write_output_intervals(double report_time_start, const std::vector<double> & v_temp_ts_time_end, double report_time_end){}
+
+	virtual double calculate_optical_efficiency(const C_csp_weatherreader::S_outputs &weather, const C_csp_solver_sim_info &sim)
+	{
+		double eta = 0.;
+		if( weather.m_solzen < 90. )
+			eta = 0.65 * pow(cos(weather.m_solzen * CSP::pi / 180.), 0.3) * (1. - 0.03 * sin(weather.m_solazi * CSP::pi / 180.));
+		m_eta_last = eta;
+		m_time_last = sim.ms_ts.m_time;
+		return eta;
+	}
+	virtual double calculate_thermal_efficiency_approx(const C_csp_weatherreader::S_outputs &weather, double q_incident)
+	{
+		return q_incident > 0. ? fmax(1. - (15. + 0.1 * (30. - weather.m_tdry)) / q_incident, 0.) : 0.;
+	}
+	virtual double get_collector_area(){ return 1.2e6; }
+};
+
+/**
+ * Power cycle with output falling off linearly with ambient temperature above 20 C
+ */
+class C_csp_test_power_cycle : public C_csp_power_cycle
+{
+public:
+	virtual void init(C_csp_power_cycle::S_solved_params &solved_params){}
+	virtual int get_operating_state(){ return C_csp_power_cycle::OFF; }
+	virtual double get_cold_startup_time(){ return 0.5; }
+	virtual double get_warm_startup_time(){ return 0.5; }
+	virtual double get_hot_startup_time(){ return 0.5; }
+	virtual double get_standby_energy_requirement(){ return 0.2 * 250.; }
+	virtual double get_cold_startup_energy(){ return 0.5 * 250.; }
+	virtual double get_warm_startup_energy(){ return 0.5 * 250.; }
+	virtual double get_hot_startup_energy(){ return 0.5 * 250.; }
+	virtual double get_max_thermal_power(){ return 1.2 * 250.; }
+	virtual double get_min_thermal_power(){ return 0.25 * 250.; }
+	virtual void get_max_power_output_operation_constraints(double T_amb, double & m_dot_HTF_ND_max, double & W_dot_ND_max)
+	{
+		m_dot_HTF_ND_max = 1.2;
+		W_dot_ND_max = fmin(1.2, 1.2 - 0.01 * (T_amb - 20.));
+	}
+	virtual double get_efficiency_at_TPH(double T_degC, double P_atm, double relhum_pct, double *w_dot_condenser = 0)
+	{
+		if( w_dot_condenser )
+			*w_dot_condenser = 1. + 0.05 * T_degC;
+		return 0.41 * (1. - 0.003 * (T_degC - 20.));
+	}
+	virtual double get_efficiency_at_load(double load_frac, double *w_dot_condenser = 0){ return 0.41 * (0.86 + 0.28 * load_frac - 0.14 * load_frac * load_frac); }
+	virtual double get_htf_pumping_parasitic_coef(){ return 0.0105; }
+	virtual double get_max_q_pc_startup(){ return 0.5 * 250.; }
+	virtual void call(const C_csp_weatherreader::S_outputs &weather, C_csp_solver_htf_1state &htf_state_in,
+		const C_csp_power_cycle::S_control_inputs &inputs, C_csp_power_cycle::S_csp_pc_out_solver &out_solver,
+		const C_csp_solver_sim_info &sim_info){}
+	virtual void converged(){}
+	virtual void write_output_intervals(double report_time_start, const std::vector<double> & v_temp_ts_time_end, double report_time_end){}
+	virtual void assign(int index, float *p_reporting_ts_array, int n_reporting_ts_array){}
+};
+
+/**
+ * CspDispatchTest sets up dispatch optimization the way C_csp_solver does for a 100 MWe tower with 10 hours of
+ * storage, using the Buenos Aires weather file, hourly time steps and a price that doubles from 4 pm to 8 pm
+ */
+class CspDispatchTest : public ::testing::Test{
+protected:
+	C_csp_weatherreader wr;
+	C_csp_solver_sim_info sim_info;
+	C_csp_messages messages;
+	C_csp_test_power_cycle pc;
+	int horizon;
+
+	void SetUp(){
+		char hourly[150];
+		sprintf(hourly, "%s/test/input_docs/weather.csv", std::getenv("SSCDIR"));
+		wr.m_filename = hourly;
+		wr.m_trackmode = 0;
+		wr.m_tilt = 0;
+		wr.m_azimuth = 0.0;
+		wr.m_weather_data_provider = std::make_shared<weatherfile>(hourly);
+		wr.init();
+		sim_info.ms_ts.m_step = 3600.;
+		horizon = 24;
+	}
+
+	void setup_dispatch(csp_dispatch_opt &dispatch, C_csp_collector_receiver &cr){
+		dispatch.copy_weather_data(wr);
+		dispatch.params.siminfo = &sim_info;
+		dispatch.params.col_rec = &cr;
+		dispatch.params.mpc_pc = &pc;
+		dispatch.params.messages = &messages;
+
+		dispatch.params.dt = 1.;
+		dispatch.params.dt_pb_startup_cold = pc.get_cold_startup_time();
+		dispatch.params.dt_pb_startup_hot = pc.get_hot_startup_time();
+		dispatch.params.q_pb_standby = pc.get_standby_energy_requirement()*1000.;
+		dispatch.params.e_pb_startup_cold = pc.get_cold_startup_energy()*1000.;
+		dispatch.params.e_pb_startup_hot = pc.get_hot_startup_energy()*1000.;
+		dispatch.params.dt_rec_startup = cr.get_startup_time() / 3600.;
+		dispatch.params.e_rec_startup = cr.get_startup_energy() * 1000;
+		dispatch.params.q_rec_min = cr.get_min_power_delivery()*1000.;
+		dispatch.params.w_rec_pump = cr.get_pumping_parasitic_coef();
+		dispatch.params.e_tes_min = 0.;
+		dispatch.params.e_tes_max = 2.5e6;
+		dispatch.params.e_tes_init = 0.3 * dispatch.params.e_tes_max;
+		dispatch.params.tes_degrade_rate = 0.;
+		dispatch.params.q_pb_max = pc.get_max_thermal_power() * 1000;
+		dispatch.params.q_pb_min = pc.get_min_thermal_power() * 1000;
+		dispatch.params.q_pb_des = 250. * 1000.;
+		dispatch.params.eta_cycle_ref = pc.get_efficiency_at_load(1.);
+		dispatch.params.sf_effadj = 1.;
+		dispatch.params.disp_time_weighting = 0.99;
+		dispatch.params.rsu_cost = 950.;
+		dispatch.params.csu_cost = 10000.;
+		dispatch.params.pen_delta_w = 0.1;
+		dispatch.params.q_rec_standby = 9.e99;
+		dispatch.params.w_rec_ht = 0.;
+		dispatch.params.w_track = cr.get_tracking_power()*1000.0;
+		dispatch.params.w_stow = cr.get_col_startup_power()*1000.0;
+		dispatch.params.w_cycle_pump = pc.get_htf_pumping_parasitic_coef();
+		dispatch.params.w_cycle_standby = dispatch.params.q_pb_standby*dispatch.params.w_cycle_pump;
+		dispatch.params.is_pb_operating0 = false;
+		dispatch.params.is_pb_standby0 = false;
+		dispatch.params.is_rec_operating0 = false;
+		dispatch.params.q_pb0 = 0.;
+
+		dispatch.params.eff_table_load.clear();
+		dispatch.params.eff_table_load.add_point(0., 0.);
+		for( int i = 0; i < 2; i++ ){
+			double x = dispatch.params.q_pb_min + (dispatch.params.q_pb_max - dispatch.params.q_pb_min)*i;
+			dispatch.params.eff_table_load.add_point(x, pc.get_efficiency_at_load(x * 1.e-3 / 250.));
+		}
+		dispatch.params.eff_table_Tdb.clear();
+		dispatch.params.wcondcoef_table_Tdb.clear();
+		for( int i = 0; i < 40; i++ ){
+			double T = -10. + 60. / 39. * i;
+			double wcond;
+			double eta = pc.get_efficiency_at_TPH(T, 1., 30., &wcond) / 0.41;
+			dispatch.params.eff_table_Tdb.add_point(T, eta);
+			dispatch.params.wcondcoef_table_Tdb.add_point(T, wcond / 100.);
+		}
+
+		dispatch.solver_params.max_bb_iter = 10000;
+		dispatch.solver_params.mip_gap = 0.001;
+		dispatch.solver_params.solution_timeout = 5.;
+		dispatch.solver_params.bb_type = -1;
+		dispatch.solver_params.disp_reporting = 0;
+		dispatch.solver_params.presolve_type = -1;
+		dispatch.solver_params.scaling_type = -1;
+		dispatch.solver_params.is_write_ampl_dat = false;
+		dispatch.solver_params.is_ampl_engine = false;
+
+		dispatch.w_lim.assign(horizon, 1.e99);
+	}
+
+	// price multipliers for the horizon starting at 'step_start', one entry per hour
+	void set_price_signal(csp_dispatch_opt &dispatch, int step_start){
+		dispatch.price_signal.resize(horizon);
+		for( int t = 0; t < horizon; t++ ){
+			int hour = (step_start + t) % 24;
+			dispatch.price_signal.at(t) = hour >= 16 && hour < 20 ? 2. : 1.;
+		}
+	}
+};
+
+/// Horizons copied from the precomputed forecast match the step by step forecast exactly, leave the field optics in the same state, and dispatch the same
+TEST_F(CspDispatchTest, ForecastTable_csp_dispatch){
+	C_csp_test_collector_receiver cr_step, cr_table;
+	csp_dispatch_opt step, table;
+	setup_dispatch(step, cr_step);
+	setup_dispatch(table, cr_table);
+
+	int ndays = 3;
+	ASSERT_TRUE(table.precompute_forecast(0, 8 * 24, 1));
+
+	for( int day = 0; day < ndays; day++ ){
+		int step_start = 4 * 24 + day * 24;		//horizons starting at midnight, from January 5
+		set_price_signal(step, step_start);
+		set_price_signal(table, step_start);
+		ASSERT_EQ(step.forecast_index(step_start, horizon, 1), -1);
+		ASSERT_EQ(table.forecast_index(step_start, horizon, 1), step_start);
+
+		ASSERT_TRUE(step.predict_performance(step_start, horizon, 1));
+		ASSERT_TRUE(table.predict_performance(step_start, horizon, 1));
+
+		ASSERT_EQ(step.outputs.q_sfavail_expected.size(), (size_t)horizon);
+		ASSERT_EQ(table.outputs.q_sfavail_expected.size(), (size_t)horizon);
+		for( int t = 0; t < horizon; t++ ){
+			EXPECT_EQ(step.outputs.q_sfavail_expected.at(t), table.outputs.q_sfavail_expected.at(t)) << "day " << day << " hour " << t;
+			EXPECT_EQ(step.outputs.eta_sf_expected.at(t), table.outputs.eta_sf_expected.at(t)) << "day " << day << " hour " << t;
+			EXPECT_EQ(step.outputs.eta_pb_expected.at(t), table.outputs.eta_pb_expected.at(t)) << "day " << day << " hour " << t;
+			EXPECT_EQ(step.outputs.f_pb_op_limit.at(t), table.outputs.f_pb_op_limit.at(t)) << "day " << day << " hour " << t;
+			EXPECT_EQ(step.outputs.w_condf_expected.at(t), table.outputs.w_condf_expected.at(t)) << "day " << day << " hour " << t;
+		}
+		EXPECT_EQ(cr_step.m_eta_last, cr_table.m_eta_last) << "day " << day;
+		EXPECT_EQ(cr_step.m_time_last, cr_table.m_time_last) << "day " << day;
+		EXPECT_EQ(step.m_weather.ms_outputs.m_beam, table.m_weather.ms_outputs.m_beam) << "day " << day;
+
+		ASSERT_TRUE(step.optimize()) << "day " << day;
+		ASSERT_TRUE(table.optimize()) << "day " << day;
+		EXPECT_EQ(step.outputs.objective, table.outputs.objective) << "day " << day;
+		for( int t = 0; t < horizon; t++ ){
+			EXPECT_EQ(step.outputs.q_pb_target.at(t), table.outputs.q_pb_target.at(t)) << "day " << day << " hour " << t;
+			EXPECT_EQ(step.outputs.w_pb_target.at(t), table.outputs.w_pb_target.at(t)) << "day " << day << " hour " << t;
+			EXPECT_EQ(step.outputs.tes_charge_expected.at(t), table.outputs.tes_charge_expected.at(t)) << "day " << day << " hour " << t;
+			EXPECT_EQ(step.outputs.rec_operation.at(t), table.outputs.rec_operation.at(t)) << "day " << day << " hour " << t;
+			EXPECT_EQ(step.outputs.pb_operation.at(t), table.outputs.pb_operation.at(t)) << "day " << day << " hour " << t;
+		}
+
+		EXPECT_GT(*std::max_element(step.outputs.w_pb_target.begin(), step.outputs.w_pb_target.end()), 0.) << "day " << day;
+
+		step.params.e_tes_init = table.params.e_tes_init = step.outputs.tes_charge_expected.at(23);
+	}
+}
+
+/// Horizons solved by updating the stored problem of a previous horizon dispatch the same as a problem built from scratch
+TEST_F(CspDispatchTest, ProblemReuse_csp_dispatch){
+	C_csp_test_collector_receiver cr_reused;
+	csp_dispatch_opt reused;
+	setup_dispatch(reused, cr_reused);
+
+	int nhorizons = 3;
+	int shift = 18;		//re-optimized every 18 hours, so hours with and without sun move within the horizon
+	for( int n = 0; n < nhorizons; n++ ){
+		int step_start = 4 * 24 + n * shift;
+
+		//the first horizon builds the problem in 'reused', later ones update it. 'rebuilt' always builds its own
+		C_csp_test_collector_receiver cr_rebuilt;
+		csp_dispatch_opt rebuilt;
+		setup_dispatch(rebuilt, cr_rebuilt);
+		rebuilt.params.e_tes_init = reused.params.e_tes_init;
+		rebuilt.params.is_pb_operating0 = reused.params.is_pb_operating0;
+		rebuilt.params.is_pb_standby0 = reused.params.is_pb_standby0;
+		rebuilt.params.is_rec_operating0 = reused.params.is_rec_operating0;
+		rebuilt.params.q_pb0 = reused.params.q_pb0;
+
+		set_price_signal(reused, step_start);
+		set_price_signal(rebuilt, step_start);
+		ASSERT_TRUE(reused.predict_performance(step_start, horizon, 1));
+		ASSERT_TRUE(rebuilt.predict_performance(step_start, horizon, 1));
+
+		ASSERT_TRUE(reused.optimize()) << "horizon " << n;
+		ASSERT_TRUE(rebuilt.optimize()) << "horizon " << n;
+		EXPECT_EQ(reused.outputs.objective, rebuilt.outputs.objective) << "horizon " << n;
+		for( int t = 0; t < horizon; t++ ){
+			EXPECT_EQ(reused.outputs.q_pb_target.at(t), rebuilt.outputs.q_pb_target.at(t)) << "horizon " << n << " hour " << t;
+			EXPECT_EQ(reused.outputs.w_pb_target.at(t), rebuilt.outputs.w_pb_target.at(t)) << "horizon " << n << " hour " << t;
+			EXPECT_EQ(reused.outputs.tes_charge_expected.at(t), rebuilt.outputs.tes_charge_expected.at(t)) << "horizon " << n << " hour " << t;
+			EXPECT_EQ(reused.outputs.rec_operation.at(t), rebuilt.outputs.rec_operation.at(t)) << "horizon " << n << " hour " << t;
+			EXPECT_EQ(reused.outputs.pb_operation.at(t), rebuilt.outputs.pb_operation.at(t)) << "horizon " << n << " hour " << t;
+			EXPECT_EQ(reused.outputs.pb_standby.at(t), rebuilt.outputs.pb_standby.at(t)) << "horizon " << n << " hour " << t;
+		}
+
+		//start the next horizon from this plan so that the initial-state entries change too
+		reused.params.e_tes_init = reused.outputs.tes_charge_expected.at(shift - 1);
+		reused.params.is_pb_operating0 = reused.outputs.pb_operation.at(shift - 1);
+		reused.params.is_pb_standby0 = reused.outputs.pb_standby.at(shift - 1);
+		reused.params.is_rec_operating0 = reused.outputs.rec_operation.at(shift - 1);
+		reused.params.q_pb0 = reused.outputs.q_pb_target.at(shift - 1);
+	}
+}